@@ -0,0 +1,25 @@
+import PYTHONPATH
+import os
+import scripts.models as models
+import scripts.modelExport as modelExport
+import scripts.interfaceUtils as utils
+from scripts.Path import Path
+
+# Project_Kinect PREDICT_BACKEND_NATIVE용 (data/models/M1.kslm, PATH_MODEL_FOLDER)
+# M1.kslr : 무작위 입력과 keras 출력, Project_Tools infer-parity로 C++ 결과와 비교
+MODEL_FILE_NAME = 'M1.kslm' # ModelFormat.h MODEL_FILE_NAME
+MODEL_REFERENCE_FILE_NAME = 'M1.kslr' # ModelFormat.h MODEL_REFERENCE_FILE_NAME
+
+#load model
+utils.showProcess('Model Loading Process')
+model = models.Model_M1()
+models.loadWeight(model, Path.get('weight'))
+
+#export
+utils.showProcess('Model Export Process')
+modelDir = os.path.join(Path.get('data'), 'models')
+if not os.path.exists(modelDir):
+    os.mkdir(modelDir)
+
+modelExport.exportModel(model, os.path.join(modelDir, MODEL_FILE_NAME))
+modelExport.exportReference(model, os.path.join(modelDir, MODEL_REFERENCE_FILE_NAME))
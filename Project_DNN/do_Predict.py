@@ -4,6 +4,7 @@ import numpy as np
 import scripts.models as models
 import scripts.dataFormater as DFormat
 import scripts.interfaceUtils as utils
+import scripts.defines as defines
 from scripts.Path import Path
 import tensorflow as tf
 from keras import backend as K
@@ -23,17 +24,55 @@ utils.showProcess('Model Loading Process')
 model = models.Model_M1()
 models.loadWeight(model, Path.get('weight'))
 
-#logic
-utils.showProcess('Predict Process')
-while (True):
-    # 수신
-    data = sys.stdin.readline()
-    if str(data).find('[Predict]') is -1:
-        continue
-    
-    spointData, imageList, label = \
-        DFormat.ROI_loadData(Path.get('temp'), False)
+#sample handoff
+if defines.PREDICT_HANDOFF_RING:
+    from scripts.sampleRing import SampleRing
+    ring = SampleRing()
+
+#predict protocol
+if defines.PREDICT_PROTOCOL_PIPE:
+    import scripts.protocol as protocol
+
+def receive():
+    '''
+    다음 predict 샘플 대기
+      ring : Project_Kinect가 shared memory에 쓴 샘플을 바로 parse (파일, stdin 없음)
+      file : C#이 넘겨준 "[Predict]" 후 data/temp 읽기
+
+    return spointData, imageList, label
+    '''
+    if defines.PREDICT_HANDOFF_RING:
+        while True:
+            data, info = ring.wait(1000)
+            if data is not None:
+                return DFormat.ROI_loadSampleBytes(data, False)
 
+    while True:
+        data = sys.stdin.readline()
+        if str(data).find('[Predict]') != -1:
+            return DFormat.ROI_loadData(Path.get('temp'), False)
+
+def loadRequest(request, extra):
+    '''
+    REQUEST가 가리키는 샘플 : ring 번호 또는 inline 바이트
+
+    return spointData, imageList, label / 샘플이 없으면 None
+    '''
+    if request['ringNumber'] >= 0:
+        if not defines.PREDICT_HANDOFF_RING:
+            return None
+        data, info = ring.readNumber(request['ringNumber'])
+    else:
+        data = extra
+
+    if not data:
+        return None
+    return DFormat.ROI_loadSampleBytes(data, False)
+
+def predict(spointData, imageList, label):
+    '''
+    return label별 확률 (np.array)
+    '''
     spointData = np.array([spointData])
     imageList = np.array([imageList])
     label = np.array([label])
@@ -46,16 +85,20 @@ while (True):
     # 참고로 keras놈은 모든 에레이를 np.array로 wrap해야 함 (변화는 없음)
     predicted = model.predict([spointData, imageList])
 
-    # 퍼센트 
-    highstIdx = np.argmax(predicted[0])
-    believe = int(predicted[0][highstIdx] * 100) # 신뢰율
+    return predicted[0]
+
+def report(scores):
+    '''
+    내부출력 (each labels percent), return labelName, 신뢰율
+    '''
+    highstIdx = np.argmax(scores)
+    believe = int(scores[highstIdx] * 100) # 신뢰율
 
-    # 내부출력 (each labels percent)
     allresult = []
-    for each_result in predicted[0]:
+    for each_result in scores:
         each_percent = int(each_result * 100)
         allresult.append(each_percent)
-    
+
     if highstIdx in labelDic:
         labelName = labelDic[highstIdx]
     else:
@@ -63,6 +106,56 @@ while (True):
 
     print(str(allresult) + ' -> ' + labelName)
 
+    return labelName, believe
+
+def servePipe():
+    '''
+    PREDICT_PROTOCOL_PIPE : Project_Kinect에 붙어 REQUEST마다 RESULT로 답한다
+    결과 표시는 Project_Kinect가 ("[Result]" 출력), 끊기면 다시 연결
+    '''
+    while True:
+        utils.showProcess('Predict Pipe Connecting')
+        channel = protocol.PredictChannel()
+        channel.connect()
+        channel.sendHello(defines.LABEL_SIZE)
+
+        try:
+            while True:
+                type, request, extra = channel.receive()
+                if type == protocol.PREDICT_MESSAGE_BYE:
+                    break
+                if type != protocol.PREDICT_MESSAGE_REQUEST or request is None:
+                    continue
+
+                receiveTime = protocol.now()
+                sample = loadRequest(request, extra)
+
+                # 샘플을 못 읽어도 requestId는 답해야 Project_Kinect의 대기가 풀린다
+                if sample is None:
+                    print('Predict #%d sample missing (ring %d)' % (request['requestId'], request['ringNumber']))
+                    channel.sendResult(request, [], receiveTime)
+                    continue
+
+                scores = predict(*sample)
+                report(scores)
+                channel.sendResult(request, scores, receiveTime)
+        except (EOFError, OSError, ValueError) as e:
+            print('Predict pipe closed: ' + str(e))
+
+        channel.close()
+
+#logic
+utils.showProcess('Predict Process')
+if defines.PREDICT_PROTOCOL_PIPE:
+    servePipe()
+
+while (True):
+    # 수신
+    spointData, imageList, label = receive()
+
+    # 퍼센트
+    labelName, believe = report(predict(spointData, imageList, label))
+
     # 결과를 메인창에 보여주기 위해[Result]접두사 추가
     resultMessage = str('[Result]') + str(labelName) + ' ' + str(believe) + '%'
 
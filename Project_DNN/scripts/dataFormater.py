@@ -1,5 +1,5 @@
 import numpy as np
-import os, sys
+import os, sys, struct
 import functools
 import matplotlib.pyplot as plt # plt.imshow
 import scripts.interfaceUtils as util #input(debug)
@@ -137,6 +137,21 @@ def path_leaf(path):
 def _comp(a, b):
     return int(a[:a.find('.')]) - int(b[:b.find('.')])
 
+def _ROI_imageDir(sampleDir, imageSize):
+    """
+    imageSize에 맞게 미리 저장된 ROI pyramid 폴더가 있으면 그 폴더를 반환
+      e.g. sample/140x140/0.bmp (IMAGE_SCALES, defines.hpp)
+    없으면 sampleDir (80x80 원본, load_img에서 resize)
+    """
+    if imageSize is None:
+        return sampleDir
+
+    scaleDir = os.path.join(sampleDir, '{0}x{1}'.format(imageSize[1], imageSize[0]))
+    if os.path.isdir(scaleDir):
+        return scaleDir
+
+    return sampleDir
+
 def _ROI_loadAllSamplePaths(rootfolder):
     """
     Path 읽기
@@ -207,7 +222,359 @@ def _ROI_loadDataList(samplePathList, isShow, imgSize):
 
     return spointSamples, imageSamples, labelSamples
 
-def ROI_loadData(sampleDir, isShow, imageSize):
+def _loadTimes(sampleDir):
+    """
+    Times.txt 읽기 : 표준화된 프레임들의 시점 (기록 시작 기준, 100ns)
+      line 1 = SPoint 프레임, line 2 = ROI 프레임 (한 손)
+    
+    return [spointTimes, roiTimes] (np.array), 파일이 없으면 None
+    """
+    path = os.path.join(sampleDir, 'Times.txt')
+    if not os.path.exists(path):
+        return None
+
+    times = []
+    with open(path) as f:
+        for line in f:
+            items = line.split()
+            if len(items) > 0:
+                times.append(np.array(items[1:int(items[0]) + 1], dtype=np.int64))
+
+    return times
+
+def _expandToStandard(data, times, size):
+    """
+    FRAME_STANDARD_ADAPTIVE로 줄어든 시퀀스를 균등 시간 size개로 펼침
+      각 균등 시점에서 가장 가까운 프레임을 사용 (nearest)
+    """
+    if len(data) == size or len(times) != len(data) or len(times) == 0:
+        return data
+
+    grid = times[-1] * (np.arange(size) + 1) / float(size)
+    idx = np.abs(times[None, :] - grid[:, None]).argmin(axis=1)
+
+    return np.array(data)[idx]
+
+# sample.ksl (SampleFile.h, Project_Kinect)
+SAMPLE_FILE_NAME = 'sample.ksl'
+SAMPLE_MAGIC = 0x534C534B
+SAMPLE_VERSION = 2
+SAMPLE_MIN_VERSION = 1 # 1 : IMAGE_CODED 없음
+SAMPLE_HEADER = struct.Struct('<IIIIiIq32s64s32s')
+SAMPLE_SECTION = struct.Struct('<IIII5IIQQ')
+SAMPLE_SECTION_SPOINT, SAMPLE_SECTION_SPOINT_TIME, SAMPLE_SECTION_IMAGE, \
+    SAMPLE_SECTION_IMAGE_TIME, SAMPLE_SECTION_FLOW, SAMPLE_SECTION_IMAGE_CODED = range(1, 7)
+SAMPLE_DTYPES = { 1: np.uint8, 2: np.float32, 3: np.int64 }
+
+def _loadSampleFile(path, offset=0, size=None):
+    """
+    sample.ksl 읽기, 각 section은 memmap 위의 view (복사 없음)
+      shard(.kss) 안의 샘플은 offset, size 지정
+
+    return header(dict), sections = { (type, param): np.ndarray }
+    """
+    buf = np.memmap(path, dtype=np.uint8, mode='r')
+    if offset != 0 or size is not None:
+        buf = buf[offset:(offset + size) if size is not None else None]
+
+    return _parseSample(buf, path)
+
+def _parseSample(buf, name):
+    """
+    메모리 위의 sample.ksl 바이트 (memmap, bytes, sampleRing 수신 버퍼)
+      section은 buf 위의 view
+    """
+    magic, version, headerSize, sectionCount, label, _, startTime, date, labelName, worker = \
+        SAMPLE_HEADER.unpack_from(buf, 0)
+    if magic != SAMPLE_MAGIC or not (SAMPLE_MIN_VERSION <= version <= SAMPLE_VERSION) or headerSize != SAMPLE_HEADER.size:
+        raise ValueError('invalid sample file: ' + name)
+
+    header = {
+        'label': label,
+        'recordStartTime': startTime,
+        'date': date.split(b'\0')[0].decode('ascii', 'ignore'),
+        'labelName': labelName.split(b'\0')[0],
+        'worker': worker.split(b'\0')[0].decode('ascii', 'ignore'),
+    }
+
+    sections = {}
+    for i in range(sectionCount):
+        items = SAMPLE_SECTION.unpack_from(buf, SAMPLE_HEADER.size + i * SAMPLE_SECTION.size)
+        sectionType, dtype, param, rank = items[0:4]
+        shape = items[4:4 + rank]
+        offset, size = items[10], items[11]
+
+        dtype = SAMPLE_DTYPES[dtype]
+        count = size // np.dtype(dtype).itemsize
+        sections[(sectionType, param)] = \
+            np.frombuffer(buf, dtype=dtype, count=count, offset=offset).reshape(shape)
+
+    return header, sections
+
+# ROI_CODEC stream (RoiCodec.cpp, Project_Kinect) : CodecHeader magic width height count
+ROI_CODEC_HEADER = struct.Struct('<IHHI')
+ROI_CODEC_RAW_MAGIC = 0x3052434B
+ROI_CODEC_RICE_MAGIC = 0x3152434B
+ROI_RICE_LIMIT = 24
+ROI_RICE_MAX_K = 7
+ROI_CONTEXT_SIZE = 8
+
+def _roiNeighbors(plane, width, x, y):
+    # left, up, up-left (경계는 가까운 값, RoiCodec.cpp neighbors와 같음)
+    i = y * width + x
+    if y == 0:
+        a = plane[i - 1] if x > 0 else 0
+        return a, a, a
+    if x == 0:
+        b = plane[i - width]
+        return b, b, b
+    return plane[i - 1], plane[i - width], plane[i - width - 1]
+
+def _roiMed(a, b, c):
+    mx, mn = max(a, b), min(a, b)
+    if c >= mx:
+        return mn
+    if c <= mn:
+        return mx
+    return a + b - c
+
+def _decodeRoiStream(data):
+    """
+    RoiCodec stream 하나 (raw, delta-rice, magic으로 구분) -> uint8 (frame, h, w)
+      DeltaRiceRoiCodec::decode를 그대로 옮김, 픽셀 단위 python 루프라 느리다 (학습 전에 한 번 풀어 둘 것)
+    """
+    data = np.ascontiguousarray(data, dtype=np.uint8)
+    magic, width, height, count = ROI_CODEC_HEADER.unpack_from(data, 0)
+    body = data[ROI_CODEC_HEADER.size:]
+    plane = width * height
+
+    if magic == ROI_CODEC_RAW_MAGIC:
+        if len(body) < plane * count:
+            raise ValueError('broken raw roi stream')
+        return body[:plane * count].reshape((count, height, width))
+    if magic != ROI_CODEC_RICE_MAGIC:
+        raise ValueError('unknown roi codec %x' % magic)
+
+    # LSB first bit 배열, 끝은 한 줄 분량의 0으로 채움 (BitReader::refill), 넘어가면 줄마다 검사
+    bitSize = len(body) * 8
+    bits = np.unpackbits(body[:, None], axis=1)[:, ::-1].reshape(-1).tolist() + [0] * (width * (ROI_RICE_LIMIT + 9))
+    pos = 0
+
+    ctxA = [4] * ROI_CONTEXT_SIZE # RiceContext 잔차 합
+    ctxN = [1] * ROI_CONTEXT_SIZE # 개수
+    upResidual = [0] * width
+    rowResidual = [0] * width
+
+    frames = np.zeros((count, height, width), dtype=np.uint8)
+    prev = None
+    for f in range(count):
+        cur = bytearray(plane)
+        upResidual = [0] * width
+
+        for y in range(height):
+            for x in range(width):
+                activity = (rowResidual[x - 1] if x > 0 else 0) + upResidual[x]
+                ctx = 0
+                while activity > 0 and ctx < ROI_CONTEXT_SIZE - 1:
+                    activity >>= 1
+                    ctx += 1
+
+                k = 0
+                while (ctxN[ctx] << k) < ctxA[ctx] and k < ROI_RICE_MAX_K:
+                    k += 1
+
+                # Rice(k) : q개의 1 + 0 + k bit, q가 limit이면 8bit 그대로
+                q = 0
+                while q < ROI_RICE_LIMIT and bits[pos]:
+                    q += 1
+                    pos += 1
+                if q == ROI_RICE_LIMIT:
+                    n, u = 8, 0
+                else:
+                    pos += 1
+                    n, u = k, q << k
+                for i in range(n):
+                    u |= bits[pos + i] << i
+                pos += n
+
+                ctxA[ctx] += u
+                ctxN[ctx] += 1
+                if ctxN[ctx] >= 64:
+                    ctxA[ctx] >>= 1
+                    ctxN[ctx] >>= 1
+
+                e = -((u + 1) >> 1) if u & 1 else u >> 1
+                a, b, c = _roiNeighbors(cur, width, x, y)
+                p = _roiMed(a, b, c)
+                if prev is not None:
+                    pa, pb, pc = _roiNeighbors(prev, width, x, y)
+                    p = min(max(prev[y * width + x] + p - _roiMed(pa, pb, pc), 0), 255)
+                cur[y * width + x] = (p + e) & 0xFF
+
+                rowResidual[x] = u
+            upResidual, rowResidual = rowResidual, upResidual
+
+            if pos > bitSize:
+                raise ValueError('broken delta-rice roi stream')
+
+        frames[f] = np.frombuffer(bytes(cur), dtype=np.uint8).reshape((height, width))
+        prev = cur
+
+    return frames
+
+def _sampleImages(sections, scale):
+    """
+    scale 하나의 (2(L/R), frame, h, w), IMAGE_CODED면 decode
+      IMAGE_CODED : [uint32 L size][L stream][R stream]
+    """
+    if (SAMPLE_SECTION_IMAGE, scale) in sections:
+        return sections[(SAMPLE_SECTION_IMAGE, scale)]
+
+    data = sections[(SAMPLE_SECTION_IMAGE_CODED, scale)]
+    leftSize = struct.unpack_from('<I', data, 0)[0]
+    if 4 + leftSize > len(data):
+        raise ValueError('broken IMAGE_CODED section')
+
+    return np.stack((_decodeRoiStream(data[4:4 + leftSize]), _decodeRoiStream(data[4 + leftSize:])))
+
+def _ROI_loadSampleFile(path, isShow, imageSize, offset=0, size=None):
+    """
+    ROI_loadData와 같은 형태로 sample.ksl 읽기
+
+    return spointData, imageList, label, [spointTimes, roiTimes]
+    """
+    header, sections = _loadSampleFile(path, offset, size)
+
+    return _ROI_fromSections(header, sections, isShow, imageSize, path)
+
+def _ROI_fromSections(header, sections, isShow, imageSize, name):
+    spoint = sections[(SAMPLE_SECTION_SPOINT, 0)]
+    spointData = spoint.reshape((spoint.shape[0], spoint.shape[1] * spoint.shape[2], 1))
+
+    labelOneHot = np.zeros(defines.LABEL_SIZE)
+    labelOneHot[header['label']] = 1
+
+    # imageSize에 맞는 scale이 저장돼 있으면 그대로, 없으면 가장 큰 scale에서 resize
+    scales = [param for (t, param) in sections if t in (SAMPLE_SECTION_IMAGE, SAMPLE_SECTION_IMAGE_CODED)]
+    if len(scales) == 0:
+        raise ValueError('no image section: ' + name)
+    scale = defines.IMAGE_WIDTH if imageSize is None else imageSize[0]
+    if scale in scales:
+        images = _sampleImages(sections, scale)
+    else:
+        src = _sampleImages(sections, max(scales))
+        images = np.array([[image.img_to_array(image.array_to_img(img[:, :, None]).resize((imageSize[1], imageSize[0])))[:, :, 0]
+            for img in hand] for hand in src])
+
+    # (2, n, h, w) -> (n, h, 2w, 1) : 왼쪽, 오른쪽 concat (_loadImageFilesWithConcat)
+    imageList = np.concatenate((images[0], images[1]), axis=2)[:, :, :, None].astype(np.float32)
+
+    times = [sections[(SAMPLE_SECTION_SPOINT_TIME, 0)], sections[(SAMPLE_SECTION_IMAGE_TIME, 0)]]
+
+    if isShow:
+        print("Sample {0} Label{1} Frame{2} Image{3}"
+        .format(header['date'], header['label'], spointData.shape[0], imageList.shape[0]))
+
+    return spointData, imageList, labelOneHot, times
+
+# data/shards/*.kss, *.idx (ShardFile.h, SAVE_FORMAT_SHARD)
+SHARD_DATA_EXT = '.kss'
+SHARD_INDEX_EXT = '.idx'
+SHARD_INDEX_MAGIC = 0x494C534B
+SHARD_VERSION = 1
+SHARD_INDEX_HEADER = struct.Struct('<IIII')
+SHARD_INDEX_ENTRY = np.dtype([('offset', '<u8'), ('size', '<u8'), ('label', '<i4'), ('reserved', '<u4'),
+    ('recordStartTime', '<i8'), ('date', 'S32'), ('worker', 'S32')])
+
+def loadShardIndex(shardDir):
+    """
+    shard 폴더의 .idx만 읽어서 전체 샘플 목록 생성 (폴더 순회, 샘플 파일 open 없음)
+
+    return [(dataPath, entry)], entry = SHARD_INDEX_ENTRY (offset, size, label, worker ...)
+    """
+    result = []
+
+    for f in sorted(os.listdir(shardDir)):
+        if not f.endswith(SHARD_INDEX_EXT):
+            continue
+
+        indexPath = os.path.join(shardDir, f)
+        dataPath = indexPath[:-len(SHARD_INDEX_EXT)] + SHARD_DATA_EXT
+
+        with open(indexPath, 'rb') as stream:
+            raw = stream.read()
+
+        magic, version, entrySize, _ = SHARD_INDEX_HEADER.unpack_from(raw, 0)
+        if magic != SHARD_INDEX_MAGIC or version != SHARD_VERSION or entrySize != SHARD_INDEX_ENTRY.itemsize:
+            print('invalid shard index: ' + indexPath)
+            continue
+
+        # 쓰다 만 마지막 entry는 버림
+        count = (len(raw) - SHARD_INDEX_HEADER.size) // entrySize
+        entries = np.frombuffer(raw, dtype=SHARD_INDEX_ENTRY, count=count, offset=SHARD_INDEX_HEADER.size)
+
+        # data보다 index가 앞선 entry (기록 중) 제외
+        dataSize = os.path.getsize(dataPath) if os.path.exists(dataPath) else 0
+        for entry in entries:
+            if entry['offset'] + entry['size'] <= dataSize:
+                result.append((dataPath, entry))
+
+    return result
+
+def ROI_loadShardSample(item, isShow, imageSize=None):
+    """
+    loadShardIndex의 항목 하나 읽기 (random access)
+
+    return spointData, imageList, label (ROI_loadData와 같음)
+    """
+    dataPath, entry = item
+    spointData, imageList, label, times = \
+        _ROI_loadSampleFile(dataPath, isShow, imageSize, int(entry['offset']), int(entry['size']))
+
+    spointData = _expandToStandard(spointData, times[0], defines.FRAME_STANDARD_SIZE)
+    imageList = _expandToStandard(imageList, times[1], defines.IMAGE_STANDARD_FRAME_SIZE)
+
+    return spointData, imageList, label
+
+def ROI_loadSampleBytes(data, isShow, imageSize=None):
+    """
+    메모리로 받은 sample.ksl 하나 읽기 (sampleRing.SampleRing.wait, PREDICT_HANDOFF_RING)
+
+    return spointData, imageList, label (ROI_loadData와 같음)
+    """
+    header, sections = _parseSample(np.frombuffer(data, dtype=np.uint8), 'sample ring')
+    spointData, imageList, label, times = _ROI_fromSections(header, sections, isShow, imageSize, 'sample ring')
+
+    spointData = _expandToStandard(spointData, times[0], defines.FRAME_STANDARD_SIZE)
+    imageList = _expandToStandard(imageList, times[1], defines.IMAGE_STANDARD_FRAME_SIZE)
+
+    return spointData, imageList, label
+
+def ROI_loadShardListAll(shardDir, isShow, isShuffle, imgSize):
+    '''
+    ROI_loadDataListAll의 shard 버전
+      shardDir = data/shards/
+    '''
+    index = loadShardIndex(shardDir)
+
+    # shuffle은 index 단계에서 (파일 순서와 무관하게 offset으로 읽음)
+    if isShuffle:
+        random.shuffle(index)
+
+    spointSamples = []
+    imageSamples = []
+    labelSamples = []
+
+    for item in index:
+        spoint, images, label = ROI_loadShardSample(item, isShow, imgSize)
+
+        spointSamples.append(spoint)
+        imageSamples.append(images)
+        labelSamples.append(label)
+
+    return np.array(spointSamples), np.array(imageSamples), np.array(labelSamples)
+
+def ROI_loadData(sampleDir, isShow, imageSize=None):
     """
     타임스텝 단위의 모든 데이터를 읽는다.
       디렉토리 안에 있는 left, right hand 이미지, SPoint.txt 로드
@@ -227,18 +594,31 @@ def ROI_loadData(sampleDir, isShow, imageSize):
     imageFileList = []
     imageList = [] # left, right sum
 
-    # 폴더내 이미지 파일명 소트, Spoint.txt 리스트에서 제거
-    for f in os.listdir(sampleDir):
-        if f.find('Spoints.txt') == -1:
-            imageFileList.append(f)
+    # 바이너리 샘플 (SAVE_FORMAT_BINARY)
+    samplePath = os.path.join(sampleDir, SAMPLE_FILE_NAME)
+    if os.path.exists(samplePath):
+        spointData, imageList, label, times = _ROI_loadSampleFile(samplePath, isShow, imageSize)
+    else:
+        # 폴더내 이미지 파일명 소트, Spoint.txt 및 scale 폴더는 리스트에서 제거
+        imageDir = _ROI_imageDir(sampleDir, imageSize)
+        for f in os.listdir(imageDir):
+            if f.endswith('.bmp'):
+                imageFileList.append(f)
+
+        imageFileList.sort(key=functools.cmp_to_key(_comp))
 
-    imageFileList.sort(key=functools.cmp_to_key(_comp))
+        # 이미지 로드 (같은 크기면 load_img에서 resize 하지 않음)
+        #imageList = _loadImageFiles(dirpath, imageFileList, isShow, imageSize)
+        imageList = _loadImageFilesWithConcat(imageDir, imageFileList, isShow, imageSize)
+        # Spint 로드
+        spointData, label = _loadDataFromFile(sampleDir + "/Spoints.txt", isShow)
 
-    # 이미지 로드
-    #imageList = _loadImageFiles(dirpath, imageFileList, isShow, imageSize)
-    imageList = _loadImageFilesWithConcat(sampleDir, imageFileList, isShow, imageSize)
-    # Spint 로드
-    spointData, label = _loadDataFromFile(sampleDir + "/Spoints.txt", isShow)
+        times = _loadTimes(sampleDir)
+
+    # 적응형 프레임 수 샘플은 Times.txt로 표준 길이에 맞춘다
+    if times is not None and len(times) == 2:
+        spointData = _expandToStandard(spointData, times[0], defines.FRAME_STANDARD_SIZE)
+        imageList = _expandToStandard(imageList, times[1], defines.IMAGE_STANDARD_FRAME_SIZE)
 
     # 이미지 확인법
     #plt.imshow(imageList[0][0] / 255) #settingwindow
@@ -246,6 +626,41 @@ def ROI_loadData(sampleDir, isShow, imageSize):
 
     return spointData, imageList, label
 
+def ROI_loadFlow(sampleDir):
+    """
+    ROI optical flow 읽기 (ROI_OPTICAL_FLOW, defines.hpp)
+      sampleDir/flow/<n>.bmp, B = dx, G = dy (128 + flow * ROI_FLOW_SCALE)
+
+    return flowList = [L1, L2 ... Ln, R1, R2 ... Rn]
+      shape eg. (70, 80, 80, 2), pixel 단위 float
+      flow 폴더가 없으면 빈 리스트
+    """
+    samplePath = os.path.join(sampleDir, SAMPLE_FILE_NAME)
+    if os.path.exists(samplePath):
+        _, sections = _loadSampleFile(samplePath)
+        if (SAMPLE_SECTION_FLOW, 0) not in sections:
+            return []
+
+        flow = sections[(SAMPLE_SECTION_FLOW, 0)]
+        flow = flow.reshape((flow.shape[0] * flow.shape[1],) + flow.shape[2:])
+        return (flow.astype(np.float32) - 128.0) / defines.ROI_FLOW_SCALE
+
+    flowDir = os.path.join(sampleDir, 'flow')
+    if not os.path.isdir(flowDir):
+        return []
+
+    fileList = [f for f in os.listdir(flowDir) if f.endswith('.bmp')]
+    fileList.sort(key=functools.cmp_to_key(_comp))
+
+    flowList = []
+    for file in fileList:
+        img = image.img_to_array(image.load_img(os.path.join(flowDir, file)))
+        # load_img는 RGB 순서 : R = 128, G = dy, B = dx
+        flow = np.stack((img[:, :, 2], img[:, :, 1]), axis=-1)
+        flowList.append((flow - 128.0) / defines.ROI_FLOW_SCALE)
+
+    return np.array(flowList)
+
 def ROI_loadSingleImages(dirpath, isShow, imgSize):
     """
     한 장 단위의 그림을 읽어서 학습/예측하는 모델에 쓰임
@@ -1 +1,7 @@
-LABEL_SIZE = 10
\ No newline at end of file
+LABEL_SIZE = 10
+ROI_FLOW_SCALE = 8.0 # defines.hpp ROI_FLOW_SCALE
+FRAME_STANDARD_SIZE = 150 # defines.hpp FRAME_STANDARD_SIZE
+IMAGE_STANDARD_FRAME_SIZE = 35 # defines.hpp IMAEG_STANDARD_FRAME_SIZE
+IMAGE_WIDTH = 80 # defines.hpp IMAGE_WIDTH
+PREDICT_HANDOFF_RING = True # defines.hpp PREDICT_HANDOFF == PREDICT_HANDOFF_RING (sampleRing.py), False = data/temp + "[Predict]"
+PREDICT_PROTOCOL_PIPE = True # defines.hpp PREDICT_PROTOCOL == PREDICT_PROTOCOL_PIPE (protocol.py), False = stdout "[Result]"
\ No newline at end of file
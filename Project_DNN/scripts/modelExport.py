@@ -0,0 +1,190 @@
+''' ---------------------------------------------------
+
+# Model Export:
+  학습된 keras 모델(Model_M1)을 Project_Kinect InferenceModel이 읽는 .kslm으로 저장 (PREDICT_BACKEND_NATIVE)
+  형식은 ModelFormat.h, 바뀌면 MODEL_VERSION과 같이 수정
+
+  exportModel(model, path)                       # Concatenate 앞 branch들 + head
+  exportReference(model, path, caseCount)       # 무작위 입력과 keras 출력 (Project_Tools infer-parity)
+
+지원 layer : Conv2D, Dense, BatchNormalization, Activation, Softmax, MaxPool2D, Flatten, LSTM
+  TimeDistributed(x)는 x로 (앞 차원은 InferenceModel이 batch로 봄)
+  Dropout 계열은 추론에서 없는 layer라 건너뜀
+  BatchNormalization은 scale, shift로 미리 계산해서 저장
+
+--------------------------------------------------- '''
+
+import struct
+import numpy as np
+from keras.layers import *
+
+MODEL_MAGIC = 0x4D4C534B
+MODEL_REFERENCE_MAGIC = 0x544C534B
+MODEL_VERSION = 1
+MODEL_MAX_RANK = 4
+MODEL_MAX_PARAMS = 8
+
+MODEL_LAYER_CONV2D, MODEL_LAYER_DENSE, MODEL_LAYER_BATCHNORM, MODEL_LAYER_ACTIVATION, \
+    MODEL_LAYER_MAXPOOL2D, MODEL_LAYER_FLATTEN, MODEL_LAYER_LSTM = range(1, 8)
+
+MODEL_ACTIVATION = { 'linear': 0, 'relu': 1, 'softmax': 2, 'tanh': 3, 'sigmoid': 4, 'hard_sigmoid': 5 }
+MODEL_PADDING = { 'valid': 0, 'same': 1 }
+
+# magic version branchCount labelCount name[32]
+FILE_HEADER = struct.Struct('<IIII32s')
+# rank shape[4] layerCount name[32]
+BRANCH_HEADER = struct.Struct('<I4iI32s')
+# type activation params[8] tensorCount reserved name[32]
+LAYER_HEADER = struct.Struct('<II8iII32s')
+# rank dims[4] reserved
+TENSOR_HEADER = struct.Struct('<I4II')
+# magic version caseCount spointSize imageSize labelCount
+REFERENCE_HEADER = struct.Struct('<IIIIII')
+
+SKIP_LAYERS = (Dropout, SpatialDropout1D, SpatialDropout2D, SpatialDropout3D, GaussianNoise, GaussianDropout)
+
+def _name(text):
+    return text.encode('utf-8')[:31]
+
+def _inbound(layer):
+    nodes = layer._inbound_nodes if hasattr(layer, '_inbound_nodes') else layer.inbound_nodes
+    return nodes[0].inbound_layers
+
+def _chain(layer, stop):
+    '''
+    layer에서 stop(InputLayer / Concatenate)까지 거슬러 올라간 순서 (stop 제외)
+    '''
+    layers = []
+    while not isinstance(layer, stop):
+        layers.insert(0, layer)
+        inbound = _inbound(layer)
+        if len(inbound) != 1:
+            raise ValueError('branch is not a chain: ' + layer.name)
+        layer = inbound[0]
+    return layers, layer
+
+def _activation(function):
+    name = function if isinstance(function, str) else function.__name__
+    if name not in MODEL_ACTIVATION:
+        raise ValueError('unsupported activation: ' + name)
+    return MODEL_ACTIVATION[name]
+
+def _layer(layer, isTimeDistributed):
+    '''
+    return type, activation, params, tensors / 건너뛸 layer면 None
+    '''
+    if isinstance(layer, TimeDistributed):
+        return _layer(layer.layer, True)
+
+    if isinstance(layer, SKIP_LAYERS):
+        return None
+
+    if isinstance(layer, Conv2D):
+        if layer.data_format != 'channels_last' or tuple(layer.dilation_rate) != (1, 1):
+            raise ValueError('unsupported conv: ' + layer.name)
+        kernel = layer.get_weights()[0]
+        bias = layer.get_weights()[1] if layer.use_bias else np.zeros(layer.filters, np.float32)
+        params = list(layer.kernel_size) + list(layer.strides) + [MODEL_PADDING[layer.padding], layer.filters]
+        return MODEL_LAYER_CONV2D, _activation(layer.activation), params, [kernel, bias]
+
+    if isinstance(layer, Dense):
+        kernel = layer.get_weights()[0]
+        bias = layer.get_weights()[1] if layer.use_bias else np.zeros(layer.units, np.float32)
+        return MODEL_LAYER_DENSE, _activation(layer.activation), [layer.units], [kernel, bias]
+
+    if isinstance(layer, BatchNormalization):
+        weights = layer.get_weights()
+        gamma = weights.pop(0) if layer.scale else 1.0
+        beta = weights.pop(0) if layer.center else 0.0
+        mean, variance = weights
+        scale = gamma / np.sqrt(variance + layer.epsilon)
+        shift = beta - mean * scale
+        return MODEL_LAYER_BATCHNORM, 0, [], [scale * np.ones_like(mean), shift * np.ones_like(mean)]
+
+    if isinstance(layer, Activation):
+        return MODEL_LAYER_ACTIVATION, _activation(layer.activation), [], []
+
+    if isinstance(layer, Softmax):
+        return MODEL_LAYER_ACTIVATION, MODEL_ACTIVATION['softmax'], [], []
+
+    if isinstance(layer, MaxPool2D):
+        return MODEL_LAYER_MAXPOOL2D, 0, list(layer.pool_size) + list(layer.strides), []
+
+    if isinstance(layer, Flatten):
+        return MODEL_LAYER_FLATTEN, 0, [1 if isTimeDistributed else 0], []
+
+    if isinstance(layer, LSTM):
+        if layer.go_backwards or layer.stateful:
+            raise ValueError('unsupported lstm: ' + layer.name)
+        kernel, recurrent = layer.get_weights()[0:2]
+        bias = layer.get_weights()[2] if layer.use_bias else np.zeros(4 * layer.units, np.float32)
+        params = [layer.units, _activation(layer.recurrent_activation), 1 if layer.return_sequences else 0]
+        return MODEL_LAYER_LSTM, _activation(layer.activation), params, [kernel, recurrent, bias]
+
+    raise ValueError('unsupported layer: ' + layer.name + ' ' + type(layer).__name__)
+
+def _writeBranch(file, name, shape, layers):
+    items = [(layer.name, _layer(layer, False)) for layer in layers]
+    items = [(n, item) for (n, item) in items if item is not None]
+
+    rank = len(shape)
+    file.write(BRANCH_HEADER.pack(rank, *(list(shape) + [0] * (MODEL_MAX_RANK - rank)), len(items), _name(name)))
+
+    for layerName, (type, activation, params, tensors) in items:
+        params = list(params) + [0] * (MODEL_MAX_PARAMS - len(params))
+        file.write(LAYER_HEADER.pack(type, activation, *params, len(tensors), 0, _name(layerName)))
+
+        for tensor in tensors:
+            tensor = np.ascontiguousarray(tensor, dtype='<f4')
+            dims = list(tensor.shape) + [0] * (MODEL_MAX_RANK - tensor.ndim)
+            file.write(TENSOR_HEADER.pack(tensor.ndim, *dims, 0))
+            file.write(tensor.tobytes())
+
+    print('  {0} {1} : {2} layer'.format(name, tuple(shape), len(items)))
+
+def exportModel(model, path):
+    '''
+    Concatenate 하나로 합쳐지는 모델 (입력 branch들 -> Concatenate -> head)
+      branch 순서는 model.inputs 순서, head 입력 = branch 출력을 이은 것
+    '''
+    heads, concat = _chain(model.layers[-1], Concatenate)
+    branches = []
+    for output in _inbound(concat):
+        layers, input = _chain(output, InputLayer)
+        branches.append((input, layers))
+
+    order = [layer.name for layer in model._input_layers] if hasattr(model, '_input_layers') else [l.name for l in model.input_layers]
+    branches.sort(key=lambda branch: order.index(branch[0].name))
+
+    labelCount = model.output_shape[-1]
+
+    with open(path, 'wb') as file:
+        file.write(FILE_HEADER.pack(MODEL_MAGIC, MODEL_VERSION, len(branches) + 1, labelCount, _name(model.name)))
+
+        print('Export ' + model.name + ' -> ' + path)
+        for input, layers in branches:
+            _writeBranch(file, input.name, input.batch_input_shape[1:], layers)
+        _writeBranch(file, concat.name, concat.output_shape[1:], heads)
+
+def exportReference(model, path, caseCount=4, seed=0):
+    '''
+    무작위 입력 caseCount개와 keras 출력 (C++ 결과와 비교용)
+      spoint는 distance 범위(0 ~ 1), image는 gray 범위(0 ~ 255)
+    '''
+    random = np.random.RandomState(seed)
+    spointShape = model.input_shape[0][1:]
+    imageShape = model.input_shape[1][1:]
+
+    spoints = random.uniform(0, 1, (caseCount,) + spointShape).astype(np.float32)
+    images = random.uniform(0, 255, (caseCount,) + imageShape).astype(np.float32)
+    outputs = model.predict([spoints, images]).astype(np.float32)
+
+    with open(path, 'wb') as file:
+        file.write(REFERENCE_HEADER.pack(MODEL_REFERENCE_MAGIC, MODEL_VERSION, caseCount,
+            int(np.prod(spointShape)), int(np.prod(imageShape)), outputs.shape[-1]))
+        for case in range(caseCount):
+            file.write(spoints[case].astype('<f4').tobytes())
+            file.write(images[case].astype('<f4').tobytes())
+            file.write(outputs[case].astype('<f4').tobytes())
+
+    print('Reference {0} case -> {1}'.format(caseCount, path))
@@ -0,0 +1,138 @@
+''' ---------------------------------------------------
+
+# Predict Protocol:
+  Project_Kinect와 predict 요청 / 결과를 named pipe로 주고받는다 (PREDICT_PROTOCOL_PIPE, PredictProtocol.h)
+  stdout "[Predict]" / "[Result]" 문자열 대신 requestId, 시각이 붙은 binary 메시지
+
+  channel = PredictChannel()
+  channel.connect()                          # Project_Kinect(server)가 뜰 때까지 재시도
+  channel.sendHello(labelCount)
+  type, body, extra = channel.receive()     # REQUEST면 body = dict, extra = inline 샘플 (없으면 b'')
+  channel.sendResult(request, scores, receiveTime)
+
+형식은 PredictProtocol.h, 바뀌면 PREDICT_PROTOCOL_VERSION과 같이 수정
+시각은 QueryPerformanceCounter (Project_Kinect와 같은 clock)
+
+--------------------------------------------------- '''
+
+import ctypes
+import struct
+import time
+
+PREDICT_PIPE_NAME = r'\\.\pipe\KSL_Predict'
+PREDICT_PROTOCOL_MAGIC = 0x504C534B
+PREDICT_PROTOCOL_VERSION = 1
+PREDICT_MESSAGE_MAX_BYTES = 16 << 20
+
+PREDICT_MESSAGE_HELLO = 1
+PREDICT_MESSAGE_REQUEST = 2
+PREDICT_MESSAGE_RESULT = 3
+PREDICT_MESSAGE_BYE = 4
+
+# magic version type size reserved
+MESSAGE_HEADER = struct.Struct('<IHHII')
+# role labelCount timerFrequency name[32]
+HELLO = struct.Struct('<IIq32s')
+# requestId captureStart captureEnd segmentTime sendTime ringNumber label sampleSize
+REQUEST = struct.Struct('<QqqqqqiI')
+# requestId sendTime receiveTime doneTime top confidence labelCount reserved
+RESULT = struct.Struct('<QqqqifII')
+
+_kernel32 = ctypes.windll.kernel32
+
+def now():
+    counter = ctypes.c_int64()
+    _kernel32.QueryPerformanceCounter(ctypes.byref(counter))
+    return counter.value
+
+def frequency():
+    value = ctypes.c_int64()
+    _kernel32.QueryPerformanceFrequency(ctypes.byref(value))
+    return value.value
+
+class PredictChannel():
+    '''
+    predictor(client) 쪽 연결 하나, receive는 한 thread에서만
+    '''
+    def __init__(self):
+        self.pipe = None
+
+    def connect(self, timeoutSec=None):
+        '''
+        server가 없거나 다른 client가 붙어 있으면 timeoutSec까지 재시도 (None : 계속)
+        '''
+        start = time.time()
+        while True:
+            try:
+                self.pipe = open(PREDICT_PIPE_NAME, 'r+b', buffering=0)
+                return True
+            except OSError:
+                if timeoutSec is not None and time.time() - start > timeoutSec:
+                    return False
+                time.sleep(0.2)
+
+    def close(self):
+        if self.pipe is not None:
+            try:
+                self.send(PREDICT_MESSAGE_BYE, b'')
+            except OSError:
+                pass
+            self.pipe.close()
+            self.pipe = None
+
+    def isConnected(self):
+        return self.pipe is not None
+
+    def send(self, type, body, extra=b''):
+        header = MESSAGE_HEADER.pack(PREDICT_PROTOCOL_MAGIC, PREDICT_PROTOCOL_VERSION, type, len(body) + len(extra), 0)
+        self.pipe.write(header + body + extra)
+
+    def sendHello(self, labelCount):
+        self.send(PREDICT_MESSAGE_HELLO, HELLO.pack(1, labelCount, frequency(), b'do_Predict'))
+
+    def sendResult(self, request, scores, receiveTime):
+        '''
+        request : receive()의 REQUEST dict, scores : label별 확률 (list / np.array)
+        top이 -1이면 실패 (scores는 비워도 됨)
+        '''
+        scores = [float(score) for score in scores]
+        top = max(range(len(scores)), key=lambda i: scores[i]) if scores else -1
+        confidence = scores[top] if top >= 0 else 0.0
+
+        body = RESULT.pack(request['requestId'], request['sendTime'], receiveTime, now(), top, confidence, len(scores), 0)
+        self.send(PREDICT_MESSAGE_RESULT, body, struct.pack('<%df' % len(scores), *scores))
+
+    def _readExact(self, size):
+        data = b''
+        while len(data) < size:
+            chunk = self.pipe.read(size - len(data))
+            if not chunk:
+                raise EOFError('predict pipe closed')
+            data += chunk
+        return data
+
+    def receive(self):
+        '''
+        return type, body, extra
+          HELLO   : dict(role, labelCount, timerFrequency, name), b''
+          REQUEST : dict(PredictRequest 필드), inline 샘플 바이트 (ringNumber >= 0 이면 b'')
+          BYE     : None, b''
+        끊기면 EOFError, 형식이 다르면 ValueError
+        '''
+        magic, version, type, size, _ = MESSAGE_HEADER.unpack(self._readExact(MESSAGE_HEADER.size))
+        if magic != PREDICT_PROTOCOL_MAGIC or version != PREDICT_PROTOCOL_VERSION or size > PREDICT_MESSAGE_MAX_BYTES:
+            raise ValueError('predict protocol mismatch (magic %x, version %d)' % (magic, version))
+
+        data = self._readExact(size)
+
+        if type == PREDICT_MESSAGE_HELLO and size >= HELLO.size:
+            role, labelCount, timerFrequency, name = HELLO.unpack_from(data, 0)
+            return type, {'role': role, 'labelCount': labelCount, 'timerFrequency': timerFrequency,
+                          'name': name.split(b'\0', 1)[0].decode('ascii', 'replace')}, b''
+
+        if type == PREDICT_MESSAGE_REQUEST and size >= REQUEST.size:
+            fields = REQUEST.unpack_from(data, 0)
+            keys = ('requestId', 'captureStart', 'captureEnd', 'segmentTime', 'sendTime', 'ringNumber', 'label', 'sampleSize')
+            return type, dict(zip(keys, fields)), data[REQUEST.size:]
+
+        return type, None, b''
@@ -0,0 +1,149 @@
+''' ---------------------------------------------------
+
+# Sample Reader:
+  Project_Reader dll (C++, kslReader.h)로 sample.ksl, shard 읽기
+  파일 매핑 + batch 조립 + prefetch는 dll 쪽 thread에서 처리
+
+  reader = SampleReader(Path.get('train'))
+  gen = reader.generator(batchSize=8, onlyImage=True)  # generator_multiple 대신
+
+--------------------------------------------------- '''
+
+import os
+import ctypes
+import numpy as np
+import defines
+
+DLL_PATH = os.path.join(os.path.dirname(os.path.realpath(__file__)),
+    '..', '..', 'Project_Reader', 'program', 'Project_Reader_x64_Release.dll')
+KSL_READER_VERSION = 1
+SPOINT_WIDTH = 74 # SampleFormat.h SAMPLE_SPOINT_WIDTH
+
+_float_p = ctypes.POINTER(ctypes.c_float)
+_int32_p = ctypes.POINTER(ctypes.c_int32)
+_int64_p = ctypes.POINTER(ctypes.c_int64)
+
+def _loadDll(path):
+    dll = ctypes.CDLL(path)
+
+    dll.ksl_version.restype = ctypes.c_int
+    dll.ksl_open.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+    dll.ksl_open.restype = ctypes.c_void_p
+    dll.ksl_close.argtypes = [ctypes.c_void_p]
+    dll.ksl_close.restype = None
+    dll.ksl_size.argtypes = [ctypes.c_void_p]
+    dll.ksl_size.restype = ctypes.c_int64
+    dll.ksl_labels.argtypes = [ctypes.c_void_p, _int32_p, ctypes.c_int64]
+    dll.ksl_labels.restype = ctypes.c_int64
+    dll.ksl_read_batch.argtypes = [ctypes.c_void_p, _int64_p, ctypes.c_int, _float_p, ctypes.c_void_p, _int32_p]
+    dll.ksl_read_batch.restype = ctypes.c_int
+    dll.ksl_prefetch_start.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_uint32]
+    dll.ksl_prefetch_start.restype = ctypes.c_int
+    dll.ksl_prefetch_next.argtypes = [ctypes.c_void_p, ctypes.POINTER(_float_p), ctypes.POINTER(ctypes.c_void_p),
+        ctypes.POINTER(_int32_p), ctypes.POINTER(ctypes.c_int)]
+    dll.ksl_prefetch_next.restype = ctypes.c_int
+    dll.ksl_last_error.restype = ctypes.c_char_p
+
+    if dll.ksl_version() != KSL_READER_VERSION:
+        raise RuntimeError('Project_Reader version mismatch: {0}'.format(dll.ksl_version()))
+
+    return dll
+
+class SampleReader():
+    '''
+    root 아래 모든 sample.ksl, data/shards/*.idx (temp 제외)
+
+    spoints : float32 (n, frameSize, 74, 1)
+    images  : uint8 / float32 (n, imageFrameSize, imageScale, 2 * imageScale, 1)  ROI_loadData와 같은 배치
+    labels  : onehot (n, LABEL_SIZE), 읽기 실패한 샘플은 0 벡터
+    '''
+    def __init__(self, root, imageSize=None, imageFloat=True, dllPath=DLL_PATH,
+        frameSize=defines.FRAME_STANDARD_SIZE, imageFrameSize=defines.IMAGE_STANDARD_FRAME_SIZE):
+        self._dll = _loadDll(dllPath)
+        self.frameSize = frameSize
+        self.imageFrameSize = imageFrameSize
+        self.imageScale = defines.IMAGE_WIDTH if imageSize is None else imageSize[0]
+        self.imageType = np.float32 if imageFloat else np.uint8
+
+        self._handle = self._dll.ksl_open(root.encode('mbcs' if os.name == 'nt' else 'utf-8'),
+            frameSize, imageFrameSize, self.imageScale, 1 if imageFloat else 0)
+        if not self._handle:
+            raise IOError(self._lastError())
+
+    def __len__(self):
+        return self._dll.ksl_size(self._handle)
+
+    def __del__(self):
+        self.close()
+
+    def close(self):
+        if getattr(self, '_handle', None):
+            self._dll.ksl_close(self._handle)
+            self._handle = None
+
+    def labels(self):
+        result = np.zeros(len(self), dtype=np.int32)
+        self._dll.ksl_labels(self._handle, result.ctypes.data_as(_int32_p), len(result))
+        return result
+
+    def readBatch(self, indices):
+        '''
+        indices 순서대로 읽기 (dll 안에서 샘플 단위 병렬)
+        '''
+        indices = np.ascontiguousarray(indices, dtype=np.int64)
+        n = len(indices)
+        spoints, images, labels = self._allocate(n)
+
+        self._dll.ksl_read_batch(self._handle, indices.ctypes.data_as(_int64_p), n,
+            spoints.ctypes.data_as(_float_p), images.ctypes.data_as(ctypes.c_void_p), labels.ctypes.data_as(_int32_p))
+
+        return spoints[..., None], images[..., None], self._onehot(labels)
+
+    def generator(self, batchSize, shuffle=True, seed=0, depth=4, onlyImage=False):
+        '''
+        generator_multiple 대체 (random_transform 없음)
+          depth : dll이 미리 채워두는 batch 수
+        yield (images, onehot) 또는 ([spoints, images], onehot)
+        '''
+        if not self._dll.ksl_prefetch_start(self._handle, batchSize, depth, 1 if shuffle else 0, seed):
+            raise RuntimeError(self._lastError())
+
+        spointShape = (batchSize, self.frameSize, SPOINT_WIDTH, 1)
+        imageShape = (batchSize, self.imageFrameSize, self.imageScale, 2 * self.imageScale, 1)
+
+        while True:
+            spointPtr = _float_p()
+            imagePtr = ctypes.c_void_p()
+            labelPtr = _int32_p()
+            epoch = ctypes.c_int()
+
+            count = self._dll.ksl_prefetch_next(self._handle, ctypes.byref(spointPtr), ctypes.byref(imagePtr),
+                ctypes.byref(labelPtr), ctypes.byref(epoch))
+            if count != batchSize:
+                raise RuntimeError(self._lastError())
+
+            # dll buffer는 다음 호출 때 재사용 : keras queue에 넘기기 전에 복사
+            images = np.ctypeslib.as_array(ctypes.cast(imagePtr, ctypes.POINTER(
+                ctypes.c_float if self.imageType == np.float32 else ctypes.c_uint8)), shape=imageShape).copy()
+            labels = self._onehot(np.ctypeslib.as_array(labelPtr, shape=(batchSize,)))
+
+            if onlyImage:
+                yield images, labels
+            else:
+                spoints = np.ctypeslib.as_array(spointPtr, shape=spointShape).copy()
+                yield [spoints, images], labels
+
+    def _allocate(self, n):
+        spoints = np.zeros((n, self.frameSize, SPOINT_WIDTH), dtype=np.float32)
+        images = np.zeros((n, self.imageFrameSize, self.imageScale, 2 * self.imageScale), dtype=self.imageType)
+        labels = np.zeros(n, dtype=np.int32)
+        return spoints, images, labels
+
+    def _onehot(self, labels):
+        result = np.zeros((len(labels), defines.LABEL_SIZE), dtype=np.float32)
+        valid = (labels >= 0) & (labels < defines.LABEL_SIZE)
+        result[np.nonzero(valid)[0], labels[valid]] = 1
+        return result
+
+    def _lastError(self):
+        return self._dll.ksl_last_error().decode('ascii', 'ignore')
@@ -0,0 +1,175 @@
+''' ---------------------------------------------------
+
+# Sample Ring:
+  predict 샘플 shared memory ring 수신 (PREDICT_HANDOFF_RING, SampleRing.h)
+  data/temp 파일 + stdout "[Predict]" 대신 Project_Kinect가 slot에 쓴 sample.ksl 바이트를 바로 읽는다
+
+  ring = SampleRing()
+  data, info = ring.wait(1000)      # 없으면 None, None
+  spoint, images, label = DFormat.ROI_loadSampleBytes(data, False)
+  data, info = ring.readNumber(n)   # PREDICT_PROTOCOL_PIPE : REQUEST가 가리키는 샘플
+
+형식은 SampleFormat.h (SampleRingHeader, SampleRingSlot), 바뀌면 같이 수정
+consumer는 하나 (event가 auto-reset)
+
+--------------------------------------------------- '''
+
+import ctypes
+import mmap
+import struct
+
+SAMPLE_RING_NAME = 'Local\\KSL_SampleRing'
+SAMPLE_RING_EVENT_NAME = 'Local\\KSL_SampleRing_Ready'
+SAMPLE_RING_MAGIC = 0x524C534B
+SAMPLE_RING_VERSION = 1
+SAMPLE_RING_SLOT_COUNT = 4
+SAMPLE_RING_SLOT_BYTES = 4 << 20
+
+# magic version slotCount slotHeaderSize slotBytes timerFrequency writeSeq readSeq reserved[2]
+RING_HEADER = struct.Struct('<IIIIQqqq16x')
+RING_WRITE_SEQ_OFFSET = 32
+RING_READ_SEQ_OFFSET = 40
+# seq number size publishTime label reserved reserved2[3]
+RING_SLOT = struct.Struct('<qqQqiI24x')
+RING_MAPPING_SIZE = RING_HEADER.size + SAMPLE_RING_SLOT_COUNT * (RING_SLOT.size + SAMPLE_RING_SLOT_BYTES)
+
+READ_RETRY = 8
+
+_kernel32 = ctypes.windll.kernel32
+_kernel32.CreateEventW.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_wchar_p]
+_kernel32.CreateEventW.restype = ctypes.c_void_p
+_kernel32.WaitForSingleObject.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+_kernel32.WaitForSingleObject.restype = ctypes.c_uint32
+_kernel32.CloseHandle.argtypes = [ctypes.c_void_p]
+
+def _now():
+    counter = ctypes.c_int64()
+    _kernel32.QueryPerformanceCounter(ctypes.byref(counter))
+    return counter.value
+
+class SampleRing():
+    '''
+    Project_Kinect보다 먼저 열어도 된다 (같은 이름으로 만들거나 연다)
+    producer가 header를 채우기 전에는 샘플 없음
+    '''
+    def __init__(self):
+        self.mm = mmap.mmap(-1, RING_MAPPING_SIZE, tagname=SAMPLE_RING_NAME)
+        self.event = _kernel32.CreateEventW(None, 0, 0, SAMPLE_RING_EVENT_NAME)
+        if not self.event:
+            raise OSError('CreateEvent fail: ' + SAMPLE_RING_EVENT_NAME)
+
+        self.skipped = 0
+        # 이미 발행된 샘플은 지난 것, 다음 샘플부터
+        self.readSeq = self._writeSeq() if self._isValid() else 0
+
+    def close(self):
+        if self.event:
+            _kernel32.CloseHandle(self.event)
+            self.event = None
+        self.mm.close()
+
+    def _isValid(self):
+        magic, version, slotCount, slotHeaderSize, slotBytes, _, _, _ = RING_HEADER.unpack_from(self.mm, 0)
+        return magic == SAMPLE_RING_MAGIC and version == SAMPLE_RING_VERSION and \
+            slotCount == SAMPLE_RING_SLOT_COUNT and slotHeaderSize == RING_SLOT.size and \
+            slotBytes == SAMPLE_RING_SLOT_BYTES
+
+    def _writeSeq(self):
+        return struct.unpack_from('<q', self.mm, RING_WRITE_SEQ_OFFSET)[0]
+
+    def _slotOffset(self, number):
+        return RING_HEADER.size + (number % SAMPLE_RING_SLOT_COUNT) * (RING_SLOT.size + SAMPLE_RING_SLOT_BYTES)
+
+    def read(self):
+        '''
+        새 샘플이 있으면 가장 최신 것 (밀린 샘플은 건너뜀)
+
+        return data(bytes, sample.ksl), info(dict) / 없으면 None, None
+        '''
+        if not self._isValid():
+            return None, None
+
+        for _ in range(READ_RETRY):
+            writeSeq = self._writeSeq()
+
+            # producer가 재시작해서 번호가 줄었으면 처음부터
+            if writeSeq < self.readSeq:
+                self.readSeq = 0
+            if writeSeq == self.readSeq:
+                return None, None
+
+            number = writeSeq - 1
+            offset = self._slotOffset(number)
+
+            before, slotNumber, size, publishTime, label, _ = RING_SLOT.unpack_from(self.mm, offset)
+            if before & 1 or slotNumber != number or size > SAMPLE_RING_SLOT_BYTES:
+                continue
+
+            start = offset + RING_SLOT.size
+            data = self.mm[start:start + size]
+
+            # 복사 중에 덮어썼으면 다시
+            if struct.unpack_from('<q', self.mm, offset)[0] != before:
+                continue
+
+            self.skipped += number - self.readSeq
+            self.readSeq = number + 1
+            struct.pack_into('<q', self.mm, RING_READ_SEQ_OFFSET, self.readSeq)
+
+            frequency = RING_HEADER.unpack_from(self.mm, 0)[5]
+            info = {
+                'number': number,
+                'label': label,
+                'size': size,
+                'latency': (_now() - publishTime) * 1000.0 / frequency if frequency else 0.0, # ms
+            }
+            return data, info
+
+        return None, None
+
+    def readNumber(self, number):
+        '''
+        번호 지정 (PREDICT_PROTOCOL_PIPE REQUEST의 ringNumber), readSeq는 그대로
+
+        return data(bytes, sample.ksl), info(dict) / 이미 덮어써졌거나 형식이 다르면 None, None
+        '''
+        if not self._isValid() or number < 0 or number >= self._writeSeq():
+            return None, None
+
+        offset = self._slotOffset(number)
+
+        for _ in range(READ_RETRY):
+            before, slotNumber, size, publishTime, label, _ = RING_SLOT.unpack_from(self.mm, offset)
+            if before & 1:
+                continue
+            if slotNumber != number or size > SAMPLE_RING_SLOT_BYTES:
+                return None, None
+
+            start = offset + RING_SLOT.size
+            data = self.mm[start:start + size]
+
+            if struct.unpack_from('<q', self.mm, offset)[0] != before:
+                continue
+
+            frequency = RING_HEADER.unpack_from(self.mm, 0)[5]
+            info = {
+                'number': number,
+                'label': label,
+                'size': size,
+                'latency': (_now() - publishTime) * 1000.0 / frequency if frequency else 0.0, # ms
+            }
+            return data, info
+
+        return None, None
+
+    def wait(self, timeoutMs):
+        '''
+        새 샘플이 올 때까지 최대 timeoutMs 대기, read()와 같은 반환
+        '''
+        data, info = self.read()
+        if data is not None:
+            return data, info
+
+        _kernel32.WaitForSingleObject(self.event, timeoutMs)
+
+        return self.read()
@@ -0,0 +1,260 @@
+#include "BatchPredictServer.h"
+
+#include <algorithm>
+
+namespace
+{
+	double elapsedMs(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end = chrono::steady_clock::now())
+	{
+		return chrono::duration<double, milli>(end - start).count();
+	}
+}
+
+BatchPredictServer::BatchPredictServer(const string& path, int maxBatch, double maxWaitMs)
+{
+	model.load(path);
+
+	this->maxBatch = max(maxBatch, 1);
+	this->maxWait = chrono::microseconds((long long)(max(maxWaitMs, 0.0) * 1000));
+
+	worker = thread(&BatchPredictServer::run, this);
+}
+
+BatchPredictServer::~BatchPredictServer()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_all();
+
+	if (worker.joinable()) worker.join();
+
+	for (Request& request : requests) request.result.set_value(Recognition());
+	requests.clear();
+
+	if (batchCount > 0)
+	{
+		cout << "BatchPredictServer ... " << requestCount << " request, " << batchCount << " batch (mean " << getMeanBatch() << ", max " << batchMax << ")"
+			<< ", wait " << getMeanWait() << "ms, infer " << getMeanInfer() << "ms/batch" << endl;
+	}
+}
+
+bool BatchPredictServer::isReady()
+{
+	return model.isLoaded() && model.getBranchCount() == 2;
+}
+
+string BatchPredictServer::getName()
+{
+	return "batch " + model.getName();
+}
+
+InferenceModel& BatchPredictServer::getModel()
+{
+	return model;
+}
+
+future<Recognition> BatchPredictServer::submit(Sample& sample)
+{
+	return submitWith([&](vector<vector<float>>& inputs) { return ModelRecognizer::prepare(model, sample, inputs[0], inputs[1]); });
+}
+
+future<Recognition> BatchPredictServer::submit(SampleFile& sample)
+{
+	return submitWith([&](vector<vector<float>>& inputs) { return ModelRecognizer::prepare(model, sample, inputs[0], inputs[1]); });
+}
+
+void BatchPredictServer::beginPrepare()
+{
+	lock_guard<mutex> guard(lock);
+	++preparing;
+}
+
+future<Recognition> BatchPredictServer::endPrepare(vector<vector<float>>&& inputs, double prepareMs, bool prepared)
+{
+	bool valid = prepared && (int)inputs.size() == model.getBranchCount();
+	for (int b = 0; valid && b < model.getBranchCount(); ++b) valid = inputs[b].size() == model.getInputSize(b);
+
+	Request request;
+	request.inputs = move(inputs);
+	request.pushTime = chrono::steady_clock::now();
+	request.prepareMs = prepareMs;
+	future<Recognition> result = request.result.get_future();
+
+	{
+		lock_guard<mutex> guard(lock);
+		--preparing;
+		if (valid && running) requests.push_back(move(request));
+		else valid = false;
+	}
+	wake.notify_one(); // 실패해도 : 이 준비를 기다리던 worker가 있을 수 있음
+
+	return valid ? move(result) : failed();
+}
+
+future<Recognition> BatchPredictServer::failed()
+{
+	promise<Recognition> result;
+	result.set_value(Recognition());
+	return result.get_future();
+}
+
+int BatchPredictServer::getMaxBatch()
+{
+	return maxBatch;
+}
+
+double BatchPredictServer::getMaxWaitMs()
+{
+	return maxWait.count() / 1000.0;
+}
+
+int BatchPredictServer::getRequests()
+{
+	lock_guard<mutex> guard(lock);
+	return requestCount;
+}
+
+int BatchPredictServer::getBatches()
+{
+	lock_guard<mutex> guard(lock);
+	return batchCount;
+}
+
+int BatchPredictServer::getLargestBatch()
+{
+	lock_guard<mutex> guard(lock);
+	return batchMax;
+}
+
+double BatchPredictServer::getMeanBatch()
+{
+	lock_guard<mutex> guard(lock);
+	return batchCount > 0 ? (double)requestCount / batchCount : 0;
+}
+
+double BatchPredictServer::getMeanWait()
+{
+	lock_guard<mutex> guard(lock);
+	return requestCount > 0 ? waitSum / requestCount : 0;
+}
+
+double BatchPredictServer::getMeanInfer()
+{
+	lock_guard<mutex> guard(lock);
+	return batchCount > 0 ? inferSum / batchCount : 0;
+}
+
+shared_ptr<BatchPredictServer> BatchPredictServer::shared()
+{
+	static mutex sharedLock;
+	static weak_ptr<BatchPredictServer> instance;
+
+	lock_guard<mutex> guard(sharedLock);
+
+	shared_ptr<BatchPredictServer> server = instance.lock();
+	if (!server)
+	{
+		server = make_shared<BatchPredictServer>();
+		instance = server;
+	}
+	return server;
+}
+
+void BatchPredictServer::run()
+{
+	while (true)
+	{
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !requests.empty() || !running; });
+			if (!running) return;
+
+			// 다른 producer가 입력을 준비 중일 때만, 가장 오래 기다린 요청 기준으로 maxWait까지 더 모은다
+			wake.wait_until(guard, requests.front().pushTime + maxWait, [&] { return (int)requests.size() >= maxBatch || preparing == 0 || !running; });
+			if (!running) return;
+
+			auto now = chrono::steady_clock::now();
+			int size = min((int)requests.size(), maxBatch);
+
+			batch.clear();
+			for (int i = 0; i < size; ++i)
+			{
+				waitSum += elapsedMs(requests.front().pushTime, now);
+				batch.push_back(move(requests.front()));
+				requests.pop_front();
+			}
+		}
+
+		infer();
+	}
+}
+
+void BatchPredictServer::infer()
+{
+	int size = (int)batch.size();
+	int labelCount = model.getLabelCount();
+	auto start = chrono::steady_clock::now();
+
+	// branch마다 요청 입력을 이어 붙임
+	packed.resize(model.getBranchCount());
+	vector<const float*> inputs;
+	for (int b = 0; b < model.getBranchCount(); ++b)
+	{
+		size_t inputSize = model.getInputSize(b);
+		packed[b].resize(inputSize * size);
+		for (int i = 0; i < size; ++i) copy(batch[i].inputs[b].begin(), batch[i].inputs[b].end(), packed[b].begin() + i * inputSize);
+		inputs.push_back(packed[b].data());
+	}
+
+	bool done = model.forward(inputs, size, scores);
+	double inferMs = elapsedMs(start);
+
+	for (int i = 0; i < size; ++i)
+	{
+		Recognition recognition;
+		if (done)
+		{
+			recognition.scores.assign(scores.begin() + i * labelCount, scores.begin() + (i + 1) * labelCount);
+			recognition.top = (int)(max_element(recognition.scores.begin(), recognition.scores.end()) - recognition.scores.begin());
+			recognition.confidence = recognition.scores[recognition.top];
+		}
+		recognition.prepareMs = batch[i].prepareMs;
+		recognition.inferMs = elapsedMs(batch[i].pushTime); // batch 대기 포함
+
+		batch[i].result.set_value(move(recognition));
+	}
+	batch.clear();
+
+	lock_guard<mutex> guard(lock);
+	requestCount += size;
+	++batchCount;
+	batchMax = max(batchMax, size);
+	inferSum += inferMs;
+}
+
+//----------------------------------------------------------------------------------
+/// BatchRecognizer
+//----------------------------------------------------------------------------------
+
+BatchRecognizer::BatchRecognizer()
+	: server(BatchPredictServer::shared())
+{
+}
+
+string BatchRecognizer::getName()
+{
+	return server->getName();
+}
+
+bool BatchRecognizer::isReady()
+{
+	return server->isReady();
+}
+
+bool BatchRecognizer::recognize(Sample& sample, Recognition& result)
+{
+	result = server->submit(sample).get();
+	return result.top >= 0;
+}
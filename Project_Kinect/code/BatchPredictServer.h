@@ -0,0 +1,135 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "InferenceModel.h"
+#include "Recognizer.h"
+
+// 여러 producer의 predict 요청을 모아 InferenceModel batch 하나로
+//   process 안 : PredictQueue마다 BatchRecognizer (PREDICT_BACKEND_BATCH)
+//   station 여러 대 : Project_Tools predict-host가 station마다 pipe (PredictProtocol.h)로 요청을 받아 submit
+//
+// 입력 텐서 준비는 submit한 thread에서 (ModelRecognizer::prepare), worker thread는 모아서 forward만 한다.
+// 다른 producer가 입력을 준비 중이면 가장 오래 기다린 요청이 maxWaitMs를 넘거나 maxBatch개가 모일 때까지 기다리고,
+// 준비 중인 producer가 없으면 기다리지 않고 바로 (producer가 하나면 batch 1, 지연 추가 없음).
+// forward 중에 들어온 요청은 다음 batch로 모인다.
+// branch마다 [batch][입력]으로 이어 붙여 forward 한 번, 결과는 요청마다 future로.
+// batch 1 forward의 call 당 비용 (kernel 가중치 읽기, LSTM step 반복)을 여러 요청이 나눠 낸다.
+class BatchPredictServer
+{
+private:
+	struct Request
+	{
+		vector<vector<float>> inputs; // branch마다 getInputSize개
+		promise<Recognition> result;
+		chrono::steady_clock::time_point pushTime;
+		double prepareMs = 0;
+	};
+
+	InferenceModel model;
+	int maxBatch;
+	chrono::microseconds maxWait;
+	thread worker;
+
+	mutex lock;
+	condition_variable wake;
+	deque<Request> requests;
+	int preparing = 0; // 입력 준비 중인 submit 수
+	bool running = true;
+
+	// worker thread
+	vector<Request> batch;
+	vector<vector<float>> packed; // branch마다 [batch][입력]
+	vector<float> scores;
+
+	// lock
+	int requestCount = 0;
+	int batchCount = 0;
+	int batchMax = 0;
+	double waitSum = 0; // submit ~ batch 시작, ms
+	double inferSum = 0; // batch forward, ms
+
+public:
+	BatchPredictServer(const string& path = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME,
+		int maxBatch = PREDICT_BATCH_MAX, double maxWaitMs = PREDICT_BATCH_WAIT_MS);
+
+	// 남은 요청은 실패 (top -1)로 끝낸다
+	~BatchPredictServer();
+
+	bool isReady();
+	string getName();
+	InferenceModel& getModel();
+
+	// 입력 준비 후 큐에, 준비 실패면 바로 top -1
+	future<Recognition> submit(Sample& sample);
+
+	// 저장 / 전송된 sample.ksl (predict-host)
+	future<Recognition> submit(SampleFile& sample);
+
+	// prepare(inputs) : branch마다 getInputSize개를 채우고 true, 준비하는 동안 worker는 batch를 더 기다린다
+	template <class F>
+	future<Recognition> submitWith(F prepare)
+	{
+		if (!isReady()) return failed();
+
+		beginPrepare();
+		auto start = chrono::steady_clock::now();
+
+		vector<vector<float>> inputs(model.getBranchCount());
+		bool prepared = prepare(inputs);
+
+		return endPrepare(move(inputs), chrono::duration<double, milli>(chrono::steady_clock::now() - start).count(), prepared);
+	}
+
+	int getMaxBatch();
+	double getMaxWaitMs();
+
+	int getRequests();
+	int getBatches();
+	int getLargestBatch();
+	double getMeanBatch();
+	double getMeanWait();
+	double getMeanInfer(); // batch 하나
+
+	// PREDICT_BACKEND_BATCH : process 안 PredictQueue들이 같이 쓰는 server (처음 부를 때 model load)
+	// Project_Kinect는 PredictQueue가 하나라 batch는 늘 1 : 여러 station은 predict-host
+	static shared_ptr<BatchPredictServer> shared();
+
+private:
+	void beginPrepare();
+
+	// preparing을 줄이고 큐에, prepared가 false거나 입력 크기가 다르면 top -1
+	future<Recognition> endPrepare(vector<vector<float>>&& inputs, double prepareMs, bool prepared);
+
+	static future<Recognition> failed();
+
+	void run();
+	void infer();
+};
+
+// PREDICT_BACKEND_BATCH : ModelRecognizer와 같은 결과, 추론은 BatchPredictServer::shared()에 맡기고 기다린다
+class BatchRecognizer : public Recognizer
+{
+private:
+	shared_ptr<BatchPredictServer> server;
+
+public:
+	BatchRecognizer();
+
+	string getName() override;
+
+	bool isReady() override;
+
+	bool recognize(Sample& sample, Recognition& result) override;
+};
@@ -0,0 +1,394 @@
+#include "DepthCodec.h"
+
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cmath>
+
+namespace
+{
+	const uint32_t RVL_MAGIC = 0x3052444B; // "KDR0"
+
+	struct DepthHeader
+	{
+		uint32_t magic;
+		uint16_t width;
+		uint16_t height;
+		uint32_t words; // 뒤따르는 uint32 개수
+	};
+
+	// 값 -> nibble 묶음 (12bit 미만, 4 nibble 이하) : zigzag 차이는 거의 다 여기 걸림
+	// entry 하나에 code (상위, 먼저 나갈 nibble이 상위) + bit 수 (하위 8bit) : pixel당 load 1번
+	const int CODE_TABLE_SIZE = 1 << 12;
+
+	struct CodeTable
+	{
+		uint32_t entry[CODE_TABLE_SIZE];
+
+		CodeTable()
+		{
+			for (uint32_t v = 0; v < CODE_TABLE_SIZE; ++v)
+			{
+				uint32_t value = v;
+				uint32_t c = 0;
+				int n = 0;
+				do
+				{
+					uint32_t nibble = value & 0x7;
+					value >>= 3;
+					if (value) nibble |= 0x8;
+					c = (c << 4) | nibble;
+					++n;
+				} while (value);
+
+				entry[v] = (c << 8) | (uint32_t)(n * 4);
+			}
+		}
+	};
+
+	const CodeTable& codeTable()
+	{
+		static const CodeTable table;
+		return table;
+	}
+
+	// nibble을 64bit에 모았다가 32bit씩 내보냄
+	// word가 찼는지는 분기 대신 p 증가량으로 : 안 찼으면 같은 자리에 다시 쓰고 다음 put이 덮어씀
+	// (encode buffer에 word 하나 여유가 있어야 함)
+	class NibbleWriter
+	{
+	private:
+		uint32_t* p;
+		uint64_t acc = 0;
+		int bits = 0;
+		const CodeTable& table;
+
+		inline void push(uint32_t code, int n)
+		{
+			acc = (acc << n) | code;
+			bits += n;
+
+			int full = bits >> 5;
+			bits -= full << 5;
+			*p = (uint32_t)(acc >> bits);
+			p += full;
+		}
+
+	public:
+		NibbleWriter(uint32_t* out) : p(out), table(codeTable()) {}
+
+		inline void put(uint32_t value)
+		{
+			if (value < CODE_TABLE_SIZE)
+			{
+				uint32_t e = table.entry[value];
+				push(e >> 8, (int)(e & 0xFF));
+				return;
+			}
+
+			do
+			{
+				uint32_t nibble = value & 0x7;
+				value >>= 3;
+				if (value) nibble |= 0x8;
+
+				push(nibble, 4);
+			} while (value);
+		}
+
+		// 두 값을 한 번에 (둘 다 코드표 안이면 합쳐도 32bit 이하 : acc 의존 사슬이 절반)
+		inline void put2(uint32_t first, uint32_t second)
+		{
+			if ((first | second) < CODE_TABLE_SIZE)
+			{
+				uint32_t a = table.entry[first];
+				uint32_t b = table.entry[second];
+				int n = (int)(b & 0xFF);
+				push(((a >> 8) << n) | (b >> 8), (int)(a & 0xFF) + n);
+				return;
+			}
+
+			put(first);
+			put(second);
+		}
+
+		uint32_t* flush()
+		{
+			if (bits > 0) *p++ = (uint32_t)(acc << (32 - bits));
+			acc = 0;
+			bits = 0;
+
+			return p;
+		}
+	};
+
+	// p부터 0이 아닌 pixel 연속 개수 : 4 pixel(64bit)씩 0 lane 검사, 0이 보이면 1개씩
+	inline uint32_t countNonzeros(const uint16_t* p, const uint16_t* end)
+	{
+		const uint16_t* q = p;
+		while (end - q >= 4)
+		{
+			uint64_t x;
+			memcpy(&x, q, sizeof(x));
+			if ((x - 0x0001000100010001ull) & ~x & 0x8000800080008000ull) break;
+			q += 4;
+		}
+		while (q != end && *q != 0) ++q;
+
+		return (uint32_t)(q - p);
+	}
+
+	class NibbleReader
+	{
+	private:
+		const uint32_t* p;
+		const uint32_t* end;
+		uint32_t word = 0;
+		int nibbles = 0;
+		bool overrun = false;
+
+	public:
+		NibbleReader(const uint32_t* data, size_t words) : p(data), end(data + words) {}
+
+		inline uint32_t get()
+		{
+			uint32_t value = 0;
+			int shift = 0;
+			uint32_t nibble;
+
+			do
+			{
+				if (nibbles == 0)
+				{
+					if (p == end)
+					{
+						overrun = true;
+						return 0;
+					}
+					word = *p++;
+					nibbles = 8;
+				}
+
+				nibble = word >> 28;
+				word <<= 4;
+				--nibbles;
+
+				value |= (nibble & 0x7) << shift;
+				shift += 3;
+			} while ((nibble & 0x8) && shift < 32);
+
+			return value;
+		}
+
+		bool isOverrun()
+		{
+			return overrun;
+		}
+	};
+
+	double elapsedMs(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+bool DepthCodec::encode(const uint16_t* depth, int width, int height, vector<uint8_t>& out)
+{
+	if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) return false;
+
+	size_t count = (size_t)width * height;
+
+	// 최악 : 0과 번갈아 나올 때 pixel마다 run 2개 + 값 6 nibble -> 4 byte
+	out.resize(sizeof(DepthHeader) + count * 4 + 16);
+	uint32_t* words = reinterpret_cast<uint32_t*>(out.data() + sizeof(DepthHeader));
+
+	NibbleWriter writer(words);
+	const uint16_t* p = depth;
+	const uint16_t* end = depth + count;
+	int previous = 0;
+
+	while (p != end)
+	{
+		uint32_t zeros = 0;
+		while (p != end && *p == 0)
+		{
+			++p;
+			++zeros;
+		}
+		writer.put(zeros);
+
+		uint32_t nonzeros = countNonzeros(p, end);
+		writer.put(nonzeros);
+
+		// zigzag (음수 shift 없이 unsigned로)
+		uint32_t i = 0;
+		for (; i + 2 <= nonzeros; i += 2)
+		{
+			int delta0 = p[0] - previous;
+			int delta1 = p[1] - p[0];
+			previous = p[1];
+			p += 2;
+			writer.put2(((uint32_t)delta0 << 1) ^ (delta0 < 0 ? 0xFFFFFFFFu : 0u), ((uint32_t)delta1 << 1) ^ (delta1 < 0 ? 0xFFFFFFFFu : 0u));
+		}
+		if (i < nonzeros)
+		{
+			int delta = *p - previous;
+			previous = *p++;
+			writer.put(((uint32_t)delta << 1) ^ (delta < 0 ? 0xFFFFFFFFu : 0u));
+		}
+	}
+
+	uint32_t* last = writer.flush();
+
+	DepthHeader header = { RVL_MAGIC, (uint16_t)width, (uint16_t)height, (uint32_t)(last - words) };
+	memcpy(out.data(), &header, sizeof(header));
+	out.resize(sizeof(DepthHeader) + header.words * sizeof(uint32_t));
+
+	return true;
+}
+
+bool DepthCodec::decode(const uint8_t* data, size_t size, uint16_t* depth, int width, int height)
+{
+	DepthHeader header;
+	if (data == nullptr || size < sizeof(header)) return false;
+
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != RVL_MAGIC || header.width != width || header.height != height) return false;
+	if (sizeof(header) + (size_t)header.words * sizeof(uint32_t) > size) return false;
+
+	// mmap 위 payload는 SESSION_ALIGN 정렬이라 uint32 접근 가능
+	NibbleReader reader(reinterpret_cast<const uint32_t*>(data + sizeof(header)), header.words);
+	uint16_t* p = depth;
+	uint16_t* end = depth + (size_t)width * height;
+	int previous = 0;
+
+	while (p != end)
+	{
+		uint32_t zeros = reader.get();
+		if (zeros > (uint32_t)(end - p)) return false;
+
+		memset(p, 0, zeros * sizeof(uint16_t));
+		p += zeros;
+
+		uint32_t nonzeros = reader.get();
+		if (nonzeros > (uint32_t)(end - p) || reader.isOverrun()) return false;
+
+		for (uint32_t i = 0; i < nonzeros; ++i)
+		{
+			uint32_t u = reader.get();
+			int delta = (int)(u >> 1) ^ -(int)(u & 1);
+			previous += delta;
+			*p++ = (uint16_t)previous;
+		}
+
+		if (reader.isOverrun()) return false;
+	}
+
+	return true;
+}
+
+bool DepthCodec::readSize(const uint8_t* data, size_t size, int& width, int& height)
+{
+	DepthHeader header;
+	if (data == nullptr || size < sizeof(header)) return false;
+
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != RVL_MAGIC) return false;
+
+	width = header.width;
+	height = header.height;
+
+	return true;
+}
+
+DepthCodec::Stats& DepthCodec::Stats::operator+=(const Stats& other)
+{
+	frames += other.frames;
+	rawBytes += other.rawBytes;
+	codedBytes += other.codedBytes;
+	encodeMs += other.encodeMs;
+	decodeMs += other.decodeMs;
+	mismatches += other.mismatches;
+
+	return *this;
+}
+
+bool DepthCodec::roundTrip(const uint16_t* depth, int width, int height, vector<uint8_t>& out, Stats& stats)
+{
+	size_t count = (size_t)width * height;
+	vector<uint16_t> decoded(count);
+
+	auto start = chrono::steady_clock::now();
+	bool result = encode(depth, width, height, out);
+	stats.encodeMs += elapsedMs(start);
+
+	start = chrono::steady_clock::now();
+	result = result && decode(out.data(), out.size(), decoded.data(), width, height);
+	stats.decodeMs += elapsedMs(start);
+
+	result = result && memcmp(depth, decoded.data(), count * sizeof(uint16_t)) == 0;
+
+	++stats.frames;
+	stats.rawBytes += (double)count * sizeof(uint16_t);
+	stats.codedBytes += (double)out.size();
+	if (!result) ++stats.mismatches;
+
+	return result;
+}
+
+DepthCodec::Stats DepthCodec::benchmarkSynthetic(int width, int height, int frameCount)
+{
+	Stats stats;
+	mt19937 random(0);
+	normal_distribution<float> noise(0.0f, 2.0f); // Kinect v2 depth 잡음 수준 (mm)
+	uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	vector<uint16_t> depth((size_t)width * height);
+	vector<uint8_t> coded;
+
+	for (int f = 0; f < frameCount; ++f)
+	{
+		// 사람이 좌우로 조금씩 움직임
+		float cx = width * (0.5f + 0.1f * sin(f * 0.1f));
+		float cy = height * 0.45f;
+		float rx = width * 0.15f;
+		float ry = height * 0.4f;
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				float d = 3000.0f + 2.0f * y; // 기울어진 벽 / 바닥
+				float dx = (x - cx) / rx;
+				float dy = (y - cy) / ry;
+				if (dx * dx + dy * dy < 1.0f) d = 1500.0f + 80.0f * (dx * dx + dy * dy);
+
+				d += noise(random);
+
+				// 가장자리 구멍, 흩어진 측정 실패
+				bool hole = x < width / 32 || uniform(random) < 0.01f;
+				depth[(size_t)y * width + x] = hole ? 0 : (uint16_t)d;
+			}
+		}
+
+		roundTrip(depth.data(), width, height, coded, stats);
+	}
+
+	return stats;
+}
+
+string DepthCodec::toString(const Stats& stats)
+{
+	stringstream ss;
+	int n = stats.frames > 0 ? stats.frames : 1;
+
+	ss << fixed << setprecision(3)
+		<< "frames " << stats.frames
+		<< ", ratio " << (stats.codedBytes > 0 ? stats.rawBytes / stats.codedBytes : 0)
+		<< ", encode " << stats.encodeMs / n << "ms"
+		<< ", decode " << stats.decodeMs / n << "ms"
+		<< ", mismatch " << stats.mismatches;
+
+	return ss.str();
+}
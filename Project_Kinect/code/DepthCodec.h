@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// 16bit depth 프레임 무손실 압축 (session DEPTH chunk, SESSION_CODEC_DEPTH_RVL)
+//
+// RVL (run length + variable length) :
+//   0 (측정 실패) 연속 개수, 0 아닌 값 연속 개수, 그 값들의 직전 유효값 대비 차이(zigzag)를
+//   모두 nibble 단위 가변 길이 (3bit 값 + 1bit 계속)로 기록한다.
+//   사람/벽처럼 매끈한 depth는 차이가 작아 pixel당 1~2 nibble, 구멍은 run 하나로 끝남.
+//   곱셈 없이 pixel당 12bit 미만 값은 4096칸 nibble 코드표(CodeTable) 조회 한 번, 두 pixel씩 묶어 32bit word로 내보냄.
+//   benchmarkSynthetic 512x424 (g++ -O2, 1 core) : encode 0.75~0.95ms, decode 1.3~1.5ms (decode는 nibble 단위라 더 느림)
+//
+// [header][uint32 word...], word 안은 상위 nibble부터
+class DepthCodec
+{
+public:
+	struct Stats
+	{
+		int frames = 0;
+		double rawBytes = 0;
+		double codedBytes = 0;
+		double encodeMs = 0;
+		double decodeMs = 0;
+		int mismatches = 0;
+
+		Stats& operator+=(const Stats& other);
+	};
+
+	static bool encode(const uint16_t* depth, int width, int height, vector<uint8_t>& out);
+
+	// depth : width * height 할당된 buffer
+	static bool decode(const uint8_t* data, size_t size, uint16_t* depth, int width, int height);
+
+	// header만 읽기
+	static bool readSize(const uint8_t* data, size_t size, int& width, int& height);
+
+	// encode -> decode -> 비교, stats 누적 (VERIFY_DEPTH_CODEC, BENCHMARK_DEPTH_CODEC)
+	// out : 압축 결과 (비교가 틀려도 채워짐)
+	static bool roundTrip(const uint16_t* depth, int width, int height, vector<uint8_t>& out, Stats& stats);
+
+	// 합성 depth (벽 + 사람 + 구멍 + 센서 잡음) frameCount장 roundTrip
+	static Stats benchmarkSynthetic(int width, int height, int frameCount);
+
+	static string toString(const Stats& stats);
+};
@@ -0,0 +1,448 @@
+#include "DtwMatcher.h"
+
+#include <ppl.h> // parallel_for, combinable
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+#include "InferenceKernels.h" // isSimd
+
+#ifdef INFERENCE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const float INF = numeric_limits<float>::infinity();
+
+	// 템플릿이 많아도 깨진 파일에서 거대한 할당을 막는 상한
+	const uint32_t DTW_MAX_TEMPLATES = 1 << 20;
+
+	//------------------------------------------------------------------------------
+	// 프레임 벡터 하나 (stride는 8 배수)
+	//------------------------------------------------------------------------------
+
+	float squaredScalar(const float* a, const float* b, int stride)
+	{
+		float sum = 0;
+		for (int i = 0; i < stride; ++i)
+		{
+			float d = a[i] - b[i];
+			sum += d * d;
+		}
+		return sum;
+	}
+
+	// envelope 밖으로 나간 만큼의 제곱합
+	float outsideScalar(const float* q, const float* up, const float* low, int stride)
+	{
+		float sum = 0;
+		for (int i = 0; i < stride; ++i)
+		{
+			float e = q[i] > up[i] ? q[i] - up[i] : (q[i] < low[i] ? low[i] - q[i] : 0.0f);
+			sum += e * e;
+		}
+		return sum;
+	}
+
+#ifdef INFERENCE_AVX2
+	float horizontalSum(__m256 v)
+	{
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+		return _mm_cvtss_f32(s);
+	}
+
+	float squaredAvx2(const float* a, const float* b, int stride)
+	{
+		__m256 acc = _mm256_setzero_ps();
+		for (int i = 0; i < stride; i += 8)
+		{
+			__m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+			acc = _mm256_fmadd_ps(d, d, acc);
+		}
+		return horizontalSum(acc);
+	}
+
+	float outsideAvx2(const float* q, const float* up, const float* low, int stride)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 acc = zero;
+		for (int i = 0; i < stride; i += 8)
+		{
+			__m256 v = _mm256_loadu_ps(q + i);
+			// q > up, q < low 중 하나만 양수
+			__m256 e = _mm256_add_ps(_mm256_max_ps(_mm256_sub_ps(v, _mm256_loadu_ps(up + i)), zero),
+				_mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(low + i), v), zero));
+			acc = _mm256_fmadd_ps(e, e, acc);
+		}
+		return horizontalSum(acc);
+	}
+#endif
+
+	float squared(const float* a, const float* b, int stride, bool simd)
+	{
+#ifdef INFERENCE_AVX2
+		if (simd) return squaredAvx2(a, b, stride);
+#endif
+		return squaredScalar(a, b, stride);
+	}
+
+	float outside(const float* q, const float* up, const float* low, int stride, bool simd)
+	{
+#ifdef INFERENCE_AVX2
+		if (simd) return outsideAvx2(q, up, low, stride);
+#endif
+		return outsideScalar(q, up, low, stride);
+	}
+
+	// 공유 k번째 거리 : 더 작을 때만 갱신
+	void lowerTo(atomic<float>& bound, float value)
+	{
+		float current = bound.load();
+		while (value < current && !bound.compare_exchange_weak(current, value));
+	}
+
+	bool closer(const DtwMatcher::Match& a, const DtwMatcher::Match& b)
+	{
+		return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+	}
+}
+
+DtwMatcher::DtwMatcher(int length, double bandRatio)
+{
+	this->length = max(length, 2);
+	band = max((int)(this->length * bandRatio + 0.5), 1);
+}
+
+bool DtwMatcher::add(int label, const float* frames, int frameSize, int featureSize)
+{
+	if (frameSize <= 0 || featureSize <= 0) return false;
+
+	if (labels.empty())
+	{
+		this->featureSize = featureSize;
+		stride = (featureSize + 7) / 8 * 8;
+	}
+	else if (featureSize != this->featureSize) return false;
+
+	size_t size = (size_t)length * stride;
+	series.resize(series.size() + size, 0.0f);
+	upper.resize(series.size());
+	lower.resize(series.size());
+	labels.push_back(label);
+	frameSizes.push_back((uint32_t)frameSize);
+
+	int index = (int)labels.size() - 1;
+	resample(frames, frameSize, series.data() + index * size);
+	envelope(index);
+
+	return true;
+}
+
+void DtwMatcher::clear()
+{
+	labels.clear();
+	frameSizes.clear();
+	series.clear();
+	upper.clear();
+	lower.clear();
+	featureSize = 0;
+	stride = 0;
+}
+
+bool DtwMatcher::load(const string& path)
+{
+	clear();
+
+	ifstream file(path.c_str(), ios::in | ios::binary);
+	if (!file.is_open())
+	{
+		cout << "DtwMatcher::load cannot open " << path << endl;
+		return false;
+	}
+
+	DtwFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != DTW_FILE_MAGIC || header.version != DTW_FILE_VERSION
+		|| header.templateCount > DTW_MAX_TEMPLATES || header.length < 2 || header.featureSize == 0)
+	{
+		cout << "DtwMatcher::load invalid template file " << path << endl;
+		return false;
+	}
+
+	// 저장된 길이로 (band 비율은 유지)
+	double bandRatio = (double)band / length;
+	length = (int)header.length;
+	band = max((int)(length * bandRatio + 0.5), 1);
+
+	vector<float> frames((size_t)length * header.featureSize);
+
+	for (uint32_t t = 0; t < header.templateCount; ++t)
+	{
+		DtwTemplateHeader item;
+		if (!file.read(reinterpret_cast<char*>(&item), sizeof(item))
+			|| !file.read(reinterpret_cast<char*>(frames.data()), sizeof(float) * frames.size()))
+		{
+			cout << "DtwMatcher::load broken template " << t << " " << path << endl;
+			clear();
+			return false;
+		}
+
+		add(item.label, frames.data(), length, (int)header.featureSize);
+		frameSizes.back() = item.frameSize;
+	}
+
+	cout << "DtwMatcher ... " << labels.size() << " template, label " << getLabelCount() << ", length " << length << ", band " << band << endl;
+
+	return true;
+}
+
+bool DtwMatcher::save(const string& path)
+{
+	ofstream file(path.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file.is_open()) return false;
+
+	DtwFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = DTW_FILE_MAGIC;
+	header.version = DTW_FILE_VERSION;
+	header.templateCount = (uint32_t)labels.size();
+	header.length = (uint32_t)length;
+	header.featureSize = (uint32_t)featureSize;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (size_t t = 0; t < labels.size(); ++t)
+	{
+		DtwTemplateHeader item = { labels[t], frameSizes[t] };
+		file.write(reinterpret_cast<const char*>(&item), sizeof(item));
+
+		// padding 제외
+		const float* row = getSeries((int)t);
+		for (int i = 0; i < length; ++i, row += stride) file.write(reinterpret_cast<const char*>(row), sizeof(float) * featureSize);
+	}
+
+	return file.good();
+}
+
+int DtwMatcher::getTemplateCount()
+{
+	return (int)labels.size();
+}
+
+int DtwMatcher::getLabelCount()
+{
+	return labels.empty() ? 0 : *max_element(labels.begin(), labels.end()) + 1;
+}
+
+int DtwMatcher::getLength()
+{
+	return length;
+}
+
+int DtwMatcher::getBand()
+{
+	return band;
+}
+
+int DtwMatcher::getFeatureSize()
+{
+	return featureSize;
+}
+
+int DtwMatcher::getLabel(int index)
+{
+	return labels[index];
+}
+
+vector<DtwMatcher::Match> DtwMatcher::search(const float* frames, int frameSize, int k, Stats* stats)
+{
+	int count = getTemplateCount();
+	k = min(max(k, 1), count);
+	if (count == 0 || frameSize <= 0) return vector<Match>();
+
+	vector<float> query;
+	prepare(frames, frameSize, query);
+
+	// 1. LB_Keogh, 작은 순서
+	vector<float> bounds(count);
+	Concurrency::parallel_for(0, count, [&](int t)
+	{
+		bounds[t] = lowerBound(query.data(), t);
+	});
+
+	vector<int> order(count);
+	iota(order.begin(), order.end(), 0);
+	sort(order.begin(), order.end(), [&](int a, int b) { return bounds[a] < bounds[b]; });
+
+	// 2. DTW, thread마다 top-k
+	struct Local
+	{
+		vector<Match> best; // 가까운 순서, 최대 k
+		vector<float> rows; // dtw 작업 버퍼
+		Stats stats;
+	};
+
+	atomic<float> shared(INF);
+	Concurrency::combinable<Local> locals;
+
+	Concurrency::parallel_for(0, count, [&](int r)
+	{
+		Local& local = locals.local();
+		int t = order[r];
+		float bound = min(shared.load(), local.best.size() == (size_t)k ? local.best.back().distance : INF);
+
+		if (bounds[t] >= bound)
+		{
+			++local.stats.pruned;
+			return;
+		}
+
+		float d = dtw(query.data(), getSeries(t), bound, local.rows);
+		if (d >= bound)
+		{
+			++local.stats.abandoned;
+			return;
+		}
+		++local.stats.computed;
+
+		Match match = { t, labels[t], d };
+		local.best.insert(upper_bound(local.best.begin(), local.best.end(), match, closer), match);
+		if (local.best.size() > (size_t)k) local.best.pop_back();
+		if (local.best.size() == (size_t)k) lowerTo(shared, local.best.back().distance);
+	});
+
+	vector<Match> result;
+	Stats total;
+	total.templates = count;
+
+	locals.combine_each([&](Local& local)
+	{
+		result.insert(result.end(), local.best.begin(), local.best.end());
+		total.pruned += local.stats.pruned;
+		total.abandoned += local.stats.abandoned;
+		total.computed += local.stats.computed;
+	});
+
+	sort(result.begin(), result.end(), closer);
+	if (result.size() > (size_t)k) result.resize(k);
+	if (stats) *stats = total;
+
+	return result;
+}
+
+void DtwMatcher::prepare(const float* frames, int frameSize, vector<float>& query)
+{
+	query.assign((size_t)length * stride, 0.0f);
+	resample(frames, frameSize, query.data());
+}
+
+float DtwMatcher::distance(const vector<float>& query, int index)
+{
+	vector<float> rows;
+	return dtw(query.data(), getSeries(index), INF, rows);
+}
+
+const float* DtwMatcher::getSeries(int index)
+{
+	return series.data() + (size_t)index * length * stride;
+}
+
+// Sakoe-Chiba band 안에서 D(i, j) = cost(i, j) + min(D(i-1, j), D(i, j-1), D(i-1, j-1)), 두 행만 유지
+float DtwMatcher::dtw(const float* query, const float* target, float bound, vector<float>& rows)
+{
+	bool simd = InferenceKernels::isSimd();
+	rows.assign(2 * (length + 1), INF);
+	float* previous = rows.data();
+	float* current = previous + length + 1;
+	previous[0] = 0; // D(-1, -1)
+
+	for (int i = 0; i < length; ++i)
+	{
+		int from = max(0, i - band);
+		int to = min(length - 1, i + band);
+		const float* q = query + (size_t)i * stride;
+		float rowMin = INF;
+
+		fill(current, current + length + 1, INF);
+		// index j + 1 = 열 j, index 0 = 열 -1
+		for (int j = from; j <= to; ++j)
+		{
+			float best = min(min(previous[j + 1], current[j]), previous[j]);
+			float d = squared(q, target + (size_t)j * stride, stride, simd) + best;
+
+			current[j + 1] = d;
+			rowMin = min(rowMin, d);
+		}
+
+		if (rowMin >= bound) return rowMin;
+		swap(previous, current);
+		previous[0] = INF;
+	}
+
+	return previous[length];
+}
+
+// 질의 프레임 i가 템플릿 band envelope 밖으로 나간 만큼 (DTW 이하 보장)
+float DtwMatcher::lowerBound(const float* query, int index)
+{
+	bool simd = InferenceKernels::isSimd();
+	size_t offset = (size_t)index * length * stride;
+	float sum = 0;
+
+	for (int i = 0; i < length; ++i)
+	{
+		size_t row = offset + (size_t)i * stride;
+		sum += outside(query + (size_t)i * stride, upper.data() + row, lower.data() + row, stride, simd);
+	}
+
+	return sum;
+}
+
+// 프레임 index 기준 선형 보간, padding 열은 0
+void DtwMatcher::resample(const float* frames, int frameSize, float* out)
+{
+	for (int i = 0; i < length; ++i)
+	{
+		double position = frameSize == 1 ? 0 : (double)i * (frameSize - 1) / (length - 1);
+		int a = min((int)position, frameSize - 1);
+		int b = min(a + 1, frameSize - 1);
+		float w = (float)(position - a);
+
+		const float* fa = frames + (size_t)a * featureSize;
+		const float* fb = frames + (size_t)b * featureSize;
+		float* o = out + (size_t)i * stride;
+
+		for (int d = 0; d < featureSize; ++d) o[d] = fa[d] + (fb[d] - fa[d]) * w;
+	}
+}
+
+void DtwMatcher::envelope(int index)
+{
+	size_t offset = (size_t)index * length * stride;
+	const float* s = series.data() + offset;
+
+	for (int i = 0; i < length; ++i)
+	{
+		float* up = upper.data() + offset + (size_t)i * stride;
+		float* low = lower.data() + offset + (size_t)i * stride;
+		memcpy(up, s + (size_t)i * stride, sizeof(float) * stride);
+		memcpy(low, s + (size_t)i * stride, sizeof(float) * stride);
+
+		for (int j = max(0, i - band); j <= min(length - 1, i + band); ++j)
+		{
+			const float* f = s + (size_t)j * stride;
+			for (int d = 0; d < stride; ++d)
+			{
+				up[d] = max(up[d], f[d]);
+				low[d] = min(low[d], f[d]);
+			}
+		}
+	}
+}
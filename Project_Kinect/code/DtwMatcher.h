@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// data/models/templates.ksdt (PATH_MODEL_FOLDER, Project_Tools dtw-enroll)
+//   DtwFileHeader, 템플릿마다 DtwTemplateHeader + float [length][featureSize]
+// 구조가 바뀌면 DTW_FILE_VERSION 증가
+#define DTW_TEMPLATE_FILE_NAME "templates.ksdt"
+#define DTW_FILE_MAGIC 0x444C534B // "KSLD"
+#define DTW_FILE_VERSION 1
+
+struct DtwFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t templateCount;
+	uint32_t length; // resample 길이 (DTW_SERIES_LENGTH)
+	uint32_t featureSize; // 프레임당 float 수 (distance L, R)
+	uint32_t reserved;
+};
+
+struct DtwTemplateHeader
+{
+	int32_t label;
+	uint32_t frameSize; // resample 전 프레임 수
+};
+
+static_assert(sizeof(DtwFileHeader) == 24, "DtwFileHeader layout");
+static_assert(sizeof(DtwTemplateHeader) == 8, "DtwTemplateHeader layout");
+
+// 등록된 템플릿(세그먼트의 SPoint distance 시퀀스)과 band DTW로 kNN
+//
+// 시퀀스는 DTW_SERIES_LENGTH로 resample, 프레임 벡터는 8 float 단위로 0 padding (AVX2 한 번에 8개).
+// search :
+//   1. 모든 템플릿의 LB_Keogh (질의 vs 템플릿 band envelope)를 병렬로 계산, 작은 순서로 정렬
+//   2. 그 순서로 템플릿마다 병렬 DTW, LB_Keogh가 현재 k번째 거리 이상이면 건너뜀 (pruned)
+//      DTW도 한 행의 최소가 k번째 거리를 넘으면 중단 (abandoned)
+// k번째 거리는 thread마다 가진 top-k 중 가장 작은 값을 공유 (전체 k번째보다 크거나 같으므로 결과는 brute force와 같다)
+//
+// 거리는 경로 위 프레임 차이 제곱합, SIMD는 InferenceKernels::isSimd()를 따른다 (INFERENCE_AVX2).
+// add / load와 search는 동시에 부르지 않는다.
+class DtwMatcher
+{
+public:
+	struct Match
+	{
+		int index;
+		int label;
+		float distance;
+	};
+
+	struct Stats
+	{
+		int templates = 0;
+		int pruned = 0; // LB_Keogh
+		int abandoned = 0; // DTW 중단
+		int computed = 0; // 끝까지 계산
+	};
+
+private:
+	int length;
+	int band;
+	int featureSize = 0;
+	int stride = 0; // featureSize를 8 배수로
+
+	vector<int> labels;
+	vector<uint32_t> frameSizes;
+	vector<float> series; // [template][length][stride]
+	vector<float> upper; // band envelope
+	vector<float> lower;
+
+public:
+	DtwMatcher(int length = DTW_SERIES_LENGTH, double bandRatio = DTW_BAND_RATIO);
+
+	// frames : [frameSize][featureSize], 첫 템플릿이 featureSize를 정함
+	bool add(int label, const float* frames, int frameSize, int featureSize);
+	void clear();
+
+	bool load(const string& path);
+	bool save(const string& path);
+
+	int getTemplateCount();
+	int getLabelCount(); // 가장 큰 label + 1
+	int getLength();
+	int getBand();
+	int getFeatureSize();
+	int getLabel(int index);
+
+	// 가까운 순서 k개
+	vector<Match> search(const float* frames, int frameSize, int k, Stats* stats = nullptr);
+
+	// 검증용 : resample된 질의 (prepare) vs 템플릿 하나, 중단 없는 DTW
+	void prepare(const float* frames, int frameSize, vector<float>& query);
+	float distance(const vector<float>& query, int index);
+
+private:
+	const float* getSeries(int index);
+
+	// 중단하면 bound 이상 값
+	float dtw(const float* query, const float* target, float bound, vector<float>& rows);
+	float lowerBound(const float* query, int index);
+
+	void resample(const float* frames, int frameSize, float* out);
+	void envelope(int index);
+};
@@ -0,0 +1,209 @@
+#include "EarlyExit.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+	// 평균 길이 갱신 비율 (최근 final 쪽으로)
+	const float FRAMES_RATE = 0.2f;
+
+	// final을 기다리는 세그먼트 최대 수 (결과가 버려진 세그먼트 정리)
+	const size_t PENDING_MAX = 16;
+}
+
+EarlyExit::EarlyExit(const string& path)
+	: path(path), checkpoints(EARLY_EXIT_CHECKPOINTS)
+{
+	checked.assign(checkpoints.size(), 0);
+	matched.assign(checkpoints.size(), 0);
+
+	load();
+}
+
+EarlyExit::~EarlyExit()
+{
+	if (finals == 0) return;
+
+	cout << "EarlyExit ... commit " << commits << " / " << finals << " (" << 100.0 * commits / finals << "%)"
+		<< ", agree " << agreed << " / " << commits << (commits > 0 ? " (" + to_string(100 * agreed / commits) + "%)" : "") << endl;
+
+	for (size_t i = 0; i < checkpoints.size(); ++i)
+	{
+		if (checked[i] == 0) continue;
+		cout << "  " << (int)(checkpoints[i] * 100) << "% prefix top-1 == final " << matched[i] << " / " << checked[i] << endl;
+	}
+
+	if (!save()) cout << "EarlyExit ... cannot write " << path << endl;
+}
+
+// label frames threshold finals commits agreed, '#'은 주석
+bool EarlyExit::load()
+{
+	ifstream file(path.c_str());
+	if (!file.is_open()) return false;
+
+	string line;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		stringstream stream(line);
+		int label;
+		LabelStat stat;
+		if (!(stream >> label >> stat.frames >> stat.threshold)) continue;
+		stream >> stat.finals >> stat.commits >> stat.agreed;
+
+		labels[label] = stat;
+	}
+
+	return true;
+}
+
+bool EarlyExit::save()
+{
+	ofstream file(path.c_str(), ios::out | ios::trunc);
+	if (!file.is_open()) return false;
+
+	file << "# label frames threshold finals commits agreed" << endl;
+	for (const auto& item : labels)
+	{
+		const LabelStat& stat = item.second;
+		file << item.first << " " << stat.frames << " " << stat.threshold << " " << stat.finals << " " << stat.commits << " " << stat.agreed << endl;
+	}
+
+	return file.good();
+}
+
+int EarlyExit::begin()
+{
+	int segment = nextSegment++;
+
+	Pending& item = pending[segment];
+	item.checkpointFrames.assign(checkpoints.size(), 0);
+	item.tops.assign(checkpoints.size(), -1);
+
+	while (pending.size() > PENDING_MAX) pending.erase(pending.begin());
+
+	return segment;
+}
+
+int EarlyExit::check(int segment, int frames)
+{
+	auto found = pending.find(segment);
+	if (found == pending.end()) return -1;
+
+	Pending& item = found->second;
+	float typical = getTypicalFrames();
+
+	// 여러 checkpoint를 한 번에 지났으면 (PredictQueue가 바빴음) 마지막 것만
+	int checkpoint = -1;
+	while (item.next < (int)checkpoints.size() && frames >= checkpoints[item.next] * typical) checkpoint = item.next++;
+	if (checkpoint < 0) return -1;
+
+	item.checkpointFrames[checkpoint] = frames;
+	return checkpoint;
+}
+
+void EarlyExit::end(int segment, int frames)
+{
+	auto found = pending.find(segment);
+	if (found != pending.end()) found->second.frames = frames;
+}
+
+void EarlyExit::cancel(int segment)
+{
+	pending.erase(segment);
+}
+
+bool EarlyExit::accept(int segment, int checkpoint, int top, float confidence)
+{
+	auto found = pending.find(segment);
+	if (found == pending.end() || top < 0 || checkpoint < 0 || checkpoint >= (int)checkpoints.size()) return false;
+
+	Pending& item = found->second;
+	item.tops[checkpoint] = top;
+
+	if (item.committed >= 0) return false;
+
+	auto stat = labels.find(top);
+	float threshold = stat == labels.end() ? (float)EARLY_EXIT_THRESHOLD : stat->second.threshold;
+	if (confidence < threshold) return false;
+
+	// 그 label 길이에 비해 너무 앞부분
+	if (item.checkpointFrames[checkpoint] < checkpoints.front() * getFrames(top)) return false;
+
+	item.committed = top;
+	return true;
+}
+
+int EarlyExit::finish(int segment, int top)
+{
+	auto found = pending.find(segment);
+	if (found == pending.end()) return -1;
+
+	Pending item = move(found->second);
+	pending.erase(found);
+
+	if (top < 0) return item.committed;
+
+	++finals;
+	for (size_t i = 0; i < checkpoints.size(); ++i)
+	{
+		if (item.tops[i] < 0) continue;
+		++checked[i];
+		matched[i] += item.tops[i] == top;
+	}
+
+	LabelStat& stat = labels[top];
+	++stat.finals;
+	if (item.frames > 0) stat.frames = stat.frames > 0 ? stat.frames + FRAMES_RATE * (item.frames - stat.frames) : (float)item.frames;
+
+	if (item.committed >= 0)
+	{
+		++commits;
+		agreed += item.committed == top;
+
+		LabelStat& committed = labels[item.committed];
+		++committed.commits;
+		committed.agreed += item.committed == top;
+	}
+
+	return item.committed;
+}
+
+int EarlyExit::getFinals()
+{
+	return finals;
+}
+
+int EarlyExit::getCommits()
+{
+	return commits;
+}
+
+int EarlyExit::getAgreed()
+{
+	return agreed;
+}
+
+float EarlyExit::getFrames(int label)
+{
+	auto found = labels.find(label);
+	return found == labels.end() || found->second.frames <= 0 ? (float)EARLY_EXIT_DEFAULT_FRAMES : found->second.frames;
+}
+
+float EarlyExit::getTypicalFrames()
+{
+	vector<float> frames;
+	for (const auto& item : labels)
+	{
+		if (item.second.frames > 0) frames.push_back(item.second.frames);
+	}
+	if (frames.empty()) return (float)EARLY_EXIT_DEFAULT_FRAMES;
+
+	nth_element(frames.begin(), frames.begin() + frames.size() / 2, frames.end());
+	return frames[frames.size() / 2];
+}
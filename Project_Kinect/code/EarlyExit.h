@@ -0,0 +1,89 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// KINECT_MODE_PREDICT early exit : 세그먼트가 끝나기 전에 지금까지 쌓인 prefix를 predict해서 먼저 결과를 낸다
+//
+// checkpoint (EARLY_EXIT_CHECKPOINTS, label별 평균 프레임 수의 비율)마다 prefix 하나 (PredictQueue::pushPartial),
+// 결과 label의 threshold 이상이고 그 label 평균 길이의 첫 checkpoint 이상 진행했으면 commit (긴 수어를 앞부분만 보고 정하지 않게).
+// 세그먼트 전체 결과(final)가 오면 commit과 같았는지, checkpoint별 prefix top-1이 final과 같았는지 센다 (threshold 조정용).
+// label별 평균 길이 / threshold / commit 통계는 data/models/earlyexit.txt에 남긴다 (threshold는 손으로 고침).
+//
+// main thread에서만 쓴다 (Kinect::updateFrame, updatePredict).
+class EarlyExit
+{
+private:
+	struct LabelStat
+	{
+		float frames = 0; // final 기준 평균 raw 프레임 수, 0 : 모름
+		float threshold = (float)EARLY_EXIT_THRESHOLD;
+		int finals = 0;
+		int commits = 0; // 이 label로 early commit
+		int agreed = 0; // 그 중 final과 같음
+	};
+
+	struct Pending
+	{
+		int frames = 0; // 세그먼트 raw 프레임 수 (end)
+		int next = 0; // 다음 checkpoint
+		vector<int> checkpointFrames; // prefix raw 프레임 수
+		vector<int> tops; // prefix top-1, -1 : 결과 없음
+		int committed = -1;
+	};
+
+	string path;
+	vector<float> checkpoints;
+	map<int, LabelStat> labels;
+	map<int, Pending> pending; // segment -> final 대기
+	int nextSegment = 0;
+
+	// 이번 실행 checkpoint별 prefix top-1 == final
+	vector<int> checked;
+	vector<int> matched;
+	int finals = 0;
+	int commits = 0;
+	int agreed = 0;
+
+public:
+	EarlyExit(const string& path = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + EARLY_EXIT_FILE_NAME);
+
+	// 통계 출력, 파일 저장
+	~EarlyExit();
+
+	bool load();
+	bool save();
+
+	// 세그먼트 시작, 번호 (PredictQueue push / pushPartial에 같이 넘김)
+	int begin();
+
+	// 지금까지 raw 프레임 수, prefix를 보낼 checkpoint 번호, -1 : 아직
+	int check(int segment, int frames);
+
+	// 세그먼트 끝 (final 요청 보냄)
+	void end(int segment, int frames);
+
+	// 세그먼트를 보내지 않음 (프레임 부족, 표준화 실패)
+	void cancel(int segment);
+
+	// prefix 결과, true : 지금 commit (결과 출력)
+	bool accept(int segment, int checkpoint, int top, float confidence);
+
+	// final 결과, early commit한 label (-1 : 없음)
+	int finish(int segment, int top);
+
+	int getFinals();
+	int getCommits();
+	int getAgreed();
+
+	// label 평균 길이, 모르면 EARLY_EXIT_DEFAULT_FRAMES
+	float getFrames(int label);
+
+private:
+	// checkpoint 기준 길이 : 아는 label 평균 길이의 중앙값
+	float getTypicalFrames();
+};
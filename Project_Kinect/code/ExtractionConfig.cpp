@@ -0,0 +1,109 @@
+#include "ExtractionConfig.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "FrameCollection.h"
+#include "ImageFrameCollection.h"
+
+ExtractionConfig& ExtractionConfig::current()
+{
+	static ExtractionConfig config;
+	return config;
+}
+
+bool ExtractionConfig::set(const string& key, const string& value)
+{
+	try
+	{
+		if (key == "frame-size") frameStandardSize = stoi(value);
+		else if (key == "frame-mode") frameStandardMode = (value == "adaptive" ? FRAME_STANDARD_ADAPTIVE : value == "uniform" ? FRAME_STANDARD_UNIFORM : stoi(value));
+		else if (key == "image-size") imageStandardSize = stoi(value);
+		else if (key == "image-select") imageSelectMode = (value == "sharpest" ? IMAGE_SELECT_SHARPEST : value == "motion" ? IMAGE_SELECT_MOTION : value == "uniform" ? IMAGE_SELECT_UNIFORM : stoi(value));
+		else if (key == "image-width") imageWidth = stoi(value);
+		else if (key == "lerp") lerpPercent = stof(value);
+		else if (key == "roi-scale") roiScale = stof(value);
+		else if (key == "min-frames") minStackedFrames = stoi(value);
+		else if (key == "image-scales")
+		{
+			// 140,80,64
+			vector<int> scales;
+			stringstream ss(value);
+			string item;
+			while (getline(ss, item, ',')) scales.push_back(stoi(item));
+
+			if (scales.empty()) return false;
+			imageScales = scales;
+		}
+		else return false;
+	}
+	catch (const exception&)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool ExtractionConfig::validate(string& error)
+{
+	sort(imageScales.begin(), imageScales.end(), greater<int>());
+	imageScales.erase(unique(imageScales.begin(), imageScales.end()), imageScales.end());
+
+	if (frameStandardSize < 2) error = "frame-size must be >= 2";
+	else if (imageStandardSize < 2) error = "image-size must be >= 2";
+	else if (imageScales.back() <= 0) error = "image-scales must be positive";
+	else if (find(imageScales.begin(), imageScales.end(), imageWidth) == imageScales.end()) error = "image-scales must contain image-width";
+	else if (lerpPercent <= 0 || lerpPercent > 1) error = "lerp must be in (0, 1]";
+	else if (roiScale <= 0) error = "roi-scale must be positive";
+	else error.clear();
+
+	return error.empty();
+}
+
+string ExtractionConfig::toString() const
+{
+	stringstream ss;
+
+	ss << "frame-size=" << frameStandardSize
+		<< " frame-mode=" << (frameStandardMode == FRAME_STANDARD_ADAPTIVE ? "adaptive" : "uniform")
+		<< " image-size=" << imageStandardSize
+		<< " image-select=" << imageSelectMode
+		<< " image-width=" << imageWidth
+		<< " image-scales=";
+	for (int i = 0; i < (int)imageScales.size(); ++i) ss << (i > 0 ? "," : "") << imageScales[i];
+	ss << " lerp=" << lerpPercent
+		<< " roi-scale=" << roiScale
+		<< " min-frames=" << minStackedFrames;
+
+	return ss.str();
+}
+
+bool ExtractionConfig::standardize(FrameCollection& frames, ImageFrameCollection& lhand, ImageFrameCollection& rhand, TIMESPAN startTime) const
+{
+	int frameSize = frameStandardSize;
+	int imageSize = imageStandardSize;
+
+	if (frameStandardMode == FRAME_STANDARD_ADAPTIVE)
+	{
+		// 움직임 에너지가 적은 동작은 프레임 수를 줄이고, 움직임 많은 구간에 프레임을 몰아준다
+		float ratio = frames.getAdaptiveRatio();
+		frameSize = max((int)(frameStandardSize * ratio + 0.5f), 2);
+		imageSize = max((int)(imageStandardSize * ratio + 0.5f), 2);
+
+		vector<TIMESPAN> imageTimes = frames.makeAdaptiveTimeline(imageSize);
+		frames.setStandard(frames.makeAdaptiveTimeline(frameSize));
+		rhand.setStandard(imageTimes);
+		lhand.setStandard(imageTimes);
+	}
+	else
+	{
+		frames.setStandard(startTime);
+		rhand.setStandard(startTime);
+		lhand.setStandard(startTime);
+	}
+
+	return frames.getCollectionSize() == frameSize &&
+		lhand.getCollectionSize() == imageSize &&
+		rhand.getCollectionSize() == imageSize;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+using namespace std;
+
+#include "common/defines.hpp"
+
+class FrameCollection;
+class ImageFrameCollection;
+
+// 특징 추출 파라미터 (defines.hpp 값을 실행 중에 바꿀 수 있게)
+//
+// 캡처 프로그램은 기본값(= defines.hpp) 그대로 쓰고,
+// Project_Tools extract는 시작할 때 --frame-size=100 처럼 덮어쓴 뒤 세션을 다시 추출한다.
+// 추출 thread가 돌기 전에만 바꾼다 (이후는 읽기 전용이라 lock 없음).
+struct ExtractionConfig
+{
+	int frameStandardSize = FRAME_STANDARD_SIZE;
+	int frameStandardMode = FRAME_STANDARD_MODE;
+	int imageStandardSize = IMAEG_STANDARD_FRAME_SIZE;
+	int imageSelectMode = IMAGE_SELECT_MODE;
+	int imageWidth = IMAGE_WIDTH; // imageScales 중 화면 표시 / Spoints 기준 level
+	vector<int> imageScales = IMAGE_SCALES; // 내림차순
+	float lerpPercent = (float)LERP_PERCENT;
+	float roiScale = 1.15f; // ROI 한 변 = spinePx(color) * roiScale
+	int minStackedFrames = 35; // 이보다 짧은 세그먼트는 저장 안함 (predict는 18)
+
+	static ExtractionConfig& current();
+
+	// key=value 하나 (frame-size, frame-mode, image-size, image-select, image-width, image-scales, lerp, roi-scale, min-frames)
+	bool set(const string& key, const string& value);
+
+	// imageScales 정렬, imageWidth 포함 확인
+	bool validate(string& error);
+
+	string toString() const;
+
+	// FRAME_STANDARD_MODE에 따라 프레임 / ROI resample, 크기가 맞으면 true (Kinect::standardize)
+	bool standardize(FrameCollection& frames, ImageFrameCollection& lhand, ImageFrameCollection& rhand, TIMESPAN startTime) const;
+};
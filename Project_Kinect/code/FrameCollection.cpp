@@ -1,4 +1,5 @@
 #include "FrameCollection.h"
+#include "ExtractionConfig.h"
 
 
 FrameCollection::FrameCollection()
@@ -34,13 +35,15 @@ void FrameCollection::setStandard(TIMESPAN startTime)
 	Frame temp;
 	TIMESPAN timeLine;
 	TIMESPAN endTime = collection[collection.size() - 1].getTime();
-	int dt = (int)(endTime - startTime) / (FRAME_STANDARD_SIZE);
+	int dt = (int)(endTime - startTime) / (ExtractionConfig::current().frameStandardSize);
 	timeLine = startTime + dt;
 	double percent = 0;
 
 	int startIdx = 0;
 	int endIdx = 0;
 
+	timeline.clear();
+
 	for (int i = 1; i < collection.size(); ++i)
 	{
 		if (collection[i].getTime() > timeLine)
@@ -52,6 +55,7 @@ void FrameCollection::setStandard(TIMESPAN startTime)
 			temp = collection[startIdx];
 			temp.LerpMe((float)percent, collection[endIdx]);
 			result.push_back(temp);
+			timeline.push_back(timeLine);
 
 			timeLine += dt;
 			if (timeLine > collection[endIdx].getTime())
@@ -67,23 +71,128 @@ void FrameCollection::setStandard(TIMESPAN startTime)
 	collection = result;
 }
 
+void FrameCollection::setStandard(const vector<TIMESPAN>& times)
+{
+	if (collection.size() < 2) return;
+
+	vector<Frame> result = vector<Frame>();
+	int size = (int)collection.size();
+	int endIdx = 1;
+
+	// times는 오름차순, t를 감싸는 [endIdx - 1, endIdx] 사이를 Lerp
+	for (TIMESPAN t : times)
+	{
+		while (endIdx < size - 1 && collection[endIdx].getTime() < t) ++endIdx;
+
+		TIMESPAN startTime = collection[endIdx - 1].getTime();
+		TIMESPAN span = collection[endIdx].getTime() - startTime;
+		double percent = span > 0 ? (double)(t - startTime) / span : 0;
+		if (percent < 0) percent = 0;
+		if (percent > 1) percent = 1;
+
+		Frame temp = collection[endIdx - 1];
+		temp.LerpMe((float)percent, collection[endIdx]);
+		result.push_back(temp);
+	}
+
+	collection = result;
+	timeline = times;
+}
+
+vector<double> FrameCollection::motionEnergy()
+{
+	vector<double> energy = vector<double>(collection.size(), 0.0);
+
+	for (int i = 1; i < (int)collection.size(); ++i)
+	{
+		for (int s = 0; s < SPOINT_SIZE; ++s)
+		{
+			energy[i] += fabs(collection[i].getDistanceL(s) - collection[i - 1].getDistanceL(s));
+			energy[i] += fabs(collection[i].getDistanceR(s) - collection[i - 1].getDistanceR(s));
+		}
+	}
+
+	return energy;
+}
+
+float FrameCollection::getAdaptiveRatio()
+{
+	vector<double> energy = motionEnergy();
+	double total = 0;
+
+	for (double e : energy) total += e;
+
+	double ratio = total / (FRAME_ADAPTIVE_ENERGY_PER_FRAME * ExtractionConfig::current().frameStandardSize);
+	if (ratio < FRAME_ADAPTIVE_MIN_RATIO) ratio = FRAME_ADAPTIVE_MIN_RATIO;
+	if (ratio > 1) ratio = 1;
+
+	return (float)ratio;
+}
+
+// 누적 에너지(시간 구간별 에너지 + floor)를 size등분, 각 등분점의 시점을 구간 내 선형 보간
+// 균등 방식처럼 첫 시점은 시작 + 1칸, 마지막 시점은 끝
+vector<TIMESPAN> FrameCollection::makeAdaptiveTimeline(int size)
+{
+	vector<TIMESPAN> times = vector<TIMESPAN>();
+	int n = (int)collection.size();
+	if (n < 2 || size <= 0) return times;
+
+	vector<double> energy = motionEnergy();
+	double total = 0;
+	for (double e : energy) total += e;
+
+	double floor = total > 0 ? FRAME_ADAPTIVE_FLOOR * total / (n - 1) : 1.0;
+
+	vector<double> cumulative = vector<double>(n, 0.0);
+	for (int i = 1; i < n; ++i)
+	{
+		cumulative[i] = cumulative[i - 1] + energy[i] + floor;
+	}
+
+	int seg = 1;
+	for (int k = 0; k < size; ++k)
+	{
+		double target = cumulative[n - 1] * (k + 1) / size;
+		while (seg < n - 1 && cumulative[seg] < target) ++seg;
+
+		double width = cumulative[seg] - cumulative[seg - 1];
+		double p = width > 0 ? (target - cumulative[seg - 1]) / width : 1.0;
+		TIMESPAN t0 = collection[seg - 1].getTime();
+		TIMESPAN t1 = collection[seg].getTime();
+
+		times.push_back(t0 + (TIMESPAN)((t1 - t0) * p));
+	}
+
+	return times;
+}
+
+vector<TIMESPAN> FrameCollection::getTimeline()
+{
+	return timeline;
+}
+
 string FrameCollection::toString()
 {
 	stringstream out;
 
 	out << currentDateTime() << " ";
 	out << LABEL(label) << " ";
-	out << FRAME_STANDARD_SIZE << " ";
+	out << collection.size() << " "; // FRAME_STANDARD_ADAPTIVE이면 FRAME_STANDARD_SIZE 이하
 	out << SPOINT_SIZE << " ";
 	out << 2 << " "; // channel
 
-	for (int j = 0; j < FRAME_STANDARD_SIZE; ++j)
+	for (int j = 0; j < (int)collection.size(); ++j)
 	{
 		out << collection[j].toString(0) << " ";
 	}		
 	return out.str();
 }
 
+Frame& FrameCollection::getFrame(int idx)
+{
+	return collection[idx];
+}
+
 int FrameCollection::getCollectionSize()
 {
 	return (int)collection.size();
@@ -92,6 +201,7 @@ int FrameCollection::getCollectionSize()
 void FrameCollection::clear()
 {
 	collection.clear();
+	timeline.clear();
 }
 
 string FrameCollection::getLabel()
@@ -14,6 +14,7 @@ class FrameCollection
 {
 private:
 	vector<Frame> collection = vector<Frame>();
+	vector<TIMESPAN> timeline; // setStandard로 선택된 시점 (Times.txt)
 	string label;
 	float** data;
 
@@ -27,16 +28,28 @@ public:
 	array<string, Show_Status_DistanceFrame_Size> lastFrameToString();
 
 	void setStandard(TIMESPAN startTime);
+	void setStandard(const vector<TIMESPAN>& times); // 주어진 시점들로 resample (Lerp)
+
+	// FRAME_STANDARD_ADAPTIVE
+	// 움직임 에너지 기준 사용할 프레임 비율 (FRAME_ADAPTIVE_MIN_RATIO ~ 1)
+	float getAdaptiveRatio();
+	// 누적 움직임 에너지를 size등분하는 시점들
+	vector<TIMESPAN> makeAdaptiveTimeline(int size);
+
+	vector<TIMESPAN> getTimeline();
 
 	// for serialize
 	string toString();
 
 	int getCollectionSize();
 
+	Frame& getFrame(int idx);
+
 	void clear();
 
 	string getLabel();
 
 private:
-
+	// raw 프레임 i-1 -> i 의 SPoint distance 변화량 합 (0번은 0)
+	vector<double> motionEnergy();
 };
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include "HnswIndex.h"
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <cmath>
+#include <cstring>
+
+#include "InferenceKernels.h" // isSimd
+
+#ifdef INFERENCE_AVX2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	// 깨진 파일에서 거대한 할당을 막는 상한
+	const uint32_t ANN_MAX_COUNT = 1 << 24;
+	const uint32_t ANN_MAX_DIM = 1 << 16;
+	const int ANN_MAX_LEVEL = 32;
+
+	// level 추첨 (같은 순서로 add하면 같은 graph)
+	const unsigned LEVEL_SEED = 42;
+
+	float squaredScalar(const float* a, const float* b, int stride)
+	{
+		float sum = 0;
+		for (int i = 0; i < stride; ++i)
+		{
+			float d = a[i] - b[i];
+			sum += d * d;
+		}
+		return sum;
+	}
+
+#ifdef INFERENCE_AVX2
+	float squaredAvx2(const float* a, const float* b, int stride)
+	{
+		__m256 acc = _mm256_setzero_ps();
+		for (int i = 0; i < stride; i += 8)
+		{
+			__m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+			acc = _mm256_fmadd_ps(d, d, acc);
+		}
+
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+		return _mm_cvtss_f32(s);
+	}
+#endif
+
+	float squared(const float* a, const float* b, int stride)
+	{
+#ifdef INFERENCE_AVX2
+		if (InferenceKernels::isSimd()) return squaredAvx2(a, b, stride);
+#endif
+		return squaredScalar(a, b, stride);
+	}
+}
+
+HnswIndex::HnswIndex(int m, int efConstruction, int efSearch)
+	: random(LEVEL_SEED)
+{
+	this->m = max(m, 2);
+	this->mMax0 = 2 * this->m;
+	this->efConstruction = max(efConstruction, this->m);
+	this->efSearch = max(efSearch, 1);
+	levelScale = 1.0 / log((double)this->m);
+}
+
+bool HnswIndex::add(int label, const float* values, int dim)
+{
+	if (dim <= 0) return false;
+
+	if (labels.empty())
+	{
+		this->dim = dim;
+		stride = (dim + 7) / 8 * 8;
+	}
+	else if (dim != this->dim) return false;
+
+	int node = (int)labels.size();
+	uniform_real_distribution<double> u(0, 1);
+	int level = min((int)(-log(max(u(random), 1e-12)) * levelScale), ANN_MAX_LEVEL);
+
+	labels.push_back(label);
+	levels.push_back(level);
+	links.emplace_back(level + 1);
+	vectors.resize(vectors.size() + stride, 0.0f);
+	memcpy(vectors.data() + (size_t)node * stride, values, sizeof(float) * dim);
+
+	if (entry < 0)
+	{
+		entry = node;
+		topLevel = level;
+		return true;
+	}
+
+	// 작업 버퍼 query에 복사 (vectors는 다음 add에서 재할당될 수 있음)
+	prepareQuery(values);
+	const float* q = query.data();
+
+	vector<Candidate> nearest = { { distance(q, entry), entry } };
+	for (int l = topLevel; l > level; --l) nearest = searchLayer(q, nearest, 1, l);
+
+	for (int l = min(level, topLevel); l >= 0; --l)
+	{
+		nearest = searchLayer(q, nearest, efConstruction, l);
+
+		links[node][l] = selectNeighbors(nearest, m);
+		for (int neighbor : links[node][l]) connect(neighbor, node, l);
+	}
+
+	if (level > topLevel)
+	{
+		topLevel = level;
+		entry = node;
+	}
+
+	return true;
+}
+
+void HnswIndex::clear()
+{
+	labels.clear();
+	levels.clear();
+	vectors.clear();
+	links.clear();
+	visited.clear();
+	entry = -1;
+	topLevel = -1;
+	dim = 0;
+	stride = 0;
+	random.seed(LEVEL_SEED);
+}
+
+bool HnswIndex::load(const string& path)
+{
+	clear();
+
+	ifstream file(path.c_str(), ios::in | ios::binary);
+	if (!file.is_open())
+	{
+		cout << "HnswIndex::load cannot open " << path << endl;
+		return false;
+	}
+
+	AnnFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != ANN_FILE_MAGIC || header.version != ANN_FILE_VERSION
+		|| header.count > ANN_MAX_COUNT || header.dim == 0 || header.dim > ANN_MAX_DIM
+		|| (header.count > 0 && (header.entry < 0 || header.entry >= (int32_t)header.count)))
+	{
+		cout << "HnswIndex::load invalid index file " << path << endl;
+		return false;
+	}
+
+	// 저장할 때의 m으로 (ef는 유지)
+	m = max((int)header.m, 2);
+	mMax0 = 2 * m;
+	levelScale = 1.0 / log((double)m);
+	dim = (int)header.dim;
+	stride = (dim + 7) / 8 * 8;
+
+	int count = (int)header.count;
+	labels.resize(count);
+	levels.resize(count);
+	links.resize(count);
+	vectors.assign((size_t)count * stride, 0.0f);
+
+	bool valid = true;
+	for (int n = 0; n < count && valid; ++n)
+	{
+		AnnNodeHeader node;
+		valid = file.read(reinterpret_cast<char*>(&node), sizeof(node)) && node.label >= 0 && node.level >= 0 && node.level <= ANN_MAX_LEVEL
+			&& file.read(reinterpret_cast<char*>(vectors.data() + (size_t)n * stride), sizeof(float) * dim);
+		if (!valid) break;
+
+		labels[n] = node.label;
+		levels[n] = node.level;
+		links[n].resize(node.level + 1);
+
+		for (vector<int>& neighbors : links[n])
+		{
+			uint32_t size;
+			if (!file.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > (uint32_t)mMax0)
+			{
+				valid = false;
+				break;
+			}
+
+			neighbors.resize(size);
+			if (size > 0 && !file.read(reinterpret_cast<char*>(neighbors.data()), sizeof(int) * size)) valid = false;
+			for (int neighbor : neighbors) valid = valid && neighbor >= 0 && neighbor < count;
+		}
+	}
+
+	// 구조 : entry가 가장 높은 level, level l의 이웃은 level l 이상 (search가 links[neighbor][l]을 읽는다)
+	if (valid && count > 0) valid = header.topLevel == levels[header.entry];
+	for (int n = 0; n < count && valid; ++n)
+	{
+		valid = levels[n] <= header.topLevel;
+		for (int l = 0; l < (int)links[n].size() && valid; ++l)
+		{
+			for (int neighbor : links[n][l]) valid = valid && levels[neighbor] >= l;
+		}
+	}
+
+	if (!valid)
+	{
+		cout << "HnswIndex::load broken node " << path << endl;
+		clear();
+		return false;
+	}
+
+	entry = count > 0 ? header.entry : -1;
+	topLevel = count > 0 ? header.topLevel : -1;
+
+	// 이어서 add해도 같은 level 분포
+	random.seed(LEVEL_SEED + count);
+
+	cout << "HnswIndex ... " << count << " embedding, label " << getLabelCount() << ", dim " << dim << ", m " << m << ", level " << topLevel << endl;
+
+	return true;
+}
+
+bool HnswIndex::save(const string& path)
+{
+	ofstream file(path.c_str(), ios::out | ios::binary | ios::trunc);
+	if (!file.is_open()) return false;
+
+	AnnFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ANN_FILE_MAGIC;
+	header.version = ANN_FILE_VERSION;
+	header.count = (uint32_t)labels.size();
+	header.dim = (uint32_t)dim;
+	header.m = (uint32_t)m;
+	header.entry = entry;
+	header.topLevel = topLevel;
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (size_t n = 0; n < labels.size(); ++n)
+	{
+		AnnNodeHeader node = { labels[n], levels[n] };
+		file.write(reinterpret_cast<const char*>(&node), sizeof(node));
+		file.write(reinterpret_cast<const char*>(getVector((int)n)), sizeof(float) * dim);
+
+		for (const vector<int>& neighbors : links[n])
+		{
+			uint32_t size = (uint32_t)neighbors.size();
+			file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+			if (size > 0) file.write(reinterpret_cast<const char*>(neighbors.data()), sizeof(int) * size);
+		}
+	}
+
+	return file.good();
+}
+
+int HnswIndex::getCount()
+{
+	return (int)labels.size();
+}
+
+int HnswIndex::getLabelCount()
+{
+	return labels.empty() ? 0 : *max_element(labels.begin(), labels.end()) + 1;
+}
+
+int HnswIndex::getDim()
+{
+	return dim;
+}
+
+int HnswIndex::getLabel(int index)
+{
+	return labels[index];
+}
+
+int HnswIndex::getTopLevel()
+{
+	return topLevel;
+}
+
+void HnswIndex::setEfSearch(int ef)
+{
+	efSearch = max(ef, 1);
+}
+
+int HnswIndex::getEfSearch()
+{
+	return efSearch;
+}
+
+vector<HnswIndex::Match> HnswIndex::search(const float* values, int k)
+{
+	vector<Match> matches;
+	distanceCount = 0;
+	if (entry < 0 || k <= 0) return matches;
+
+	prepareQuery(values);
+	const float* q = query.data();
+
+	vector<Candidate> nearest = { { distance(q, entry), entry } };
+	for (int l = topLevel; l > 0; --l) nearest = searchLayer(q, nearest, 1, l);
+	nearest = searchLayer(q, nearest, max(efSearch, k), 0);
+
+	for (int i = 0; i < min(k, (int)nearest.size()); ++i)
+	{
+		matches.push_back({ nearest[i].second, labels[nearest[i].second], nearest[i].first });
+	}
+	return matches;
+}
+
+vector<HnswIndex::Match> HnswIndex::searchExact(const float* values, int k)
+{
+	prepareQuery(values);
+
+	vector<Candidate> all(labels.size());
+	for (size_t n = 0; n < labels.size(); ++n) all[n] = { squared(query.data(), getVector((int)n), stride), (int)n };
+
+	int size = min(max(k, 0), (int)all.size());
+	partial_sort(all.begin(), all.begin() + size, all.end());
+
+	vector<Match> matches;
+	for (int i = 0; i < size; ++i) matches.push_back({ all[i].second, labels[all[i].second], all[i].first });
+	return matches;
+}
+
+int HnswIndex::getLastDistances()
+{
+	return distanceCount;
+}
+
+const float* HnswIndex::getVector(int index)
+{
+	return vectors.data() + (size_t)index * stride;
+}
+
+float HnswIndex::distance(const float* a, int index)
+{
+	++distanceCount;
+	return squared(a, getVector(index), stride);
+}
+
+void HnswIndex::prepareQuery(const float* values)
+{
+	query.assign(stride, 0.0f);
+	memcpy(query.data(), values, sizeof(float) * dim);
+}
+
+void HnswIndex::nextVisit()
+{
+	if (visited.size() < labels.size()) visited.resize(labels.size(), 0);
+
+	if (++visitTag == 0)
+	{
+		fill(visited.begin(), visited.end(), 0);
+		visitTag = 1;
+	}
+}
+
+vector<HnswIndex::Candidate> HnswIndex::searchLayer(const float* q, const vector<Candidate>& starts, int ef, int level)
+{
+	nextVisit();
+
+	priority_queue<Candidate, vector<Candidate>, greater<Candidate>> frontier; // 가까운 것이 top
+	priority_queue<Candidate> found; // 먼 것이 top, ef개까지
+
+	for (const Candidate& start : starts)
+	{
+		if (visited[start.second] == visitTag) continue;
+		visited[start.second] = visitTag;
+
+		frontier.push(start);
+		found.push(start);
+		if ((int)found.size() > ef) found.pop();
+	}
+
+	while (!frontier.empty())
+	{
+		Candidate current = frontier.top();
+		if ((int)found.size() >= ef && current.first > found.top().first) break;
+		frontier.pop();
+
+		for (int neighbor : links[current.second][level])
+		{
+			if (visited[neighbor] == visitTag) continue;
+			visited[neighbor] = visitTag;
+
+			float d = distance(q, neighbor);
+			if ((int)found.size() < ef || d < found.top().first)
+			{
+				frontier.push({ d, neighbor });
+				found.push({ d, neighbor });
+				if ((int)found.size() > ef) found.pop();
+			}
+		}
+	}
+
+	vector<Candidate> result(found.size());
+	for (size_t i = result.size(); i > 0; --i)
+	{
+		result[i - 1] = found.top();
+		found.pop();
+	}
+	return result;
+}
+
+vector<int> HnswIndex::selectNeighbors(const vector<Candidate>& candidates, int count)
+{
+	vector<int> selected;
+	for (const Candidate& candidate : candidates)
+	{
+		if ((int)selected.size() >= count) break;
+
+		// 이미 고른 이웃 쪽이 더 가까우면 그 이웃을 거쳐 갈 수 있음
+		bool keep = true;
+		for (int other : selected)
+		{
+			if (squared(getVector(candidate.second), getVector(other), stride) < candidate.first)
+			{
+				keep = false;
+				break;
+			}
+		}
+		if (keep) selected.push_back(candidate.second);
+	}
+	return selected;
+}
+
+void HnswIndex::connect(int from, int to, int level)
+{
+	vector<int>& neighbors = links[from][level];
+	neighbors.push_back(to);
+
+	int limit = level == 0 ? mMax0 : m;
+	if ((int)neighbors.size() <= limit) return;
+
+	vector<Candidate> candidates;
+	const float* base = getVector(from);
+	for (int n : neighbors) candidates.push_back({ squared(base, getVector(n), stride), n });
+	sort(candidates.begin(), candidates.end());
+
+	neighbors = selectNeighbors(candidates, limit);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// data/models/embeddings.ksan (PATH_MODEL_FOLDER, Project_Tools ann-enroll)
+//   AnnFileHeader, 노드마다 AnnNodeHeader + float [dim] + level마다 (uint32 이웃 수 + int32 이웃...)
+// graph까지 저장하므로 load는 다시 만들지 않는다, 구조가 바뀌면 ANN_FILE_VERSION 증가
+#define ANN_INDEX_FILE_NAME "embeddings.ksan"
+#define ANN_FILE_MAGIC 0x414C534B // "KSLA"
+#define ANN_FILE_VERSION 1
+
+struct AnnFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t count;
+	uint32_t dim;
+	uint32_t m;
+	int32_t entry;
+	int32_t topLevel;
+	uint32_t reserved;
+};
+
+struct AnnNodeHeader
+{
+	int32_t label;
+	int32_t level;
+};
+
+static_assert(sizeof(AnnFileHeader) == 32, "AnnFileHeader layout");
+static_assert(sizeof(AnnNodeHeader) == 8, "AnnNodeHeader layout");
+
+// 임베딩 kNN 근사 검색 (HNSW : 계층 small-world graph)
+//
+// 노드마다 level을 확률로 정하고 (level l 이상일 확률 m^-l), level마다 가까운 이웃 m개 (level 0은 2m)를 잇는다.
+// add : 위 level부터 greedy로 내려오며 level마다 efConstruction개 후보 -> 이웃 선택 heuristic
+//       (이미 고른 이웃보다 질의에 더 가까운 후보만, 한쪽 cluster에 몰리지 않게), 양방향 연결 후 넘치면 다시 선택
+// search : 같은 방법으로 내려와 level 0에서 max(efSearch, k)개 후보 중 가까운 k개
+// 추가는 기존 노드를 건드리지 않고 graph에 끼워 넣으므로 (incremental) 분류 layer 재학습 없이 label을 늘릴 수 있다.
+//
+// 거리는 L2 제곱, 벡터는 8 float 단위로 0 padding (AVX2), SIMD는 InferenceKernels::isSimd()를 따른다.
+// search도 작업 버퍼를 쓰므로 add / load / search 모두 한 thread에서.
+class HnswIndex
+{
+public:
+	struct Match
+	{
+		int index;
+		int label;
+		float distance;
+	};
+
+private:
+	typedef pair<float, int> Candidate; // 거리, 노드
+
+	int m;
+	int mMax0; // level 0 이웃 최대
+	int efConstruction;
+	int efSearch;
+	double levelScale; // 1 / ln(m)
+
+	int dim = 0;
+	int stride = 0; // dim을 8 배수로
+
+	vector<int> labels;
+	vector<int> levels;
+	vector<float> vectors; // [node][stride]
+	vector<vector<vector<int>>> links; // [node][level] 이웃
+	int entry = -1;
+	int topLevel = -1;
+	mt19937 random;
+
+	// search 작업 버퍼
+	vector<float> query;
+	vector<uint32_t> visited;
+	uint32_t visitTag = 0;
+	int distanceCount = 0;
+
+public:
+	HnswIndex(int m = ANN_M, int efConstruction = ANN_EF_CONSTRUCTION, int efSearch = ANN_EF_SEARCH);
+
+	// 첫 벡터가 dim을 정함
+	bool add(int label, const float* values, int dim);
+	void clear();
+
+	bool load(const string& path);
+	bool save(const string& path);
+
+	int getCount();
+	int getLabelCount(); // 가장 큰 label + 1
+	int getDim();
+	int getLabel(int index);
+	int getTopLevel();
+
+	void setEfSearch(int ef);
+	int getEfSearch();
+
+	// 가까운 순서 k개 (근사)
+	vector<Match> search(const float* values, int k);
+	// 검증용 : 모든 노드와 비교
+	vector<Match> searchExact(const float* values, int k);
+
+	// 마지막 search에서 거리 계산 수
+	int getLastDistances();
+
+private:
+	const float* getVector(int index);
+	float distance(const float* a, int index);
+
+	void prepareQuery(const float* values);
+	void nextVisit();
+
+	// level 하나에서 starts부터 best-first, 가까운 순서 최대 ef개
+	vector<Candidate> searchLayer(const float* q, const vector<Candidate>& starts, int ef, int level);
+	// candidates : 가까운 순서
+	vector<int> selectNeighbors(const vector<Candidate>& candidates, int count);
+	void connect(int from, int to, int level);
+};
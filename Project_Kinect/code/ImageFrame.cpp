@@ -1,4 +1,5 @@
 #include "ImageFrame.h"
+#include "ExtractionConfig.h"
 
 ImageFrame::ImageFrame()
 {
@@ -8,16 +9,188 @@ void ImageFrame::memorize(cv::Mat image, TIMESPAN endtime)
 {
 	// this->image = image;
 	image.copyTo(this->image);
+	this->images.clear();
 	this->lastFrameRelativeTime = endtime;
+
+	measureSharpness();
 }
 
-void ImageFrame::save(string filepath)
+void ImageFrame::memorize(const vector<cv::Mat>& pyramid, TIMESPAN endtime)
+{
+	images.resize(pyramid.size());
+	for (int i = 0; i < (int)pyramid.size(); ++i)
+	{
+		pyramid[i].copyTo(images[i]);
+	}
+
+	image = images.size() > 0 ? images[baseScaleIndex()] : cv::Mat();
+	this->lastFrameRelativeTime = endtime;
+
+	measureSharpness();
+}
+
+// 帰(motion blur) cropϼ 2 ̺ л ۴
+void ImageFrame::measureSharpness()
 {
-	cv::Mat gray;
+	sharpness = 0;
+	motion = 0;
+	gray = cv::Mat();
+
+	if (image.empty()) return;
+
 	cv::cvtColor(image, gray, CV_RGB2GRAY);
-	cv::imwrite(filepath, gray);
+
+	cv::Mat laplacian;
+	cv::Scalar mean, stddev;
+	cv::Laplacian(gray, laplacian, CV_16S);
+	cv::meanStdDev(laplacian, mean, stddev);
+
+	sharpness = stddev[0] * stddev[0];
+}
+
+void ImageFrame::measureMotion(const ImageFrame& prev)
+{
+	if (gray.empty() || prev.gray.empty() || gray.size() != prev.gray.size())
+	{
+		motion = 0;
+		return;
+	}
+
+	cv::Mat diff;
+	cv::absdiff(gray, prev.gray, diff);
+
+	motion = cv::mean(diff)[0];
+}
+
+double ImageFrame::getSharpness()
+{
+	return sharpness;
+}
+
+double ImageFrame::getMotion()
+{
+	return motion;
+}
+
+void ImageFrame::makePyramid(const cv::Mat& roi, vector<cv::Mat>& pyramid)
+{
+	int scaleSize = getScaleSize();
+	pyramid.resize(scaleSize);
+
+	// crop  ū level   а,  level ٷ  level δ
+	const cv::Mat* src = &roi;
+	for (int i = 0; i < scaleSize; ++i)
+	{
+		int scale = getScale(i);
+		cv::resize(*src, pyramid[i], cv::Size(scale, scale), 0, 0, cv::INTER_AREA);
+		src = &pyramid[i];
+	}
+}
+
+bool ImageFrame::cropHand(const cv::Mat& src, float x, float y, float spinePx, vector<cv::Mat>& pyramid)
+{
+	float width = spinePx * ExtractionConfig::current().roiScale;
+	float height = width;
+
+	// ɿ 
+	cv::Rect roi((int)(x - width / 2), (int)(y - height / 2), (int)width, (int)height);
+
+	if (0 <= roi.x && 0 < roi.width && roi.x + roi.width <= src.cols && 0 <= roi.y && 0 < roi.height && roi.y + roi.height <= src.rows)
+	{
+		makePyramid(src(roi), pyramid);
+		return true;
+	}
+
+	return false;
+}
+
+int ImageFrame::baseScaleIndex()
+{
+	const ExtractionConfig& config = ExtractionConfig::current();
+
+	for (int i = 0; i < getScaleSize(); ++i)
+	{
+		if (getScale(i) == config.imageWidth) return i;
+	}
+
+	FAIL_STOP(0, "IMAGE_SCALES must contain IMAGE_WIDTH");
+	return 0;
 }
 
+int ImageFrame::getScale(int scaleIdx)
+{
+	return ExtractionConfig::current().imageScales[scaleIdx];
+}
+
+int ImageFrame::getScaleSize()
+{
+	return (int)ExtractionConfig::current().imageScales.size();
+}
+
+void ImageFrame::save(string filepath)
+{
+	save(filepath, baseScaleIndex());
+}
+
+void ImageFrame::save(string filepath, int scaleIdx)
+{
+	cv::Mat gray = getGray(scaleIdx);
+	if (gray.empty()) return;
+
+	writeImage(filepath, gray);
+}
+
+bool ImageFrame::writeImage(const string& filepath, const cv::Mat& mat)
+{
+	vector<uchar> buffer;
+	if (!cv::imencode(".bmp", mat, buffer)) return false;
+
+	return write_file_atomic(filepath, (const char*)buffer.data(), buffer.size());
+}
+
+
+void ImageFrame::setFlow(const cv::Mat& flow)
+{
+	this->flow = flow;
+}
+
+bool ImageFrame::hasFlow()
+{
+	return !flow.empty();
+}
+
+// bmp 2ä  : B = dx, G = dy, R = 128
+void ImageFrame::saveFlow(string filepath)
+{
+	if (flow.empty()) return;
+
+	cv::Mat channels[3];
+	cv::split(flow, channels);
+	channels[2] = cv::Mat(flow.size(), CV_8UC1, cv::Scalar(128));
+
+	cv::Mat merged;
+	cv::merge(channels, 3, merged);
+	writeImage(filepath, merged);
+}
+
+cv::Mat ImageFrame::getGray(int scaleIdx)
+{
+	if (scaleIdx == baseScaleIndex() && !gray.empty()) return gray;
+
+	cv::Mat src = scaleIdx < (int)images.size() ? images[scaleIdx] : cv::Mat();
+	if (src.empty() && scaleIdx == baseScaleIndex()) src = image;
+	if (src.empty()) return cv::Mat();
+
+	cv::Mat result;
+	cv::cvtColor(src, result, CV_RGB2GRAY);
+
+	return result;
+}
+
+cv::Mat ImageFrame::getFlow()
+{
+	return flow;
+}
 
 TIMESPAN ImageFrame::getTime()
 {
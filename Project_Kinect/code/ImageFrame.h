@@ -17,23 +17,58 @@ using namespace std;
 class ImageFrame
 {
 private:
-	cv::Mat image;
+	cv::Mat image; // IMAGE_WIDTH x IMAGE_HEIGHT (= images[baseScaleIndex()])
+	vector<cv::Mat> images; // IMAGE_SCALES 
+	cv::Mat flow; // CV_8UC2,    (OpticalFlowStage)
+	cv::Mat gray; // image gray,   
+	double sharpness = 0; // Laplacian variance
+	double motion = 0; //    mean abs diff
 	TIMESPAN lastFrameRelativeTime;
 
 public:
 	ImageFrame();
 
 	void memorize(cv::Mat image, TIMESPAN endtime);
+	void memorize(const vector<cv::Mat>& pyramid, TIMESPAN endtime);
+
+	// roi crop -> IMAGE_SCALES pyramid, level  resize 1ȸ
+	static void makePyramid(const cv::Mat& roi, vector<cv::Mat>& pyramid);
+
+	// (x, y) ߽,   spinePx * roiScale 簢 crop -> pyramid, ȭ ̸ false
+	static bool cropHand(const cv::Mat& src, float x, float y, float spinePx, vector<cv::Mat>& pyramid);
+
+	// ExtractionConfig::imageScales (⺻ IMAGE_SCALES)
+	static int baseScaleIndex();
+	static int getScale(int scaleIdx);
+	static int getScaleSize();
 
 	// ForFile
 	// string toString(int noting);
 	void save(string filename);
+	void save(string filename, int scaleIdx);
+
+	void setFlow(const cv::Mat& flow);
+	bool hasFlow();
+	void saveFlow(string filename);
+
+	// bmp encode  write_file_atomic (  )
+	static bool writeImage(const string& filepath, const cv::Mat& mat);
+
+	// Ǵ   gray / flow (SampleFile)
+	cv::Mat getGray(int scaleIdx);
+	cv::Mat getFlow();
 
 	TIMESPAN getTime();
 
+	// keyframe  
+	double getSharpness();
+	double getMotion();
+	void measureMotion(const ImageFrame& prev);
+
 	void LerpMe(float p, const ImageFrame &right);
 
 	void toString(stringstream &s, char delimeter);
 
 private:
+	void measureSharpness();
 };
\ No newline at end of file
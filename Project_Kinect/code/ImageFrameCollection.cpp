@@ -1,4 +1,5 @@
 #include "ImageFrameCollection.h"
+#include "ExtractionConfig.h"
 
 
 ImageFrameCollection::ImageFrameCollection()
@@ -15,18 +16,29 @@ void ImageFrameCollection::setLabel(string src)
 void ImageFrameCollection::stackFrame(const ImageFrame& f)
 {
 	collection.push_back(f);
+
+	if (collection.size() > 1)
+	{
+		collection.back().measureMotion(collection[collection.size() - 2]);
+	}
 }
 
 void ImageFrameCollection::setStandard(TIMESPAN startTime)
 {
 	if (collection.size() < 2) return;
 
+	if (ExtractionConfig::current().imageSelectMode != IMAGE_SELECT_UNIFORM)
+	{
+		setStandardByScore(startTime);
+		return;
+	}
+
 	vector<ImageFrame> result = vector<ImageFrame>();
 	ImageFrame temp;
 	TIMESPAN timeLine;
 	TIMESPAN endTime = collection[collection.size() - 1].getTime();
 
-	int dt = (int)(endTime - startTime) / (IMAEG_STANDARD_FRAME_SIZE);
+	int dt = (int)(endTime - startTime) / (ExtractionConfig::current().imageStandardSize);
 	timeLine = startTime + dt;
 
 	double percent = 0;
@@ -62,20 +74,207 @@ void ImageFrameCollection::setStandard(TIMESPAN startTime)
 
 	//cout << cnt << endl;
 	collection = result;
+
+	timeline.clear();
+	for (ImageFrame& f : collection) timeline.push_back(f.getTime());
+}
+
+
+// ü  IMAEG_STANDARD_FRAME_SIZE ð bin  bin     
+void ImageFrameCollection::setStandardByScore(TIMESPAN startTime)
+{
+	vector<TIMESPAN> binEnds = vector<TIMESPAN>();
+	TIMESPAN endTime = collection[collection.size() - 1].getTime();
+	int binSize = ExtractionConfig::current().imageStandardSize;
+	double dt = (double)(endTime - startTime) / binSize;
+
+	for (int bin = 0; bin < binSize; ++bin)
+	{
+		binEnds.push_back(startTime + (TIMESPAN)(dt * (bin + 1)));
+	}
+
+	setStandard(binEnds);
+}
+
+// bin k = (binEnds[k - 1], binEnds[k]),  bin   
+// IMAGE_SELECT_UNIFORM̸ bin   , ƴϸ bin   ְ 
+//   bin bin     (uniform  ) ä
+void ImageFrameCollection::setStandard(const vector<TIMESPAN>& binEnds)
+{
+	if (collection.size() < 2) return;
+
+	vector<ImageFrame> result = vector<ImageFrame>();
+	int binSize = (int)binEnds.size();
+	int size = (int)collection.size();
+	int idx = 0;
+
+	result.reserve(binSize);
+	timeline.clear();
+
+	for (int bin = 0; bin < binSize; ++bin)
+	{
+		bool isLast = (bin == binSize - 1);
+		int best = -1;
+		double bestScore = -1;
+
+		while (idx < size && (collection[idx].getTime() < binEnds[bin] || isLast))
+		{
+			double score = selectScore(collection[idx]);
+			if (score > bestScore)
+			{
+				bestScore = score;
+				best = idx;
+			}
+			++idx;
+		}
+
+		if (best < 0 || ExtractionConfig::current().imageSelectMode == IMAGE_SELECT_UNIFORM) best = max(idx - 1, 0);
+
+		result.push_back(collection[best]);
+		timeline.push_back(collection[best].getTime());
+	}
+
+	collection = result;
 }
 
+vector<TIMESPAN> ImageFrameCollection::getTimeline()
+{
+	return timeline;
+}
+
+double ImageFrameCollection::selectScore(ImageFrame& f)
+{
+	if (ExtractionConfig::current().imageSelectMode == IMAGE_SELECT_MOTION) return f.getMotion();
+
+	return f.getSharpness();
+}
 
 // 76_L.bmp
+// IMAGE_WIDTH  scale   , e.g. 140x140/76.bmp
+// optical flow flow/76.bmp
 void ImageFrameCollection::save(string dirpath, int numberPadding)
 {
-	string fileName;
+	int size = (int)collection.size(); // FRAME_STANDARD_ADAPTIVE̸ IMAEG_STANDARD_FRAME_SIZE 
+	bool hasFlow = size > 0 && collection[0].hasFlow();
 
-	for (int j = 0; j < IMAEG_STANDARD_FRAME_SIZE; ++j)
+	int scaleSize = ImageFrame::getScaleSize();
+	vector<string> scaleDirs = vector<string>(scaleSize);
+	for (int s = 0; s < scaleSize; ++s)
 	{
-		fileName = to_string(numberPadding + j);
+		if (s == ImageFrame::baseScaleIndex())
+		{
+			scaleDirs[s] = dirpath;
+			continue;
+		}
 
-		collection[j].save(dirpath + fileName + ".bmp");
+		scaleDirs[s] = dirpath + getScaleDirName(s) + "/";
+		_mkdir(scaleDirs[s].c_str());
 	}
+
+	if (hasFlow) _mkdir((dirpath + "flow").c_str());
+
+	//    encode, ϸ temp -> rename
+	Concurrency::parallel_for(0, size, [&](int j)
+	{
+		string fileName = to_string(numberPadding + j) + ".bmp";
+
+		for (int s = 0; s < scaleSize; ++s)
+		{
+			collection[j].save(scaleDirs[s] + fileName, s);
+		}
+
+		if (hasFlow) collection[j].saveFlow(dirpath + "flow/" + fileName);
+	});
+}
+
+void ImageFrameCollection::setFlow(int idx, const cv::Mat& flow)
+{
+	if (idx < 0 || idx >= (int)collection.size()) return;
+
+	collection[idx].setFlow(flow);
+}
+
+void ImageFrameCollection::getGrays(int scaleIdx, vector<cv::Mat>& grays)
+{
+	grays.resize(collection.size());
+
+	Concurrency::parallel_for(0, (int)collection.size(), [&](int j)
+	{
+		grays[j] = collection[j].getGray(scaleIdx);
+
+		//    0 (codec   ũⰡ ƾ )
+		if (grays[j].empty())
+		{
+			int scale = ImageFrame::getScale(scaleIdx);
+			grays[j] = cv::Mat::zeros(scale, scale, CV_8UC1);
+		}
+	});
+}
+
+bool ImageFrameCollection::encode(int scaleIdx, RoiCodec& codec, vector<uint8_t>& out)
+{
+	vector<cv::Mat> grays;
+	getGrays(scaleIdx, grays);
+
+	return codec.encode(grays, out);
+}
+
+void ImageFrameCollection::benchmarkCodec(RoiCodec& codec)
+{
+	vector<cv::Mat> grays;
+	getGrays(ImageFrame::baseScaleIndex(), grays);
+	if (grays.empty()) return;
+
+	size_t raw = grays.size() * grays[0].total();
+	string formats[2] = { ".bmp", ".png" };
+
+	cout << "[ROI codec] " << grays.size() << " frames, raw " << raw << " byte" << endl;
+
+	for (string& format : formats)
+	{
+		size_t size = 0;
+		vector<uchar> buffer;
+		auto start = chrono::high_resolution_clock::now();
+
+		for (cv::Mat& gray : grays)
+		{
+			cv::imencode(format, gray, buffer);
+			size += buffer.size();
+		}
+
+		double ms = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+		cout << "  " << format << " : " << size << " byte (x" << (double)raw / size << "), " << ms << " ms" << endl;
+	}
+
+	vector<uint8_t> encoded;
+	vector<cv::Mat> decoded;
+
+	auto start = chrono::high_resolution_clock::now();
+	codec.encode(grays, encoded);
+	auto middle = chrono::high_resolution_clock::now();
+	bool ok = codec.decode(encoded.data(), encoded.size(), decoded);
+	auto end = chrono::high_resolution_clock::now();
+
+	for (int j = 0; ok && j < (int)grays.size(); ++j)
+	{
+		ok = cv::countNonZero(grays[j] != decoded[j]) == 0;
+	}
+
+	cout << "  " << codec.getName() << " : " << encoded.size() << " byte (x" << (double)raw / encoded.size() << "), encode "
+		<< chrono::duration<double, milli>(middle - start).count() << " ms, decode "
+		<< chrono::duration<double, milli>(end - middle).count() << " ms, lossless " << ok << endl;
+}
+
+string ImageFrameCollection::getScaleDirName(int scaleIdx)
+{
+	int scale = ImageFrame::getScale(scaleIdx);
+
+	return to_string(scale) + "x" + to_string(scale);
+}
+
+ImageFrame& ImageFrameCollection::getFrame(int idx)
+{
+	return collection[idx];
 }
 
 int ImageFrameCollection::getCollectionSize()
@@ -86,6 +285,7 @@ int ImageFrameCollection::getCollectionSize()
 void ImageFrameCollection::clear()
 {
 	collection.clear();
+	timeline.clear();
 }
 
 string ImageFrameCollection::getLabel()
@@ -4,17 +4,21 @@
 #include <array>
 #include <vector>
 #include <string>
+#include <direct.h> // _mkdir
+#include <ppl.h> // parallel_for
 using namespace std;
 
 #include "common/defines.hpp"
 #include "common/LabelMapper.h"
 #include "ImageFrame.h"
+#include "RoiCodec.h"
 
 
 class ImageFrameCollection
 {
 private:
 	vector<ImageFrame> collection = vector<ImageFrame>();
+	vector<TIMESPAN> timeline; // setStandard õ   (Times.txt)
 	string label;
 
 public:
@@ -27,12 +31,28 @@ public:
 	// array<string, Show_Status_DistanceFrame_Size> lastFrameToString();
 
 	void setStandard(TIMESPAN startTime);  // ǥȭ (FrameSize, Lerp)
+	void setStandard(const vector<TIMESPAN>& binEnds); // bin 1  (IMAGE_SELECT_MODE)
+
+	vector<TIMESPAN> getTimeline();
 
 	// save image frames
 
 	void save(string dirpath, int);
 
+	static string getScaleDirName(int scaleIdx);
+
+	void setFlow(int idx, const cv::Mat& flow);
+
+	// scale gray   (RoiCodec)
+	void getGrays(int scaleIdx, vector<cv::Mat>& grays);
+	bool encode(int scaleIdx, RoiCodec& codec, vector<uint8_t>& out);
+
+	// BENCHMARK_ROI_CODEC : base scale bmp, png, codec encodeؼ ũ/ð 
+	void benchmarkCodec(RoiCodec& codec);
+
 	int getCollectionSize();
+
+	ImageFrame& getFrame(int idx);
 	
 	void clear();
 
@@ -41,5 +61,9 @@ public:
 	void toStream(stringstream&, char delimeter);
 
 private:
+	// IMAGE_SELECT_SHARPEST, IMAGE_SELECT_MOTION
+	void setStandardByScore(TIMESPAN startTime);
+
+	double selectScore(ImageFrame& f);
 
 };
\ No newline at end of file
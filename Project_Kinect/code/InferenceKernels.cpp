@@ -0,0 +1,598 @@
+#include "InferenceKernels.h"
+
+#include <ppl.h> // parallel_for
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef INFERENCE_AVX2
+#include <immintrin.h>
+#include <intrin.h> // __cpuid, _xgetbv
+#endif
+
+namespace
+{
+	bool simdEnabled = true;
+	bool int8SimdEnabled = true;
+	bool vnniEnabled = true;
+
+	// dense kernel 조각 : 입력 512행 x 출력 16열 x 4byte = 32KB (L1)
+	const int DENSE_K_BLOCK = 512;
+	// 이보다 작은 dense는 parallel_for 없이 (LSTM 한 step 등은 넘는다)
+	const size_t DENSE_PARALLEL_MAC = 1 << 16;
+
+	//------------------------------------------------------------------------------
+	// scalar
+	//------------------------------------------------------------------------------
+
+	void convScalar(const float* src, int rowStride, int cin, const float* kernel, const float* bias,
+		int kh, int kw, int sh, int sw, float* out, int oh, int ow, int cout)
+	{
+		for (int oy = 0; oy < oh; ++oy)
+		{
+			for (int ox = 0; ox < ow; ++ox)
+			{
+				const float* p = src + oy * sh * rowStride + ox * sw * cin;
+				float* o = out + (oy * ow + ox) * cout;
+
+				for (int oc = 0; oc < cout; ++oc) o[oc] = bias ? bias[oc] : 0;
+
+				for (int ky = 0; ky < kh; ++ky)
+				{
+					for (int kx = 0; kx < kw; ++kx)
+					{
+						const float* q = p + ky * rowStride + kx * cin;
+						const float* w = kernel + (ky * kw + kx) * cin * cout;
+
+						for (int ci = 0; ci < cin; ++ci, w += cout)
+						{
+							float v = q[ci];
+							for (int oc = 0; oc < cout; ++oc) o[oc] += v * w[oc];
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void denseScalar(const float* in, int rows, int inSize, const float* kernel, const float* bias, float* out, int outSize)
+	{
+		for (int r = 0; r < rows; ++r)
+		{
+			const float* x = in + (size_t)r * inSize;
+			float* y = out + (size_t)r * outSize;
+
+			for (int o = 0; o < outSize; ++o) y[o] = bias ? bias[o] : 0;
+
+			for (int k = 0; k < inSize; ++k)
+			{
+				float v = x[k];
+				const float* w = kernel + (size_t)k * outSize;
+				for (int o = 0; o < outSize; ++o) y[o] += v * w[o];
+			}
+		}
+	}
+
+	// patch [kpad] u8 x kernel [cout][kpad] s8 -> o[oc] = 합 x scales[oc] + bias[oc]
+	void dotInt8Scalar(const uint8_t* patch, const int8_t* kernel, int kpad, int cout, const float* scales, const float* bias, float* o)
+	{
+		for (int oc = 0; oc < cout; ++oc)
+		{
+			const int8_t* w = kernel + (size_t)oc * kpad;
+			int32_t sum = 0;
+			for (int k = 0; k < kpad; ++k) sum += patch[k] * w[k];
+			o[oc] = sum * scales[oc] + (bias ? bias[oc] : 0);
+		}
+	}
+
+#ifdef INFERENCE_AVX2
+	//------------------------------------------------------------------------------
+	// AVX2 + FMA
+	//------------------------------------------------------------------------------
+
+	// P픽셀 (x stride pixelStep) x N*8 채널, acc[P][N]은 register
+	template <int P, int N>
+	inline void convTile(const float* p, int pixelStep, int rowStride, int cin, const float* kernel, const float* bias,
+		int kh, int kw, float* o, int cout)
+	{
+		__m256 acc[P][N];
+		for (int n = 0; n < N; ++n)
+		{
+			__m256 b = bias ? _mm256_loadu_ps(bias + n * 8) : _mm256_setzero_ps();
+			for (int i = 0; i < P; ++i) acc[i][n] = b;
+		}
+
+		for (int ky = 0; ky < kh; ++ky)
+		{
+			for (int kx = 0; kx < kw; ++kx)
+			{
+				const float* q = p + ky * rowStride + kx * cin;
+				const float* w = kernel + (ky * kw + kx) * cin * cout;
+
+				for (int ci = 0; ci < cin; ++ci, w += cout)
+				{
+					__m256 wv[N];
+					for (int n = 0; n < N; ++n) wv[n] = _mm256_loadu_ps(w + n * 8);
+
+					for (int i = 0; i < P; ++i)
+					{
+						__m256 v = _mm256_broadcast_ss(q + i * pixelStep + ci);
+						for (int n = 0; n < N; ++n) acc[i][n] = _mm256_fmadd_ps(v, wv[n], acc[i][n]);
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < P; ++i)
+		{
+			for (int n = 0; n < N; ++n) _mm256_storeu_ps(o + i * cout + n * 8, acc[i][n]);
+		}
+	}
+
+	// 8의 배수가 아닌 나머지 채널 (B1C2 18, B1C3 20)
+	template <int P>
+	void convTail(const float* p, int pixelStep, int rowStride, int cin, const float* kernel, const float* bias,
+		int kh, int kw, float* o, int cout, int oc)
+	{
+		for (; oc < cout; ++oc)
+		{
+			for (int i = 0; i < P; ++i)
+			{
+				float sum = bias ? bias[oc] : 0;
+				for (int ky = 0; ky < kh; ++ky)
+				{
+					for (int kx = 0; kx < kw; ++kx)
+					{
+						const float* q = p + i * pixelStep + ky * rowStride + kx * cin;
+						const float* w = kernel + (ky * kw + kx) * cin * cout + oc;
+						for (int ci = 0; ci < cin; ++ci) sum += q[ci] * w[ci * cout];
+					}
+				}
+				o[i * cout + oc] = sum;
+			}
+		}
+	}
+
+	template <int P>
+	void convPixels(const float* p, int pixelStep, int rowStride, int cin, const float* kernel, const float* bias,
+		int kh, int kw, float* o, int cout)
+	{
+		int oc = 0;
+		for (; oc + 16 <= cout; oc += 16)
+		{
+			convTile<P, 2>(p, pixelStep, rowStride, cin, kernel + oc, bias ? bias + oc : nullptr, kh, kw, o + oc, cout);
+		}
+		for (; oc + 8 <= cout; oc += 8)
+		{
+			convTile<P, 1>(p, pixelStep, rowStride, cin, kernel + oc, bias ? bias + oc : nullptr, kh, kw, o + oc, cout);
+		}
+		convTail<P>(p, pixelStep, rowStride, cin, kernel, bias, kh, kw, o, cout, oc);
+	}
+
+	void convAvx2(const float* src, int rowStride, int cin, const float* kernel, const float* bias,
+		int kh, int kw, int sh, int sw, float* out, int oh, int ow, int cout)
+	{
+		int pixelStep = sw * cin;
+
+		for (int oy = 0; oy < oh; ++oy)
+		{
+			const float* row = src + oy * sh * rowStride;
+			int ox = 0;
+
+			for (; ox + 4 <= ow; ox += 4)
+			{
+				convPixels<4>(row + ox * pixelStep, pixelStep, rowStride, cin, kernel, bias, kh, kw, out + (oy * ow + ox) * cout, cout);
+			}
+			for (; ox < ow; ++ox)
+			{
+				convPixels<1>(row + ox * pixelStep, pixelStep, rowStride, cin, kernel, bias, kh, kw, out + (oy * ow + ox) * cout, cout);
+			}
+		}
+	}
+
+	// R행 x N*8열, k0 ~ k1 구간만 더한다 (k0 == 0이면 bias부터)
+	template <int R, int N>
+	inline void denseTile(const float* in, int inSize, const float* kernel, const float* bias, float* out, int outSize, int k0, int k1)
+	{
+		__m256 acc[R][N];
+		for (int r = 0; r < R; ++r)
+		{
+			for (int n = 0; n < N; ++n)
+			{
+				acc[r][n] = k0 > 0 ? _mm256_loadu_ps(out + (size_t)r * outSize + n * 8)
+					: (bias ? _mm256_loadu_ps(bias + n * 8) : _mm256_setzero_ps());
+			}
+		}
+
+		const float* w = kernel + (size_t)k0 * outSize;
+		for (int k = k0; k < k1; ++k, w += outSize)
+		{
+			__m256 wv[N];
+			for (int n = 0; n < N; ++n) wv[n] = _mm256_loadu_ps(w + n * 8);
+
+			for (int r = 0; r < R; ++r)
+			{
+				__m256 v = _mm256_broadcast_ss(in + (size_t)r * inSize + k);
+				for (int n = 0; n < N; ++n) acc[r][n] = _mm256_fmadd_ps(v, wv[n], acc[r][n]);
+			}
+		}
+
+		for (int r = 0; r < R; ++r)
+		{
+			for (int n = 0; n < N; ++n) _mm256_storeu_ps(out + (size_t)r * outSize + n * 8, acc[r][n]);
+		}
+	}
+
+	template <int N>
+	void denseColumns(const float* in, int rows, int inSize, const float* kernel, const float* bias, float* out, int outSize, int oc)
+	{
+		for (int k0 = 0; k0 < inSize; k0 += DENSE_K_BLOCK)
+		{
+			int k1 = min(k0 + DENSE_K_BLOCK, inSize);
+			int r = 0;
+
+			for (; r + 4 <= rows; r += 4)
+			{
+				denseTile<4, N>(in + (size_t)r * inSize, inSize, kernel + oc, bias ? bias + oc : nullptr, out + (size_t)r * outSize + oc, outSize, k0, k1);
+			}
+			for (; r < rows; ++r)
+			{
+				denseTile<1, N>(in + (size_t)r * inSize, inSize, kernel + oc, bias ? bias + oc : nullptr, out + (size_t)r * outSize + oc, outSize, k0, k1);
+			}
+		}
+	}
+
+	void denseAvx2(const float* in, int rows, int inSize, const float* kernel, const float* bias, float* out, int outSize)
+	{
+		int blocks = outSize / 16;
+		auto block = [&](int b)
+		{
+			denseColumns<2>(in, rows, inSize, kernel, bias, out, outSize, b * 16);
+		};
+
+		if ((size_t)rows * inSize * outSize >= DENSE_PARALLEL_MAC && blocks > 1) Concurrency::parallel_for(0, blocks, block);
+		else for (int b = 0; b < blocks; ++b) block(b);
+
+		int oc = blocks * 16;
+		if (oc + 8 <= outSize)
+		{
+			denseColumns<1>(in, rows, inSize, kernel, bias, out, outSize, oc);
+			oc += 8;
+		}
+
+		// 나머지 열 (label 수 등)
+		for (int r = 0; r < rows && oc < outSize; ++r)
+		{
+			const float* x = in + (size_t)r * inSize;
+			for (int o = oc; o < outSize; ++o)
+			{
+				float sum = bias ? bias[o] : 0;
+				for (int k = 0; k < inSize; ++k) sum += x[k] * kernel[(size_t)k * outSize + o];
+				out[(size_t)r * outSize + o] = sum;
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	// int8 (u7 x s8, 32 byte씩)
+	//------------------------------------------------------------------------------
+
+	// u8 x s8 인접 2쌍 합 (s16, u7이라 포화 없음) -> 인접 2개 합 (s32)
+	struct MaddAvx2
+	{
+		__m256i ones = _mm256_set1_epi16(1);
+
+		__m256i operator()(__m256i acc, __m256i u, __m256i s) const
+		{
+			return _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(u, s), ones));
+		}
+	};
+
+#ifdef INFERENCE_VNNI
+	// AVX512-VNNI (VL) : u8 x s8 4쌍 합을 s32에 바로 누적
+	struct MaddVnni
+	{
+		__m256i operator()(__m256i acc, __m256i u, __m256i s) const
+		{
+			return _mm256_dpbusd_epi32(acc, u, s);
+		}
+	};
+#endif
+
+	// acc 4개 -> 각각의 합 [4]
+	inline __m128i sum4(__m256i a0, __m256i a1, __m256i a2, __m256i a3)
+	{
+		__m256i s = _mm256_hadd_epi32(_mm256_hadd_epi32(a0, a1), _mm256_hadd_epi32(a2, a3));
+		return _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+	}
+
+	// patch 32 byte를 한 번 load해서 출력 4채널에
+	template <class Madd>
+	void dotInt8(const uint8_t* patch, const int8_t* kernel, int kpad, int cout, const float* scales, const float* bias, float* o)
+	{
+		Madd madd;
+		__m256i zero = _mm256_setzero_si256();
+		int oc = 0;
+
+		for (; oc + 4 <= cout; oc += 4)
+		{
+			const int8_t* w = kernel + (size_t)oc * kpad;
+			__m256i a0 = zero, a1 = zero, a2 = zero, a3 = zero;
+
+			for (int k = 0; k < kpad; k += 32)
+			{
+				__m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(patch + k));
+				a0 = madd(a0, p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k)));
+				a1 = madd(a1, p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + kpad + k)));
+				a2 = madd(a2, p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 2 * kpad + k)));
+				a3 = madd(a3, p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 3 * kpad + k)));
+			}
+
+			__m128 v = _mm_mul_ps(_mm_cvtepi32_ps(sum4(a0, a1, a2, a3)), _mm_loadu_ps(scales + oc));
+			_mm_storeu_ps(o + oc, bias ? _mm_add_ps(v, _mm_loadu_ps(bias + oc)) : v);
+		}
+
+		for (; oc < cout; ++oc)
+		{
+			const int8_t* w = kernel + (size_t)oc * kpad;
+			__m256i a = zero;
+			for (int k = 0; k < kpad; k += 32)
+			{
+				a = madd(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(patch + k)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k)));
+			}
+			o[oc] = _mm_cvtsi128_si32(sum4(a, zero, zero, zero)) * scales[oc] + (bias ? bias[oc] : 0);
+		}
+	}
+#endif
+}
+
+bool InferenceKernels::hasAvx2()
+{
+#ifdef INFERENCE_AVX2
+	static const bool supported = []
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+
+		// FMA, OSXSAVE, AVX + OS가 ymm 저장
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 12)) == 0 || (info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+		if ((_xgetbv(0) & 6) != 6) return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}();
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+bool InferenceKernels::hasVnni()
+{
+#if defined(INFERENCE_AVX2) && defined(INFERENCE_VNNI)
+	static const bool supported = []
+	{
+		if (!hasAvx2()) return false;
+
+		// OS가 opmask / zmm 저장
+		if ((_xgetbv(0) & 0xe6) != 0xe6) return false;
+
+		// AVX512F, AVX512VL, AVX512-VNNI
+		int info[4];
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 16)) != 0 && ((unsigned)info[1] >> 31) != 0 && (info[2] & (1 << 11)) != 0;
+	}();
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+void InferenceKernels::setSimd(bool enable)
+{
+	simdEnabled = enable;
+}
+
+bool InferenceKernels::isSimd()
+{
+	return simdEnabled && hasAvx2();
+}
+
+void InferenceKernels::setInt8Simd(bool enable)
+{
+	int8SimdEnabled = enable;
+}
+
+bool InferenceKernels::isInt8Simd()
+{
+	return int8SimdEnabled && isSimd();
+}
+
+void InferenceKernels::setVnni(bool enable)
+{
+	vnniEnabled = enable;
+}
+
+bool InferenceKernels::isVnni()
+{
+	return vnniEnabled && isInt8Simd() && hasVnni();
+}
+
+void InferenceKernels::conv2d(const float* in, int h, int w, int cin,
+	const float* kernel, const float* bias, int kh, int kw, int sh, int sw, int padTop, int padLeft,
+	float* out, int oh, int ow, int cout, int activation, float* padded)
+{
+	// 필요한 만큼만 padding (same이면 뒤쪽은 stride에 따라 0 ~ k-1)
+	int ph = max((oh - 1) * sh + kh, h + padTop);
+	int pw = max((ow - 1) * sw + kw, w + padLeft);
+	int rowStride = pw * cin;
+
+	const float* src = in;
+	if (padTop > 0 || padLeft > 0 || ph > h || pw > w)
+	{
+		memset(padded, 0, sizeof(float) * ph * rowStride);
+		for (int y = 0; y < h; ++y)
+		{
+			memcpy(padded + (y + padTop) * rowStride + padLeft * cin, in + y * w * cin, sizeof(float) * w * cin);
+		}
+		src = padded;
+	}
+	else rowStride = w * cin;
+
+#ifdef INFERENCE_AVX2
+	if (isSimd()) convAvx2(src, rowStride, cin, kernel, bias, kh, kw, sh, sw, out, oh, ow, cout);
+	else
+#endif
+	convScalar(src, rowStride, cin, kernel, bias, kh, kw, sh, sw, out, oh, ow, cout);
+
+	activate(out, (size_t)oh * ow * cout, cout, activation);
+}
+
+void InferenceKernels::conv2dInt8(const float* in, int h, int w, int cin, float inputScale,
+	const int8_t* kernel, int kpad, const float* scales, const float* bias, int kh, int kw, int sh, int sw, int padTop, int padLeft,
+	float* out, int oh, int ow, int cout, int activation, uint8_t* padded, uint8_t* patch)
+{
+	int ph = max((oh - 1) * sh + kh, h + padTop);
+	int pw = max((ow - 1) * sw + kw, w + padLeft);
+	int rowStride = pw * cin;
+
+	// u7, padding 0은 입력 0
+	memset(padded, 0, (size_t)ph * rowStride);
+	float inverse = 1.0f / inputScale;
+	for (int y = 0; y < h; ++y)
+	{
+		const float* src = in + y * w * cin;
+		uint8_t* dst = padded + (y + padTop) * rowStride + padLeft * cin;
+		for (int i = 0; i < w * cin; ++i) dst[i] = (uint8_t)min(max((int)(src[i] * inverse + 0.5f), 0), 127);
+	}
+
+	auto dot = dotInt8Scalar;
+#ifdef INFERENCE_AVX2
+	if (isInt8Simd()) dot = dotInt8<MaddAvx2>;
+#ifdef INFERENCE_VNNI
+	if (isVnni()) dot = dotInt8<MaddVnni>;
+#endif
+#endif
+
+	// 출력 픽셀마다 kh행 x (kw x cin) byte를 patch로 모음, 뒤 kpad까지는 0
+	int rowBytes = kw * cin;
+	memset(patch + kh * rowBytes, 0, kpad - kh * rowBytes);
+
+	for (int oy = 0; oy < oh; ++oy)
+	{
+		for (int ox = 0; ox < ow; ++ox)
+		{
+			const uint8_t* p = padded + oy * sh * rowStride + ox * sw * cin;
+			for (int ky = 0; ky < kh; ++ky) memcpy(patch + ky * rowBytes, p + ky * rowStride, rowBytes);
+
+			dot(patch, kernel, kpad, cout, scales, bias, out + (oy * ow + ox) * cout);
+		}
+	}
+
+	activate(out, (size_t)oh * ow * cout, cout, activation);
+}
+
+int InferenceKernels::int8Stride(int size)
+{
+	return (size + 31) / 32 * 32;
+}
+
+void InferenceKernels::dense(const float* in, int rows, int inSize, const float* kernel, const float* bias,
+	float* out, int outSize, int activation)
+{
+#ifdef INFERENCE_AVX2
+	if (isSimd()) denseAvx2(in, rows, inSize, kernel, bias, out, outSize);
+	else
+#endif
+	denseScalar(in, rows, inSize, kernel, bias, out, outSize);
+
+	activate(out, (size_t)rows * outSize, outSize, activation);
+}
+
+void InferenceKernels::maxpool2d(const float* in, int h, int w, int c, int ph, int pw, int sh, int sw, float* out, int oh, int ow)
+{
+	for (int oy = 0; oy < oh; ++oy)
+	{
+		for (int ox = 0; ox < ow; ++ox)
+		{
+			float* o = out + (oy * ow + ox) * c;
+			const float* first = in + (oy * sh * w + ox * sw) * c;
+			memcpy(o, first, sizeof(float) * c);
+
+			for (int y = 0; y < ph; ++y)
+			{
+				for (int x = 0; x < pw; ++x)
+				{
+					const float* p = in + ((oy * sh + y) * w + ox * sw + x) * c;
+					for (int k = 0; k < c; ++k) o[k] = max(o[k], p[k]);
+				}
+			}
+		}
+	}
+}
+
+void InferenceKernels::affine(float* data, size_t count, int channels, const float* scale, const float* shift, int activation)
+{
+	for (size_t i = 0; i < count; i += channels)
+	{
+		float* p = data + i;
+		for (int c = 0; c < channels; ++c) p[c] = p[c] * scale[c] + shift[c];
+	}
+
+	activate(data, count, channels, activation);
+}
+
+void InferenceKernels::activate(float* data, size_t count, int channels, int activation)
+{
+	switch (activation)
+	{
+	case MODEL_ACTIVATION_RELU:
+		for (size_t i = 0; i < count; ++i) data[i] = max(data[i], 0.0f);
+		break;
+
+	case MODEL_ACTIVATION_TANH:
+		for (size_t i = 0; i < count; ++i) data[i] = tanh(data[i]);
+		break;
+
+	case MODEL_ACTIVATION_SIGMOID:
+		for (size_t i = 0; i < count; ++i) data[i] = 1.0f / (1.0f + exp(-data[i]));
+		break;
+
+	case MODEL_ACTIVATION_HARD_SIGMOID:
+		for (size_t i = 0; i < count; ++i) data[i] = min(max(0.2f * data[i] + 0.5f, 0.0f), 1.0f);
+		break;
+
+	case MODEL_ACTIVATION_SOFTMAX:
+		for (size_t i = 0; i < count; i += channels)
+		{
+			float* p = data + i;
+			float top = *max_element(p, p + channels);
+			float sum = 0;
+
+			for (int c = 0; c < channels; ++c)
+			{
+				p[c] = exp(p[c] - top);
+				sum += p[c];
+			}
+			for (int c = 0; c < channels; ++c) p[c] /= sum;
+		}
+		break;
+
+	default: // MODEL_ACTIVATION_LINEAR
+		break;
+	}
+}
+
+int InferenceKernels::samePadding(int size, int kernel, int stride, int* total)
+{
+	int out = (size + stride - 1) / stride;
+	int pad = max((out - 1) * stride + kernel - size, 0);
+
+	if (total) *total = pad;
+
+	return pad / 2;
+}
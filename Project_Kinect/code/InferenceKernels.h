@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "ModelFormat.h"
+
+// InferenceModel이 쓰는 float 연산 (channels_last, row-major)
+//
+// INFERENCE_AVX2가 켜져 있고 CPU가 AVX2 + FMA를 지원하면 AVX2 kernel, 아니면 scalar.
+// 둘은 합산 순서만 다르다 (infer-parity에서 setSimd(false)로 비교).
+//
+// conv2d : 입력을 padding된 버퍼에 복사한 뒤 valid conv, 출력 4픽셀 x 16채널을 register에 두고 (kernel 한 번 load -> 4픽셀에 사용)
+// conv2dInt8 : InferenceModel::quantize 된 conv, AVX512-VNNI (INFERENCE_VNNI) > AVX2 maddubs > scalar, 셋의 정수 합은 같다 (setInt8Simd / setVnni로 고름)
+// dense  : 출력 16열 x 입력 DENSE_K_BLOCK 행 kernel 조각이 L1에 남아 있는 동안 모든 row(4개씩)를 지나간다
+class InferenceKernels
+{
+public:
+	static bool hasAvx2(); // INFERENCE_AVX2 && CPU 지원
+	static void setSimd(bool enable); // false : scalar 강제 (parity 비교)
+	static bool isSimd();
+	static void setInt8Simd(bool enable); // false : conv2dInt8만 scalar, float kernel은 그대로 (quant-eval 비교)
+	static bool isInt8Simd();
+	static bool hasVnni(); // INFERENCE_VNNI && CPU가 AVX512-VNNI + VL 지원
+	static void setVnni(bool enable); // false : int8도 AVX2 (quant-eval 비교)
+	static bool isVnni();
+
+	// 한 장 in [h, w, cin] -> out [oh, ow, cout], kernel [kh, kw, cin, cout]
+	// padded : (h + padTop + padBottom) x (w + padLeft + padRight) x cin 이상, 호출측 작업 버퍼
+	static void conv2d(const float* in, int h, int w, int cin,
+		const float* kernel, const float* bias, int kh, int kw, int sh, int sw, int padTop, int padLeft,
+		float* out, int oh, int ow, int cout, int activation, float* padded);
+
+	// conv2d와 같은 계산을 int8로, 입력은 round(x / inputScale)를 0 ~ 127 (u7 : maddubs의 s16 합이 포화하지 않는다)
+	// kernel [cout][kpad] s8 (출력 채널마다 [kh, kw, cin], 뒤는 0), out = 정수 합 x scales[oc] + bias[oc]
+	// padded : conv2d의 padded와 같은 개수의 byte, patch : kpad byte
+	static void conv2dInt8(const float* in, int h, int w, int cin, float inputScale,
+		const int8_t* kernel, int kpad, const float* scales, const float* bias, int kh, int kw, int sh, int sw, int padTop, int padLeft,
+		float* out, int oh, int ow, int cout, int activation, uint8_t* padded, uint8_t* patch);
+
+	// conv2dInt8 kernel 한 채널 길이 (32의 배수)
+	static int int8Stride(int size);
+
+	// in [rows, inSize] x kernel [inSize, outSize] + bias -> out [rows, outSize]
+	static void dense(const float* in, int rows, int inSize, const float* kernel, const float* bias,
+		float* out, int outSize, int activation);
+
+	// 한 장 in [h, w, c] -> out [oh, ow, c], valid
+	static void maxpool2d(const float* in, int h, int w, int c, int ph, int pw, int sh, int sw, float* out, int oh, int ow);
+
+	// data [count / channels, channels] 마다 x * scale[c] + shift[c] 후 activation
+	static void affine(float* data, size_t count, int channels, const float* scale, const float* shift, int activation);
+
+	// MODEL_ACTIVATION, SOFTMAX는 마지막 차원(channels)마다
+	static void activate(float* data, size_t count, int channels, int activation);
+
+	// keras 'same' padding (tf) : 앞쪽 padding, 전체 padding은 *total
+	static int samePadding(int size, int kernel, int stride, int* total = nullptr);
+};
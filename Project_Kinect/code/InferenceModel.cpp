@@ -0,0 +1,769 @@
+#include "InferenceModel.h"
+
+#include <ppl.h> // parallel_for, combinable
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// 깨진 파일에서 거대한 할당을 막는 상한 (B2D1 kernel이 1300만 개 정도)
+	const size_t TENSOR_MAX_FLOATS = (size_t)1 << 27;
+
+	string fixedString(const char* text, size_t size)
+	{
+		return string(text, strnlen(text, size));
+	}
+
+	bool isLinear(const ModelLayerHeader& header)
+	{
+		return (header.type == MODEL_LAYER_CONV2D || header.type == MODEL_LAYER_DENSE)
+			&& header.activation == MODEL_ACTIVATION_LINEAR;
+	}
+
+	// 출력 크기 (valid / same)
+	int outputSize(int size, int kernel, int stride, int padding)
+	{
+		if (padding == MODEL_PADDING_SAME) return (size + stride - 1) / stride;
+		return size >= kernel ? (size - kernel) / stride + 1 : 0;
+	}
+}
+
+InferenceModel::InferenceModel()
+{
+}
+
+bool InferenceModel::load(const string& path)
+{
+	loaded = false;
+	branches.clear();
+
+	ifstream file(path.c_str(), ios::in | ios::binary);
+	if (!file.is_open())
+	{
+		cout << "InferenceModel::load cannot open " << path << endl;
+		return false;
+	}
+
+	ModelFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != MODEL_MAGIC || header.version != MODEL_VERSION
+		|| header.branchCount < 2 || header.branchCount > MODEL_MAX_BRANCHES || header.labelCount == 0)
+	{
+		cout << "InferenceModel::load invalid model file " << path << endl;
+		return false;
+	}
+
+	name = fixedString(header.name, sizeof(header.name));
+	labelCount = (int)header.labelCount;
+	branches.resize(header.branchCount);
+
+	for (Branch& branch : branches)
+	{
+		if (!readBranch(file, branch))
+		{
+			cout << "InferenceModel::load broken branch " << branch.name << " " << path << endl;
+			return false;
+		}
+		fold(branch);
+	}
+
+	// head 입력 = 앞 branch 출력을 이은 것
+	size_t maxSize = 0;
+	size_t headInput = 0;
+
+	for (size_t b = 0; b < branches.size(); ++b)
+	{
+		Branch& branch = branches[b];
+		bool isHead = b + 1 == branches.size();
+
+		if (isHead && count(branch.inputShape) != headInput)
+		{
+			cout << "InferenceModel::load head input " << count(branch.inputShape) << " != " << headInput << endl;
+			return false;
+		}
+
+		if (!inferShapes(branch, branch.inputShape))
+		{
+			cout << "InferenceModel::load shape mismatch in " << branch.name << endl;
+			return false;
+		}
+
+		maxSize = max(maxSize, count(branch.inputShape));
+		for (Layer& layer : branch.layers) maxSize = max(maxSize, count(layer.shape));
+
+		if (!isHead) headInput += branch.layers.empty() ? count(branch.inputShape) : count(branch.layers.back().shape);
+	}
+
+	const Branch& head = branches.back();
+	if (head.layers.empty() || count(head.layers.back().shape) != (size_t)labelCount)
+	{
+		cout << "InferenceModel::load head output != label " << labelCount << endl;
+		return false;
+	}
+
+	layerSize = maxSize;
+	buffers[0].assign(maxSize, 0);
+	buffers[1].assign(maxSize, 0);
+	branchMs.assign(branches.size(), 0);
+	loaded = true;
+
+#ifdef INFERENCE_INT8
+	loadQuantization(getQuantizationPath(path));
+#endif
+
+	size_t layerCount = 0;
+	for (Branch& branch : branches) layerCount += branch.layers.size();
+
+	cout << "InferenceModel ... " << name << " (" << branches.size() << " branch, " << layerCount << " layer after fold, label " << labelCount
+		<< (InferenceKernels::isSimd() ? ", avx2" : ", scalar");
+	if (getQuantizedCount() > 0) cout << ", int8 conv " << getQuantizedCount() << (InferenceKernels::isVnni() ? " vnni" : "");
+	cout << ")" << endl;
+
+	return true;
+}
+
+bool InferenceModel::isLoaded()
+{
+	return loaded;
+}
+
+string InferenceModel::getName()
+{
+	return name;
+}
+
+int InferenceModel::getLabelCount()
+{
+	return labelCount;
+}
+
+int InferenceModel::getBranchCount()
+{
+	return (int)branches.size() - 1;
+}
+
+vector<int> InferenceModel::getInputShape(int branch)
+{
+	return branches[branch].inputShape;
+}
+
+size_t InferenceModel::getInputSize(int branch)
+{
+	return count(branches[branch].inputShape);
+}
+
+bool InferenceModel::forward(const vector<const float*>& inputs, vector<float>& scores)
+{
+	return forward(inputs, 1, scores);
+}
+
+bool InferenceModel::forward(const vector<const float*>& inputs, int batch, vector<float>& scores)
+{
+	if (!runBranches(inputs, batch)) return false;
+
+	auto start = chrono::steady_clock::now();
+	run(branches.back(), branchOutputs.data(), batch, scores);
+	branchMs.back() = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	return true;
+}
+
+bool InferenceModel::embed(const vector<const float*>& inputs, vector<float>& embedding, vector<float>* scores)
+{
+	if (!runBranches(inputs, 1)) return false;
+
+	auto start = chrono::steady_clock::now();
+	Branch& head = branches.back();
+	size_t last = head.layers.size() - 1;
+	run(head, branchOutputs.data(), 1, embedding, last);
+
+	// 정규화 전 값이 분류 layer 입력
+	if (scores) run(head, embedding.data(), 1, *scores, SIZE_MAX, last);
+	branchMs.back() = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	float norm = 0;
+	for (float v : embedding) norm += v * v;
+	norm = sqrt(norm);
+	if (norm > 0) for (float& v : embedding) v /= norm;
+
+	return true;
+}
+
+size_t InferenceModel::getEmbeddingSize()
+{
+	if (!loaded) return 0;
+
+	const Branch& head = branches.back();
+	return head.layers.size() < 2 ? count(head.inputShape) : count(head.layers[head.layers.size() - 2].shape);
+}
+
+bool InferenceModel::runBranches(const vector<const float*>& inputs, int batch)
+{
+	if (!loaded || batch <= 0 || (int)inputs.size() != getBranchCount()) return false;
+
+	if (buffers[0].size() < layerSize * batch)
+	{
+		buffers[0].resize(layerSize * batch);
+		buffers[1].resize(layerSize * batch);
+	}
+
+	// head 입력 : 샘플마다 [branch 0 출력][branch 1 출력]...
+	size_t headInput = count(branches.back().inputShape);
+	branchOutputs.resize(headInput * batch);
+
+	vector<float> out;
+	size_t offset = 0;
+
+	for (int b = 0; b < getBranchCount(); ++b)
+	{
+		auto start = chrono::steady_clock::now();
+		run(branches[b], inputs[b], batch, out);
+		branchMs[b] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+		size_t size = out.size() / batch;
+		for (int i = 0; i < batch; ++i) memcpy(branchOutputs.data() + i * headInput + offset, out.data() + i * size, sizeof(float) * size);
+		offset += size;
+	}
+
+	return true;
+}
+
+double InferenceModel::getBranchMs(int branch)
+{
+	return branch >= 0 && branch < (int)branchMs.size() ? branchMs[branch] : 0;
+}
+
+void InferenceModel::setCalibrating(bool enable)
+{
+	calibrating = enable;
+	if (!enable) return;
+
+	for (Branch& branch : branches)
+	{
+		for (Layer& layer : branch.layers)
+		{
+			layer.inputMin = numeric_limits<float>::max();
+			layer.inputMax = -numeric_limits<float>::max();
+		}
+	}
+}
+
+int InferenceModel::quantize(int branch)
+{
+	for (size_t b = 0; b < branches.size(); ++b)
+	{
+		if (branch >= 0 && (int)b != branch) continue;
+
+		for (Layer& layer : branches[b].layers)
+		{
+			// 음수 입력은 u7로 못 나타냄, 한 번도 안 본 layer도 제외
+			if (layer.header.type != MODEL_LAYER_CONV2D || layer.inputMin < 0 || layer.inputMax <= 0) continue;
+
+			quantizeLayer(layer, layer.inputMax / 127);
+		}
+	}
+
+	return getQuantizedCount();
+}
+
+void InferenceModel::clearQuantization()
+{
+	for (Branch& branch : branches)
+	{
+		for (Layer& layer : branch.layers)
+		{
+			layer.inputScale = 0;
+			layer.kpad = 0;
+			layer.qkernel.clear();
+			layer.qscales.clear();
+		}
+	}
+}
+
+int InferenceModel::getQuantizedCount()
+{
+	int quantized = 0;
+	for (Branch& branch : branches)
+	{
+		for (Layer& layer : branch.layers) quantized += layer.inputScale > 0;
+	}
+	return quantized;
+}
+
+void InferenceModel::setInt8(bool enable)
+{
+	int8 = enable;
+}
+
+bool InferenceModel::isInt8()
+{
+	return int8 && getQuantizedCount() > 0;
+}
+
+bool InferenceModel::saveQuantization(const string& path)
+{
+	ofstream file(path.c_str(), ios::out | ios::trunc);
+	if (!file.is_open()) return false;
+
+	file.precision(9);
+	file << "# " << name << " int8 conv : branch layer(fold 후) name inputScale" << endl;
+	for (size_t b = 0; b < branches.size(); ++b)
+	{
+		for (size_t l = 0; l < branches[b].layers.size(); ++l)
+		{
+			const Layer& layer = branches[b].layers[l];
+			if (layer.inputScale <= 0) continue;
+
+			file << b << " " << l << " " << fixedString(layer.header.name, sizeof(layer.header.name)) << " " << layer.inputScale << endl;
+		}
+	}
+
+	return file.good();
+}
+
+bool InferenceModel::loadQuantization(const string& path)
+{
+	ifstream file(path.c_str());
+	if (!file.is_open()) return false;
+
+	clearQuantization();
+
+	string line;
+	bool matched = true;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		stringstream stream(line);
+		size_t b, l;
+		string layerName;
+		float inputScale;
+		if (!(stream >> b >> l >> layerName >> inputScale)) continue;
+
+		// 다른 모델에서 만든 파일이면 그 줄은 float로
+		if (b >= branches.size() || l >= branches[b].layers.size()
+			|| fixedString(branches[b].layers[l].header.name, sizeof(branches[b].layers[l].header.name)) != layerName
+			|| !quantizeLayer(branches[b].layers[l], inputScale))
+		{
+			cout << "InferenceModel::loadQuantization mismatch " << b << " " << l << " " << layerName << " " << path << endl;
+			matched = false;
+		}
+	}
+
+	return matched;
+}
+
+string InferenceModel::getQuantizationPath(const string& modelPath)
+{
+	size_t dot = modelPath.find_last_of('.');
+	size_t slash = modelPath.find_last_of("/\\");
+	string base = dot != string::npos && (slash == string::npos || dot > slash) ? modelPath.substr(0, dot) : modelPath;
+
+	return base + MODEL_QUANT_EXT;
+}
+
+// 출력 채널마다 scale = max |w| / 127 (대칭), kernel은 [cout][kh * kw * cin]으로 옮기고 32 byte 단위까지 0
+bool InferenceModel::quantizeLayer(Layer& layer, float inputScale)
+{
+	if (layer.header.type != MODEL_LAYER_CONV2D || !(inputScale > 0)) return false;
+
+	const vector<float>& kernel = layer.tensors[0];
+	int cout = layer.header.params[5];
+	int size = (int)(kernel.size() / cout); // kh * kw * cin
+
+	layer.inputScale = inputScale;
+	layer.kpad = InferenceKernels::int8Stride(size);
+	layer.qkernel.assign((size_t)cout * layer.kpad, 0);
+	layer.qscales.resize(cout);
+
+	for (int oc = 0; oc < cout; ++oc)
+	{
+		float high = 0;
+		for (int k = 0; k < size; ++k) high = max(high, fabs(kernel[(size_t)k * cout + oc]));
+
+		float scale = high > 0 ? high / 127 : 1;
+		int8_t* q = layer.qkernel.data() + (size_t)oc * layer.kpad;
+		for (int k = 0; k < size; ++k) q[k] = (int8_t)lround(kernel[(size_t)k * cout + oc] / scale);
+
+		layer.qscales[oc] = inputScale * scale;
+	}
+
+	return true;
+}
+
+bool InferenceModel::readBranch(istream& file, Branch& branch)
+{
+	ModelBranchHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.rank == 0 || header.rank > MODEL_MAX_RANK) return false;
+
+	branch.name = fixedString(header.name, sizeof(header.name));
+	branch.inputShape.assign(header.shape, header.shape + header.rank);
+	branch.layers.resize(header.layerCount);
+
+	for (Layer& layer : branch.layers)
+	{
+		if (!file.read(reinterpret_cast<char*>(&layer.header), sizeof(layer.header)) || layer.header.tensorCount > 4) return false;
+
+		layer.tensors.resize(layer.header.tensorCount);
+		for (vector<float>& tensor : layer.tensors)
+		{
+			ModelTensorHeader t;
+			if (!file.read(reinterpret_cast<char*>(&t), sizeof(t)) || t.rank > MODEL_MAX_RANK) return false;
+
+			size_t size = 1;
+			for (uint32_t i = 0; i < t.rank; ++i) size *= t.dims[i];
+			if (size > TENSOR_MAX_FLOATS) return false;
+
+			tensor.resize(size);
+			if (!file.read(reinterpret_cast<char*>(tensor.data()), sizeof(float) * size)) return false;
+		}
+	}
+
+	return true;
+}
+
+bool InferenceModel::inferShapes(Branch& branch, const vector<int>& inputShape)
+{
+	vector<int> shape = inputShape;
+
+	for (Layer& layer : branch.layers)
+	{
+		const ModelLayerHeader& h = layer.header;
+		int rank = (int)shape.size();
+
+		switch (h.type)
+		{
+		case MODEL_LAYER_CONV2D:
+		{
+			int kh = h.params[0], kw = h.params[1], sh = h.params[2], sw = h.params[3], filters = h.params[5];
+			if (rank < 3 || layer.tensors.size() != 2 || kh <= 0 || kw <= 0 || sh <= 0 || sw <= 0) return false;
+
+			int cin = shape[rank - 1];
+			if (layer.tensors[0].size() != (size_t)kh * kw * cin * filters || layer.tensors[1].size() != (size_t)filters) return false;
+
+			shape[rank - 3] = outputSize(shape[rank - 3], kh, sh, h.params[4]);
+			shape[rank - 2] = outputSize(shape[rank - 2], kw, sw, h.params[4]);
+			shape[rank - 1] = filters;
+			break;
+		}
+
+		case MODEL_LAYER_DENSE:
+		{
+			int units = h.params[0];
+			if (layer.tensors.size() != 2 || layer.tensors[0].size() != (size_t)shape[rank - 1] * units || layer.tensors[1].size() != (size_t)units) return false;
+
+			shape[rank - 1] = units;
+			break;
+		}
+
+		case MODEL_LAYER_BATCHNORM:
+			if (layer.tensors.size() != 2 || layer.tensors[0].size() != (size_t)shape[rank - 1] || layer.tensors[1].size() != (size_t)shape[rank - 1]) return false;
+			break;
+
+		case MODEL_LAYER_ACTIVATION:
+			break;
+
+		case MODEL_LAYER_MAXPOOL2D:
+			if (rank < 3 || h.params[0] <= 0 || h.params[1] <= 0 || h.params[2] <= 0 || h.params[3] <= 0) return false;
+
+			shape[rank - 3] = outputSize(shape[rank - 3], h.params[0], h.params[2], MODEL_PADDING_VALID);
+			shape[rank - 2] = outputSize(shape[rank - 2], h.params[1], h.params[3], MODEL_PADDING_VALID);
+			break;
+
+		case MODEL_LAYER_FLATTEN:
+		{
+			// params[0] : 남기는 앞쪽 차원 수 (TimeDistributed면 1)
+			int keep = h.params[0];
+			if (keep < 0 || keep >= rank) return false;
+
+			int flat = (int)count(shape, keep);
+			shape.resize(keep);
+			shape.push_back(flat);
+			break;
+		}
+
+		case MODEL_LAYER_LSTM:
+		{
+			int units = h.params[0];
+			if (rank != 2 || layer.tensors.size() != 3
+				|| layer.tensors[0].size() != (size_t)shape[1] * 4 * units
+				|| layer.tensors[1].size() != (size_t)units * 4 * units
+				|| layer.tensors[2].size() != (size_t)4 * units) return false;
+
+			// params[2] : return_sequences
+			if (h.params[2]) shape[1] = units;
+			else shape = { units };
+			break;
+		}
+
+		default:
+			cout << "InferenceModel unknown layer type " << h.type << " " << fixedString(h.name, sizeof(h.name)) << endl;
+			return false;
+		}
+
+		for (int d : shape)
+		{
+			if (d <= 0) return false;
+		}
+		layer.shape = shape;
+	}
+
+	return true;
+}
+
+// BN / activation을 앞 layer에 접기 (추론 결과는 같고 메모리 왕복이 줄어든다)
+void InferenceModel::fold(Branch& branch)
+{
+	vector<Layer>& layers = branch.layers;
+
+	for (size_t i = 1; i < layers.size();)
+	{
+		Layer& prev = layers[i - 1];
+		Layer& layer = layers[i];
+		bool folded = false;
+
+		// conv / dense -> BN : kernel 열과 bias에 scale, shift
+		if (layer.header.type == MODEL_LAYER_BATCHNORM && isLinear(prev.header))
+		{
+			const vector<float>& scale = layer.tensors[0];
+			const vector<float>& shift = layer.tensors[1];
+			vector<float>& kernel = prev.tensors[0];
+			vector<float>& bias = prev.tensors[1];
+			size_t outSize = bias.size();
+
+			if (scale.size() == outSize)
+			{
+				for (size_t k = 0; k < kernel.size(); ++k) kernel[k] *= scale[k % outSize];
+				for (size_t o = 0; o < outSize; ++o) bias[o] = bias[o] * scale[o] + shift[o];
+
+				prev.header.activation = layer.header.activation;
+				folded = true;
+			}
+		}
+		// conv / dense / BN -> activation
+		else if (layer.header.type == MODEL_LAYER_ACTIVATION && prev.header.activation == MODEL_ACTIVATION_LINEAR
+			&& (isLinear(prev.header) || prev.header.type == MODEL_LAYER_BATCHNORM))
+		{
+			prev.header.activation = layer.header.activation;
+			folded = true;
+		}
+		// BN -> dense : 입력 쪽 scale은 kernel 행에, shift는 bias로
+		else if (layer.header.type == MODEL_LAYER_DENSE && prev.header.type == MODEL_LAYER_BATCHNORM
+			&& prev.header.activation == MODEL_ACTIVATION_LINEAR)
+		{
+			const vector<float>& scale = prev.tensors[0];
+			const vector<float>& shift = prev.tensors[1];
+			vector<float>& kernel = layer.tensors[0];
+			vector<float>& bias = layer.tensors[1];
+			size_t outSize = bias.size();
+
+			if (scale.size() * outSize == kernel.size())
+			{
+				for (size_t k = 0; k < scale.size(); ++k)
+				{
+					float* row = kernel.data() + k * outSize;
+					for (size_t o = 0; o < outSize; ++o)
+					{
+						bias[o] += shift[k] * row[o];
+						row[o] *= scale[k];
+					}
+				}
+
+				layers.erase(layers.begin() + (i - 1));
+				continue; // i는 그대로 (다음 layer가 당겨짐)
+			}
+		}
+
+		if (folded) layers.erase(layers.begin() + i);
+		else ++i;
+	}
+}
+
+void InferenceModel::run(Branch& branch, const float* input, int batch, vector<float>& out, size_t layerCount, size_t firstLayer)
+{
+	const float* current = input;
+	vector<int> shape = firstLayer == 0 ? branch.inputShape : branch.layers[firstLayer - 1].shape;
+	int next = 0;
+
+	for (size_t l = firstLayer; l < min(layerCount, branch.layers.size()); ++l)
+	{
+		Layer& layer = branch.layers[l];
+
+		// row-major라 flatten은 shape만 바뀜
+		if (layer.header.type != MODEL_LAYER_FLATTEN)
+		{
+			float* target = buffers[next].data();
+			runLayer(layer, shape, batch, current, target);
+
+			current = target;
+			next ^= 1;
+		}
+		shape = layer.shape;
+	}
+
+	out.assign(current, current + count(shape) * batch);
+}
+
+// inShape은 batch 제외, 앞쪽 차원은 모두 batch처럼 다루므로 batch는 개수만 늘어난다 (LSTM 제외)
+void InferenceModel::runLayer(Layer& layer, const vector<int>& inShape, int batch, const float* in, float* out)
+{
+	const ModelLayerHeader& h = layer.header;
+	int rank = (int)inShape.size();
+	size_t inCount = count(inShape) * batch;
+
+	switch (h.type)
+	{
+	case MODEL_LAYER_CONV2D:
+	{
+		int height = inShape[rank - 3], width = inShape[rank - 2], cin = inShape[rank - 1];
+		int oh = layer.shape[rank - 3], ow = layer.shape[rank - 2], cout = layer.shape[rank - 1];
+		int kh = h.params[0], kw = h.params[1], sh = h.params[2], sw = h.params[3];
+		bool same = h.params[4] == MODEL_PADDING_SAME;
+
+		int padTop = same ? InferenceKernels::samePadding(height, kh, sh) : 0;
+		int padLeft = same ? InferenceKernels::samePadding(width, kw, sw) : 0;
+		size_t paddedSize = (size_t)max((oh - 1) * sh + kh, height + padTop) * max((ow - 1) * sw + kw, width + padLeft) * cin;
+
+		size_t inImage = (size_t)height * width * cin;
+		size_t outImage = (size_t)oh * ow * cout;
+		int images = (int)(inCount / inImage);
+
+		if (calibrating)
+		{
+			auto range = minmax_element(in, in + inCount);
+			layer.inputMin = min(layer.inputMin, *range.first);
+			layer.inputMax = max(layer.inputMax, *range.second);
+		}
+
+		// TimeDistributed : 프레임마다 병렬, padding 버퍼는 thread마다
+		Concurrency::combinable<vector<float>> padded;
+		Concurrency::combinable<vector<uint8_t>> bytes; // int8 : padded + patch
+		bool quantized = int8 && layer.inputScale > 0;
+
+		Concurrency::parallel_for(0, images, [&](int i)
+		{
+			if (quantized)
+			{
+				vector<uint8_t>& buffer = bytes.local();
+				if (buffer.size() < paddedSize + layer.kpad) buffer.resize(paddedSize + layer.kpad);
+
+				InferenceKernels::conv2dInt8(in + i * inImage, height, width, cin, layer.inputScale,
+					layer.qkernel.data(), layer.kpad, layer.qscales.data(), layer.tensors[1].data(), kh, kw, sh, sw, padTop, padLeft,
+					out + i * outImage, oh, ow, cout, h.activation, buffer.data(), buffer.data() + paddedSize);
+				return;
+			}
+
+			vector<float>& buffer = padded.local();
+			if (buffer.size() < paddedSize) buffer.resize(paddedSize);
+
+			InferenceKernels::conv2d(in + i * inImage, height, width, cin,
+				layer.tensors[0].data(), layer.tensors[1].data(), kh, kw, sh, sw, padTop, padLeft,
+				out + i * outImage, oh, ow, cout, h.activation, buffer.data());
+		});
+		break;
+	}
+
+	case MODEL_LAYER_DENSE:
+	{
+		int inSize = inShape[rank - 1];
+		int units = h.params[0];
+
+		InferenceKernels::dense(in, (int)(inCount / inSize), inSize, layer.tensors[0].data(), layer.tensors[1].data(), out, units, h.activation);
+		break;
+	}
+
+	case MODEL_LAYER_BATCHNORM:
+		memcpy(out, in, sizeof(float) * inCount);
+		InferenceKernels::affine(out, inCount, inShape[rank - 1], layer.tensors[0].data(), layer.tensors[1].data(), h.activation);
+		break;
+
+	case MODEL_LAYER_ACTIVATION:
+		memcpy(out, in, sizeof(float) * inCount);
+		InferenceKernels::activate(out, inCount, inShape[rank - 1], h.activation);
+		break;
+
+	case MODEL_LAYER_MAXPOOL2D:
+	{
+		int height = inShape[rank - 3], width = inShape[rank - 2], c = inShape[rank - 1];
+		int oh = layer.shape[rank - 3], ow = layer.shape[rank - 2];
+		size_t inImage = (size_t)height * width * c;
+		size_t outImage = (size_t)oh * ow * c;
+
+		for (size_t i = 0; i < inCount / inImage; ++i)
+		{
+			InferenceKernels::maxpool2d(in + i * inImage, height, width, c, h.params[0], h.params[1], h.params[2], h.params[3], out + i * outImage, oh, ow);
+		}
+		break;
+	}
+
+	case MODEL_LAYER_LSTM:
+		runLstm(layer, inShape, batch, in, out);
+		break;
+	}
+}
+
+// keras LSTM (implementation 1) : z = x W + h U + b, gate 순서 i, f, c, o
+// 샘플들의 같은 step을 한 번에 (h U는 batch행 dense)
+void InferenceModel::runLstm(Layer& layer, const vector<int>& inShape, int batch, const float* in, float* out)
+{
+	const ModelLayerHeader& h = layer.header;
+	int steps = inShape[0];
+	int inSize = inShape[1];
+	int units = h.params[0];
+	int recurrentActivation = h.params[1];
+	bool sequences = h.params[2] != 0;
+	size_t gateSize = (size_t)4 * units;
+
+	// 입력 쪽은 모든 샘플, 모든 step을 한 번에 [batch][step][4 * units]
+	gates.resize((size_t)batch * steps * gateSize);
+	InferenceKernels::dense(in, batch * steps, inSize, layer.tensors[0].data(), layer.tensors[2].data(), gates.data(), 4 * units, MODEL_ACTIVATION_LINEAR);
+
+	if (zeros.size() < gateSize) zeros.assign(gateSize, 0.0f);
+	vector<float> hidden((size_t)batch * units, 0.0f), cell((size_t)batch * units, 0.0f), z(batch * gateSize);
+
+	for (int t = 0; t < steps; ++t)
+	{
+		InferenceKernels::dense(hidden.data(), batch, units, layer.tensors[1].data(), zeros.data(), z.data(), 4 * units, MODEL_ACTIVATION_LINEAR);
+
+		for (int n = 0; n < batch; ++n)
+		{
+			float* zi = z.data() + n * gateSize;
+			float* zf = zi + units;
+			float* zc = zf + units;
+			float* zo = zc + units;
+			float* hn = hidden.data() + (size_t)n * units;
+			float* cn = cell.data() + (size_t)n * units;
+
+			const float* x = gates.data() + ((size_t)n * steps + t) * gateSize;
+			for (size_t g = 0; g < gateSize; ++g) zi[g] += x[g];
+
+			InferenceKernels::activate(zi, units, units, recurrentActivation);
+			InferenceKernels::activate(zf, units, units, recurrentActivation);
+			InferenceKernels::activate(zc, units, units, h.activation);
+			InferenceKernels::activate(zo, units, units, recurrentActivation);
+
+			for (int u = 0; u < units; ++u) cn[u] = zf[u] * cn[u] + zi[u] * zc[u];
+
+			for (int u = 0; u < units; ++u) hn[u] = cn[u];
+			InferenceKernels::activate(hn, units, units, h.activation);
+			for (int u = 0; u < units; ++u) hn[u] *= zo[u];
+
+			if (sequences) memcpy(out + ((size_t)n * steps + t) * units, hn, sizeof(float) * units);
+		}
+	}
+
+	if (!sequences) memcpy(out, hidden.data(), sizeof(float) * batch * units);
+}
+
+size_t InferenceModel::count(const vector<int>& shape, size_t from)
+{
+	size_t size = 1;
+	for (size_t i = from; i < shape.size(); ++i) size *= shape[i];
+	return size;
+}
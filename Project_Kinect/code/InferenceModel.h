@@ -0,0 +1,118 @@
+#pragma once
+
+#include <istream>
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "ModelFormat.h"
+#include "InferenceKernels.h"
+
+// keras Model_M1을 export한 .kslm으로 추론 (형식은 ModelFormat.h, Project_DNN/scripts/modelExport.py)
+//
+// load 때 BatchNormalization / Activation을 앞 CONV2D / DENSE에 접어 넣는다
+// (conv -> BN -> relu 는 conv 하나로, BN -> dense 는 dense 하나로).
+// 앞쪽 차원은 batch로 보므로 TimeDistributed(conv)는 프레임마다 병렬로 돈다.
+// forward(inputs, batch, ...)는 샘플 여러 개를 한 번에 (dense / LSTM은 kernel 한 번 읽고 모든 샘플, BatchPredictServer).
+// INFERENCE_INT8 : 모델 옆 .kslq (Project_Tools quant-eval)가 있으면 거기 적힌 conv를 int8로 (InferenceKernels::conv2dInt8).
+//
+// forward는 한 thread에서만 (작업 버퍼를 재사용)
+class InferenceModel
+{
+private:
+	struct Layer
+	{
+		ModelLayerHeader header;
+		vector<vector<float>> tensors;
+		vector<int> shape; // 이 layer 출력 shape (batch 제외)
+
+		// CONV2D int8, inputScale 0이면 float
+		float inputMin = 0; // calibration 중 본 입력 범위
+		float inputMax = 0;
+		float inputScale = 0;
+		int kpad = 0;
+		vector<int8_t> qkernel; // [cout][kpad]
+		vector<float> qscales; // inputScale x 출력 채널 kernel scale
+	};
+
+	struct Branch
+	{
+		string name;
+		vector<int> inputShape;
+		vector<Layer> layers;
+	};
+
+	string name;
+	vector<Branch> branches;
+	int labelCount = 0;
+	bool loaded = false;
+
+	vector<float> buffers[2]; // ping-pong, 가장 큰 layer 출력 크기 x batch
+	size_t layerSize = 0; // 가장 큰 layer 출력 (batch 1)
+	vector<float> branchOutputs; // head 입력 (샘플마다 이어 붙임)
+	vector<float> gates; // LSTM
+	vector<float> zeros; // LSTM recurrent dense bias
+
+	bool calibrating = false;
+	bool int8 = true;
+	vector<double> branchMs; // 마지막 forward
+
+public:
+	InferenceModel();
+
+	bool load(const string& path);
+	bool isLoaded();
+
+	string getName();
+	int getLabelCount();
+	int getBranchCount(); // head 제외
+	// branch 입력 shape / float 수
+	vector<int> getInputShape(int branch);
+	size_t getInputSize(int branch);
+
+	// inputs[branch] : getInputSize(branch)개 float, scores : labelCount개 (softmax)
+	bool forward(const vector<const float*>& inputs, vector<float>& scores);
+
+	// batch개 샘플, inputs[branch] : batch x getInputSize(branch) (이어서), scores : batch x labelCount
+	bool forward(const vector<const float*>& inputs, int batch, vector<float>& scores);
+
+	// head 마지막 layer (분류) 직전 출력을 L2 정규화, getEmbeddingSize개 (EmbeddingRecognizer)
+	// scores가 있으면 마지막 layer만 이어서 돌려 forward와 같은 값도 (LearnedRecognizer, branch는 한 번)
+	bool embed(const vector<const float*>& inputs, vector<float>& embedding, vector<float>* scores = nullptr);
+	size_t getEmbeddingSize();
+
+	// branch 실행 시간 (마지막 forward, ms)
+	double getBranchMs(int branch);
+
+	// int8 : setCalibrating(true) 동안 forward하면 conv마다 입력 범위를 모으고, quantize로 적용
+	void setCalibrating(bool enable); // true면 모은 범위를 지움
+	// branch (-1 : 전부)에서 calibration 입력이 0 이상인 conv만 (픽셀, relu 뒤), return int8 conv 수
+	int quantize(int branch = -1);
+	void clearQuantization();
+	int getQuantizedCount();
+	void setInt8(bool enable); // false : quantize 되어 있어도 float (quant-eval 비교)
+	bool isInt8();
+
+	// "branch layer name inputScale" 줄, kernel은 load 때 float에서 다시 만든다
+	bool saveQuantization(const string& path);
+	bool loadQuantization(const string& path);
+	static string getQuantizationPath(const string& modelPath); // M1.kslm -> M1.kslq
+
+private:
+	bool readBranch(istream& file, Branch& branch);
+	bool inferShapes(Branch& branch, const vector<int>& inputShape);
+	void fold(Branch& branch);
+	bool quantizeLayer(Layer& layer, float inputScale);
+
+	// head 제외 branch 실행, 출력은 branchOutputs
+	bool runBranches(const vector<const float*>& inputs, int batch);
+	// branch 하나 (firstLayer부터 layerCount개 앞까지) 실행, 결과는 out (크기 = 마지막 layer shape 곱)
+	// input은 firstLayer 입력 (firstLayer - 1 출력 shape)
+	void run(Branch& branch, const float* input, int batch, vector<float>& out, size_t layerCount = SIZE_MAX, size_t firstLayer = 0);
+	void runLayer(Layer& layer, const vector<int>& inShape, int batch, const float* in, float* out);
+	void runLstm(Layer& layer, const vector<int>& inShape, int batch, const float* in, float* out);
+
+	static size_t count(const vector<int>& shape, size_t from = 0);
+};
@@ -40,6 +40,10 @@ void MainTransaction::chooseMenu()
 	case KINECT_MODE_LEARNING:
 		modeLearning();
 		break;
+
+	case KINECT_MODE_STREAM:
+		modePredict(); //  loop,  ó ٸ (Kinect::updateStream)
+		break;
 	}
 }
 
@@ -116,10 +120,40 @@ void MainTransaction::modePredict()
 	}
 }
 
-// *not avaliable*  
-// **********
-// _not avaliable_
+// ׸Ʈ  label  (LearnedRecognizer, data/models/learned.ksnc ٷ )
+// label ٲ  ݺ, -1̸   ٷ predict
 void MainTransaction::modeLearning()
 {
+	LabelMapper::getInstance()->printLabel();
+
+	try {
+		while (true)
+		{
+			int label = INPUT(int, "Learning Label (-1 : Predict)");
+			if (label < 0) break;
+
+			cout << ">>> " << label << ": " << LABEL(label) << endl;
+			k.setLabel(label);
+
+			cout << "[ESC] to Next Label" << endl;
+			while (true)
+			{
+				k.run_one_cycle();
+
+				const int key = cv::waitKey(10);
+				if (key == VK_ESCAPE) {
+					break;
+				}
+			}
+		}
+	}
+	catch (std::exception& ex) {
+		std::cout << ex.what() << std::endl;
+		return;
+	}
 
+	//  recognizer (PredictQueue) ٽ load ʴ´
+	k.setMode(KINECT_MODE_PREDICT);
+	cout << ">>> " << to_string(KINECT_MODE_PREDICT) << endl;
+	modePredict();
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+
+// C++ 추론용 모델 파일 (data/models/M1.kslm), parity 확인용 reference (M1.kslr)
+// Kinect / Windows 의존 없음 : Project_DNN/scripts/modelExport.py가 keras 모델에서 쓴다
+//
+// .kslm = [ModelFileHeader][branch]... (little endian, float32)
+//   branch = [ModelBranchHeader][layer]...
+//   layer  = [ModelLayerHeader][tensor]...
+//   tensor = [ModelTensorHeader][float data (dims 곱)]
+//
+// 마지막 branch가 head : 입력은 앞 branch 출력들을 순서대로 이은 것 (Concatenate)
+// Model_M1 : branch 0 = B1 (spoint [150, 74, 1]), 1 = B2 (ROI [T, h, w, 1]), 2 = M1 head
+//
+// 텐서는 keras 그대로 channels_last, 앞쪽 차원은 batch처럼 취급 (TimeDistributed는 export에서 벗겨냄)
+//   CONV2D     params : kh, kw, sh, sw, padding(MODEL_PADDING), filters  tensors : kernel [kh, kw, cin, cout], bias [cout]
+//   DENSE      params : units                                            tensors : kernel [in, out], bias [out]
+//   BATCHNORM  (추론 고정값)                                             tensors : scale [c], shift [c]  (gamma / sqrt(var + eps), beta - mean * scale)
+//   ACTIVATION activation만
+//   MAXPOOL2D  params : ph, pw, sh, sw (valid)
+//   FLATTEN    마지막 3차원 -> 1차원 (row-major라 복사 없음)
+//   LSTM       params : units, recurrent activation(MODEL_ACTIVATION)     tensors : kernel [in, 4u], recurrent [u, 4u], bias [4u]  (gate i, f, c, o)
+//
+// .kslr = [ModelReferenceHeader][case]..., case = spoint float[spointSize], image float[imageSize], output float[labelCount]
+// .kslq = int8 conv 목록 (text, InferenceModel::saveQuantization), 모델 파일 이름에서 확장자만 바꿈
+//
+// 형식이 바뀌면 MODEL_VERSION을 올리고 modelExport.py도 같이 수정
+
+#define MODEL_FILE_NAME "M1.kslm"
+#define MODEL_REFERENCE_FILE_NAME "M1.kslr"
+#define MODEL_QUANT_EXT ".kslq"
+#define MODEL_MAGIC 0x4D4C534B // "KSLM"
+#define MODEL_REFERENCE_MAGIC 0x544C534B // "KSLT"
+#define MODEL_VERSION 1
+#define MODEL_MAX_RANK 4
+#define MODEL_MAX_PARAMS 8
+#define MODEL_MAX_BRANCHES 4
+
+enum MODEL_LAYER
+{
+	MODEL_LAYER_CONV2D = 1,
+	MODEL_LAYER_DENSE,
+	MODEL_LAYER_BATCHNORM,
+	MODEL_LAYER_ACTIVATION,
+	MODEL_LAYER_MAXPOOL2D,
+	MODEL_LAYER_FLATTEN,
+	MODEL_LAYER_LSTM,
+};
+
+enum MODEL_ACTIVATION
+{
+	MODEL_ACTIVATION_LINEAR = 0,
+	MODEL_ACTIVATION_RELU,
+	MODEL_ACTIVATION_SOFTMAX,
+	MODEL_ACTIVATION_TANH,
+	MODEL_ACTIVATION_SIGMOID,
+	MODEL_ACTIVATION_HARD_SIGMOID, // keras 2.2 이하 LSTM recurrent_activation 기본값
+};
+
+enum MODEL_PADDING
+{
+	MODEL_PADDING_VALID = 0,
+	MODEL_PADDING_SAME,
+};
+
+struct ModelFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t branchCount;
+	uint32_t labelCount; // head 출력 크기
+	char name[32]; // keras model.name
+};
+
+struct ModelBranchHeader
+{
+	uint32_t rank; // 입력 shape (batch 제외), head는 1 (이어 붙인 크기)
+	uint32_t shape[MODEL_MAX_RANK];
+	uint32_t layerCount;
+	char name[32];
+};
+
+struct ModelLayerHeader
+{
+	uint32_t type; // MODEL_LAYER
+	uint32_t activation; // MODEL_ACTIVATION, CONV2D / DENSE 뒤에 바로 적용 (keras activation=)
+	int32_t params[MODEL_MAX_PARAMS];
+	uint32_t tensorCount;
+	uint32_t reserved;
+	char name[32]; // keras layer name (TimeDistributed면 wrapper 이름)
+};
+
+struct ModelTensorHeader
+{
+	uint32_t rank;
+	uint32_t dims[MODEL_MAX_RANK];
+	uint32_t reserved;
+};
+
+struct ModelReferenceHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t caseCount;
+	uint32_t spointSize; // float 수 (branch 0 입력)
+	uint32_t imageSize; // branch 1 입력
+	uint32_t labelCount;
+};
+
+static_assert(sizeof(ModelFileHeader) == 48, "ModelFileHeader layout");
+static_assert(sizeof(ModelBranchHeader) == 56, "ModelBranchHeader layout");
+static_assert(sizeof(ModelLayerHeader) == 80, "ModelLayerHeader layout");
+static_assert(sizeof(ModelTensorHeader) == 24, "ModelTensorHeader layout");
+static_assert(sizeof(ModelReferenceHeader) == 24, "ModelReferenceHeader layout");
@@ -0,0 +1,213 @@
+#include "NcmHead.h"
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// 깨진 파일에서 거대한 할당을 막는 상한
+	const uint32_t NCM_MAX_LABELS = 1 << 16;
+	const uint32_t NCM_MAX_DIM = 1 << 16;
+}
+
+bool NcmHead::update(int label, const float* embedding, int dim)
+{
+	if (label < 0 || (uint32_t)label >= NCM_MAX_LABELS || dim <= 0) return false;
+	if (this->dim == 0) this->dim = dim;
+	if (dim != this->dim) return false;
+
+	if (label >= getLabelCount())
+	{
+		counts.resize(label + 1, 0);
+		sums.resize((size_t)(label + 1) * dim, 0.0f);
+	}
+
+	float* sum = sums.data() + (size_t)label * dim;
+	for (int i = 0; i < dim; ++i) sum[i] += embedding[i];
+	++counts[label];
+
+	updateMeans();
+	return true;
+}
+
+void NcmHead::forget(int label)
+{
+	if (label < 0 || label >= getLabelCount()) return;
+
+	counts[label] = 0;
+	fill(sums.begin() + (size_t)label * dim, sums.begin() + (size_t)(label + 1) * dim, 0.0f);
+	updateMeans();
+}
+
+void NcmHead::clear()
+{
+	dim = 0;
+	counts.clear();
+	sums.clear();
+	center.clear();
+	means.clear();
+}
+
+bool NcmHead::load(const string& path)
+{
+	clear();
+
+	ifstream file(path.c_str(), ios::in | ios::binary);
+	if (!file.is_open()) return false; // 아직 배운 것이 없음
+
+	NcmFileHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != NCM_FILE_MAGIC || header.version != NCM_FILE_VERSION
+		|| header.labelCount > NCM_MAX_LABELS || header.dim > NCM_MAX_DIM || (header.dim == 0 && header.labelCount > 0))
+	{
+		cout << "NcmHead::load invalid head file " << path << endl;
+		return false;
+	}
+
+	dim = (int)header.dim;
+	counts.resize(header.labelCount);
+	sums.resize((size_t)header.labelCount * dim);
+
+	for (uint32_t l = 0; l < header.labelCount; ++l)
+	{
+		if (!file.read(reinterpret_cast<char*>(&counts[l]), sizeof(uint32_t))
+			|| !file.read(reinterpret_cast<char*>(sums.data() + (size_t)l * dim), sizeof(float) * dim))
+		{
+			cout << "NcmHead::load broken label " << l << " " << path << endl;
+			clear();
+			return false;
+		}
+	}
+	updateMeans();
+
+	cout << "NcmHead ... " << getLearnedCount() << " label, " << getTotal() << " sample, dim " << dim << endl;
+
+	return true;
+}
+
+bool NcmHead::save(const string& path)
+{
+	NcmFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = NCM_FILE_MAGIC;
+	header.version = NCM_FILE_VERSION;
+	header.labelCount = (uint32_t)counts.size();
+	header.dim = (uint32_t)dim;
+
+	vector<char> buffer(sizeof(header) + counts.size() * (sizeof(uint32_t) + sizeof(float) * dim));
+	char* out = buffer.data();
+	memcpy(out, &header, sizeof(header));
+	out += sizeof(header);
+
+	for (size_t l = 0; l < counts.size(); ++l)
+	{
+		memcpy(out, &counts[l], sizeof(uint32_t));
+		out += sizeof(uint32_t);
+		memcpy(out, sums.data() + l * dim, sizeof(float) * dim);
+		out += sizeof(float) * dim;
+	}
+
+	return write_file_atomic(path, buffer.data(), buffer.size());
+}
+
+int NcmHead::getDim()
+{
+	return dim;
+}
+
+int NcmHead::getLabelCount()
+{
+	return (int)counts.size();
+}
+
+int NcmHead::getLearnedCount()
+{
+	return (int)count_if(counts.begin(), counts.end(), [](uint32_t c) { return c > 0; });
+}
+
+int NcmHead::getCount(int label)
+{
+	return label >= 0 && label < getLabelCount() ? (int)counts[label] : 0;
+}
+
+int NcmHead::getTotal()
+{
+	int total = 0;
+	for (uint32_t c : counts) total += (int)c;
+	return total;
+}
+
+bool NcmHead::score(const float* embedding, int dim, vector<float>& scores, float temperature)
+{
+	scores.assign(counts.size(), 0.0f);
+	if (dim != this->dim || getLearnedCount() == 0) return false;
+
+	query.resize(dim);
+	float norm = 0;
+	for (int i = 0; i < dim; ++i)
+	{
+		query[i] = embedding[i] - center[i];
+		norm += query[i] * query[i];
+	}
+	norm = sqrt(norm);
+	for (float& v : query) v = norm > 0 ? v / norm : 0.0f;
+
+	// 배운 label만 softmax (최대값을 빼서 exp overflow 방지)
+	float best = -1e30f;
+	for (size_t l = 0; l < counts.size(); ++l)
+	{
+		if (counts[l] == 0) continue;
+
+		const float* mean = means.data() + l * dim;
+		float cosine = 0;
+		for (int i = 0; i < dim; ++i) cosine += query[i] * mean[i];
+
+		scores[l] = temperature * cosine;
+		best = max(best, scores[l]);
+	}
+
+	float sum = 0;
+	for (size_t l = 0; l < counts.size(); ++l)
+	{
+		scores[l] = counts[l] > 0 ? exp(scores[l] - best) : 0.0f;
+		sum += scores[l];
+	}
+	for (float& s : scores) s /= sum;
+
+	return true;
+}
+
+void NcmHead::updateMeans()
+{
+	int labelCount = getLabelCount();
+	int total = getTotal();
+
+	center.assign(dim, 0.0f);
+	for (int l = 0; l < labelCount; ++l)
+	{
+		const float* sum = sums.data() + (size_t)l * dim;
+		for (int i = 0; i < dim; ++i) center[i] += sum[i];
+	}
+	for (float& v : center) v = total > 0 ? v / total : 0.0f;
+
+	means.assign((size_t)labelCount * dim, 0.0f);
+	for (int l = 0; l < labelCount; ++l)
+	{
+		if (counts[l] == 0) continue;
+
+		const float* sum = sums.data() + (size_t)l * dim;
+		float* mean = means.data() + (size_t)l * dim;
+
+		float norm = 0;
+		for (int i = 0; i < dim; ++i)
+		{
+			mean[i] = sum[i] / counts[l] - center[i];
+			norm += mean[i] * mean[i];
+		}
+		norm = sqrt(norm);
+		for (int i = 0; i < dim; ++i) mean[i] = norm > 0 ? mean[i] / norm : 0.0f;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// data/models/learned.ksnc (PATH_MODEL_FOLDER, KINECT_MODE_LEARNING이 update마다 저장)
+//   NcmFileHeader, label마다 uint32 샘플 수 + float [dim] 임베딩 합
+// 모델이 바뀌면 (임베딩 크기가 다르면) LearnedRecognizer가 쓰지 않는다
+#define NCM_HEAD_FILE_NAME "learned.ksnc"
+#define NCM_FILE_MAGIC 0x4E4C534B // "KSLN"
+#define NCM_FILE_VERSION 1
+
+struct NcmFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t labelCount;
+	uint32_t dim;
+	uint32_t reserved[4];
+};
+
+static_assert(sizeof(NcmFileHeader) == 32, "NcmFileHeader layout");
+
+// 임베딩 (InferenceModel::embed, L2 정규화) label별 평균 -> 가장 가까운 평균 (nearest class mean)
+//
+// 임베딩과 평균 모두 배운 샘플 전체 평균 (center)을 빼고 정규화 : 임베딩이 한 방향에 몰려 있어도 (cos이 모두 1 근처) label 차이가 남는다.
+// update는 label 합에 더하고 center와 평균들을 다시 만듦 (O(label x dim), 역전파 없음), 샘플 하나로도 바로 반영된다.
+// score : 배운 label만 cos(임베딩 - center, 평균) x temperature softmax, 배우지 않은 label은 0.
+// 평균은 합에서 매번 다시 만들므로 update 순서와 상관없이 같은 값.
+class NcmHead
+{
+private:
+	int dim = 0;
+	vector<uint32_t> counts; // label별 샘플 수, 0 : 배우지 않음
+	vector<float> sums; // [label][dim]
+	vector<float> center; // [dim] 배운 샘플 전체 평균
+	vector<float> means; // [label][dim] label 평균 - center를 L2 정규화
+	vector<float> query; // score 작업 버퍼
+
+public:
+	// 첫 임베딩이 dim을 정함
+	bool update(int label, const float* embedding, int dim);
+	// label 하나를 잊음 (잘못 배운 경우)
+	void forget(int label);
+	void clear();
+
+	bool load(const string& path);
+	// temp 파일에 쓴 뒤 rename (write_file_atomic), 중간에 꺼져도 이전 파일이 남는다
+	bool save(const string& path);
+
+	int getDim();
+	int getLabelCount(); // 가장 큰 label + 1
+	int getLearnedCount(); // 샘플이 있는 label 수
+	int getCount(int label);
+	int getTotal();
+
+	// scores : getLabelCount()개, false : 배운 label 없음 / dim 다름
+	bool score(const float* embedding, int dim, vector<float>& scores, float temperature = NCM_TEMPERATURE);
+
+private:
+	void updateMeans();
+};
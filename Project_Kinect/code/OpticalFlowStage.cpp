@@ -0,0 +1,120 @@
+#include "OpticalFlowStage.h"
+#include "ExtractionConfig.h"
+
+OpticalFlowStage::OpticalFlowStage()
+{
+	worker = thread(&OpticalFlowStage::run, this);
+}
+
+OpticalFlowStage::~OpticalFlowStage()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_all();
+
+	if (worker.joinable()) worker.join();
+}
+
+void OpticalFlowStage::push(int hand, int index, const cv::Mat& image)
+{
+	Job job;
+	job.hand = hand;
+	job.index = index;
+
+	// gray 변환이 복사를 겸한다 (ROI 버퍼는 다음 프레임에 재사용됨)
+	if (!image.empty())
+	{
+		cv::cvtColor(image, job.gray, CV_RGB2GRAY);
+	}
+
+	{
+		lock_guard<mutex> guard(lock);
+		jobs.push_back(job);
+	}
+	wake.notify_one();
+}
+
+void OpticalFlowStage::finish(ImageFrameCollection& lhand, ImageFrameCollection& rhand)
+{
+	unique_lock<mutex> guard(lock);
+	waitIdle(guard);
+
+	for (int h = 0; h < 2; ++h)
+	{
+		ImageFrameCollection& target = (h == 0 ? lhand : rhand);
+		int size = min((int)flows[h].size(), target.getCollectionSize());
+
+		for (int i = 0; i < size; ++i)
+		{
+			target.setFlow(i, flows[h][i]);
+		}
+	}
+}
+
+void OpticalFlowStage::clear()
+{
+	unique_lock<mutex> guard(lock);
+	jobs.clear();
+	waitIdle(guard);
+
+	for (int h = 0; h < 2; ++h)
+	{
+		prevGray[h] = cv::Mat();
+		flows[h].clear();
+	}
+}
+
+void OpticalFlowStage::waitIdle(unique_lock<mutex>& guard)
+{
+	idle.wait(guard, [&] { return jobs.empty() && !busy; });
+}
+
+void OpticalFlowStage::run()
+{
+	while (true)
+	{
+		Job job;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !jobs.empty() || !running; });
+			if (!running) return;
+
+			job = jobs.front();
+			jobs.pop_front();
+			busy = true;
+		}
+
+		// prev/flows는 worker만 쓰고, finish/clear는 idle일 때만 접근한다
+		cv::Mat flow = compute(prevGray[job.hand], job.gray);
+		if (!job.gray.empty()) prevGray[job.hand] = job.gray;
+
+		vector<cv::Mat>& target = flows[job.hand];
+		if ((int)target.size() <= job.index) target.resize(job.index + 1);
+		target[job.index] = flow;
+
+		{
+			lock_guard<mutex> guard(lock);
+			busy = false;
+		}
+		idle.notify_all();
+	}
+}
+
+cv::Mat OpticalFlowStage::compute(const cv::Mat& prev, const cv::Mat& next)
+{
+	int width = ExtractionConfig::current().imageWidth; // push되는 ROI가 기준 level
+	cv::Mat result(width, width, CV_8UC2, cv::Scalar(128, 128));
+
+	// 첫 프레임 또는 손 ROI 미검출 : 움직임 없음
+	if (prev.empty() || next.empty() || prev.size() != next.size()) return result;
+
+	// 80x80 (기본 imageWidth) 이므로 level 2, window 9 정도면 충분
+	cv::Mat flow;
+	cv::calcOpticalFlowFarneback(prev, next, flow, 0.5, 2, 9, 2, 5, 1.1, 0);
+
+	flow.convertTo(result, CV_8UC2, ROI_FLOW_SCALE, 128);
+
+	return result;
+}
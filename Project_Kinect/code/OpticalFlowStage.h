@@ -0,0 +1,59 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "ImageFrameCollection.h"
+
+// 손 ROI 연속 프레임간 dense optical flow
+//
+// updateFrame()에서 프레임이 쌓일 때마다 push, worker thread가 바로 계산한다.
+// 세그먼트가 끝나면 finish()로 남은 계산을 기다린 뒤 ImageFrame에 flow를 붙인다.
+// (setStandard 이전에 붙여야 표준화된 프레임이 자기 flow를 들고 간다)
+//
+// flow 저장 형식 : CV_8UC2, value = 128 + dx * ROI_FLOW_SCALE (saturate)
+class OpticalFlowStage
+{
+private:
+	struct Job
+	{
+		int hand; // 0 : left, 1 : right
+		int index; // collection index
+		cv::Mat gray;
+	};
+
+	thread worker;
+	mutex lock;
+	condition_variable wake;
+	condition_variable idle;
+	deque<Job> jobs;
+	bool busy = false;
+	bool running = true;
+
+	cv::Mat prevGray[2];
+	vector<cv::Mat> flows[2];
+
+public:
+	OpticalFlowStage();
+	~OpticalFlowStage();
+
+	void push(int hand, int index, const cv::Mat& image);
+
+	// 남은 job 완료 대기 후 collection에 flow 연결
+	void finish(ImageFrameCollection& lhand, ImageFrameCollection& rhand);
+
+	void clear();
+
+private:
+	void run();
+
+	void waitIdle(unique_lock<mutex>& guard);
+
+	static cv::Mat compute(const cv::Mat& prev, const cv::Mat& next);
+};
@@ -0,0 +1,282 @@
+#include "PredictChannel.h"
+
+#include <sddl.h> // ConvertStringSecurityDescriptorToSecurityDescriptorA
+#pragma comment(lib, "advapi32.lib") // vcxproj AdditionalDependencies에 기본 lib이 없음
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+	const DWORD PIPE_BUFFER_BYTES = 1 << 16;
+}
+
+PredictChannel::PredictChannel()
+{
+	connected = false;
+}
+
+PredictChannel::~PredictChannel()
+{
+	close();
+}
+
+int64_t PredictChannel::now()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+int64_t PredictChannel::frequency()
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return frequency.QuadPart;
+}
+
+bool PredictChannel::open()
+{
+	// overlapped 완료 통지용, manual reset (ReadFile / WriteFile이 시작할 때 reset)
+	if (readEvent == NULL) readEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (writeEvent == NULL) writeEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+	return readEvent != NULL && writeEvent != NULL;
+}
+
+bool PredictChannel::accept(DWORD timeoutMs)
+{
+	if (!open()) return false;
+
+	if (pipe == INVALID_HANDLE_VALUE)
+	{
+		// PREDICT_PIPE_REMOTE : 기본 DACL은 다른 PC client에게 쓰기를 주지 않음 -> 인증된 사용자 읽기 / 쓰기
+		SECURITY_ATTRIBUTES security;
+		memset(&security, 0, sizeof(security));
+		security.nLength = sizeof(security);
+		bool remote = PREDICT_PIPE_REMOTE
+			&& ConvertStringSecurityDescriptorToSecurityDescriptorA("D:(A;;GA;;;SY)(A;;GA;;;BA)(A;;GA;;;OW)(A;;GRGW;;;AU)", SDDL_REVISION_1, &security.lpSecurityDescriptor, NULL);
+
+		// instance 하나 : 같은 이름의 server(다른 Project_Kinect)가 있으면 실패
+		pipe = CreateNamedPipeA(PREDICT_PIPE_NAME,
+			PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+			PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | (remote ? PIPE_ACCEPT_REMOTE_CLIENTS : PIPE_REJECT_REMOTE_CLIENTS),
+			1, PIPE_BUFFER_BYTES, PIPE_BUFFER_BYTES, 0, remote ? &security : NULL);
+		if (remote) LocalFree(security.lpSecurityDescriptor);
+		else if (PREDICT_PIPE_REMOTE) cout << "PredictChannel::accept fail security descriptor " << GetLastError() << ", local predictor only" << endl;
+
+		if (pipe == INVALID_HANDLE_VALUE)
+		{
+			cout << "PredictChannel::accept fail CreateNamedPipe " << GetLastError() << endl;
+			return false;
+		}
+		isServer = true;
+	}
+
+	disconnect();
+
+	OVERLAPPED ov;
+	memset(&ov, 0, sizeof(ov));
+	ov.hEvent = readEvent;
+
+	if (!ConnectNamedPipe(pipe, &ov))
+	{
+		DWORD error = GetLastError();
+
+		if (error == ERROR_IO_PENDING)
+		{
+			DWORD transferred;
+
+			if (WaitForSingleObject(readEvent, timeoutMs) == WAIT_TIMEOUT) CancelIoEx(pipe, &ov);
+			if (!GetOverlappedResult(pipe, &ov, &transferred, TRUE)) return false; // timeout, cancel
+		}
+		else if (error != ERROR_PIPE_CONNECTED) // ConnectNamedPipe 전에 client가 먼저 붙은 경우는 성공
+		{
+			cout << "PredictChannel::accept fail ConnectNamedPipe " << error << endl;
+			return false;
+		}
+	}
+
+	hasClient = true;
+	connected = true;
+
+	return true;
+}
+
+bool PredictChannel::connect(DWORD timeoutMs, const string& name)
+{
+	close();
+	if (!open()) return false;
+
+	DWORD start = GetTickCount();
+
+	while (true)
+	{
+		pipe = CreateFileA(name.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+		if (pipe != INVALID_HANDLE_VALUE) break;
+
+		DWORD error = GetLastError();
+		if (timeoutMs != INFINITE && GetTickCount() - start >= timeoutMs) return false;
+
+		// BUSY : 다른 client가 연결 중, 그 외 (FILE_NOT_FOUND) : server가 아직 없음
+		if (error == ERROR_PIPE_BUSY) WaitNamedPipeA(name.c_str(), 100);
+		else Sleep(50);
+	}
+
+	isServer = false;
+	connected = true;
+
+	return true;
+}
+
+void PredictChannel::cancel()
+{
+	if (pipe != INVALID_HANDLE_VALUE) CancelIoEx(pipe, NULL);
+}
+
+void PredictChannel::disconnect()
+{
+	connected = false;
+
+	if (isServer && hasClient)
+	{
+		DisconnectNamedPipe(pipe);
+		hasClient = false;
+	}
+}
+
+void PredictChannel::close()
+{
+	disconnect();
+
+	if (pipe != INVALID_HANDLE_VALUE) CloseHandle(pipe);
+	if (readEvent != NULL) CloseHandle(readEvent);
+	if (writeEvent != NULL) CloseHandle(writeEvent);
+
+	pipe = INVALID_HANDLE_VALUE;
+	readEvent = NULL;
+	writeEvent = NULL;
+	isServer = false;
+}
+
+bool PredictChannel::isOpen()
+{
+	return pipe != INVALID_HANDLE_VALUE;
+}
+
+bool PredictChannel::isConnected()
+{
+	return connected;
+}
+
+bool PredictChannel::send(uint16_t type, const void* body, uint32_t size, const void* extra, uint32_t extraSize)
+{
+	lock_guard<mutex> guard(writeLock);
+
+	if (!connected) return false;
+
+	PredictMessageHeader header;
+	header.magic = PREDICT_PROTOCOL_MAGIC;
+	header.version = PREDICT_PROTOCOL_VERSION;
+	header.type = type;
+	header.size = size + extraSize;
+	header.reserved = 0;
+
+	writeBuffer.resize(sizeof(header) + size + extraSize);
+	memcpy(writeBuffer.data(), &header, sizeof(header));
+	if (size > 0) memcpy(writeBuffer.data() + sizeof(header), body, size);
+	if (extraSize > 0) memcpy(writeBuffer.data() + sizeof(header) + size, extra, extraSize);
+
+	return writeExact(writeBuffer.data(), (DWORD)writeBuffer.size());
+}
+
+bool PredictChannel::receive(Message& message, DWORD timeoutMs)
+{
+	if (!connected) return false;
+
+	bool timeout;
+	if (!readExact(reinterpret_cast<uint8_t*>(&message.header), sizeof(message.header), timeoutMs, timeout)) return false;
+
+	const PredictMessageHeader& header = message.header;
+	if (header.magic != PREDICT_PROTOCOL_MAGIC || header.version != PREDICT_PROTOCOL_VERSION || header.size > PREDICT_MESSAGE_MAX_BYTES)
+	{
+		// stream 위치를 잃었으므로 연결을 버린다
+		cout << "PredictChannel::receive bad message (magic " << hex << header.magic << dec
+			<< ", version " << header.version << ", size " << header.size << ")" << endl;
+		connected = false;
+		return false;
+	}
+
+	message.body.resize(header.size);
+	if (header.size > 0 && !readExact(message.body.data(), header.size, INFINITE, timeout))
+	{
+		connected = false;
+		return false;
+	}
+
+	return true;
+}
+
+bool PredictChannel::readExact(uint8_t* data, DWORD size, DWORD firstTimeoutMs, bool& timeout)
+{
+	DWORD done = 0;
+	timeout = false;
+
+	while (done < size)
+	{
+		OVERLAPPED ov;
+		memset(&ov, 0, sizeof(ov));
+		ov.hEvent = readEvent;
+
+		DWORD transferred = 0;
+
+		if (!ReadFile(pipe, data + done, size - done, NULL, &ov) && GetLastError() != ERROR_IO_PENDING)
+		{
+			connected = false; // ERROR_BROKEN_PIPE : 상대가 닫음
+			return false;
+		}
+
+		if (WaitForSingleObject(readEvent, done == 0 ? firstTimeoutMs : INFINITE) == WAIT_TIMEOUT) CancelIoEx(pipe, &ov);
+
+		if (!GetOverlappedResult(pipe, &ov, &transferred, TRUE))
+		{
+			// timeout 또는 cancel() : 읽은 것 없이 취소됐으면 연결은 그대로
+			if (GetLastError() == ERROR_OPERATION_ABORTED && done == 0)
+			{
+				timeout = true;
+				return false;
+			}
+
+			connected = false;
+			return false;
+		}
+
+		done += transferred;
+	}
+
+	return true;
+}
+
+bool PredictChannel::writeExact(const uint8_t* data, DWORD size)
+{
+	DWORD done = 0;
+
+	while (done < size)
+	{
+		OVERLAPPED ov;
+		memset(&ov, 0, sizeof(ov));
+		ov.hEvent = writeEvent;
+
+		DWORD transferred = 0;
+
+		if ((!WriteFile(pipe, data + done, size - done, NULL, &ov) && GetLastError() != ERROR_IO_PENDING)
+			|| !GetOverlappedResult(pipe, &ov, &transferred, TRUE))
+		{
+			connected = false;
+			return false;
+		}
+
+		done += transferred;
+	}
+
+	return true;
+}
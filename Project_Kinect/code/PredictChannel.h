@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Windows.h> // HANDLE, OVERLAPPED
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "PredictProtocol.h"
+
+// PredictProtocol 메시지를 named pipe로 주고받는 연결 하나 (형식은 PredictProtocol.h)
+//
+// server(Project_Kinect) : accept()로 client 연결 대기, 끊기면 다시 accept()
+// client(predictor, Project_Tools proto-loopback / predict-host) : connect(), 다른 PC의 station은 \\<pc>\pipe\KSL_Predict (PREDICT_PIPE_REMOTE)
+//
+// overlapped I/O라 한 thread가 receive()에서 기다리는 동안 다른 thread가 send() 가능
+// (동기 pipe handle은 같은 handle의 read / write가 서로를 기다린다).
+// receive는 한 thread에서만, send는 writeLock으로 메시지 단위 직렬화.
+class PredictChannel
+{
+public:
+	struct Message
+	{
+		PredictMessageHeader header;
+		vector<uint8_t> body;
+
+		// body 앞부분을 메시지 struct로, 크기가 모자라면 nullptr
+		template <class T>
+		const T* as() const
+		{
+			return body.size() >= sizeof(T) ? reinterpret_cast<const T*>(body.data()) : nullptr;
+		}
+	};
+
+private:
+	HANDLE pipe = INVALID_HANDLE_VALUE;
+	HANDLE readEvent = NULL;
+	HANDLE writeEvent = NULL;
+	bool isServer = false;
+	bool hasClient = false; // server : DisconnectNamedPipe 필요
+	atomic<bool> connected;
+	mutex writeLock;
+	vector<uint8_t> writeBuffer; // writeLock
+
+public:
+	PredictChannel();
+	~PredictChannel();
+
+	PredictChannel(const PredictChannel&) = delete;
+	PredictChannel& operator=(const PredictChannel&) = delete;
+
+	// server, 이전 client는 끊고 새 client 대기
+	bool accept(DWORD timeoutMs = INFINITE);
+	// client, server가 없으면 timeoutMs까지 다시 시도
+	bool connect(DWORD timeoutMs, const string& name = PREDICT_PIPE_NAME);
+
+	// 다른 thread의 accept / receive 대기를 깨움 (close 전에)
+	void cancel();
+	void close();
+	bool isOpen(); // pipe handle 있음 (server : CreateNamedPipe 성공)
+	bool isConnected();
+
+	// header + body + extra를 한 번에 씀 (extra : REQUEST inline 샘플, RESULT scores)
+	bool send(uint16_t type, const void* body, uint32_t size, const void* extra = nullptr, uint32_t extraSize = 0);
+
+	// false : timeout (isConnected() 그대로) 또는 끊김 / 형식 오류 (isConnected() false)
+	// timeout은 메시지 시작까지만, 일단 header를 받기 시작하면 끝까지 읽는다
+	bool receive(Message& message, DWORD timeoutMs = INFINITE);
+
+	static int64_t now(); // QueryPerformanceCounter
+	static int64_t frequency();
+
+private:
+	bool open();
+	void disconnect();
+
+	// exact size, firstTimeoutMs : 첫 바이트까지만
+	bool readExact(uint8_t* data, DWORD size, DWORD firstTimeoutMs, bool& timeout);
+	bool writeExact(const uint8_t* data, DWORD size);
+};
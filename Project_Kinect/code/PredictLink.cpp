@@ -0,0 +1,293 @@
+#include "PredictLink.h"
+
+#include <cstring>
+#include <chrono>
+
+namespace
+{
+	// worker가 running을 확인하는 주기 (accept / receive timeout)
+	const DWORD POLL_MS = 200;
+
+	double toMs(int64_t ticks, int64_t frequency)
+	{
+		return frequency > 0 ? ticks * 1000.0 / frequency : 0;
+	}
+}
+
+PredictLink::PredictLink()
+{
+	running = true;
+	sent = 0;
+	received = 0;
+	failed = 0;
+
+	if (PREDICT_PROTOCOL == PREDICT_PROTOCOL_PIPE)
+	{
+		worker = thread(&PredictLink::run, this);
+	}
+}
+
+PredictLink::~PredictLink()
+{
+	running = false;
+	channel.cancel();
+
+	if (worker.joinable()) worker.join();
+
+	if (channel.isConnected()) channel.send(PREDICT_MESSAGE_BYE, nullptr, 0);
+	channel.close();
+}
+
+bool PredictLink::submit(Sample& sample)
+{
+	int64_t submitTime = PredictChannel::now();
+	if (sample.segmentTime == 0) sample.segmentTime = submitTime;
+
+	bool usePipe = PREDICT_PROTOCOL == PREDICT_PROTOCOL_PIPE && channel.isConnected();
+	// PREDICT_PIPE_REMOTE : predictor가 다른 PC일 수 있으니 연결되어 있으면 ring 없이 inline
+	bool useRing = PREDICT_HANDOFF == PREDICT_HANDOFF_RING && !ringFailed && !(PREDICT_PIPE_REMOTE && usePipe);
+
+	if (useRing && !ring.isOpen() && !ring.create())
+	{
+		cout << "PredictLink::submit ring fail, predict sample -> " << (usePipe ? "inline" : "data/temp") << endl;
+		ringFailed = true;
+		useRing = false;
+	}
+
+	if (!useRing && !usePipe) return false;
+
+	if (!SampleFile::serialize(sample, buffer))
+	{
+		++failed;
+		return false;
+	}
+
+	PredictRequest request;
+	memset(&request, 0, sizeof(request));
+
+	vector<TIMESPAN> timeline = sample.frames.getTimeline();
+	if (!timeline.empty())
+	{
+		request.captureStart = timeline.front();
+		request.captureEnd = timeline.back();
+	}
+	request.segmentTime = sample.segmentTime;
+	request.label = sample.label;
+	request.sampleSize = (uint32_t)buffer.size();
+	request.ringNumber = useRing ? ring.publish(buffer.data(), buffer.size(), sample.label) : -1;
+
+	// ring만 (PREDICT_PROTOCOL_STDOUT, predictor 미연결) : ring event로 깨어난 consumer가 최신 샘플을 가져간다
+	if (!usePipe)
+	{
+		if (request.ringNumber < 0) ++failed;
+		else ++sent;
+
+		cout << sample.labelName << " Predict sending ... " << (request.ringNumber >= 0 ? "ring " : "fail ") << request.ringNumber
+			<< " (" << buffer.size() << " byte, " << toMs(PredictChannel::now() - sample.segmentTime, PredictChannel::frequency()) << "ms)" << endl;
+
+		return request.ringNumber >= 0;
+	}
+
+	// ring 발행 실패 -> inline
+	bool inlined = request.ringNumber < 0;
+
+	{
+		lock_guard<mutex> guard(lock);
+		request.requestId = nextId++;
+		request.sendTime = PredictChannel::now();
+		pending[request.requestId] = { request, submitTime };
+	}
+
+	bool result = channel.send(PREDICT_MESSAGE_REQUEST, &request, sizeof(request),
+		inlined ? buffer.data() : nullptr, inlined ? (uint32_t)buffer.size() : 0);
+
+	if (result) ++sent;
+	else
+	{
+		{
+			lock_guard<mutex> guard(lock);
+			pending.erase(request.requestId);
+			++failed;
+		}
+		settled.notify_all();
+	}
+
+	cout << sample.labelName << " Predict sending ... " << (result ? "done #" : "fail #") << request.requestId
+		<< (inlined ? " inline" : " ring " + to_string(request.ringNumber))
+		<< " (" << buffer.size() << " byte, " << toMs(request.sendTime - submitTime, PredictChannel::frequency()) << "ms)" << endl;
+
+	return result;
+}
+
+bool PredictLink::poll(Completed& result)
+{
+	lock_guard<mutex> guard(lock);
+
+	if (completed.empty()) return false;
+
+	result = move(completed.front());
+	completed.pop_front();
+
+	return true;
+}
+
+int PredictLink::getSent()
+{
+	return sent;
+}
+
+int PredictLink::getReceived()
+{
+	return received;
+}
+
+int PredictLink::getFailed()
+{
+	return failed;
+}
+
+int PredictLink::getOutstanding()
+{
+	lock_guard<mutex> guard(lock);
+	return (int)pending.size();
+}
+
+bool PredictLink::waitOutstanding(int limit, DWORD timeoutMs)
+{
+	unique_lock<mutex> guard(lock);
+	return settled.wait_for(guard, chrono::milliseconds(timeoutMs), [&] { return (int)pending.size() < limit; });
+}
+
+bool PredictLink::isConnected()
+{
+	return channel.isConnected();
+}
+
+double PredictLink::getLastLatency()
+{
+	lock_guard<mutex> guard(lock);
+	return lastTotalMs;
+}
+
+void PredictLink::run()
+{
+	while (running)
+	{
+		if (!channel.isConnected())
+		{
+			dropPending();
+
+			if (!channel.accept(POLL_MS))
+			{
+				// pipe 자체를 못 만듦 (다른 Project_Kinect가 server) : ring / data/temp만 사용
+				if (!channel.isOpen())
+				{
+					cout << "PredictLink ... pipe unavailable, predict without " << PREDICT_PIPE_NAME << endl;
+					return;
+				}
+				continue;
+			}
+
+			PredictHello hello;
+			memset(&hello, 0, sizeof(hello));
+			hello.role = 0;
+			hello.timerFrequency = PredictChannel::frequency();
+			memcpy(hello.name, "Project_Kinect", sizeof("Project_Kinect"));
+
+			channel.send(PREDICT_MESSAGE_HELLO, &hello, sizeof(hello));
+			continue;
+		}
+
+		PredictChannel::Message message;
+		if (!channel.receive(message, POLL_MS)) continue;
+
+		switch (message.header.type)
+		{
+		case PREDICT_MESSAGE_HELLO:
+			if (const PredictHello* hello = message.as<PredictHello>())
+			{
+				string name(hello->name, strnlen(hello->name, sizeof(hello->name)));
+				cout << "PredictLink ... predictor connected " << name << " (label " << hello->labelCount << ")" << endl;
+
+				// 다른 clock이면 transfer / infer 시간은 의미 없음
+				if (hello->timerFrequency != PredictChannel::frequency())
+				{
+					cout << "PredictLink ... predictor timer frequency mismatch " << hello->timerFrequency << endl;
+				}
+			}
+			break;
+
+		case PREDICT_MESSAGE_RESULT:
+			onResult(message);
+			break;
+
+		case PREDICT_MESSAGE_BYE:
+			cout << "PredictLink ... predictor bye" << endl;
+			break;
+
+		default:
+			cout << "PredictLink ... unknown message " << message.header.type << endl;
+			break;
+		}
+	}
+}
+
+void PredictLink::onResult(const PredictChannel::Message& message)
+{
+	const PredictResult* result = message.as<PredictResult>();
+	if (result == nullptr || result->labelCount > PREDICT_LABEL_MAX
+		|| message.body.size() < sizeof(PredictResult) + result->labelCount * sizeof(float))
+	{
+		cout << "PredictLink::onResult bad result (" << message.body.size() << " byte)" << endl;
+		return;
+	}
+
+	int64_t now = PredictChannel::now();
+	int64_t frequency = PredictChannel::frequency();
+	const float* scores = reinterpret_cast<const float*>(message.body.data() + sizeof(PredictResult));
+
+	unique_lock<mutex> guard(lock);
+
+	auto it = pending.find(result->requestId);
+	if (it == pending.end())
+	{
+		// 연결이 끊겨 버린 요청의 늦은 결과
+		cout << "PredictLink::onResult unknown request #" << result->requestId << endl;
+		return;
+	}
+
+	const PredictRequest& request = it->second.request;
+	int64_t submitTime = it->second.submitTime;
+
+	Completed done;
+	done.requestId = result->requestId;
+	done.top = result->top;
+	done.confidence = result->confidence;
+	done.scores.assign(scores, scores + result->labelCount);
+	done.captureStart = request.captureStart;
+	done.captureEnd = request.captureEnd;
+	done.totalMs = toMs(now - request.segmentTime, frequency);
+	done.queueMs = toMs(submitTime - request.segmentTime, frequency);
+	done.sendMs = toMs(request.sendTime - submitTime, frequency);
+	done.transferMs = toMs(result->receiveTime - request.sendTime, frequency);
+	done.inferMs = toMs(result->doneTime - result->receiveTime, frequency);
+
+	lastTotalMs = done.totalMs;
+	completed.push_back(move(done));
+	pending.erase(it);
+	++received;
+
+	guard.unlock();
+	settled.notify_all();
+}
+
+void PredictLink::dropPending()
+{
+	{
+		lock_guard<mutex> guard(lock);
+
+		failed += (int)pending.size();
+		pending.clear();
+	}
+	settled.notify_all();
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "SampleRing.h"
+#include "PredictChannel.h"
+
+// Project_Kinect 쪽 predict 요청 송신 / 결과 수신
+//
+// submit : serialize -> SampleRing 발행 (PREDICT_HANDOFF_RING) -> REQUEST (PREDICT_PROTOCOL_PIPE)
+//   ring을 못 쓰면 샘플을 REQUEST 뒤에 inline으로 붙인다.
+//   PREDICT_PROTOCOL_STDOUT이면 REQUEST 없이 ring 발행만 (predictor는 ring event로 깨어남).
+// worker thread : predictor 연결 대기 -> HELLO 교환 -> RESULT 수신, 끊기면 다시 대기
+//   RESULT는 requestId로 보낸 요청과 짝지어 Completed로 쌓고, Kinect(main thread)가 poll로 꺼낸다.
+//   요청마다 응답을 기다리지 않으므로 연달아 온 수어도 각자 자기 결과를 받는다.
+// 몇 개까지 결과를 기다리게 둘지는 PredictQueue가 waitOutstanding으로 정한다.
+class PredictLink
+{
+public:
+	struct Completed
+	{
+		uint64_t requestId;
+		int top; // -1 : predictor 실패
+		float confidence;
+		vector<float> scores;
+		int64_t captureStart; // Kinect RelativeTime
+		int64_t captureEnd;
+		double totalMs; // 세그먼트 완료 ~ 결과 수신
+		double queueMs; // 세그먼트 완료 ~ submit (PredictQueue 대기)
+		double sendMs; // submit ~ 요청 송신 (serialize, ring 복사), native : 입력 텐서 준비
+		double transferMs; // 요청 송신 ~ predictor 수신, native : 0
+		double inferMs; // predictor 수신 ~ 예측 완료
+		bool early = false; // PredictQueue cascade gate가 답함 (이미지 경로 없음)
+		int segment = -1; // PredictQueue::push / pushPartial에 넘긴 번호 (recognizer만, PredictLink는 -1)
+		int checkpoint = -1; // 진행 중 prefix (PredictQueue::pushPartial, EarlyExit), -1 : 세그먼트 전체
+		int learn = -1; // KINECT_MODE_LEARNING : 배우라고 보낸 label (PredictQueue::push), top / scores는 배우기 전 결과
+		bool learned = false; // learn을 반영하고 저장함
+		double learnMs = 0; // 갱신 + 저장
+	};
+
+private:
+	struct Pending
+	{
+		PredictRequest request;
+		int64_t submitTime; // QPC
+	};
+
+	SampleRing ring;
+	bool ringFailed = false;
+	PredictChannel channel;
+	vector<uint8_t> buffer; // submit은 한 thread에서만
+
+	thread worker;
+	atomic<bool> running;
+
+	mutex lock;
+	condition_variable settled; // pending이 줄었음
+	map<uint64_t, Pending> pending; // 결과 대기 중인 요청
+	deque<Completed> completed;
+	uint64_t nextId = 1;
+
+	atomic<int> sent;
+	atomic<int> received;
+	atomic<int> failed; // 송신 실패, 연결이 끊겨 버린 요청
+	double lastTotalMs = 0; // lock
+
+public:
+	PredictLink();
+	~PredictLink();
+
+	// false : 보낼 곳이 없음 (ring, pipe 둘 다 실패) -> 호출측이 data/temp + "[Predict]"
+	// sample.segmentTime이 0이면 지금 시각
+	bool submit(Sample& sample);
+
+	// main thread에서 결과 꺼내기
+	bool poll(Completed& result);
+
+	int getSent();
+	int getReceived();
+	int getFailed();
+	int getOutstanding();
+	// 결과 대기 요청이 limit 미만이 될 때까지, false : timeout
+	bool waitOutstanding(int limit, DWORD timeoutMs);
+	bool isConnected();
+	double getLastLatency(); // ms
+
+private:
+	void run();
+
+	void onResult(const PredictChannel::Message& message);
+
+	// 연결이 끊기면 대기 중인 요청은 결과가 오지 않는다
+	void dropPending();
+};
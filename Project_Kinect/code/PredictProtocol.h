@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+// predict 요청 / 결과 메시지 형식 (PREDICT_PROTOCOL_PIPE, PredictChannel.h)
+// Kinect / Windows 의존 없음 : Project_DNN/scripts/protocol.py가 같은 형식을 쓴다
+//
+// named pipe PREDICT_PIPE_NAME, Project_Kinect가 server, predictor(do_Predict.py)가 client
+// 메시지 = [PredictMessageHeader][body (header.size byte)]  (little endian, byte stream)
+//
+//   HELLO   양쪽 연결 직후 한 번, 버전 / label 수 / timer 확인
+//   REQUEST Kinect -> predictor, 샘플 하나 = requestId 하나
+//           ringNumber >= 0 : 샘플은 SampleRing의 그 번호 slot, < 0 : body 뒤에 sample.ksl 바이트 (sampleSize)
+//   RESULT  predictor -> Kinect, 같은 requestId + label별 확률 (labelCount개 float)
+//   BYE     정상 종료
+//
+// requestId로 결과를 짝지으므로 응답을 기다리지 않고 여러 요청을 연달아 보내도 된다 (pipelining).
+// 시각은 모두 QueryPerformanceCounter (같은 PC의 두 process가 같은 clock), captureStart/End만 Kinect RelativeTime (100ns)
+//
+// 형식이 바뀌면 PREDICT_PROTOCOL_VERSION을 올리고 protocol.py도 같이 수정
+
+#define PREDICT_PIPE_NAME "\\\\.\\pipe\\KSL_Predict"
+#define PREDICT_PROTOCOL_MAGIC 0x504C534B // "KSLP"
+#define PREDICT_PROTOCOL_VERSION 1
+#define PREDICT_MESSAGE_MAX_BYTES (16 << 20) // body 최대 (inline 샘플 포함), 넘으면 연결 끊음
+#define PREDICT_LABEL_MAX 256
+
+enum PREDICT_MESSAGE
+{
+	PREDICT_MESSAGE_HELLO = 1,
+	PREDICT_MESSAGE_REQUEST,
+	PREDICT_MESSAGE_RESULT,
+	PREDICT_MESSAGE_BYE,
+};
+
+struct PredictMessageHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t type; // PREDICT_MESSAGE
+	uint32_t size; // body byte
+	uint32_t reserved;
+};
+
+struct PredictHello
+{
+	uint32_t role; // 0 : server(Kinect), 1 : predictor
+	uint32_t labelCount; // predictor : 출력 label 수, server : 0
+	int64_t timerFrequency; // QueryPerformanceFrequency
+	char name[32];
+};
+
+struct PredictRequest
+{
+	uint64_t requestId;
+	int64_t captureStart; // 세그먼트 첫 프레임 (Kinect RelativeTime)
+	int64_t captureEnd; // 마지막 프레임
+	int64_t segmentTime; // 세그먼트 완료 (QPC)
+	int64_t sendTime; // 요청 보낸 시각 (QPC)
+	int64_t ringNumber; // SampleRing 번호, -1 : inline
+	int32_t label; // 녹화 중 선택된 label (predict에서는 참고용)
+	uint32_t sampleSize; // inline 샘플 byte (ringNumber >= 0 이면 ring slot 크기)
+};
+
+struct PredictResult
+{
+	uint64_t requestId;
+	int64_t sendTime; // REQUEST의 sendTime 그대로
+	int64_t receiveTime; // predictor가 요청을 받은 시각 (QPC)
+	int64_t doneTime; // 예측 완료 (QPC)
+	int32_t top; // 가장 높은 label, -1 : 실패 (샘플 없음 / parse 실패)
+	float confidence; // scores[top]
+	uint32_t labelCount; // body 뒤 float scores[labelCount]
+	uint32_t reserved;
+};
+
+static_assert(sizeof(PredictMessageHeader) == 16, "PredictMessageHeader layout");
+static_assert(sizeof(PredictHello) == 48, "PredictHello layout");
+static_assert(sizeof(PredictRequest) == 56, "PredictRequest layout");
+static_assert(sizeof(PredictResult) == 48, "PredictResult layout");
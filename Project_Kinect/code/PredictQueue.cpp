@@ -0,0 +1,453 @@
+#include "PredictQueue.h"
+
+#include <chrono>
+
+namespace
+{
+	// dispatcher가 running을 확인하는 주기 (in-flight 대기)
+	const DWORD POLL_MS = 200;
+
+	double toMs(int64_t ticks)
+	{
+		int64_t frequency = PredictChannel::frequency();
+		return frequency > 0 ? ticks * 1000.0 / frequency : 0;
+	}
+}
+
+PredictQueue::PredictQueue(SampleSaver& saver, int policy, int capacity, int maxInFlight, int backend, int gateBackend, float gateMargin,
+	float gateMaxDistance)
+	: saver(saver)
+{
+	recognizer = Recognizer::create(backend);
+	if (recognizer && !recognizer->isReady())
+	{
+		cout << "PredictQueue ... " << recognizer->getName() << " not ready, predict with python" << endl;
+		recognizer.reset();
+	}
+	backendName = recognizer ? recognizer->getName() : string("python");
+
+	// gate와 뒤 단계가 같으면 cascade 의미 없음
+	if (gateBackend != backend) gate = Recognizer::create(gateBackend);
+	if (gate && !gate->isReady())
+	{
+		cout << "PredictQueue ... gate " << gate->getName() << " not ready, no cascade" << endl;
+		gate.reset();
+	}
+	this->gateMargin = gateMargin;
+	this->gateMaxDistance = gateMaxDistance;
+
+	this->policy = policy;
+	this->capacity = policy == PREDICT_QUEUE_COALESCE_LATEST ? 1 : max(capacity, 1);
+	this->maxInFlight = max(maxInFlight, 1);
+	pushed = 0;
+	dispatched = 0;
+	dropped = 0;
+	coalesced = 0;
+	partials = 0;
+
+	dispatcher = thread(&PredictQueue::run, this);
+}
+
+PredictQueue::~PredictQueue()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+		dropped += (int)requests.size();
+		requests.clear();
+		hasPartial = false;
+	}
+	wake.notify_all();
+	space.notify_all();
+
+	if (dispatcher.joinable()) dispatcher.join();
+
+	if (gate && answered > 0)
+	{
+		cout << "PredictQueue ... cascade " << gate->getName() << " early " << early << " / " << answered << " (" << 100.0 * early / answered << "%)"
+			<< ", mean " << totalSum / answered << "ms (early " << getMeanEarlyLatency() << "ms, late " << getMeanLateLatency() << "ms)" << endl;
+	}
+}
+
+bool PredictQueue::push(Sample&& sample, int segment, int learn)
+{
+	if (learn >= 0 && !recognizer)
+	{
+		cout << sample.labelName << " Learn ... no recognizer (" << getBackendName() << ")" << endl;
+		return false;
+	}
+
+	{
+		unique_lock<mutex> guard(lock);
+		++pushed;
+
+		if ((int)requests.size() >= capacity)
+		{
+			switch (policy)
+			{
+			case PREDICT_QUEUE_BLOCK:
+				// capture thread가 멈춘다, predictor가 멈췄으면 timeout 후 새 요청을 버림
+				if (!space.wait_for(guard, chrono::milliseconds(PREDICT_QUEUE_BLOCK_TIMEOUT_MS),
+					[&] { return (int)requests.size() < capacity || !running; }) || !running)
+				{
+					++dropped;
+					cout << sample.labelName << " Predict queue ... drop (blocked " << PREDICT_QUEUE_BLOCK_TIMEOUT_MS << "ms)" << endl;
+					return false;
+				}
+				break;
+
+			case PREDICT_QUEUE_COALESCE_LATEST:
+				coalesced += (int)requests.size();
+				cout << requests.back().sample.labelName << " Predict queue ... coalesced -> " << sample.labelName << endl;
+				requests.clear();
+				break;
+
+			default: // PREDICT_QUEUE_DROP_OLDEST
+				++dropped;
+				cout << requests.front().sample.labelName << " Predict queue ... drop oldest (" << toMs(PredictChannel::now() - requests.front().pushTime) << "ms waited)" << endl;
+				requests.pop_front();
+				break;
+			}
+		}
+
+		Request request;
+		request.sample = move(sample);
+		request.pushTime = PredictChannel::now();
+		request.segment = segment;
+		request.learn = learn;
+		requests.push_back(move(request));
+	}
+	wake.notify_one();
+
+	return true;
+}
+
+bool PredictQueue::pushPartial(Sample&& sample, int segment, int checkpoint)
+{
+	if (!recognizer) return false;
+
+	{
+		lock_guard<mutex> guard(lock);
+		if (!running) return false;
+
+		partial.sample = move(sample);
+		partial.pushTime = PredictChannel::now();
+		partial.segment = segment;
+		partial.checkpoint = checkpoint;
+		hasPartial = true;
+	}
+	wake.notify_one();
+
+	return true;
+}
+
+bool PredictQueue::poll(PredictLink::Completed& result)
+{
+	lock_guard<mutex> guard(lock);
+
+	if (!completed.empty())
+	{
+		result = move(completed.front());
+		completed.pop_front();
+	}
+	else if (!link.poll(result)) return false;
+
+	if (result.checkpoint >= 0 || result.learn >= 0) return true; // prefix, learn은 cascade 통계에서 제외
+
+	++answered;
+	totalSum += result.totalMs;
+	if (result.early)
+	{
+		++early;
+		earlySum += result.totalMs;
+	}
+
+	return true;
+}
+
+PredictLink& PredictQueue::getPredictLink()
+{
+	return link;
+}
+
+bool PredictQueue::isNative()
+{
+	return recognizer != nullptr;
+}
+
+string PredictQueue::getBackendName()
+{
+	lock_guard<mutex> guard(lock);
+	return backendName;
+}
+
+double PredictQueue::getLastLatency()
+{
+	lock_guard<mutex> guard(lock);
+	return lastTotal;
+}
+
+string PredictQueue::getGateName()
+{
+	return gate ? gate->getName() : string();
+}
+
+int PredictQueue::getAnswered()
+{
+	lock_guard<mutex> guard(lock);
+	return answered;
+}
+
+int PredictQueue::getEarly()
+{
+	lock_guard<mutex> guard(lock);
+	return early;
+}
+
+double PredictQueue::getMeanLatency()
+{
+	lock_guard<mutex> guard(lock);
+	return answered > 0 ? totalSum / answered : 0;
+}
+
+double PredictQueue::getMeanEarlyLatency()
+{
+	lock_guard<mutex> guard(lock);
+	return early > 0 ? earlySum / early : 0;
+}
+
+double PredictQueue::getMeanLateLatency()
+{
+	lock_guard<mutex> guard(lock);
+	return answered > early ? (totalSum - earlySum) / (answered - early) : 0;
+}
+
+bool PredictQueue::isBusy()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		if (!requests.empty() || hasPartial || working) return true;
+	}
+	return link.getOutstanding() > 0;
+}
+
+int PredictQueue::getPartials()
+{
+	return partials;
+}
+
+int PredictQueue::getDepth()
+{
+	lock_guard<mutex> guard(lock);
+	return (int)requests.size();
+}
+
+int PredictQueue::getPushed()
+{
+	return pushed;
+}
+
+int PredictQueue::getDispatched()
+{
+	return dispatched;
+}
+
+int PredictQueue::getDropped()
+{
+	return dropped;
+}
+
+int PredictQueue::getCoalesced()
+{
+	return coalesced;
+}
+
+double PredictQueue::getLastWait()
+{
+	lock_guard<mutex> guard(lock);
+	return lastWait;
+}
+
+double PredictQueue::getMeanWait()
+{
+	lock_guard<mutex> guard(lock);
+	return dispatched > 0 ? waitSum / dispatched : 0;
+}
+
+double PredictQueue::getMaxWait()
+{
+	lock_guard<mutex> guard(lock);
+	return waitMax;
+}
+
+const char* PredictQueue::getPolicyName(int policy)
+{
+	switch (policy)
+	{
+	case PREDICT_QUEUE_DROP_OLDEST: return "drop-oldest";
+	case PREDICT_QUEUE_COALESCE_LATEST: return "coalesce-latest";
+	case PREDICT_QUEUE_BLOCK: return "block";
+	}
+	return "unknown";
+}
+
+void PredictQueue::run()
+{
+	while (true)
+	{
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !requests.empty() || hasPartial || !running; });
+			if (!running) return;
+		}
+
+		// backpressure : 결과가 오거나 연결이 끊길 때까지 다음 요청은 큐에서 기다린다 (그 사이 policy 적용)
+		// recognizer는 이 thread에서 끝까지 돌리므로 기다릴 것이 없다, gate가 있으면 넘길 때만 기다린다
+		while (running && !recognizer && !gate && !link.waitOutstanding(maxInFlight, POLL_MS));
+
+		Request request;
+		{
+			lock_guard<mutex> guard(lock);
+			if (!running) return;
+
+			if (!requests.empty())
+			{
+				request = move(requests.front());
+				requests.pop_front();
+
+				lastWait = toMs(PredictChannel::now() - request.pushTime);
+				waitSum += lastWait;
+				waitMax = max(waitMax, lastWait);
+				++dispatched;
+			}
+			else if (hasPartial)
+			{
+				// prefix는 세그먼트 요청이 없을 때만
+				request = move(partial);
+				hasPartial = false;
+			}
+			else continue;
+
+			working = true;
+		}
+		space.notify_all();
+
+		if (request.checkpoint >= 0)
+		{
+			recognize(request);
+			++partials;
+		}
+		else dispatch(request);
+
+		lock_guard<mutex> guard(lock);
+		working = false;
+	}
+}
+
+void PredictQueue::dispatch(Request& request)
+{
+	if (request.learn >= 0)
+	{
+		learn(request);
+		return;
+	}
+
+	if (gate && answerEarly(request)) return;
+
+	if (recognizer)
+	{
+		recognize(request);
+		return;
+	}
+
+	while (running && gate && !link.waitOutstanding(maxInFlight, POLL_MS));
+	if (!running)
+	{
+		++dropped; // 종료, 결과를 받을 곳이 없음
+		return;
+	}
+
+	if (!link.submit(request.sample))
+	{
+		// data/temp + "[Predict]" (SampleSaver, 쓰기가 끝난 뒤 출력)
+		saver.push(move(request.sample), string(PATH_DATA_FOLDER) + "temp/", true);
+	}
+}
+
+bool PredictQueue::answerEarly(Request& request)
+{
+	int64_t dispatchTime = PredictChannel::now();
+
+	Recognition recognition;
+	if (!gate->recognize(request.sample, recognition) || recognition.getMargin() < gateMargin) return false;
+	if (gateMaxDistance > 0 && recognition.distance > gateMaxDistance) return false;
+
+	// 배운 label이 후보면 recognizer (NcmHead)가 정함
+	for (int l = 0; recognizer && l < (int)recognition.scores.size(); ++l)
+	{
+		if (recognition.scores[l] > 0 && recognizer->isAdapted(l)) return false;
+	}
+
+	complete(request, recognition, true, dispatchTime, true);
+	return true;
+}
+
+void PredictQueue::recognize(Request& request)
+{
+	int64_t dispatchTime = PredictChannel::now();
+
+	Recognition recognition;
+	bool result = recognizer->recognize(request.sample, recognition);
+
+	if (!result && request.checkpoint < 0) cout << request.sample.labelName << " Predict ... " << recognizer->getName() << " fail" << endl;
+
+	complete(request, recognition, result, dispatchTime, false);
+}
+
+void PredictQueue::learn(Request& request)
+{
+	int64_t dispatchTime = PredictChannel::now();
+
+	Recognition recognition;
+	request.learned = recognizer->learn(request.sample, request.learn, recognition);
+
+	if (!request.learned) cout << request.sample.labelName << " Learn ... " << recognizer->getName() << " fail" << endl;
+
+	{
+		lock_guard<mutex> guard(lock);
+		backendName = recognizer->getName();
+	}
+
+	complete(request, recognition, recognition.top >= 0, dispatchTime, false);
+}
+
+void PredictQueue::complete(Request& request, Recognition& recognition, bool result, int64_t dispatchTime, bool early)
+{
+	Sample& sample = request.sample;
+
+	PredictLink::Completed done;
+	done.top = result ? recognition.top : -1;
+	done.confidence = recognition.confidence;
+	done.scores = move(recognition.scores);
+
+	vector<TIMESPAN> timeline = sample.frames.getTimeline();
+	done.captureStart = timeline.empty() ? 0 : timeline.front();
+	done.captureEnd = timeline.empty() ? 0 : timeline.back();
+
+	done.totalMs = toMs(PredictChannel::now() - sample.segmentTime);
+	done.queueMs = toMs(dispatchTime - sample.segmentTime);
+	done.sendMs = recognition.prepareMs;
+	done.transferMs = 0;
+	done.inferMs = recognition.inferMs;
+	done.early = early;
+	done.segment = request.segment;
+	done.checkpoint = request.checkpoint;
+	done.learn = request.learn;
+	done.learned = request.learned;
+	done.learnMs = recognition.learnMs;
+
+	lock_guard<mutex> guard(lock);
+	done.requestId = nextId++;
+	if (request.checkpoint < 0) lastTotal = done.totalMs;
+	completed.push_back(move(done));
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "SampleSaver.h"
+#include "PredictLink.h"
+#include "Recognizer.h"
+
+// 세그먼트(Kinect::save) -> predictor 사이 요청 큐
+//
+// 수어를 연달아 하면 predictor가 앞 샘플을 끝내기 전에 다음 세그먼트가 나온다.
+// dispatcher thread가 결과 대기 요청이 maxInFlight 미만일 때만 PredictLink로 넘기고 (backpressure),
+// 그 동안 쌓이는 요청은 policy대로 처리한다 (PREDICT_QUEUE_DROP_OLDEST / COALESCE_LATEST / BLOCK).
+// maxInFlight를 ring slot 수 이하로 두면 predictor가 읽기 전에 slot이 덮이지 않는다.
+//
+// PredictLink로 못 보내면 (ring, pipe 둘 다 없음) SampleSaver가 data/temp에 쓰고 "[Predict]"를 출력한다.
+// 결과를 모르는 경로(ring만, data/temp)는 in-flight 제한 없이 바로 넘긴다.
+//
+// PREDICT_BACKEND_NATIVE / DTW / BATCH면 dispatcher thread가 Recognizer로 직접 추론한다 (in-flight는 항상 1, python 없음).
+// 결과는 어느 경로든 poll()로 같은 Completed 형식.
+//
+// PREDICT_GATE (cascade) : dispatcher가 먼저 skeleton만 보는 gate recognizer를 돌리고,
+// top-1 margin이 PREDICT_GATE_MARGIN 이상이면 그 결과로 끝낸다 (serialize, ring / data/temp 쓰기, 이미지 branch 없음).
+// margin은 상대값이라 등록된 어느 수어와도 먼 동작도 통과할 수 있어, 가장 가까운 이웃 거리가 PREDICT_GATE_MAX_DISTANCE보다 멀면 넘긴다.
+// 애매할 때만 위 경로로 넘긴다. 넘긴 요청은 in-flight가 빌 때까지 dispatcher가 들고 기다린다.
+//
+// push(learn) (KINECT_MODE_LEARNING) : 같은 dispatcher에서 Recognizer::learn (gate 없음), 결과에 배우기 전 예측과 갱신 시간.
+// gate는 배운 것을 모르므로, gate 후보 (score > 0) 중에 배운 label (Recognizer::isAdapted)이 있으면 답하지 않고 넘긴다.
+//
+// pushPartial (EarlyExit) : 진행 중 세그먼트 prefix는 큐와 따로 최신 하나만 두고, 대기 요청이 없을 때만 recognizer로 (gate 없음).
+// 세그먼트 요청을 밀어내지 않으며 python 경로로는 보내지 않는다.
+class PredictQueue
+{
+private:
+	struct Request
+	{
+		Sample sample;
+		int64_t pushTime; // QPC
+		int segment = -1;
+		int checkpoint = -1; // prefix
+		int learn = -1; // 배울 label
+		bool learned = false;
+	};
+
+	SampleSaver& saver;
+	PredictLink link;
+	unique_ptr<Recognizer> recognizer; // nullptr : python (PredictLink)
+	string backendName; // lock, learn이 바꾸므로 dispatcher가 갱신
+	unique_ptr<Recognizer> gate; // nullptr : cascade 없음
+	float gateMargin;
+	float gateMaxDistance; // 0 : 검사 안함
+	thread dispatcher;
+
+	mutex lock;
+	condition_variable wake;
+	condition_variable space; // BLOCK
+	deque<Request> requests;
+	Request partial; // 최신 prefix 하나
+	bool hasPartial = false;
+	deque<PredictLink::Completed> completed; // recognizer 결과
+	uint64_t nextId = 1;
+	int policy;
+	int capacity;
+	int maxInFlight;
+	bool running = true;
+	bool working = false; // dispatcher가 요청 처리 중
+
+	atomic<int> pushed;
+	atomic<int> dispatched;
+	atomic<int> dropped;
+	atomic<int> coalesced;
+	atomic<int> partials; // recognizer로 돌린 prefix
+	double waitSum = 0; // lock, ms
+	double waitMax = 0;
+	double lastWait = 0;
+	double lastTotal = 0; // recognizer
+
+	// poll된 결과 (cascade 효과), lock
+	int answered = 0;
+	int early = 0;
+	double totalSum = 0;
+	double earlySum = 0;
+
+public:
+	PredictQueue(SampleSaver& saver, int policy = PREDICT_QUEUE_POLICY, int capacity = PREDICT_QUEUE_CAPACITY, int maxInFlight = PREDICT_MAX_IN_FLIGHT,
+		int backend = PREDICT_BACKEND, int gateBackend = PREDICT_GATE, float gateMargin = PREDICT_GATE_MARGIN,
+		float gateMaxDistance = PREDICT_GATE_MAX_DISTANCE);
+
+	// 대기 요청은 버리고 종료 (결과를 받을 곳이 없음)
+	~PredictQueue();
+
+	// false : 버림 (BLOCK timeout), DROP_OLDEST / COALESCE_LATEST는 기다리던 요청을 대신 버린다
+	// learn >= 0 : predict 대신 그 label로 배움 (recognizer만, 없으면 false)
+	bool push(Sample&& sample, int segment = -1, int learn = -1);
+
+	// 진행 중 prefix, 기다리던 prefix는 대체, false : recognizer 없음
+	bool pushPartial(Sample&& sample, int segment, int checkpoint);
+
+	// main thread에서 결과 꺼내기 (recognizer, PredictLink)
+	bool poll(PredictLink::Completed& result);
+
+	// 상태 표시 (Kinect)
+	PredictLink& getPredictLink();
+	bool isNative();
+	string getBackendName();
+	double getLastLatency(); // recognizer, ms
+	string getGateName(); // 없으면 ""
+
+	// 대기 / 처리 중 / 결과 대기 요청이 있음 (KINECT_MODE_STREAM이 window를 건너뜀)
+	bool isBusy();
+
+	int getDepth(); // 대기 요청 수 (in-flight 제외)
+	int getPushed();
+	int getDispatched();
+	int getDropped();
+	int getCoalesced();
+	int getPartials();
+	// push ~ dispatch (ms)
+	double getLastWait();
+	double getMeanWait();
+	double getMaxWait();
+
+	// poll된 결과 중 gate가 답한 수, 평균 지연 (세그먼트 완료 ~ 결과, ms)
+	int getAnswered();
+	int getEarly();
+	double getMeanLatency();
+	double getMeanEarlyLatency();
+	double getMeanLateLatency();
+
+	static const char* getPolicyName(int policy);
+
+private:
+	void run();
+
+	// gate -> recognizer / PredictLink / data/temp
+	void dispatch(Request& request);
+
+	// gate 결과가 확실하면 Completed로 넣고 true
+	bool answerEarly(Request& request);
+
+	void recognize(Request& request);
+
+	void learn(Request& request);
+
+	void complete(Request& request, Recognition& recognition, bool result, int64_t dispatchTime, bool early);
+};
@@ -0,0 +1,558 @@
+#include "Recognizer.h"
+#include "BatchPredictServer.h"
+
+#include <ppl.h> // parallel_for
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+	double elapsedMs(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+
+	int findScale(int scale)
+	{
+		for (int s = 0; s < ImageFrame::getScaleSize(); ++s)
+		{
+			if (ImageFrame::getScale(s) == scale) return s;
+		}
+		return -1;
+	}
+
+	// dataFormater._expandToStandard : FRAME_STANDARD_ADAPTIVE로 줄어든 시퀀스를 균등 시간 size개로 (nearest)
+	vector<int> expandIndex(const vector<TIMESPAN>& timeline, TIMESPAN startTime, int frameSize, int size)
+	{
+		vector<int> index(size);
+		if (frameSize == size || (int)timeline.size() != frameSize || frameSize == 0)
+		{
+			for (int k = 0; k < size; ++k) index[k] = min(k, max(frameSize - 1, 0));
+			return index;
+		}
+
+		double last = (double)(timeline.back() - startTime);
+		int f = 0;
+		for (int k = 0; k < size; ++k)
+		{
+			double grid = last * (k + 1) / size;
+			// timeline은 증가, argmin과 같게 같은 거리면 앞 프레임
+			while (f + 1 < frameSize && abs((double)(timeline[f + 1] - startTime) - grid) < abs((double)(timeline[f] - startTime) - grid)) ++f;
+			index[k] = f;
+		}
+		return index;
+	}
+}
+
+float Recognition::getMargin() const
+{
+	if (top < 0 || top >= (int)scores.size()) return 0;
+
+	float second = 0;
+	for (int l = 0; l < (int)scores.size(); ++l)
+	{
+		if (l != top) second = max(second, scores[l]);
+	}
+	return scores[top] - second;
+}
+
+unique_ptr<Recognizer> Recognizer::create(int backend)
+{
+	if (backend == PREDICT_BACKEND_NATIVE) return unique_ptr<Recognizer>(new ModelRecognizer());
+	if (backend == PREDICT_BACKEND_DTW) return unique_ptr<Recognizer>(new DtwRecognizer());
+	if (backend == PREDICT_BACKEND_BATCH) return unique_ptr<Recognizer>(new BatchRecognizer());
+	if (backend == PREDICT_BACKEND_EMBEDDING) return unique_ptr<Recognizer>(new EmbeddingRecognizer());
+	if (backend == PREDICT_BACKEND_LEARNED) return unique_ptr<Recognizer>(new LearnedRecognizer());
+
+	return nullptr;
+}
+
+//----------------------------------------------------------------------------------
+/// ModelRecognizer
+//----------------------------------------------------------------------------------
+
+ModelRecognizer::ModelRecognizer(const string& path)
+{
+	model.load(path);
+}
+
+string ModelRecognizer::getName()
+{
+	return "native " + model.getName();
+}
+
+bool ModelRecognizer::isReady()
+{
+	return model.isLoaded() && model.getBranchCount() == 2;
+}
+
+bool ModelRecognizer::recognize(Sample& sample, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady()) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!prepare(sample)) return false;
+
+	result.prepareMs = elapsedMs(start);
+	start = chrono::steady_clock::now();
+
+	if (!model.forward({ spoint.data(), images.data() }, result.scores)) return false;
+
+	result.inferMs = elapsedMs(start);
+	result.top = (int)(max_element(result.scores.begin(), result.scores.end()) - result.scores.begin());
+	result.confidence = result.scores[result.top];
+
+	return true;
+}
+
+InferenceModel& ModelRecognizer::getModel()
+{
+	return model;
+}
+
+bool ModelRecognizer::prepare(Sample& sample)
+{
+	return prepare(model, sample, spoint, images);
+}
+
+bool ModelRecognizer::prepare(InferenceModel& model, Sample& sample, vector<float>& spoint, vector<float>& images)
+{
+	// spoint [frame, 2 * SPOINT_SIZE, 1]
+	vector<int> shape = model.getInputShape(0);
+	int frameSize = sample.frames.getCollectionSize();
+
+	if (shape.size() != 3 || frameSize == 0 || frameSize > shape[0] || shape[1] != 2 * SPOINT_SIZE || shape[2] != 1)
+	{
+		cout << "ModelRecognizer::prepare spoint " << frameSize << " frame, model " << shape[0] << " x " << shape[1] << endl;
+		return false;
+	}
+
+	vector<int> frameIndex = expandIndex(sample.frames.getTimeline(), sample.recordStartTime, frameSize, shape[0]);
+	spoint.resize(model.getInputSize(0));
+	float* out = spoint.data();
+
+	for (int f : frameIndex)
+	{
+		Frame& frame = sample.frames.getFrame(f);
+		for (int i = 0; i < SPOINT_SIZE; ++i) *out++ = (float)frame.getDistanceL(i);
+		for (int i = 0; i < SPOINT_SIZE; ++i) *out++ = (float)frame.getDistanceR(i);
+	}
+
+	// ROI [T, h, w, 1]
+	shape = model.getInputShape(1);
+	int imageSize = sample.lhand.getCollectionSize();
+
+	if (shape.size() != 4 || shape[3] != 1 || imageSize != sample.rhand.getCollectionSize())
+	{
+		cout << "ModelRecognizer::prepare image shape mismatch" << endl;
+		return false;
+	}
+
+	bool concatWidth = shape[2] == 2 * shape[1];
+	bool concatTime = shape[2] == shape[1] && shape[0] % 2 == 0;
+	int steps = concatWidth ? shape[0] : shape[0] / 2;
+	int scaleIdx = findScale(shape[1]);
+
+	if ((!concatWidth && !concatTime) || scaleIdx < 0 || imageSize == 0 || imageSize > steps)
+	{
+		cout << "ModelRecognizer::prepare image " << imageSize << " frame, model " << shape[0] << " x " << shape[1] << " x " << shape[2] << endl;
+		return false;
+	}
+
+	int scale = shape[1];
+	vector<int> imageIndex = expandIndex(sample.lhand.getTimeline(), sample.recordStartTime, imageSize, steps);
+	images.resize(model.getInputSize(1));
+	ImageFrameCollection* hands[2] = { &sample.lhand, &sample.rhand };
+
+	Concurrency::parallel_for(0, 2 * steps, [&](int k)
+	{
+		int hand = k / steps;
+		int i = k % steps;
+		cv::Mat gray = hands[hand]->getFrame(imageIndex[i]).getGray(scaleIdx);
+
+		// concatWidth : 프레임 i의 각 행 = [왼손 scale][오른손 scale]
+		float* base = concatWidth ? images.data() + (size_t)i * scale * 2 * scale + hand * scale
+			: images.data() + (size_t)k * scale * scale;
+		int rowStride = concatWidth ? 2 * scale : scale;
+
+		for (int y = 0; y < scale; ++y)
+		{
+			const uint8_t* src = gray.ptr<uint8_t>(y);
+			float* dst = base + y * rowStride;
+			for (int x = 0; x < scale; ++x) dst[x] = src[x];
+		}
+	});
+
+	return true;
+}
+
+bool ModelRecognizer::prepare(InferenceModel& model, SampleFile& sample, vector<float>& spoint, vector<float>& images)
+{
+	vector<int> shape = model.getInputShape(0);
+	int frameSize = sample.getFrameSize();
+	const float* spoints = sample.getSPoints();
+	if (spoints == nullptr || frameSize == 0 || shape.size() != 3 || shape[1] != 2 * SPOINT_SIZE) return false;
+
+	// [frame][2][SPOINT_SIZE]는 입력과 같은 순서 (distanceL, distanceR)
+	size_t frameFloats = 2 * SPOINT_SIZE;
+	spoint.resize(model.getInputSize(0));
+	for (int k = 0; k < shape[0]; ++k)
+	{
+		const float* frame = spoints + min(k, frameSize - 1) * frameFloats;
+		copy(frame, frame + frameFloats, spoint.begin() + k * frameFloats);
+	}
+
+	shape = model.getInputShape(1);
+	if (shape.size() != 4 || shape[3] != 1) return false;
+
+	bool concatWidth = shape[2] == 2 * shape[1];
+	bool concatTime = shape[2] == shape[1] && shape[0] % 2 == 0;
+	int steps = concatWidth ? shape[0] : shape[0] / 2;
+	int scale = shape[1];
+
+	vector<cv::Mat> hands[2];
+	if ((!concatWidth && !concatTime) || !sample.getImages(0, scale, hands[0]) || !sample.getImages(1, scale, hands[1])
+		|| hands[0].empty() || hands[0].size() != hands[1].size()) return false;
+
+	images.resize(model.getInputSize(1));
+	int rowStride = concatWidth ? 2 * scale : scale;
+
+	for (int hand = 0; hand < 2; ++hand)
+	{
+		for (int i = 0; i < steps; ++i)
+		{
+			const cv::Mat& gray = hands[hand][min(i, (int)hands[hand].size() - 1)];
+			if (gray.rows != scale || gray.cols != scale) return false;
+
+			float* base = concatWidth ? images.data() + (size_t)i * scale * 2 * scale + hand * scale
+				: images.data() + (size_t)(hand * steps + i) * scale * scale;
+
+			for (int y = 0; y < scale; ++y)
+			{
+				const uint8_t* src = gray.ptr<uint8_t>(y);
+				float* dst = base + y * rowStride;
+				for (int x = 0; x < scale; ++x) dst[x] = src[x];
+			}
+		}
+	}
+
+	return true;
+}
+
+const float* ModelRecognizer::getSPoints()
+{
+	return spoint.data();
+}
+
+const float* ModelRecognizer::getImages()
+{
+	return images.data();
+}
+
+//----------------------------------------------------------------------------------
+/// DtwRecognizer
+//----------------------------------------------------------------------------------
+
+DtwRecognizer::DtwRecognizer(const string& path)
+{
+	matcher.load(path);
+}
+
+string DtwRecognizer::getName()
+{
+	return "dtw " + to_string(matcher.getTemplateCount());
+}
+
+bool DtwRecognizer::isReady()
+{
+	return matcher.getTemplateCount() > 0 && matcher.getFeatureSize() == 2 * SPOINT_SIZE;
+}
+
+bool DtwRecognizer::recognize(Sample& sample, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady() || sample.frames.getCollectionSize() == 0) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	getFeatures(sample.frames, frames);
+
+	result.prepareMs = elapsedMs(start);
+	start = chrono::steady_clock::now();
+
+	vector<DtwMatcher::Match> matches = matcher.search(frames.data(), sample.frames.getCollectionSize(), DTW_K, &lastStats);
+	if (matches.empty()) return false;
+
+	// 거리 역수 투표 (같은 거리면 가까운 이웃 label)
+	result.scores.assign(matcher.getLabelCount(), 0.0f);
+	float sum = 0;
+	for (const DtwMatcher::Match& match : matches)
+	{
+		float weight = 1.0f / (match.distance + 1e-6f);
+		result.scores[match.label] += weight;
+		sum += weight;
+	}
+	for (float& score : result.scores) score /= sum;
+
+	result.inferMs = elapsedMs(start);
+	result.top = matches[0].label;
+	for (int l = 0; l < (int)result.scores.size(); ++l)
+	{
+		if (result.scores[l] > result.scores[result.top]) result.top = l;
+	}
+	result.confidence = result.scores[result.top];
+	result.distance = matches[0].distance / DTW_SERIES_LENGTH;
+
+	return true;
+}
+
+DtwMatcher& DtwRecognizer::getMatcher()
+{
+	return matcher;
+}
+
+DtwMatcher::Stats DtwRecognizer::getLastStats()
+{
+	return lastStats;
+}
+
+void DtwRecognizer::getFeatures(FrameCollection& frames, vector<float>& out)
+{
+	int frameSize = frames.getCollectionSize();
+	out.resize((size_t)frameSize * 2 * SPOINT_SIZE);
+	float* o = out.data();
+
+	for (int f = 0; f < frameSize; ++f)
+	{
+		Frame& frame = frames.getFrame(f);
+		for (int i = 0; i < SPOINT_SIZE; ++i) *o++ = (float)frame.getDistanceL(i);
+		for (int i = 0; i < SPOINT_SIZE; ++i) *o++ = (float)frame.getDistanceR(i);
+	}
+}
+
+//----------------------------------------------------------------------------------
+/// EmbeddingRecognizer
+//----------------------------------------------------------------------------------
+
+EmbeddingRecognizer::EmbeddingRecognizer(const string& modelPath, const string& indexPath)
+	: indexPath(indexPath)
+{
+	model.load(modelPath);
+	index.load(indexPath);
+}
+
+string EmbeddingRecognizer::getName()
+{
+	return "embedding " + model.getName() + " " + to_string(index.getCount());
+}
+
+bool EmbeddingRecognizer::isReady()
+{
+	return model.isLoaded() && model.getBranchCount() == 2 && index.getCount() > 0 && (size_t)index.getDim() == model.getEmbeddingSize();
+}
+
+bool EmbeddingRecognizer::recognize(Sample& sample, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady()) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!ModelRecognizer::prepare(model, sample, spoint, images)) return false;
+
+	result.prepareMs = elapsedMs(start);
+	start = chrono::steady_clock::now();
+
+	if (!model.embed({ spoint.data(), images.data() }, embedding)) return false;
+
+	vector<HnswIndex::Match> matches = index.search(embedding.data(), ANN_K);
+	if (matches.empty()) return false;
+
+	// 거리 역수 투표 (DtwRecognizer와 같음)
+	result.scores.assign(index.getLabelCount(), 0.0f);
+	float sum = 0;
+	for (const HnswIndex::Match& match : matches)
+	{
+		float weight = 1.0f / (match.distance + 1e-6f);
+		result.scores[match.label] += weight;
+		sum += weight;
+	}
+	for (float& score : result.scores) score /= sum;
+
+	result.inferMs = elapsedMs(start);
+	result.top = matches[0].label;
+	for (int l = 0; l < (int)result.scores.size(); ++l)
+	{
+		if (result.scores[l] > result.scores[result.top]) result.top = l;
+	}
+	result.confidence = result.scores[result.top];
+
+	return true;
+}
+
+bool EmbeddingRecognizer::enroll(Sample& sample, int label)
+{
+	if (label < 0 || !model.isLoaded() || model.getBranchCount() != 2) return false;
+	if (!ModelRecognizer::prepare(model, sample, spoint, images) || !model.embed({ spoint.data(), images.data() }, embedding)) return false;
+
+	return index.add(label, embedding.data(), (int)embedding.size());
+}
+
+bool EmbeddingRecognizer::save()
+{
+	return index.save(indexPath);
+}
+
+InferenceModel& EmbeddingRecognizer::getModel()
+{
+	return model;
+}
+
+HnswIndex& EmbeddingRecognizer::getIndex()
+{
+	return index;
+}
+
+//----------------------------------------------------------------------------------
+/// LearnedRecognizer
+//----------------------------------------------------------------------------------
+
+LearnedRecognizer::LearnedRecognizer(const string& modelPath, const string& headPath, float weight)
+	: headPath(headPath), weight(weight)
+{
+	model.load(modelPath);
+	head.load(headPath);
+
+	// 다른 모델로 배운 평균은 쓸 수 없음 (파일은 다음 learn 때 덮어씀)
+	if (head.getDim() != 0 && (size_t)head.getDim() != model.getEmbeddingSize())
+	{
+		cout << "LearnedRecognizer ... " << headPath << " dim " << head.getDim() << " != model " << model.getEmbeddingSize() << ", ignored" << endl;
+		head.clear();
+	}
+}
+
+string LearnedRecognizer::getName()
+{
+	return "learned " + model.getName() + " " + to_string(head.getLearnedCount()) + " label " + to_string(head.getTotal());
+}
+
+bool LearnedRecognizer::isReady()
+{
+	return model.isLoaded() && model.getBranchCount() == 2;
+}
+
+bool LearnedRecognizer::recognize(Sample& sample, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady()) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!ModelRecognizer::prepare(model, sample, spoint, images)) return false;
+
+	double prepareMs = elapsedMs(start);
+	bool recognized = recognize(spoint.data(), images.data(), result);
+	result.prepareMs = prepareMs;
+
+	return recognized;
+}
+
+bool LearnedRecognizer::learn(Sample& sample, int label, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady()) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!ModelRecognizer::prepare(model, sample, spoint, images)) return false;
+
+	double prepareMs = elapsedMs(start);
+	bool learned = learn(spoint.data(), images.data(), label, result);
+	result.prepareMs = prepareMs;
+
+	return learned;
+}
+
+bool LearnedRecognizer::recognize(const float* spoint, const float* images, Recognition& result)
+{
+	result = Recognition();
+	if (!isReady()) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!model.embed({ spoint, images }, embedding, &result.scores)) return false;
+
+	// 배운 label (모델 label 안) 사이만 다시 나눔
+	int labelCount = (int)result.scores.size();
+	if (head.score(embedding.data(), (int)embedding.size(), headScores))
+	{
+		float modelMass = 0, headMass = 0;
+		for (int l = 0; l < min(labelCount, head.getLabelCount()); ++l)
+		{
+			if (head.getCount(l) == 0) continue;
+			modelMass += result.scores[l];
+			headMass += headScores[l];
+		}
+
+		for (int l = 0; l < min(labelCount, head.getLabelCount()) && modelMass > 0 && headMass > 0; ++l)
+		{
+			if (head.getCount(l) == 0) continue;
+			result.scores[l] = (1 - weight) * result.scores[l] + weight * modelMass * headScores[l] / headMass;
+		}
+	}
+
+	result.inferMs = elapsedMs(start);
+	result.top = (int)(max_element(result.scores.begin(), result.scores.end()) - result.scores.begin());
+	result.confidence = result.scores[result.top];
+
+	return true;
+}
+
+bool LearnedRecognizer::learn(const float* spoint, const float* images, int label, Recognition& result)
+{
+	if (label < 0 || label >= model.getLabelCount())
+	{
+		cout << "LearnedRecognizer::learn label " << label << " not in model (" << model.getLabelCount() << " label)" << endl;
+		return false;
+	}
+
+	// 배우기 전 결과, 임베딩은 그대로 씀
+	if (!recognize(spoint, images, result)) return false;
+
+	auto start = chrono::steady_clock::now();
+
+	if (!head.update(label, embedding.data(), (int)embedding.size())) return false;
+	if (!headPath.empty() && !head.save(headPath)) cout << "LearnedRecognizer::learn cannot write " << headPath << endl;
+
+	result.learnMs = elapsedMs(start);
+
+	return true;
+}
+
+bool LearnedRecognizer::reset()
+{
+	head.clear();
+	return headPath.empty() || head.save(headPath);
+}
+
+void LearnedRecognizer::setHeadPath(const string& path)
+{
+	headPath = path;
+}
+
+bool LearnedRecognizer::isAdapted(int label)
+{
+	return head.getCount(label) > 0;
+}
+
+InferenceModel& LearnedRecognizer::getModel()
+{
+	return model;
+}
+
+NcmHead& LearnedRecognizer::getHead()
+{
+	return head;
+}
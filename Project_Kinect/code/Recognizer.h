@@ -0,0 +1,191 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "InferenceModel.h"
+#include "DtwMatcher.h"
+#include "HnswIndex.h"
+#include "NcmHead.h"
+
+// 세그먼트 하나 -> label 확률 (같은 process 안에서, PREDICT_BACKEND != PREDICT_BACKEND_PYTHON)
+//
+// PredictQueue dispatcher thread가 recognize()를 부른다 (한 thread).
+// 준비가 안 되면 (모델 파일 없음 등) PredictQueue는 PredictLink(python)로 보낸다.
+struct Recognition
+{
+	int top = -1; // -1 : 실패
+	float confidence = 0;
+	vector<float> scores;
+	float distance = -1; // 가장 가까운 템플릿까지 거리 / DTW_SERIES_LENGTH (DtwRecognizer), -1 : 거리 없음
+	double prepareMs = 0; // Sample -> 입력 텐서
+	double inferMs = 0;
+	double learnMs = 0; // Recognizer::learn : 갱신 + 저장
+
+	// top-1 - top-2 score (cascade gate, PredictQueue)
+	float getMargin() const;
+};
+
+class Recognizer
+{
+public:
+	virtual ~Recognizer() {}
+
+	virtual string getName() = 0;
+
+	virtual bool isReady() = 0;
+
+	virtual bool recognize(Sample& sample, Recognition& result) = 0;
+
+	// KINECT_MODE_LEARNING : 세그먼트 하나를 label로 배움 (다음 recognize부터 반영), result는 배우기 전 결과
+	// false : 배울 수 없는 recognizer / label
+	virtual bool learn(Sample& sample, int label, Recognition& result) { return false; }
+
+	// learn으로 바뀐 label (PredictQueue gate가 이 label은 답하지 않음)
+	virtual bool isAdapted(int label) { return false; }
+
+	// PREDICT_BACKEND_NATIVE, PREDICT_BACKEND_DTW, PREDICT_BACKEND_BATCH (BatchPredictServer.h), PREDICT_BACKEND_EMBEDDING, PREDICT_BACKEND_LEARNED, 그 외는 nullptr (python)
+	static unique_ptr<Recognizer> create(int backend);
+};
+
+// keras Model_M1 export (data/models/M1.kslm)를 InferenceModel로 실행
+//
+// 입력은 do_Predict.py (dataFormater.ROI_loadSampleBytes)와 같은 값
+//   branch 0 : spoint [frame, 2 * SPOINT_SIZE, 1]  distanceL, distanceR
+//   branch 1 : ROI [T, h, w, 1] gray 0 ~ 255, w == 2 * scale이면 왼손 | 오른손 가로로 이어 붙임 (35, 80, 160, 1)
+//              T == 2 * 프레임이면 왼손 프레임들 다음 오른손 프레임들 (70, 80, 80, 1)
+class ModelRecognizer : public Recognizer
+{
+private:
+	InferenceModel model;
+	vector<float> spoint;
+	vector<float> images;
+
+public:
+	ModelRecognizer(const string& path = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+
+	string getName() override;
+
+	bool isReady() override;
+
+	bool recognize(Sample& sample, Recognition& result) override;
+
+	InferenceModel& getModel();
+
+	// do_Predict.py와 같은 입력 텐서 (model 입력 shape에 맞춤, 프레임이 적으면 균등 시간으로 펼침), false : 프레임이 더 많음 / scale이 다름
+	bool prepare(Sample& sample);
+	// 같은 것을 남의 버퍼에 (BatchPredictServer producer thread), model은 읽기만
+	static bool prepare(InferenceModel& model, Sample& sample, vector<float>& spoint, vector<float>& images);
+	// 저장된 샘플 (Project_Tools), 시간축은 앞에서부터 채우고 모자라면 마지막 프레임 반복 (표준화된 샘플은 프레임 수가 모델과 같다)
+	static bool prepare(InferenceModel& model, SampleFile& sample, vector<float>& spoint, vector<float>& images);
+	const float* getSPoints();
+	const float* getImages();
+};
+
+// 등록된 템플릿 (data/models/templates.ksdt)과 SPoint distance DTW kNN, ROI는 쓰지 않는다
+//
+// scores : 이웃 DTW_K개의 거리 역수를 label별로 더해 정규화 (템플릿에 있는 가장 큰 label + 1개)
+class DtwRecognizer : public Recognizer
+{
+private:
+	DtwMatcher matcher;
+	vector<float> frames;
+	DtwMatcher::Stats lastStats;
+
+public:
+	DtwRecognizer(const string& path = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + DTW_TEMPLATE_FILE_NAME);
+
+	string getName() override;
+
+	bool isReady() override;
+
+	bool recognize(Sample& sample, Recognition& result) override;
+
+	DtwMatcher& getMatcher();
+	DtwMatcher::Stats getLastStats();
+
+	// [frame][2 * SPOINT_SIZE] distanceL, distanceR (sample.ksl SPOINT section과 같은 순서)
+	static void getFeatures(FrameCollection& frames, vector<float>& out);
+};
+
+// ModelRecognizer와 같은 입력 -> InferenceModel::embed -> 등록된 임베딩 (data/models/embeddings.ksan)과 HnswIndex kNN
+//
+// 분류 layer (softmax label 수 고정) 대신 등록된 임베딩과 비교하므로 label은 재학습 없이 enroll로 늘린다 (Project_Tools ann-enroll).
+// scores : 이웃 ANN_K개의 거리 역수를 label별로 더해 정규화 (index에 있는 가장 큰 label + 1개)
+class EmbeddingRecognizer : public Recognizer
+{
+private:
+	InferenceModel model;
+	HnswIndex index;
+	string indexPath;
+	vector<float> spoint;
+	vector<float> images;
+	vector<float> embedding;
+
+public:
+	EmbeddingRecognizer(const string& modelPath = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME,
+		const string& indexPath = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + ANN_INDEX_FILE_NAME);
+
+	string getName() override;
+
+	bool isReady() override;
+
+	bool recognize(Sample& sample, Recognition& result) override;
+
+	// 세그먼트 하나를 label로 index에 추가 (다음 recognize부터 반영), 파일은 save()
+	bool enroll(Sample& sample, int label);
+	bool save();
+
+	InferenceModel& getModel();
+	HnswIndex& getIndex();
+};
+
+// ModelRecognizer와 같은 모델 + 배운 label 평균 (NcmHead, data/models/learned.ksnc), KINECT_MODE_LEARNING이 learn으로 갱신
+//
+// embed 한 번으로 모델 score와 임베딩을 같이 구하고, 배운 label 사이의 순위만 다시 정한다
+//   배운 label들에 모델이 준 확률 합은 그대로, 그 안을 (1 - NCM_WEIGHT) x 모델 score + NCM_WEIGHT x 평균 score로 나눔
+//   배우지 않은 label은 모델 score 그대로 (헷갈리는 label 몇 개만 배워도 나머지는 바뀌지 않는다, 배운 label이 둘 이상이어야 순위가 바뀜)
+// 배운 것이 없으면 ModelRecognizer와 같은 결과. learn은 평균 갱신 + 저장까지 (임베딩 이후 ms 미만), 모델 label 밖은 배우지 않는다.
+class LearnedRecognizer : public Recognizer
+{
+private:
+	InferenceModel model;
+	NcmHead head;
+	string headPath;
+	float weight;
+	vector<float> spoint;
+	vector<float> images;
+	vector<float> embedding;
+	vector<float> headScores;
+
+public:
+	LearnedRecognizer(const string& modelPath = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME,
+		const string& headPath = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + NCM_HEAD_FILE_NAME, float weight = NCM_WEIGHT);
+
+	string getName() override;
+
+	bool isReady() override;
+
+	bool recognize(Sample& sample, Recognition& result) override;
+
+	bool learn(Sample& sample, int label, Recognition& result) override;
+
+	// NcmHead가 배운 label
+	bool isAdapted(int label) override;
+
+	// 준비된 입력 (ModelRecognizer::prepare), Project_Tools learn-eval
+	bool recognize(const float* spoint, const float* images, Recognition& result);
+	bool learn(const float* spoint, const float* images, int label, Recognition& result);
+
+	// 배운 것을 모두 지우고 파일도 비움
+	bool reset();
+	// path가 ""이면 update마다 저장하지 않음 (learn-eval)
+	void setHeadPath(const string& path);
+
+	InferenceModel& getModel();
+	NcmHead& getHead();
+};
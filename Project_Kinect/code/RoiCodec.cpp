@@ -0,0 +1,450 @@
+#include "RoiCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	const uint32_t RAW_MAGIC = 0x3052434B; // "KCR0"
+	const uint32_t RICE_MAGIC = 0x3152434B; // "KCR1"
+	const int RICE_LIMIT = 24; // unary 길이 제한, 넘으면 8bit 그대로
+	const int RICE_MAX_K = 7;
+	const int CONTEXT_SIZE = 8;
+
+	struct CodecHeader
+	{
+		uint32_t magic;
+		uint16_t width;
+		uint16_t height;
+		uint32_t count;
+	};
+
+	bool writeHeader(uint32_t magic, const vector<cv::Mat>& frames, vector<uint8_t>& out)
+	{
+		CodecHeader header = { magic, 0, 0, (uint32_t)frames.size() };
+
+		if (!frames.empty())
+		{
+			header.width = (uint16_t)frames[0].cols;
+			header.height = (uint16_t)frames[0].rows;
+		}
+
+		for (const cv::Mat& f : frames)
+		{
+			if (f.type() != CV_8UC1 || f.cols != header.width || f.rows != header.height) return false;
+		}
+
+		out.resize(sizeof(header));
+		memcpy(out.data(), &header, sizeof(header));
+
+		return true;
+	}
+
+	bool readHeader(uint32_t magic, const uint8_t* data, size_t size, CodecHeader& header)
+	{
+		if (data == nullptr || size < sizeof(header)) return false;
+
+		memcpy(&header, data, sizeof(header));
+
+		return header.magic == magic;
+	}
+
+	// (x, y)의 left, up, up-left (경계는 가까운 값으로 대체, encode/decode 동일)
+	inline void neighbors(const uint8_t* plane, int width, int x, int y, int& a, int& b, int& c)
+	{
+		const uint8_t* row = plane + y * width;
+		const uint8_t* up = row - width;
+
+		if (y == 0)
+		{
+			a = x > 0 ? row[x - 1] : 0;
+			b = a;
+			c = a;
+		}
+		else if (x == 0)
+		{
+			b = up[0];
+			a = b;
+			c = b;
+		}
+		else
+		{
+			a = row[x - 1];
+			b = up[x];
+			c = up[x - 1];
+		}
+	}
+
+	// LOCO-I median edge detector
+	inline int med(int a, int b, int c)
+	{
+		int mx = a > b ? a : b;
+		int mn = a < b ? a : b;
+
+		if (c >= mx) return mn;
+		if (c <= mn) return mx;
+		return a + b - c;
+	}
+
+	inline int predict(const uint8_t* cur, const uint8_t* prev, int width, int x, int y)
+	{
+		int a, b, c;
+		neighbors(cur, width, x, y, a, b, c);
+		int spatial = med(a, b, c);
+
+		if (prev == nullptr) return spatial;
+
+		int pa, pb, pc;
+		neighbors(prev, width, x, y, pa, pb, pc);
+
+		int p = prev[y * width + x] + spatial - med(pa, pb, pc);
+
+		return p < 0 ? 0 : (p > 255 ? 255 : p);
+	}
+
+	// 주변(left, up) 잔차 크기 -> context 0 ~ CONTEXT_SIZE-1 (log2 bucket)
+	inline int contextOf(int activity)
+	{
+		int ctx = 0;
+		while (activity > 0 && ctx < CONTEXT_SIZE - 1)
+		{
+			activity >>= 1;
+			++ctx;
+		}
+
+		return ctx;
+	}
+
+	struct RiceContext
+	{
+		int a = 4; // 잔차 합
+		int n = 1; // 개수
+
+		inline int k()
+		{
+			int k = 0;
+			while ((n << k) < a && k < RICE_MAX_K) ++k;
+			return k;
+		}
+
+		inline void update(int u)
+		{
+			a += u;
+			if (++n >= 64)
+			{
+				a >>= 1;
+				n >>= 1;
+			}
+		}
+	};
+
+	class BitWriter
+	{
+	private:
+		vector<uint8_t>& out;
+		uint64_t acc = 0;
+		int bits = 0;
+
+	public:
+		BitWriter(vector<uint8_t>& out) : out(out) {}
+
+		// LSB first, n <= 32
+		inline void put(uint32_t value, int n)
+		{
+			acc |= (uint64_t)value << bits;
+			bits += n;
+
+			while (bits >= 8)
+			{
+				out.push_back((uint8_t)acc);
+				acc >>= 8;
+				bits -= 8;
+			}
+		}
+
+		void flush()
+		{
+			if (bits > 0) out.push_back((uint8_t)acc);
+			acc = 0;
+			bits = 0;
+		}
+	};
+
+	class BitReader
+	{
+	private:
+		const uint8_t* p;
+		const uint8_t* end;
+		uint64_t acc = 0;
+		int bits = 0;
+		int overrun = 0;
+
+	public:
+		BitReader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+
+		// 한 심볼(unary + k bit)을 읽을 만큼 채움, 끝을 넘으면 0으로 채우고 overrun
+		inline void refill()
+		{
+			while (bits <= 56)
+			{
+				uint64_t byte = 0;
+				if (p < end) byte = *p++;
+				else ++overrun;
+
+				acc |= byte << bits;
+				bits += 8;
+			}
+		}
+
+		inline uint32_t get(int n)
+		{
+			uint32_t value = (uint32_t)(acc & ((1ull << n) - 1));
+			acc >>= n;
+			bits -= n;
+
+			return value;
+		}
+
+		// 연속된 1의 개수 (limit까지), limit 미만이면 끝의 0도 소비
+		inline int unary(int limit)
+		{
+			int q = 0;
+			while ((acc & 1) && q < limit)
+			{
+				acc >>= 1;
+				++q;
+			}
+			bits -= q;
+
+			if (q < limit)
+			{
+				acc >>= 1;
+				--bits;
+			}
+
+			return q;
+		}
+
+		bool isOverrun()
+		{
+			return overrun > 8; // refill이 미리 읽는 8byte 이상 넘어가면 손상된 데이터
+		}
+	};
+
+	inline void putRice(BitWriter& writer, int u, int k)
+	{
+		int q = u >> k;
+
+		if (q < RICE_LIMIT)
+		{
+			writer.put((1u << q) - 1, q + 1); // q개의 1 + 0
+			if (k > 0) writer.put(u & ((1 << k) - 1), k);
+		}
+		else
+		{
+			writer.put((1u << RICE_LIMIT) - 1, RICE_LIMIT);
+			writer.put(u, 8);
+		}
+	}
+
+	inline int getRice(BitReader& reader, int k)
+	{
+		reader.refill();
+
+		int q = reader.unary(RICE_LIMIT);
+		if (q == RICE_LIMIT) return (int)reader.get(8);
+
+		return (q << k) | (k > 0 ? (int)reader.get(k) : 0);
+	}
+
+	// plane 단위 : frames를 연속 메모리로 보고 처리 (cv::Mat은 continuous로 맞춤)
+	void encodePlanes(const vector<const uint8_t*>& planes, int width, int height, vector<uint8_t>& out)
+	{
+		BitWriter writer(out);
+		RiceContext contexts[CONTEXT_SIZE];
+		vector<int> upResidual(width), rowResidual(width);
+
+		for (int f = 0; f < (int)planes.size(); ++f)
+		{
+			const uint8_t* cur = planes[f];
+			const uint8_t* prev = f > 0 ? planes[f - 1] : nullptr;
+
+			fill(upResidual.begin(), upResidual.end(), 0);
+
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					int p = predict(cur, prev, width, x, y);
+					int e = (cur[y * width + x] - p) & 0xFF;
+					if (e >= 128) e -= 256;
+					int u = e >= 0 ? 2 * e : -2 * e - 1; // zigzag
+
+					RiceContext& ctx = contexts[contextOf((x > 0 ? rowResidual[x - 1] : 0) + upResidual[x])];
+					putRice(writer, u, ctx.k());
+					ctx.update(u);
+
+					rowResidual[x] = u;
+				}
+				upResidual.swap(rowResidual);
+			}
+		}
+
+		writer.flush();
+	}
+
+	bool decodePlanes(const uint8_t* data, size_t size, vector<uint8_t*>& planes, int width, int height)
+	{
+		BitReader reader(data, size);
+		RiceContext contexts[CONTEXT_SIZE];
+		vector<int> upResidual(width), rowResidual(width);
+
+		for (int f = 0; f < (int)planes.size(); ++f)
+		{
+			uint8_t* cur = planes[f];
+			const uint8_t* prev = f > 0 ? planes[f - 1] : nullptr;
+
+			fill(upResidual.begin(), upResidual.end(), 0);
+
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					RiceContext& ctx = contexts[contextOf((x > 0 ? rowResidual[x - 1] : 0) + upResidual[x])];
+					int u = getRice(reader, ctx.k());
+					ctx.update(u);
+
+					int e = (u & 1) ? -((u + 1) >> 1) : (u >> 1);
+					int p = predict(cur, prev, width, x, y);
+					cur[y * width + x] = (uint8_t)((p + e) & 0xFF);
+
+					rowResidual[x] = u;
+				}
+				upResidual.swap(rowResidual);
+			}
+
+			if (reader.isOverrun()) return false;
+		}
+
+		return true;
+	}
+
+	void allocateFrames(const CodecHeader& header, vector<cv::Mat>& frames, vector<uint8_t*>& planes)
+	{
+		frames.resize(header.count);
+		planes.resize(header.count);
+
+		for (uint32_t i = 0; i < header.count; ++i)
+		{
+			frames[i] = cv::Mat(header.height, header.width, CV_8UC1);
+			planes[i] = frames[i].data;
+		}
+	}
+}
+
+unique_ptr<RoiCodec> RoiCodec::create(int type)
+{
+	if (type == ROI_CODEC_DELTA_RICE) return unique_ptr<RoiCodec>(new DeltaRiceRoiCodec());
+
+	return unique_ptr<RoiCodec>(new RawRoiCodec());
+}
+
+//----------------------------------------------------------------------------------
+/// RawRoiCodec
+//----------------------------------------------------------------------------------
+
+string RawRoiCodec::getName()
+{
+	return "raw";
+}
+
+bool RawRoiCodec::encode(const vector<cv::Mat>& frames, vector<uint8_t>& out)
+{
+	if (!writeHeader(RAW_MAGIC, frames, out)) return false;
+
+	for (const cv::Mat& f : frames)
+	{
+		for (int r = 0; r < f.rows; ++r)
+		{
+			const uint8_t* row = f.ptr<uint8_t>(r);
+			out.insert(out.end(), row, row + f.cols);
+		}
+	}
+
+	return true;
+}
+
+bool RawRoiCodec::decode(const uint8_t* data, size_t size, vector<cv::Mat>& frames)
+{
+	CodecHeader header;
+	if (!readHeader(RAW_MAGIC, data, size, header)) return false;
+
+	size_t plane = (size_t)header.width * header.height;
+	if (size < sizeof(header) + plane * header.count) return false;
+
+	vector<uint8_t*> planes;
+	allocateFrames(header, frames, planes);
+
+	for (uint32_t i = 0; i < header.count; ++i)
+	{
+		memcpy(planes[i], data + sizeof(header) + plane * i, plane);
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------
+/// DeltaRiceRoiCodec
+//----------------------------------------------------------------------------------
+
+string DeltaRiceRoiCodec::getName()
+{
+	return "delta-rice";
+}
+
+bool DeltaRiceRoiCodec::encode(const vector<cv::Mat>& frames, vector<uint8_t>& out)
+{
+	if (!writeHeader(RICE_MAGIC, frames, out)) return false;
+	if (frames.empty()) return true;
+
+	vector<cv::Mat> continuous;
+	vector<const uint8_t*> planes;
+
+	for (const cv::Mat& f : frames)
+	{
+		continuous.push_back(f.isContinuous() ? f : f.clone());
+		planes.push_back(continuous.back().data);
+	}
+
+	// 평균 2~3 bit/pixel 정도라 미리 잡아둠
+	out.reserve(out.size() + frames.size() * frames[0].total() / 2);
+
+	encodePlanes(planes, frames[0].cols, frames[0].rows, out);
+
+	// noise뿐인 입력은 raw보다 커질 수 있음 : raw로 저장 (decode에서 magic으로 구분)
+	if (out.size() > sizeof(CodecHeader) + frames.size() * frames[0].total())
+	{
+		out.clear();
+		return RawRoiCodec().encode(frames, out);
+	}
+
+	return true;
+}
+
+bool DeltaRiceRoiCodec::decode(const uint8_t* data, size_t size, vector<cv::Mat>& frames)
+{
+	CodecHeader header;
+	if (readHeader(RAW_MAGIC, data, size, header)) return RawRoiCodec().decode(data, size, frames);
+	if (!readHeader(RICE_MAGIC, data, size, header)) return false;
+
+	vector<uint8_t*> planes;
+	allocateFrames(header, frames, planes);
+
+	if (!decodePlanes(data + sizeof(header), size - sizeof(header), planes, header.width, header.height))
+	{
+		frames.clear();
+		return false;
+	}
+
+	return true;
+}
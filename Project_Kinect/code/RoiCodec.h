@@ -0,0 +1,57 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+#include "common/codecDefines.hpp" // defines.hpp (Kinect.h) 없이 : Project_Reader도 빌드
+
+// 손 ROI 시퀀스 무손실 압축
+//
+// 입력은 같은 크기의 CV_8UC1 프레임들 (한 손, 시간 순서)
+// ImageFrameCollection::encode()가 gray 프레임을 모아 넘긴다
+class RoiCodec
+{
+public:
+	virtual ~RoiCodec() {}
+
+	virtual string getName() = 0;
+
+	virtual bool encode(const vector<cv::Mat>& frames, vector<uint8_t>& out) = 0;
+
+	// frames : 새로 할당된 CV_8UC1
+	virtual bool decode(const uint8_t* data, size_t size, vector<cv::Mat>& frames) = 0;
+
+	// ROI_CODEC_RAW, ROI_CODEC_DELTA_RICE
+	static unique_ptr<RoiCodec> create(int type);
+};
+
+// 압축 없음 : [header][frame 0][frame 1]...
+class RawRoiCodec : public RoiCodec
+{
+public:
+	string getName() override;
+
+	bool encode(const vector<cv::Mat>& frames, vector<uint8_t>& out) override;
+
+	bool decode(const uint8_t* data, size_t size, vector<cv::Mat>& frames) override;
+};
+
+// temporal delta 예측 + adaptive Rice 부호화
+//
+// 예측 : 첫 프레임은 MED (LOCO-I), 이후는 prev(x) + MED(cur) - MED(prev)
+//        (직전 프레임 같은 위치 + 현재/직전 프레임 주변 gradient 차이)
+// 잔차 : mod 256 -> zigzag -> Rice(k), k는 주변 잔차 크기 context별 평균으로 결정
+// 테이블, 곱셈 없이 픽셀당 분기 몇 개라 capture 중 encode해도 부담이 적다
+class DeltaRiceRoiCodec : public RoiCodec
+{
+public:
+	string getName() override;
+
+	bool encode(const vector<cv::Mat>& frames, vector<uint8_t>& out) override;
+
+	bool decode(const uint8_t* data, size_t size, vector<cv::Mat>& frames) override;
+};
@@ -1,4 +1,5 @@
 #include "SPoint.h"
+#include "ExtractionConfig.h"
 
 SPoint::SPoint()
 {
@@ -33,9 +34,11 @@ CameraSpacePoint SPoint::getPoint()
 // lerp
 void SPoint::setPoint(CameraSpacePoint p)
 {
-	point.X = Lerp((float)LERP_PERCENT, point.X, p.X);
-	point.Y = Lerp((float)LERP_PERCENT, point.Y, p.Y);
-	point.Z = Lerp((float)LERP_PERCENT, point.Z, p.Z);
+	float percent = ExtractionConfig::current().lerpPercent;
+
+	point.X = Lerp(percent, point.X, p.X);
+	point.Y = Lerp(percent, point.Y, p.Y);
+	point.Z = Lerp(percent, point.Z, p.Z);
 }
 
 float SPoint::Lerp(float p, float x, float y)
@@ -49,3 +52,93 @@ float SPoint::Lerp(float p, float x, float y)
 
 	return  x + (y - x) * p;
 }
+
+void SPoint::fill(array<SPoint, SPOINT_SIZE>& sPoints, const Joint* joints, const vector<CameraSpacePoint>& vertexes, float spinePx)
+{
+	CameraSpacePoint additionalPoints[11];
+
+	sPoints[SPOINT_HEAD_HAIR].setPoint(vertexes[28]);
+	sPoints[SPOINT_HEAD_FACE_EYE_LEFT].setPoint(vertexes[333]);
+	sPoints[SPOINT_HEAD_FACE_EYE_RIGHT].setPoint(vertexes[732]);
+	sPoints[SPOINT_HEAD_FACE_NOSE].setPoint(vertexes[23]);
+	sPoints[SPOINT_HEAD_FACE_LIP].setPoint(vertexes[8]);
+	sPoints[SPOINT_HEAD_FACE_CHEEK_LEFT].setPoint(vertexes[52]);
+	sPoints[SPOINT_HEAD_FACE_CHEEK_RIGHT].setPoint(vertexes[581]);
+	sPoints[SPOINT_HEAD_FACE_JAW].setPoint(vertexes[0]);
+
+	sPoints[SPOINT_BODY_NECK].setPoint(joints[JointType::JointType_Neck].Position);
+	sPoints[SPOINT_BODY_SPINE_MID].setPoint(joints[JointType::JointType_SpineMid].Position);
+	sPoints[SPOINT_BODY_SPINE_BASE].setPoint(joints[JointType::JointType_SpineBase].Position);
+	sPoints[SPOINT_BODY_SPINE_SHOULDER].setPoint(joints[JointType::JointType_SpineShoulder].Position);
+	sPoints[SPOINT_BODY_SHOULDER_LEFT].setPoint(joints[JointType::JointType_ShoulderLeft].Position);
+	sPoints[SPOINT_BODY_SHOULDER_RIGHT].setPoint(joints[JointType::JointType_ShoulderRight].Position);
+	sPoints[SPOINT_BODY_ELBOW_LEFT].setPoint(joints[JointType::JointType_ElbowLeft].Position);
+	sPoints[SPOINT_BODY_ELBOW_RIGHT].setPoint(joints[JointType::JointType_ElbowRight].Position);
+	sPoints[SPOINT_BODY_WRIST_LEFT].setPoint(joints[JointType::JointType_WristLeft].Position);
+	sPoints[SPOINT_BODY_WRIST_RIGHT].setPoint(joints[JointType::JointType_WristRight].Position);
+	sPoints[SPOINT_BODY_HAND_TIP_LEFT].setPoint(joints[JointType::JointType_HandTipLeft].Position);
+	sPoints[SPOINT_BODY_HAND_TIP_RIGHT].setPoint(joints[JointType::JointType_HandTipRight].Position);
+
+	// additional points
+	additionalPoints[0].X = sPoints[SPOINT_HEAD_HAIR].getPoint().X;
+	additionalPoints[0].Y = sPoints[SPOINT_HEAD_HAIR].getPoint().Y + spinePx;
+	additionalPoints[0].Z = sPoints[SPOINT_HEAD_HAIR].getPoint().Z;
+	additionalPoints[1].X = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().X - spinePx;
+	additionalPoints[1].Y = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Y;
+	additionalPoints[1].Z = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Z;
+	additionalPoints[2].X = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().X + spinePx;
+	additionalPoints[2].Y = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Y;
+	additionalPoints[2].Z = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Z;
+
+	sPoints[SPOINT_HEAD_TOP].setPoint(additionalPoints[0]);
+	sPoints[SPOINT_HEAD_SIDE_LEFT].setPoint(additionalPoints[1]);
+	sPoints[SPOINT_HEAD_SIDE_RIGHT].setPoint(additionalPoints[2]);
+
+	// version2 points
+	sPoints[SPOINT_BODY_HIP_LEFT].setPoint(joints[JointType::JointType_HipLeft].Position);
+	sPoints[SPOINT_BODY_HIP_RIGHT].setPoint(joints[JointType::JointType_HipRight].Position);
+	sPoints[SPOINT_BODY_KNEE_LEFT].setPoint(joints[JointType::JointType_KneeLeft].Position);
+	sPoints[SPOINT_BODY_KNEE_RIGHT].setPoint(joints[JointType::JointType_KneeRight].Position);
+	sPoints[SPOINT_BODY_ANKLE_LEFT].setPoint(joints[JointType::JointType_AnkleLeft].Position);
+	sPoints[SPOINT_BODY_ANKLE_RIGHT].setPoint(joints[JointType::JointType_AnkleRight].Position);
+
+	// version2 addtional points
+	additionalPoints[3].X = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().X - spinePx;
+	additionalPoints[3].Y = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().Y;
+	additionalPoints[3].Z = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().Z;
+	additionalPoints[4].X = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().X + spinePx;
+	additionalPoints[4].Y = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().Y;
+	additionalPoints[4].Z = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().Z;
+	additionalPoints[5].X = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().X - spinePx;
+	additionalPoints[5].Y = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().Y;
+	additionalPoints[5].Z = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().Z;
+	additionalPoints[6].X = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().X + spinePx;
+	additionalPoints[6].Y = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().Y;
+	additionalPoints[6].Z = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().Z;
+	additionalPoints[7].X = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().X - spinePx;
+	additionalPoints[7].Y = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().Y;
+	additionalPoints[7].Z = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().Z;
+	additionalPoints[8].X = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().X + spinePx;
+	additionalPoints[8].Y = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().Y;
+	additionalPoints[8].Z = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().Z;
+	additionalPoints[9].X = sPoints[SPOINT_BODY_SPINE_MID].getPoint().X - spinePx;
+	additionalPoints[9].Y = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Y;
+	additionalPoints[9].Z = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Z;
+	additionalPoints[10].X = sPoints[SPOINT_BODY_SPINE_MID].getPoint().X + spinePx;
+	additionalPoints[10].Y = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Y;
+	additionalPoints[10].Z = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Z;
+
+	sPoints[SPOINT_BODY_HIP_SIDE_LEFT].setPoint(additionalPoints[3]);
+	sPoints[SPOINT_BODY_HIP_SIDE_RIGHT].setPoint(additionalPoints[4]);
+	sPoints[SPOINT_BODY_SHOULDER_SIDE_LEFT].setPoint(additionalPoints[5]);
+	sPoints[SPOINT_BODY_SHOULDER_SIDE_RIGHT].setPoint(additionalPoints[6]);
+	sPoints[SPOINT_BODY_KNEE_SIDE_LEFT].setPoint(additionalPoints[7]);
+	sPoints[SPOINT_BODY_KNEE_SIDE_RIGHT].setPoint(additionalPoints[8]);
+	sPoints[SPOINT_BODY_SPINE_MID_SIDE_LEFT].setPoint(additionalPoints[9]);
+	sPoints[SPOINT_BODY_SPINE_MID_SIDE_RIGHT].setPoint(additionalPoints[10]);
+}
+
+bool SPoint::isHandActivated(array<SPoint, SPOINT_SIZE>& sPoints, SPointsType wrist, float spinePx)
+{
+	return sPoints[wrist].getPoint().Y > sPoints[SPOINT_BODY_SPINE_BASE].getPoint().Y + spinePx / 2;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Kinect.h>
+#include <array>
+#include <vector>
 #include <string>
 using namespace std;
 
@@ -117,6 +119,13 @@ public:
 
 	float Lerp(float p, float x, float y);
 
+	// joint + HDFace vertex ü SPoint  (Kinect::updateSPoint, Project_Tools extract)
+	// joints : JointType_Count, vertexes : HDFace 1347, spinePx : SpineShoulder ~ SpineMid (camera space)
+	static void fill(array<SPoint, SPOINT_SIZE>& sPoints, const Joint* joints, const vector<CameraSpacePoint>& vertexes, float spinePx);
+
+	//  Ȱȭ : ո SpineBase spinePx / 2 ̻ 
+	static bool isHandActivated(array<SPoint, SPOINT_SIZE>& sPoints, SPointsType wrist, float spinePx);
+
 private:
 
 
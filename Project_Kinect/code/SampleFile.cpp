@@ -0,0 +1,457 @@
+#include "SampleFile.h"
+#include "ExtractionConfig.h"
+
+#include <Windows.h> // CreateFileMapping, MapViewOfFile
+
+namespace
+{
+	struct Payload
+	{
+		SampleSection section;
+		vector<uint8_t> bytes;
+	};
+
+	void copyString(char* dst, size_t size, const string& src)
+	{
+		size_t length = min(src.size(), size - 1);
+		memcpy(dst, src.data(), length);
+		dst[length] = '\0';
+	}
+
+	uint64_t alignUp(uint64_t value)
+	{
+		return (value + SAMPLE_ALIGN - 1) / SAMPLE_ALIGN * SAMPLE_ALIGN;
+	}
+
+	Payload makePayload(uint32_t type, uint32_t dtype, uint32_t param, vector<uint32_t> shape, size_t elementSize)
+	{
+		Payload p;
+		memset(&p.section, 0, sizeof(p.section));
+		p.section.type = type;
+		p.section.dtype = dtype;
+		p.section.param = param;
+		p.section.rank = (uint32_t)shape.size();
+
+		size_t count = 1;
+		for (int i = 0; i < (int)shape.size(); ++i)
+		{
+			p.section.shape[i] = shape[i];
+			count *= shape[i];
+		}
+
+		p.bytes.resize(count * elementSize);
+		p.section.size = p.bytes.size();
+
+		return p;
+	}
+
+	Payload makeTimes(uint32_t type, const vector<TIMESPAN>& times, TIMESPAN startTime)
+	{
+		Payload p = makePayload(type, SAMPLE_DTYPE_INT64, 0, { (uint32_t)times.size() }, sizeof(int64_t));
+		int64_t* out = reinterpret_cast<int64_t*>(p.bytes.data());
+
+		for (TIMESPAN t : times) *out++ = t - startTime;
+
+		return p;
+	}
+
+	size_t dtypeSize(uint32_t dtype)
+	{
+		switch (dtype)
+		{
+		case SAMPLE_DTYPE_UINT8: return sizeof(uint8_t);
+		case SAMPLE_DTYPE_FLOAT32: return sizeof(float);
+		case SAMPLE_DTYPE_INT64: return sizeof(int64_t);
+		default: return 0;
+		}
+	}
+
+	// product(shape) * dtype <= size (곱이 uint64를 넘지 않게 size로 나눠서 비교)
+	bool shapeFits(const SampleSection& s)
+	{
+		uint64_t bytes = dtypeSize(s.dtype);
+		if (bytes == 0) return false;
+
+		for (uint32_t i = 0; i < s.rank; ++i) if (s.shape[i] == 0) return true;
+		for (uint32_t i = 0; i < s.rank; ++i)
+		{
+			if (bytes > s.size / s.shape[i]) return false;
+			bytes *= s.shape[i];
+		}
+
+		return bytes <= s.size;
+	}
+
+	// accessor가 가정하는 section 모양 (SampleFormat.h 표)
+	bool layoutFits(const SampleSection& s)
+	{
+		switch (s.type)
+		{
+		case SAMPLE_SECTION_SPOINT:
+			return s.dtype == SAMPLE_DTYPE_FLOAT32 && s.rank == 3 && (uint64_t)s.shape[1] * s.shape[2] == SAMPLE_SPOINT_WIDTH;
+		case SAMPLE_SECTION_SPOINT_TIME:
+		case SAMPLE_SECTION_IMAGE_TIME:
+			return s.dtype == SAMPLE_DTYPE_INT64 && s.rank == 1;
+		case SAMPLE_SECTION_IMAGE:
+			return s.dtype == SAMPLE_DTYPE_UINT8 && s.rank == 4 && s.shape[0] == 2;
+		case SAMPLE_SECTION_FLOW:
+			return s.dtype == SAMPLE_DTYPE_UINT8 && s.rank == 5 && s.shape[0] == 2;
+		case SAMPLE_SECTION_IMAGE_CODED:
+			return s.dtype == SAMPLE_DTYPE_UINT8;
+		default:
+			return true;
+		}
+	}
+
+	// mat -> dst (h * w * channels byte), 빈 mat은 0으로 채움
+	void copyMat(const cv::Mat& mat, uint8_t* dst, size_t bytes)
+	{
+		if (mat.empty() || mat.total() * mat.elemSize() != bytes)
+		{
+			memset(dst, 0, bytes);
+			return;
+		}
+
+		if (mat.isContinuous()) memcpy(dst, mat.data, bytes);
+		else
+		{
+			size_t row = mat.cols * mat.elemSize();
+			for (int r = 0; r < mat.rows; ++r) memcpy(dst + r * row, mat.ptr(r), row);
+		}
+	}
+}
+
+SampleFile::SampleFile()
+{
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+}
+
+SampleFile::~SampleFile()
+{
+	close();
+}
+
+bool SampleFile::write(const string& path, Sample& sample)
+{
+	vector<uint8_t> buffer;
+	if (!serialize(sample, buffer)) return false;
+
+	ofstream out(path.data(), ios::out | ios::binary | ios::trunc);
+	if (!out.is_open()) return false;
+
+	out.write(reinterpret_cast<const char*>(buffer.data()), (streamsize)buffer.size());
+
+	return out.good();
+}
+
+bool SampleFile::serialize(Sample& sample, vector<uint8_t>& buffer)
+{
+	int frameSize = sample.frames.getCollectionSize();
+	int imageSize = sample.lhand.getCollectionSize();
+
+	if (imageSize != sample.rhand.getCollectionSize())
+	{
+		cout << "SampleFile::serialize L/R image frame size mismatch " << sample.labelName << endl;
+		return false;
+	}
+
+	vector<Payload> payloads;
+
+	// SPOINT
+	{
+		Payload p = makePayload(SAMPLE_SECTION_SPOINT, SAMPLE_DTYPE_FLOAT32, 0,
+			{ (uint32_t)frameSize, 2, SPOINT_SIZE }, sizeof(float));
+		float* out = reinterpret_cast<float*>(p.bytes.data());
+
+		for (int f = 0; f < frameSize; ++f)
+		{
+			Frame& frame = sample.frames.getFrame(f);
+			for (int i = 0; i < SPOINT_SIZE; ++i) *out++ = (float)frame.getDistanceL(i);
+			for (int i = 0; i < SPOINT_SIZE; ++i) *out++ = (float)frame.getDistanceR(i);
+		}
+		payloads.push_back(move(p));
+	}
+
+	payloads.push_back(makeTimes(SAMPLE_SECTION_SPOINT_TIME, sample.frames.getTimeline(), sample.recordStartTime));
+
+	// IMAGE, scale 마다
+	ImageFrameCollection* hands[2] = { &sample.lhand, &sample.rhand };
+
+	for (int s = 0; s < ImageFrame::getScaleSize() && ROI_CODEC == ROI_CODEC_RAW; ++s)
+	{
+		uint32_t scale = ImageFrame::getScale(s);
+		size_t bytes = scale * scale;
+
+		Payload p = makePayload(SAMPLE_SECTION_IMAGE, SAMPLE_DTYPE_UINT8, scale,
+			{ 2, (uint32_t)imageSize, scale, scale }, 1);
+		uint8_t* out = p.bytes.data();
+
+		// gray 변환이 대부분이라 프레임 단위 병렬 (각자 다른 영역에 씀)
+		Concurrency::parallel_for(0, 2 * imageSize, [&](int k)
+		{
+			int h = k / imageSize;
+			int i = k % imageSize;
+
+			copyMat(hands[h]->getFrame(i).getGray(s), out + k * bytes, bytes);
+		});
+		payloads.push_back(move(p));
+	}
+
+	for (int s = 0; s < ImageFrame::getScaleSize() && ROI_CODEC != ROI_CODEC_RAW; ++s)
+	{
+		vector<uint8_t> streams[2];
+
+		// 손 단위로 병렬 encode
+		Concurrency::parallel_for(0, 2, [&](int h)
+		{
+			unique_ptr<RoiCodec> codec = RoiCodec::create(ROI_CODEC);
+			hands[h]->encode(s, *codec, streams[h]);
+		});
+
+		uint32_t leftSize = (uint32_t)streams[0].size();
+		Payload p = makePayload(SAMPLE_SECTION_IMAGE_CODED, SAMPLE_DTYPE_UINT8, ImageFrame::getScale(s),
+			{ (uint32_t)(sizeof(uint32_t) + streams[0].size() + streams[1].size()) }, 1);
+
+		memcpy(p.bytes.data(), &leftSize, sizeof(leftSize));
+		memcpy(p.bytes.data() + sizeof(leftSize), streams[0].data(), streams[0].size());
+		memcpy(p.bytes.data() + sizeof(leftSize) + streams[0].size(), streams[1].data(), streams[1].size());
+		payloads.push_back(move(p));
+	}
+
+	payloads.push_back(makeTimes(SAMPLE_SECTION_IMAGE_TIME, sample.lhand.getTimeline(), sample.recordStartTime));
+
+	// FLOW
+	if (imageSize > 0 && sample.lhand.getFrame(0).hasFlow())
+	{
+		// flow는 기준 level (imageWidth) ROI에서 계산 (OpticalFlowStage)
+		uint32_t width = (uint32_t)ExtractionConfig::current().imageWidth;
+		size_t bytes = (size_t)width * width * 2;
+
+		Payload p = makePayload(SAMPLE_SECTION_FLOW, SAMPLE_DTYPE_UINT8, 0,
+			{ 2, (uint32_t)imageSize, width, width, 2 }, 1);
+		uint8_t* out = p.bytes.data();
+
+		for (int h = 0; h < 2; ++h)
+		{
+			for (int i = 0; i < imageSize; ++i, out += bytes)
+			{
+				copyMat(hands[h]->getFrame(i).getFlow(), out, bytes);
+			}
+		}
+		payloads.push_back(move(p));
+	}
+
+	// header, layout
+	SampleHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SAMPLE_MAGIC;
+	header.version = SAMPLE_VERSION;
+	header.headerSize = sizeof(SampleHeader);
+	header.sectionCount = (uint32_t)payloads.size();
+	header.label = sample.label;
+	header.recordStartTime = sample.recordStartTime;
+	copyString(header.dateTime, sizeof(header.dateTime), sample.dateTime);
+	copyString(header.labelName, sizeof(header.labelName), sample.labelName);
+	copyString(header.workerName, sizeof(header.workerName), sample.workerName);
+
+	uint64_t offset = alignUp(sizeof(SampleHeader) + payloads.size() * sizeof(SampleSection));
+	for (Payload& p : payloads)
+	{
+		p.section.offset = offset;
+		offset = alignUp(offset + p.section.size);
+	}
+
+	// 섹션 사이 padding은 0
+	buffer.assign((size_t)offset, 0);
+
+	memcpy(buffer.data(), &header, sizeof(header));
+	for (int i = 0; i < (int)payloads.size(); ++i)
+	{
+		memcpy(buffer.data() + sizeof(header) + i * sizeof(SampleSection), &payloads[i].section, sizeof(SampleSection));
+		memcpy(buffer.data() + payloads[i].section.offset, payloads[i].bytes.data(), payloads[i].bytes.size());
+	}
+
+	return true;
+}
+
+bool SampleFile::open(const string& path)
+{
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(SampleHeader))
+	{
+		close();
+		return false;
+	}
+	fileSize = (uint64_t)size.QuadPart;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		close();
+		return false;
+	}
+
+	base = reinterpret_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (base == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	header = reinterpret_cast<const SampleHeader*>(base);
+	sections = reinterpret_cast<const SampleSection*>(base + sizeof(SampleHeader));
+
+	if (!validate())
+	{
+		cout << "SampleFile::open invalid sample " << path << endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool SampleFile::attach(const uint8_t* data, uint64_t size)
+{
+	close();
+
+	if (data == nullptr || size < sizeof(SampleHeader)) return false;
+
+	base = data;
+	fileSize = size;
+	attached = true;
+	header = reinterpret_cast<const SampleHeader*>(base);
+	sections = reinterpret_cast<const SampleSection*>(base + sizeof(SampleHeader));
+
+	if (!validate())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+bool SampleFile::validate()
+{
+	if (header->magic != SAMPLE_MAGIC || header->version < SAMPLE_MIN_VERSION || header->version > SAMPLE_VERSION) return false;
+	if (header->headerSize != sizeof(SampleHeader)) return false;
+	if (sizeof(SampleHeader) + (uint64_t)header->sectionCount * sizeof(SampleSection) > fileSize) return false;
+
+	for (uint32_t i = 0; i < header->sectionCount; ++i)
+	{
+		const SampleSection& s = sections[i];
+		if (s.rank > SAMPLE_MAX_RANK) return false;
+		if (s.offset % SAMPLE_ALIGN != 0 || s.size > fileSize || s.offset > fileSize - s.size) return false;
+		if (!layoutFits(s) || !shapeFits(s)) return false;
+	}
+
+	return true;
+}
+
+void SampleFile::close()
+{
+	if (base != nullptr && !attached) UnmapViewOfFile(base);
+	if (mapping != NULL) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+	base = nullptr;
+	attached = false;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+	fileSize = 0;
+	header = nullptr;
+	sections = nullptr;
+}
+
+bool SampleFile::isOpen()
+{
+	return base != nullptr;
+}
+
+const SampleHeader& SampleFile::getHeader()
+{
+	return *header;
+}
+
+const SampleSection* SampleFile::findSection(int type, int param)
+{
+	if (header == nullptr) return nullptr;
+
+	for (uint32_t i = 0; i < header->sectionCount; ++i)
+	{
+		if (sections[i].type == (uint32_t)type && (param < 0 || sections[i].param == (uint32_t)param))
+		{
+			return &sections[i];
+		}
+	}
+
+	return nullptr;
+}
+
+int SampleFile::getFrameSize()
+{
+	const SampleSection* s = findSection(SAMPLE_SECTION_SPOINT);
+
+	return s == nullptr ? 0 : (int)s->shape[0];
+}
+
+int SampleFile::getImageFrameSize()
+{
+	const SampleSection* s = findSection(SAMPLE_SECTION_IMAGE_TIME);
+
+	return s == nullptr ? 0 : (int)s->shape[0];
+}
+
+const float* SampleFile::getSPoints()
+{
+	return data<float>(findSection(SAMPLE_SECTION_SPOINT));
+}
+
+cv::Mat SampleFile::getImage(int hand, int index, int scale)
+{
+	const SampleSection* s = findSection(SAMPLE_SECTION_IMAGE, scale);
+	if (s == nullptr || hand < 0 || hand > 1 || index < 0 || index >= (int)s->shape[1]) return cv::Mat();
+
+	int h = (int)s->shape[2];
+	int w = (int)s->shape[3];
+	const uint8_t* ptr = data<uint8_t>(s) + ((size_t)hand * s->shape[1] + index) * h * w;
+
+	return cv::Mat(h, w, CV_8UC1, const_cast<uint8_t*>(ptr));
+}
+
+bool SampleFile::getImages(int hand, int scale, vector<cv::Mat>& frames)
+{
+	frames.clear();
+	if (hand < 0 || hand > 1) return false;
+
+	const SampleSection* s = findSection(SAMPLE_SECTION_IMAGE, scale);
+	if (s != nullptr)
+	{
+		for (int i = 0; i < (int)s->shape[1]; ++i) frames.push_back(getImage(hand, i, scale));
+
+		return true;
+	}
+
+	s = findSection(SAMPLE_SECTION_IMAGE_CODED, scale);
+	if (s == nullptr || s->size < sizeof(uint32_t)) return false;
+
+	const uint8_t* ptr = data<uint8_t>(s);
+	uint32_t leftSize;
+	memcpy(&leftSize, ptr, sizeof(leftSize));
+	if (sizeof(uint32_t) + leftSize > s->size) return false;
+
+	const uint8_t* stream = ptr + sizeof(uint32_t) + (hand == 0 ? 0 : leftSize);
+	size_t size = hand == 0 ? leftSize : s->size - sizeof(uint32_t) - leftSize;
+
+	// stream magic으로 codec 구분 (delta-rice decode는 raw도 읽음)
+	DeltaRiceRoiCodec codec;
+
+	return codec.decode(stream, size, frames);
+}
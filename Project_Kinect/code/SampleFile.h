@@ -0,0 +1,79 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ppl.h> // parallel_for
+#include <opencv2/opencv.hpp>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "FrameCollection.h"
+#include "ImageFrameCollection.h"
+#include "SampleFormat.h"
+
+// 저장 단위 : 표준화가 끝난 세그먼트 하나
+struct Sample
+{
+	int label = -1;
+	string labelName;
+	string workerName;
+	string dateTime;
+	TIMESPAN recordStartTime = 0;
+	int64_t segmentTime = 0; // QueryPerformanceCounter, 세그먼트 완료 시각 (predict 지연 측정, 파일에는 안 씀)
+	FrameCollection frames;
+	ImageFrameCollection lhand;
+	ImageFrameCollection rhand;
+};
+
+class SampleFile
+{
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* base = nullptr;
+	bool attached = false; // attach() : 남의 메모리, unmap 안함
+	uint64_t fileSize = 0;
+	const SampleHeader* header = nullptr;
+	const SampleSection* sections = nullptr;
+
+public:
+	SampleFile();
+	~SampleFile();
+
+	SampleFile(const SampleFile&) = delete;
+	SampleFile& operator=(const SampleFile&) = delete;
+
+	static bool write(const string& path, Sample& sample);
+	static bool serialize(Sample& sample, vector<uint8_t>& buffer);
+
+	// read (mmap), 반환 포인터/Mat은 close() 전까지만 유효
+	bool open(const string& path);
+	// 이미 매핑된 메모리 위의 샘플 (e.g. ShardReader), data는 SAMPLE_ALIGN 정렬
+	bool attach(const uint8_t* data, uint64_t size);
+	void close();
+	bool isOpen();
+
+	const SampleHeader& getHeader();
+	const SampleSection* findSection(int type, int param = -1);
+
+	template <class T>
+	const T* data(const SampleSection* section)
+	{
+		return section == nullptr ? nullptr : reinterpret_cast<const T*>(base + section->offset);
+	}
+
+	int getFrameSize(); // SPOINT frame 수
+	int getImageFrameSize(); // 한 손 ROI frame 수
+	const float* getSPoints(); // [frame][2][SPOINT_SIZE]
+
+	// 복사 없이 mapping을 가리키는 CV_8UC1 (IMAGE section만)
+	cv::Mat getImage(int hand, int index, int scale = IMAGE_WIDTH);
+
+	// 한 손 시퀀스 전체, IMAGE_CODED면 decode
+	bool getImages(int hand, int scale, vector<cv::Mat>& frames);
+
+private:
+	bool validate();
+};
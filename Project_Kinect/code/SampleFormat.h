@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+
+// sample.ksl, shard(.kss/.idx) 파일 형식, predict 샘플 ring (shared memory)
+// Kinect / Windows 의존 없음 : Project_Reader(dll)도 이 헤더만으로 읽는다
+
+// 단일 파일 바이너리 샘플 (sample.ksl)
+//
+// [SampleHeader][SampleSection x sectionCount][pad][section data]...
+// section data는 SAMPLE_ALIGN 정렬, shape 순서 그대로 row-major (little endian)
+// -> mmap 후 포인터 캐스팅만으로 읽는다 (text parse, bmp open 없음)
+//
+//   SPOINT      float32 [frame, 2(L/R), SPOINT_SIZE]   Spoints.txt와 같은 값 순서
+//   SPOINT_TIME int64   [frame]                        recordStartTime 기준 (100ns, Times.txt)
+//   IMAGE       uint8   [2(L/R), frame, h, w]          gray, IMAGE_SCALES 마다 1개 (param = scale)
+//   IMAGE_TIME  int64   [frame]
+//   FLOW        uint8   [2(L/R), frame, h, w, 2]       ROI_OPTICAL_FLOW일 때만
+//   IMAGE_CODED uint8   [byte]                         ROI_CODEC != RAW일 때 IMAGE 대신 (param = scale)
+//                       [uint32 L size][L RoiCodec stream][R RoiCodec stream]
+//
+// 형식이 바뀌면 SAMPLE_VERSION을 올리고 Project_DNN/scripts/dataFormater.py도 같이 수정
+
+#define SAMPLE_FILE_NAME "sample.ksl"
+#define SAMPLE_MAGIC 0x534C534B // "KSLS"
+#define SAMPLE_VERSION 2 // 2 : IMAGE_CODED section
+#define SAMPLE_MIN_VERSION 1 // 읽을 수 있는 가장 오래된 형식 (1은 IMAGE_CODED 없음)
+#define SAMPLE_ALIGN 64
+#define SAMPLE_MAX_RANK 5
+#define SAMPLE_SPOINT_WIDTH 74 // SPOINT shape[1] * shape[2] (L, R 각 SPOINT_SIZE)
+
+enum SAMPLE_SECTION
+{
+	SAMPLE_SECTION_SPOINT = 1,
+	SAMPLE_SECTION_SPOINT_TIME,
+	SAMPLE_SECTION_IMAGE,
+	SAMPLE_SECTION_IMAGE_TIME,
+	SAMPLE_SECTION_FLOW,
+	SAMPLE_SECTION_IMAGE_CODED,
+};
+
+enum SAMPLE_DTYPE
+{
+	SAMPLE_DTYPE_UINT8 = 1,
+	SAMPLE_DTYPE_FLOAT32,
+	SAMPLE_DTYPE_INT64,
+};
+
+struct SampleHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize; // sizeof(SampleHeader)
+	uint32_t sectionCount;
+	int32_t label;
+	uint32_t reserved;
+	int64_t recordStartTime;
+	char dateTime[32]; // currentDateTime()
+	char labelName[64]; // LABEL(label), LABEL.txt 인코딩 그대로
+	char workerName[32];
+};
+
+struct SampleSection
+{
+	uint32_t type; // SAMPLE_SECTION
+	uint32_t dtype; // SAMPLE_DTYPE
+	uint32_t param; // IMAGE : scale
+	uint32_t rank;
+	uint32_t shape[SAMPLE_MAX_RANK];
+	uint32_t reserved;
+	uint64_t offset; // 파일 시작 기준
+	uint64_t size; // byte
+};
+
+static_assert(sizeof(SampleHeader) == 160, "SampleHeader layout");
+static_assert(sizeof(SampleSection) == 56, "SampleSection layout");
+
+// append-only dataset shard (SAVE_FORMAT_SHARD)
+//
+// data/shards/<datetime>_<n>.kss : sample.ksl 바이트를 SAMPLE_ALIGN 정렬로 이어 붙인 파일
+// data/shards/<datetime>_<n>.idx : [ShardIndexHeader][ShardIndexEntry]...
+//
+// 샘플을 data 파일에 쓴 뒤 index에 entry를 추가한다 (entry가 있는 샘플만 유효).
+// 데이터셋 목록은 폴더를 뒤지지 않고 .idx만 읽으면 되고,
+// 샘플 하나는 .kss 매핑 위에서 offset으로 바로 접근 (shuffle 학습용 random access).
+//
+// 읽기 : Project_DNN/scripts/dataFormater.py (ROI_loadShardListAll)
+
+#define SHARD_DATA_EXT ".kss"
+#define SHARD_INDEX_EXT ".idx"
+#define SHARD_INDEX_MAGIC 0x494C534B // "KSLI"
+#define SHARD_VERSION 1
+
+struct ShardIndexHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entrySize; // sizeof(ShardIndexEntry)
+	uint32_t reserved;
+};
+
+struct ShardIndexEntry
+{
+	uint64_t offset; // .kss 안의 샘플 시작 (SAMPLE_ALIGN 배수)
+	uint64_t size;
+	int32_t label;
+	uint32_t reserved;
+	int64_t recordStartTime;
+	char dateTime[32];
+	char workerName[32];
+};
+
+static_assert(sizeof(ShardIndexHeader) == 16, "ShardIndexHeader layout");
+static_assert(sizeof(ShardIndexEntry) == 96, "ShardIndexEntry layout");
+
+// predict 샘플 shared memory ring (PREDICT_HANDOFF_RING, SampleRing.h)
+//
+// named file mapping SAMPLE_RING_NAME : [SampleRingHeader][slot 0]...[slot n-1]
+//   slot = [SampleRingSlot][sample.ksl 바이트, 최대 slotBytes]  (payload는 SAMPLE_ALIGN 정렬)
+//
+// 쓰기 (Project_Kinect SampleSaver, producer 하나)
+//   slot.seq 홀수 -> payload, 정보 복사 -> slot.seq 짝수 -> header.writeSeq = number + 1 -> SetEvent(SAMPLE_RING_EVENT_NAME)
+// 읽기 (do_Predict.py, Project_Tools ring-consume, consumer 하나)
+//   writeSeq > readSeq 이면 가장 최신 샘플(writeSeq - 1)의 slot을 복사, 복사 전후 seq가 같고 짝수일 때만 유효
+//   (그 사이 producer가 덮어썼으면 다시 읽는다), 읽은 뒤 header.readSeq = number + 1
+// event는 auto-reset, 놓친 신호가 있어도 writeSeq로 판단하므로 wait는 timeout과 같이 쓴다
+//
+// 형식이 바뀌면 SAMPLE_RING_VERSION을 올리고 Project_DNN/scripts/sampleRing.py도 같이 수정
+
+#define SAMPLE_RING_NAME "Local\\KSL_SampleRing"
+#define SAMPLE_RING_EVENT_NAME "Local\\KSL_SampleRing_Ready"
+#define SAMPLE_RING_MAGIC 0x524C534B // "KSLR"
+#define SAMPLE_RING_VERSION 1
+#define SAMPLE_RING_SLOT_COUNT 4
+#define SAMPLE_RING_SLOT_BYTES (4 << 20) // 기본 설정 샘플 ~2.2MB (IMAGE 140/80/64 x 35 x 2 + SPOINT)
+
+struct SampleRingHeader
+{
+	uint32_t magic; // producer가 나머지를 채운 뒤 마지막에 기록
+	uint32_t version;
+	uint32_t slotCount;
+	uint32_t slotHeaderSize; // sizeof(SampleRingSlot)
+	uint64_t slotBytes;
+	int64_t timerFrequency; // QueryPerformanceFrequency
+	volatile int64_t writeSeq; // 발행한 샘플 수 (= 다음 샘플 번호)
+	volatile int64_t readSeq; // consumer가 마지막으로 읽은 번호 + 1
+	int64_t reserved[2];
+};
+
+struct SampleRingSlot
+{
+	volatile int64_t seq; // 홀수 : 쓰는 중
+	int64_t number; // 샘플 번호 (0부터), slot = number % slotCount
+	uint64_t size; // payload byte
+	int64_t publishTime; // QueryPerformanceCounter, 수신측 지연 측정용
+	int32_t label;
+	uint32_t reserved;
+	int64_t reserved2[3];
+};
+
+static_assert(sizeof(SampleRingHeader) == 64, "SampleRingHeader layout");
+static_assert(sizeof(SampleRingSlot) == 64, "SampleRingSlot layout");
@@ -0,0 +1,263 @@
+#include "SampleRing.h"
+
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+	// 읽는 도중 producer가 같은 slot을 덮어쓰면 다시 읽는 횟수
+	const int READ_RETRY = 8;
+}
+
+SampleRing::SampleRing()
+{
+}
+
+SampleRing::~SampleRing()
+{
+	close();
+}
+
+uint64_t SampleRing::getMappingSize()
+{
+	return sizeof(SampleRingHeader) + (uint64_t)SAMPLE_RING_SLOT_COUNT * (sizeof(SampleRingSlot) + SAMPLE_RING_SLOT_BYTES);
+}
+
+bool SampleRing::create()
+{
+	if (!map(true)) return false;
+
+	if (isValid())
+	{
+		cout << "SampleRing::create ... attach (next " << header->writeSeq << ")" << endl;
+		return true;
+	}
+
+	// consumer가 먼저 만들었거나 다른 버전 : header 초기화, magic은 마지막에
+	header->magic = 0;
+	MemoryBarrier();
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+
+	header->version = SAMPLE_RING_VERSION;
+	header->slotCount = SAMPLE_RING_SLOT_COUNT;
+	header->slotHeaderSize = sizeof(SampleRingSlot);
+	header->slotBytes = SAMPLE_RING_SLOT_BYTES;
+	header->timerFrequency = frequency.QuadPart;
+	header->writeSeq = 0;
+	header->readSeq = 0;
+
+	for (int i = 0; i < SAMPLE_RING_SLOT_COUNT; ++i)
+	{
+		memset(slotOf(i), 0, sizeof(SampleRingSlot));
+	}
+
+	MemoryBarrier();
+	header->magic = SAMPLE_RING_MAGIC;
+
+	return true;
+}
+
+bool SampleRing::open()
+{
+	if (!map(false)) return false;
+
+	// 이미 발행된 샘플은 지난 것, 다음 샘플부터
+	readSeq = isValid() ? header->writeSeq : 0;
+	skipped = 0;
+
+	return true;
+}
+
+bool SampleRing::map(bool isProducer)
+{
+	close();
+
+	uint64_t size = getMappingSize();
+
+	mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		(DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), SAMPLE_RING_NAME);
+	if (mapping == NULL)
+	{
+		cout << "SampleRing::map fail CreateFileMapping " << GetLastError() << endl;
+		return false;
+	}
+
+	base = reinterpret_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)size));
+	if (base == nullptr)
+	{
+		// 같은 이름의 더 작은 ring (다른 SAMPLE_RING_SLOT_*로 빌드된 process)
+		cout << "SampleRing::map fail MapViewOfFile " << GetLastError() << endl;
+		close();
+		return false;
+	}
+
+	ready = CreateEventA(NULL, FALSE, FALSE, SAMPLE_RING_EVENT_NAME);
+	if (ready == NULL)
+	{
+		cout << "SampleRing::map fail CreateEvent " << GetLastError() << endl;
+		close();
+		return false;
+	}
+
+	header = reinterpret_cast<SampleRingHeader*>(base);
+
+	cout << "SampleRing " << (isProducer ? "producer" : "consumer") << " ... " << SAMPLE_RING_NAME
+		<< " (" << SAMPLE_RING_SLOT_COUNT << " x " << (SAMPLE_RING_SLOT_BYTES >> 20) << "MB)" << endl;
+
+	return true;
+}
+
+void SampleRing::close()
+{
+	if (base != nullptr) UnmapViewOfFile(base);
+	if (mapping != NULL) CloseHandle(mapping);
+	if (ready != NULL) CloseHandle(ready);
+
+	base = nullptr;
+	header = nullptr;
+	mapping = NULL;
+	ready = NULL;
+}
+
+bool SampleRing::isOpen()
+{
+	return base != nullptr;
+}
+
+bool SampleRing::isValid()
+{
+	return header != nullptr
+		&& header->magic == SAMPLE_RING_MAGIC
+		&& header->version == SAMPLE_RING_VERSION
+		&& header->slotCount == SAMPLE_RING_SLOT_COUNT
+		&& header->slotHeaderSize == sizeof(SampleRingSlot)
+		&& header->slotBytes == SAMPLE_RING_SLOT_BYTES;
+}
+
+SampleRingSlot* SampleRing::slotOf(int64_t number)
+{
+	uint64_t index = (uint64_t)(number % SAMPLE_RING_SLOT_COUNT);
+	return reinterpret_cast<SampleRingSlot*>(base + sizeof(SampleRingHeader) + index * (sizeof(SampleRingSlot) + SAMPLE_RING_SLOT_BYTES));
+}
+
+int64_t SampleRing::publish(const uint8_t* data, uint64_t size, int label)
+{
+	if (!isValid()) return -1;
+
+	if (size > SAMPLE_RING_SLOT_BYTES)
+	{
+		cout << "SampleRing::publish fail " << size << " byte > SAMPLE_RING_SLOT_BYTES" << endl;
+		return -1;
+	}
+
+	int64_t number = header->writeSeq;
+	SampleRingSlot* slot = slotOf(number);
+	uint8_t* payload = reinterpret_cast<uint8_t*>(slot) + sizeof(SampleRingSlot);
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	InterlockedIncrement64(&slot->seq); // 홀수 : 쓰는 중
+
+	memcpy(payload, data, (size_t)size);
+	slot->number = number;
+	slot->size = size;
+	slot->publishTime = now.QuadPart;
+	slot->label = label;
+
+	InterlockedIncrement64(&slot->seq); // 짝수 : 완료
+	InterlockedExchange64(&header->writeSeq, number + 1);
+
+	SetEvent(ready);
+
+	return number;
+}
+
+bool SampleRing::read(vector<uint8_t>& buffer, SampleRingSlot& info)
+{
+	if (!isValid()) return false;
+
+	for (int retry = 0; retry < READ_RETRY; ++retry)
+	{
+		int64_t writeSeq = header->writeSeq;
+		MemoryBarrier();
+
+		// producer가 재시작해서 번호가 줄었으면 처음부터
+		if (writeSeq < readSeq) readSeq = 0;
+		if (writeSeq == readSeq) return false;
+
+		int64_t number = writeSeq - 1;
+		if (!read(number, buffer, info)) continue; // 그 사이 더 새 샘플이 들어옴
+
+		skipped += number - readSeq;
+		readSeq = number + 1;
+		InterlockedExchange64(&header->readSeq, readSeq);
+
+		return true;
+	}
+
+	return false;
+}
+
+bool SampleRing::read(int64_t number, vector<uint8_t>& buffer, SampleRingSlot& info)
+{
+	if (!isValid() || number < 0) return false;
+
+	SampleRingSlot* slot = slotOf(number);
+	const uint8_t* payload = reinterpret_cast<const uint8_t*>(slot) + sizeof(SampleRingSlot);
+
+	for (int retry = 0; retry < READ_RETRY; ++retry)
+	{
+		int64_t before = slot->seq;
+		MemoryBarrier();
+		if (before & 1) continue; // 쓰는 중
+
+		info = *slot;
+		if (info.number != number) return false; // 이미 덮어썼거나 아직 안 씀
+		if (info.size > SAMPLE_RING_SLOT_BYTES) continue;
+
+		buffer.resize((size_t)info.size);
+		memcpy(buffer.data(), payload, (size_t)info.size);
+
+		MemoryBarrier();
+		if (slot->seq == before) return true; // 복사 중에 덮어쓰지 않았음
+	}
+
+	return false;
+}
+
+bool SampleRing::wait(vector<uint8_t>& buffer, SampleRingSlot& info, DWORD timeoutMs)
+{
+	if (read(buffer, info)) return true;
+
+	WaitForSingleObject(ready, timeoutMs);
+
+	return read(buffer, info);
+}
+
+int64_t SampleRing::getWriteSeq()
+{
+	return isValid() ? header->writeSeq : 0;
+}
+
+int64_t SampleRing::getReadSeq()
+{
+	return isValid() ? header->readSeq : 0;
+}
+
+int64_t SampleRing::getSkipped()
+{
+	return skipped;
+}
+
+double SampleRing::getLatency(const SampleRingSlot& info)
+{
+	if (!isValid() || header->timerFrequency == 0) return 0;
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	return (now.QuadPart - info.publishTime) * 1000.0 / header->timerFrequency;
+}
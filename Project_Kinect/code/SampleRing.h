@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Windows.h> // HANDLE
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFormat.h"
+
+// predict 샘플 handoff : named shared memory ring + auto-reset event (형식은 SampleFormat.h)
+//
+// data/temp에 쓰고 "[Predict]"를 C# -> python stdin으로 넘기던 경로 대신
+// producer(SampleSaver)가 serialize한 sample.ksl 바이트를 slot에 복사하고 event로 깨운다.
+// consumer는 seq 전후 비교로 찢어진 slot을 걸러내고, 밀렸으면 최신 샘플만 읽는다 (건너뛴 수는 getSkipped).
+//
+// create / open 둘 다 같은 이름으로 만들거나 연다 : 어느 쪽 process가 먼저 떠도 된다.
+// header는 producer(create)만 초기화, consumer는 magic이 채워질 때까지 샘플 없음으로 본다.
+class SampleRing
+{
+private:
+	HANDLE mapping = NULL;
+	HANDLE ready = NULL;
+	uint8_t* base = nullptr;
+	SampleRingHeader* header = nullptr;
+	int64_t readSeq = 0; // consumer : 다음에 읽을 번호
+	int64_t skipped = 0;
+
+public:
+	SampleRing();
+	~SampleRing();
+
+	SampleRing(const SampleRing&) = delete;
+	SampleRing& operator=(const SampleRing&) = delete;
+
+	// producer, 같은 형식의 ring이 이미 있으면 번호를 이어간다
+	bool create();
+	// consumer
+	bool open();
+	void close();
+	bool isOpen();
+
+	// producer, data : SampleFile::serialize 결과
+	// 반환 : 샘플 번호 (PredictRequest.ringNumber), -1 : 실패
+	int64_t publish(const uint8_t* data, uint64_t size, int label);
+
+	// consumer, 새 샘플이 있으면 바로, 없으면 timeoutMs까지 event 대기
+	// buffer : sample.ksl 바이트 (SampleFile::attach), info : slot 정보 (number, label, publishTime)
+	bool wait(vector<uint8_t>& buffer, SampleRingSlot& info, DWORD timeoutMs);
+	bool read(vector<uint8_t>& buffer, SampleRingSlot& info);
+	// 번호 지정 (PredictRequest.ringNumber), slot이 이미 덮어써졌으면 false, readSeq는 그대로
+	bool read(int64_t number, vector<uint8_t>& buffer, SampleRingSlot& info);
+
+	int64_t getWriteSeq();
+	int64_t getReadSeq(); // consumer가 기록한 값, producer 쪽 상태 표시용
+	int64_t getSkipped();
+
+	// publishTime ~ 현재 (ms)
+	double getLatency(const SampleRingSlot& info);
+
+	static uint64_t getMappingSize();
+
+private:
+	bool map(bool isProducer);
+	bool isValid();
+
+	SampleRingSlot* slotOf(int64_t number);
+};
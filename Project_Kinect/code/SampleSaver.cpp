@@ -0,0 +1,209 @@
+#include "SampleSaver.h"
+
+#include <Windows.h> // MoveFileExA
+
+SampleSaver::SampleSaver(int workerCount, int capacity)
+{
+	this->capacity = capacity;
+	saved = 0;
+	dropped = 0;
+	failed = 0;
+	written = 0;
+
+	for (int i = 0; i < workerCount; ++i)
+	{
+		workers.push_back(thread(&SampleSaver::run, this));
+	}
+}
+
+SampleSaver::~SampleSaver()
+{
+	flush();
+
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_all();
+
+	for (thread& worker : workers)
+	{
+		if (worker.joinable()) worker.join();
+	}
+}
+
+bool SampleSaver::push(Sample&& sample, const string& dirpath, bool isSending)
+{
+	{
+		lock_guard<mutex> guard(lock);
+
+		if ((int)jobs.size() >= capacity)
+		{
+			++dropped;
+			cout << sample.labelName << " Record saving ... drop (queue full) " << dirpath << endl;
+			return false;
+		}
+
+		Job job;
+		job.sample = move(sample);
+		job.dirpath = dirpath;
+		job.isSending = isSending;
+		jobs.push_back(move(job));
+	}
+	wake.notify_one();
+
+	return true;
+}
+
+void SampleSaver::flush()
+{
+	unique_lock<mutex> guard(lock);
+	idle.wait(guard, [&] { return jobs.empty() && busy == 0; });
+}
+
+int SampleSaver::getDepth()
+{
+	lock_guard<mutex> guard(lock);
+	return (int)jobs.size() + busy;
+}
+
+int SampleSaver::getSaved()
+{
+	return saved;
+}
+
+int SampleSaver::getDropped()
+{
+	return dropped;
+}
+
+int SampleSaver::getFailed()
+{
+	return failed;
+}
+
+void SampleSaver::run()
+{
+	while (true)
+	{
+		Job job;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !jobs.empty() || !running; });
+			if (jobs.empty()) return; // !running
+
+			job = move(jobs.front());
+			jobs.pop_front();
+			++busy;
+		}
+
+		if (job.isSending)
+		{
+			lock_guard<mutex> guard(sendLock);
+
+			// 쓰기 완료 후에 알려야 python이 반쯤 쓴 샘플을 읽지 않는다
+			if (write(job)) cout << "[Predict]" << endl;
+		}
+		else write(job);
+
+		{
+			lock_guard<mutex> guard(lock);
+			--busy;
+		}
+		idle.notify_all();
+	}
+}
+
+bool SampleSaver::write(Job& job)
+{
+	bool result;
+
+#ifdef BENCHMARK_ROI_CODEC
+	{
+		unique_ptr<RoiCodec> codec = RoiCodec::create(ROI_CODEC == ROI_CODEC_RAW ? ROI_CODEC_DELTA_RICE : ROI_CODEC);
+		job.sample.lhand.benchmarkCodec(*codec);
+	}
+#endif
+
+	if (SAVE_FORMAT == SAVE_FORMAT_SHARD && !job.isSending)
+	{
+		// serialize는 병렬, append만 직렬
+		vector<uint8_t> buffer;
+		result = SampleFile::serialize(job.sample, buffer);
+
+		if (result)
+		{
+			lock_guard<mutex> guard(shardLock);
+			result = shardWriter.append(buffer);
+		}
+
+		if (result) ++saved;
+		else ++failed;
+
+		cout << job.sample.labelName << " Record saving ... " << (result ? "done " : "fail ") << ++written << shardWriter.getDataPath() << endl;
+
+		return result;
+	}
+
+	makeDirectories(job.dirpath);
+
+	if (SAVE_FORMAT != SAVE_FORMAT_TEXT)
+	{
+		string path = job.dirpath + SAMPLE_FILE_NAME;
+		string temp = path + ".tmp";
+
+		result = SampleFile::write(temp, job.sample)
+			&& MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+	}
+	else result = writeText(job);
+
+	if (result) ++saved;
+	else ++failed;
+
+	cout << job.sample.labelName << " Record saving ... " << (result ? "done " : "fail ") << ++written << job.dirpath << endl;
+
+	return result;
+}
+
+// 이미지 -> Times.txt -> Spoints.txt 순서, Spoints.txt가 있으면 샘플 완성
+bool SampleSaver::writeText(Job& job)
+{
+	Sample& sample = job.sample;
+
+	sample.lhand.save(job.dirpath, 0);
+	sample.rhand.save(job.dirpath, sample.lhand.getCollectionSize());
+
+	// Times.txt : 표준화된 각 프레임의 시점 (recordStartTime 기준, 100ns)
+	// line 1 = SPoint 프레임, line 2 = ROI 프레임
+	stringstream times;
+	vector<TIMESPAN> timelines[2] = { sample.frames.getTimeline(), sample.lhand.getTimeline() };
+
+	for (int t = 0; t < 2; ++t)
+	{
+		times << timelines[t].size();
+		for (TIMESPAN time : timelines[t]) times << " " << (time - sample.recordStartTime);
+		times << endl;
+	}
+
+	string timeText = times.str();
+	if (!write_file_atomic(job.dirpath + "Times.txt", timeText.data(), timeText.size())) return false;
+
+	// Spoints.txt
+	stringstream spoints;
+	spoints << sample.frames.toString() << endl;
+
+	string spointText = spoints.str();
+
+	return write_file_atomic(job.dirpath + "Spoints.txt", spointText.data(), spointText.size());
+}
+
+// data/0_안녕하세요/2018-05-19_..._kyg/ 의 각 단계 폴더 생성 (이미 있으면 _mkdir 실패, 무시)
+void SampleSaver::makeDirectories(const string& dirpath)
+{
+	for (size_t pos = dirpath.find('/'); pos != string::npos; pos = dirpath.find('/', pos + 1))
+	{
+		if (pos == 0) continue;
+
+		_mkdir(dirpath.substr(0, pos).c_str());
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "ShardFile.h"
+
+// 세그먼트 저장 write-behind 큐
+//
+// Kinect::save()는 Sample을 move로 넘기고 바로 돌아간다 (capture thread는 disk를 기다리지 않음).
+// worker thread들이 폴더 생성, encode, 쓰기를 하고 모든 파일은 temp -> rename 으로 쓴다.
+// 큐가 가득 차면 새 세그먼트는 버리고 dropped를 센다.
+//
+// predict 샘플은 PredictQueue -> PredictLink로 가고, 보낼 곳이 없을 때만 (PREDICT_HANDOFF_FILE + PREDICT_PROTOCOL_STDOUT, 실패)
+// isSending job으로 들어온다 : data/temp에 쓰기가 끝난 뒤에 "[Predict]"를 출력한다.
+// sending job끼리는 sendLock으로 직렬화한다 (같은 data/temp).
+class SampleSaver
+{
+private:
+	struct Job
+	{
+		Sample sample;
+		string dirpath; // '/'로 끝남
+		bool isSending;
+	};
+
+	vector<thread> workers;
+	mutex lock;
+	mutex sendLock;
+	mutex shardLock;
+	ShardWriter shardWriter; // SAVE_FORMAT_SHARD
+	condition_variable wake;
+	condition_variable idle;
+	deque<Job> jobs;
+	int capacity;
+	int busy = 0;
+	bool running = true;
+
+	atomic<int> saved;
+	atomic<int> dropped;
+	atomic<int> failed;
+	atomic<int> written; // 로그 번호 (worker들이 같이 씀)
+
+public:
+	SampleSaver(int workerCount = SAVE_WORKER_COUNT, int capacity = SAVE_QUEUE_CAPACITY);
+
+	// 남은 job을 모두 쓴 뒤 종료
+	~SampleSaver();
+
+	// false : 큐가 가득 차서 버림
+	bool push(Sample&& sample, const string& dirpath, bool isSending);
+
+	// 큐가 빌 때까지 대기
+	void flush();
+
+	int getDepth();
+	int getSaved();
+	int getDropped();
+	int getFailed();
+
+	// data/0_안녕하세요/2018-05-19_..._kyg/ 의 각 단계 폴더 생성
+	static void makeDirectories(const string& dirpath);
+
+private:
+	void run();
+
+	bool write(Job& job);
+
+	bool writeText(Job& job);
+};
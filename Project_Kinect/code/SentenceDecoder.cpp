@@ -0,0 +1,280 @@
+#include "SentenceDecoder.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	const float NEG_INF = -numeric_limits<float>::infinity();
+
+	// log 0 대신 (recognizer score가 0인 label)
+	const float PROB_FLOOR = 1e-8f;
+
+	// add-k smoothing
+	const float PRIOR_SMOOTHING = 0.5f;
+
+	float logAdd(float a, float b)
+	{
+		if (a == NEG_INF) return b;
+		if (b == NEG_INF) return a;
+		float high = max(a, b);
+		return high + log1p(exp(min(a, b) - high));
+	}
+
+	float logProb(float p)
+	{
+		return log(max(p, PROB_FLOOR));
+	}
+}
+
+bool BigramPrior::load(const string& path)
+{
+	ifstream file(path.c_str());
+	if (!file.is_open()) return false;
+
+	string line;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+
+		stringstream stream(line);
+		int prev, next;
+		float count;
+		if (stream >> prev >> next >> count) add(prev, next, count);
+	}
+
+	return true;
+}
+
+bool BigramPrior::save(const string& path)
+{
+	ofstream file(path.c_str(), ios::out | ios::trunc);
+	if (!file.is_open()) return false;
+
+	file << "# prev next count (prev -1 : 문장 시작)" << endl;
+	for (const auto& row : counts)
+	{
+		for (const auto& item : row.second) file << row.first << " " << item.first << " " << item.second << endl;
+	}
+
+	return file.good();
+}
+
+void BigramPrior::add(int prev, int next, float count)
+{
+	if (next < 0 || count <= 0) return;
+
+	counts[prev][next] += count;
+	totals[prev] += count;
+	labelCount = max(labelCount, max(prev, next) + 1);
+}
+
+void BigramPrior::addSentence(const vector<int>& labels)
+{
+	int prev = -1;
+	for (int label : labels)
+	{
+		add(prev, label);
+		prev = label;
+	}
+}
+
+bool BigramPrior::isEmpty()
+{
+	return counts.empty();
+}
+
+float BigramPrior::score(int prev, int next)
+{
+	float size = (float)max(labelCount, next + 1);
+
+	auto row = counts.find(prev);
+	if (row == counts.end()) return -log(size);
+
+	auto item = row->second.find(next);
+	float count = item == row->second.end() ? 0 : item->second;
+
+	return log((count + PRIOR_SMOOTHING) / (totals[prev] + PRIOR_SMOOTHING * size));
+}
+
+float SentenceDecoder::Beam::getScore(float insertionBonus) const
+{
+	return logAdd(blank, label) + prior + insertionBonus * pending.size();
+}
+
+SentenceDecoder::SentenceDecoder(int beamWidth, int topLabels, int maxPending, float lmWeight, float insertionBonus)
+{
+	this->beamWidth = max(beamWidth, 1);
+	this->topLabels = max(topLabels, 1);
+	this->maxPending = max(maxPending, 1);
+	this->lmWeight = lmWeight;
+	this->insertionBonus = insertionBonus;
+
+	reset();
+}
+
+void SentenceDecoder::setPrior(BigramPrior* prior)
+{
+	this->prior = prior;
+}
+
+void SentenceDecoder::push(const vector<float>& posteriors, vector<int>& committed)
+{
+	if (posteriors.size() < 2) return;
+
+	int blankIndex = (int)posteriors.size() - 1;
+	float logBlank = logProb(posteriors[blankIndex]);
+
+	// step마다 확장할 label
+	order.resize(blankIndex);
+	iota(order.begin(), order.end(), 0);
+	int top = min(topLabels, blankIndex);
+	partial_sort(order.begin(), order.begin() + top, order.end(), [&](int a, int b) { return posteriors[a] > posteriors[b]; });
+
+	candidates.clear();
+	vector<int> pending;
+
+	for (const Beam& from : beams)
+	{
+		float total = logAdd(from.blank, from.label);
+
+		// 그대로 : blank, 또는 마지막 label 계속
+		auto found = candidates.find(from.pending);
+		if (found == candidates.end())
+		{
+			Beam same = from;
+			same.blank = NEG_INF;
+			same.label = NEG_INF;
+			found = candidates.emplace(from.pending, move(same)).first;
+		}
+
+		Beam& same = found->second;
+		same.blank = logAdd(same.blank, total + logBlank);
+		if (from.last >= 0 && from.last < blankIndex) same.label = logAdd(same.label, from.label + logProb(posteriors[from.last]));
+
+		// 새 label (같은 label은 blank 뒤에서만)
+		for (int i = 0; i < top; ++i)
+		{
+			int label = order[i];
+			float logp = (label == from.last ? from.blank : total) + logProb(posteriors[label]);
+			if (logp == NEG_INF) continue;
+
+			pending = from.pending;
+			pending.push_back(label);
+			extend(from, label, logp, pending);
+		}
+	}
+
+	maxCandidates = max(maxCandidates, (int)candidates.size());
+
+	beams.clear();
+	for (auto& item : candidates) beams.push_back(move(item.second));
+	candidates.clear();
+
+	int keep = min(beamWidth, (int)beams.size());
+	partial_sort(beams.begin(), beams.begin() + keep, beams.end(), [&](const Beam& a, const Beam& b)
+	{
+		return a.getScore(insertionBonus) > b.getScore(insertionBonus);
+	});
+	beams.resize(keep);
+
+	// 긴 stream에서 underflow 안 나게 best 기준으로
+	float best = logAdd(beams[0].blank, beams[0].label);
+	for (Beam& beam : beams)
+	{
+		beam.blank -= best;
+		beam.label -= best;
+	}
+
+	++steps;
+	commit(committed);
+}
+
+void SentenceDecoder::flush(vector<int>& committed)
+{
+	if (!beams.empty()) committed.insert(committed.end(), beams[0].pending.begin(), beams[0].pending.end());
+	reset();
+}
+
+void SentenceDecoder::reset()
+{
+	beams.clear();
+
+	Beam start;
+	start.label = NEG_INF;
+	beams.push_back(start);
+}
+
+vector<int> SentenceDecoder::getPending()
+{
+	return beams.empty() ? vector<int>() : beams[0].pending;
+}
+
+int SentenceDecoder::getSteps()
+{
+	return steps;
+}
+
+int SentenceDecoder::getMaxCandidates()
+{
+	return maxCandidates;
+}
+
+void SentenceDecoder::addBlank(const vector<float>& scores, float blank, vector<float>& posteriors)
+{
+	blank = min(max(blank, 0.0f), 1.0f);
+
+	posteriors.resize(scores.size() + 1);
+	for (size_t i = 0; i < scores.size(); ++i) posteriors[i] = scores[i] * (1 - blank);
+	posteriors.back() = blank;
+}
+
+void SentenceDecoder::extend(const Beam& from, int label, float logp, vector<int>& pending)
+{
+	auto found = candidates.find(pending);
+	if (found == candidates.end())
+	{
+		Beam next;
+		next.pending = pending;
+		next.last = label;
+		next.blank = NEG_INF;
+		next.label = NEG_INF;
+		next.prior = from.prior + (prior && !prior->isEmpty() ? lmWeight * prior->score(from.last, label) : 0);
+		found = candidates.emplace(pending, move(next)).first;
+	}
+
+	found->second.label = logAdd(found->second.label, logp);
+}
+
+void SentenceDecoder::commit(vector<int>& committed)
+{
+	// 모든 beam이 같은 앞부분
+	size_t common = beams[0].pending.size();
+	for (size_t b = 1; b < beams.size() && common > 0; ++b)
+	{
+		const vector<int>& pending = beams[b].pending;
+		size_t i = 0;
+		while (i < common && i < pending.size() && pending[i] == beams[0].pending[i]) ++i;
+		common = i;
+	}
+
+	// 너무 길면 best 앞 하나를 확정, 다른 앞부분 beam은 버림
+	if (common == 0 && (int)beams[0].pending.size() > maxPending)
+	{
+		int first = beams[0].pending[0];
+		beams.erase(remove_if(beams.begin() + 1, beams.end(), [&](const Beam& beam)
+		{
+			return beam.pending.empty() || beam.pending[0] != first;
+		}), beams.end());
+		common = 1;
+	}
+
+	if (common == 0) return;
+
+	committed.insert(committed.end(), beams[0].pending.begin(), beams[0].pending.begin() + common);
+	for (Beam& beam : beams) beam.pending.erase(beam.pending.begin(), beam.pending.begin() + common);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+
+// label id 두 개의 연속 확률 (LabelMapper id, -1 : 문장 시작), SentenceDecoder의 n-gram prior
+//
+// 파일 : 한 줄에 "prev next count" ('#'은 주석), add-k smoothing
+class BigramPrior
+{
+private:
+	map<int, map<int, float>> counts;
+	map<int, float> totals;
+	int labelCount = 0; // 본 가장 큰 id + 1 (smoothing 분모)
+
+public:
+	bool load(const string& path);
+	bool save(const string& path);
+
+	void add(int prev, int next, float count = 1);
+
+	// 문장 하나 (시작 -> 첫 label 포함)
+	void addSentence(const vector<int>& labels);
+
+	bool isEmpty();
+
+	// log P(next | prev)
+	float score(int prev, int next);
+};
+
+// window별 label 확률 열 -> label 열 (CTC prefix beam search)
+//
+// 한 step = window 하나의 확률 [label..., blank] (blank은 마지막, 수어 사이 / 손 없음).
+// 같은 label이 이어지면 하나로, 같은 label을 두 번 하려면 사이에 blank이 있어야 한다.
+// step마다 상위 SENTENCE_TOP_LABELS개 label만 확장하고 beam SENTENCE_BEAM_WIDTH개만 남긴다.
+// 모든 beam이 같은 앞부분은 확정(committed)해서 beam에서 뺀다, 확정 안 된 label이 SENTENCE_MAX_PENDING을 넘으면 best beam 앞부분을 확정.
+// 그래서 step당 시간 / 메모리는 문장 길이와 상관없이 beam x top label x pending 이하.
+class SentenceDecoder
+{
+private:
+	struct Beam
+	{
+		vector<int> pending; // 확정 안 된 label
+		int last = -1; // 마지막 label (확정된 것 포함, -1 : 없음)
+		float blank = 0; // log P(blank으로 끝남)
+		float label = 0; // log P(label로 끝남)
+		float prior = 0; // lmWeight * log prior 누적
+
+		float getScore(float insertionBonus) const;
+	};
+
+	int beamWidth;
+	int topLabels;
+	int maxPending;
+	float lmWeight;
+	float insertionBonus;
+	BigramPrior* prior = nullptr;
+
+	vector<Beam> beams;
+	map<vector<int>, Beam> candidates; // step 중 같은 prefix 합치기
+	vector<int> order; // top label
+
+	int steps = 0;
+	int maxCandidates = 0;
+
+public:
+	SentenceDecoder(int beamWidth = SENTENCE_BEAM_WIDTH, int topLabels = SENTENCE_TOP_LABELS, int maxPending = SENTENCE_MAX_PENDING,
+		float lmWeight = (float)SENTENCE_LM_WEIGHT, float insertionBonus = (float)SENTENCE_INSERTION_BONUS);
+
+	// nullptr : prior 없음, decoder보다 오래 있어야 함
+	void setPrior(BigramPrior* prior);
+
+	// window 하나, posteriors.back()은 blank, 새로 확정된 label을 committed에 붙인다
+	void push(const vector<float>& posteriors, vector<int>& committed);
+
+	// 문장 끝 : best beam의 나머지를 확정하고 처음 상태로
+	void flush(vector<int>& committed);
+
+	void reset();
+
+	// 확정 안 된 best 추정 (표시용)
+	vector<int> getPending();
+
+	int getSteps();
+	int getMaxCandidates(); // step 중 가장 많았던 prefix 수
+
+	// recognizer scores (blank 없음) -> [scores * (1 - blank), blank]
+	static void addBlank(const vector<float>& scores, float blank, vector<float>& posteriors);
+
+private:
+	void extend(const Beam& from, int label, float logp, vector<int>& pending);
+	void commit(vector<int>& committed);
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+
+// raw session 파일 형식 (SessionRecorder.h)
+// Kinect SDK 타입 없이 기본 타입만 : 다른 도구에서도 그대로 읽는다
+//
+// data/sessions/<datetime>.ksr
+//   [SessionHeader][chunk][chunk]...[SessionIndexHeader][SessionIndexEntry x count]
+//   chunk = [SessionChunkHeader][payload], SESSION_ALIGN 정렬
+//
+// chunk는 압축 thread가 끝나는 순서로 붙으므로 파일 안에서 시간순이 아니다.
+// close() 때 index(시간순)를 끝에 쓰고 header.indexOffset을 채움.
+// indexOffset == 0 (비정상 종료)이면 SessionReader가 chunk를 처음부터 훑어 index를 다시 만든다.
+//
+//   COLOR  JPEG (SESSION_CODEC_JPEG)             width x height, BGR
+//   DEPTH  RVL (SESSION_CODEC_DEPTH_RVL, DepthCodec) 또는 uint16 [height][width] (mm)
+//   BODY   [SessionBodyHeader][SessionBody x count]  tracked body만
+//   FACE   float32 [vertex][3]                   HDFace vertex (camera space), width = vertex 수
+//   CALIB  float32 [n][5]                        camera (x, y, z) -> color (x, y), 세션 시작 시 1번
+//   META   SessionMeta                           label, mode, 작업자 바뀔 때
+
+#define SESSION_FILE_EXT ".ksr"
+#define SESSION_MAGIC 0x52534C4B // "KLSR"
+#define SESSION_CHUNK_MAGIC 0x4B484353 // "SCHK"
+#define SESSION_INDEX_MAGIC 0x4952534B // "KSRI"
+#define SESSION_VERSION 1
+#define SESSION_ALIGN 64
+#define SESSION_JOINT_COUNT 25 // JointType_Count
+
+enum SESSION_STREAM
+{
+	SESSION_STREAM_COLOR = 1,
+	SESSION_STREAM_DEPTH,
+	SESSION_STREAM_BODY,
+	SESSION_STREAM_FACE,
+	SESSION_STREAM_CALIB,
+	SESSION_STREAM_META,
+
+	SESSION_STREAM_SIZE,
+};
+
+enum SESSION_CODEC
+{
+	SESSION_CODEC_NONE = 0,
+	SESSION_CODEC_JPEG,
+	SESSION_CODEC_DEPTH_RVL, // DepthCodec, 무손실
+};
+
+struct SessionHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t headerSize; // sizeof(SessionHeader)
+	uint32_t indexCount;
+	uint64_t indexOffset; // 0 : index 없음 (기록 중 또는 비정상 종료)
+	char dateTime[32]; // currentDateTime()
+	uint32_t colorWidth;
+	uint32_t colorHeight;
+	uint32_t depthWidth;
+	uint32_t depthHeight;
+};
+
+struct SessionChunkHeader
+{
+	uint32_t magic; // SESSION_CHUNK_MAGIC
+	uint16_t stream; // SESSION_STREAM
+	uint16_t codec; // SESSION_CODEC
+	int64_t time; // 각 stream의 RelativeTime (100ns)
+	uint32_t width;
+	uint32_t height;
+	uint64_t size; // payload byte
+};
+
+struct SessionIndexHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entrySize; // sizeof(SessionIndexEntry)
+	uint32_t count;
+};
+
+struct SessionIndexEntry
+{
+	int64_t time;
+	uint64_t offset; // SessionChunkHeader 위치
+	uint32_t stream;
+	uint32_t reserved;
+};
+
+struct SessionJoint
+{
+	float x, y, z; // camera space (m)
+	int32_t trackingState;
+	float colorX, colorY; // 기록 당시 CoordinateMapper 결과
+	float orientation[4]; // x, y, z, w
+};
+
+struct SessionBody
+{
+	uint64_t trackingId;
+	int32_t handLeftState;
+	int32_t handRightState;
+	int32_t handLeftConfidence;
+	int32_t handRightConfidence;
+	int32_t closest; // 1 : Kinect::findClosestBody가 고른 body (SPoint 대상)
+	int32_t reserved;
+	SessionJoint joints[SESSION_JOINT_COUNT];
+};
+
+struct SessionBodyHeader
+{
+	uint32_t count;
+	uint32_t reserved;
+};
+
+struct SessionMeta
+{
+	int32_t label;
+	int32_t mode; // KINECT_MODE
+	char workerName[32];
+};
+
+static_assert(sizeof(SessionHeader) == 72, "SessionHeader layout");
+static_assert(sizeof(SessionChunkHeader) == 32, "SessionChunkHeader layout");
+static_assert(sizeof(SessionIndexEntry) == 24, "SessionIndexEntry layout");
+static_assert(sizeof(SessionJoint) == 40, "SessionJoint layout");
+static_assert(sizeof(SessionBody) == 32 + 40 * SESSION_JOINT_COUNT, "SessionBody layout");
+static_assert(sizeof(SessionMeta) == 40, "SessionMeta layout");
@@ -0,0 +1,320 @@
+#include "SessionReader.h"
+
+#include <algorithm>
+
+namespace
+{
+	uint64_t alignUp(uint64_t value)
+	{
+		return (value + SESSION_ALIGN - 1) / SESSION_ALIGN * SESSION_ALIGN;
+	}
+}
+
+SessionReader::SessionReader()
+{
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+	memset(&header, 0, sizeof(header));
+}
+
+SessionReader::~SessionReader()
+{
+	close();
+}
+
+bool SessionReader::open(const string& path)
+{
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(SessionHeader))
+	{
+		close();
+		return false;
+	}
+	fileSize = (uint64_t)size.QuadPart;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	base = mapping == NULL ? nullptr : reinterpret_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (base == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	memcpy(&header, base, sizeof(header));
+	if (header.magic != SESSION_MAGIC || header.version != SESSION_VERSION || header.headerSize != sizeof(SessionHeader))
+	{
+		cout << "SessionReader::open invalid session " << path << endl;
+		close();
+		return false;
+	}
+
+	if (!readIndex())
+	{
+		cout << "SessionReader::open no index, scanning chunks " << path << endl;
+		if (!scanChunks())
+		{
+			close();
+			return false;
+		}
+	}
+
+	buildStreams();
+	fitCalibration();
+
+	return true;
+}
+
+void SessionReader::close()
+{
+	if (base != nullptr) UnmapViewOfFile(base);
+	if (mapping != NULL) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+	base = nullptr;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+	fileSize = 0;
+
+	index.clear();
+	for (vector<int>& s : streams) s.clear();
+	projection.release();
+}
+
+bool SessionReader::isOpen()
+{
+	return base != nullptr;
+}
+
+const SessionHeader& SessionReader::getHeader()
+{
+	return header;
+}
+
+int SessionReader::getChunkSize(int stream)
+{
+	return stream > 0 && stream < SESSION_STREAM_SIZE ? (int)streams[stream].size() : 0;
+}
+
+TIMESPAN SessionReader::getStartTime()
+{
+	// CALIB(time 0) 제외
+	for (const SessionIndexEntry& e : index)
+	{
+		if (e.stream != SESSION_STREAM_CALIB) return e.time;
+	}
+
+	return 0;
+}
+
+TIMESPAN SessionReader::getEndTime()
+{
+	return index.empty() ? 0 : index.back().time;
+}
+
+TIMESPAN SessionReader::getTime(int stream, int n)
+{
+	return index[streams[stream][n]].time;
+}
+
+int SessionReader::seek(int stream, TIMESPAN time)
+{
+	if (getChunkSize(stream) == 0) return -1;
+
+	const vector<int>& s = streams[stream];
+	auto it = upper_bound(s.begin(), s.end(), time, [&](TIMESPAN t, int i) { return t < index[i].time; });
+
+	return (int)(it - s.begin()) - 1;
+}
+
+const SessionChunkHeader* SessionReader::getChunk(int stream, int n, const uint8_t*& payload)
+{
+	if (n < 0 || n >= getChunkSize(stream)) return nullptr;
+
+	const SessionChunkHeader* chunk = reinterpret_cast<const SessionChunkHeader*>(base + index[streams[stream][n]].offset);
+	payload = reinterpret_cast<const uint8_t*>(chunk + 1);
+
+	return chunk;
+}
+
+bool SessionReader::readColor(int n, cv::Mat& color)
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_COLOR, n, payload);
+	if (chunk == nullptr) return false;
+
+	if (chunk->codec == SESSION_CODEC_JPEG)
+	{
+		color = cv::imdecode(cv::Mat(1, (int)chunk->size, CV_8UC1, const_cast<uint8_t*>(payload)), cv::IMREAD_COLOR);
+	}
+	else
+	{
+		cv::Mat bgra((int)chunk->height, (int)chunk->width, CV_8UC4, const_cast<uint8_t*>(payload));
+		cv::cvtColor(bgra, color, cv::COLOR_BGRA2BGR);
+	}
+
+	return !color.empty();
+}
+
+bool SessionReader::readDepth(int n, cv::Mat& depth)
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_DEPTH, n, payload);
+	if (chunk == nullptr) return false;
+
+	if (chunk->codec == SESSION_CODEC_DEPTH_RVL)
+	{
+		depth.create((int)chunk->height, (int)chunk->width, CV_16UC1);
+		return DepthCodec::decode(payload, (size_t)chunk->size, depth.ptr<uint16_t>(0), depth.cols, depth.rows);
+	}
+	if (chunk->codec != SESSION_CODEC_NONE) return false;
+
+	cv::Mat((int)chunk->height, (int)chunk->width, CV_16UC1, const_cast<uint8_t*>(payload)).copyTo(depth);
+
+	return true;
+}
+
+bool SessionReader::readBodies(int n, vector<SessionBody>& bodies)
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_BODY, n, payload);
+	if (chunk == nullptr || chunk->size < sizeof(SessionBodyHeader)) return false;
+
+	SessionBodyHeader bodyHeader;
+	memcpy(&bodyHeader, payload, sizeof(bodyHeader));
+	if (sizeof(bodyHeader) + bodyHeader.count * sizeof(SessionBody) > chunk->size) return false;
+
+	const SessionBody* first = reinterpret_cast<const SessionBody*>(payload + sizeof(bodyHeader));
+	bodies.assign(first, first + bodyHeader.count);
+
+	return true;
+}
+
+bool SessionReader::readFace(int n, vector<CameraSpacePoint>& vertexes)
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_FACE, n, payload);
+	if (chunk == nullptr || chunk->size != chunk->width * sizeof(CameraSpacePoint)) return false;
+
+	const CameraSpacePoint* first = reinterpret_cast<const CameraSpacePoint*>(payload);
+	vertexes.assign(first, first + chunk->width);
+
+	return true;
+}
+
+bool SessionReader::readMeta(int n, SessionMeta& meta)
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_META, n, payload);
+	if (chunk == nullptr || chunk->size != sizeof(SessionMeta)) return false;
+
+	memcpy(&meta, payload, sizeof(meta));
+
+	return true;
+}
+
+bool SessionReader::mapCameraToColor(const CameraSpacePoint& point, ColorSpacePoint& color)
+{
+	if (projection.empty()) return false;
+
+	const double* p = projection.ptr<double>(0);
+	double w = p[8] * point.X + p[9] * point.Y + p[10] * point.Z + p[11];
+	if (w <= 0) return false;
+
+	color.X = (float)((p[0] * point.X + p[1] * point.Y + p[2] * point.Z + p[3]) / w);
+	color.Y = (float)((p[4] * point.X + p[5] * point.Y + p[6] * point.Z + p[7]) / w);
+
+	return true;
+}
+
+bool SessionReader::readIndex()
+{
+	if (header.indexOffset == 0 || header.indexOffset + sizeof(SessionIndexHeader) > fileSize) return false;
+
+	SessionIndexHeader indexHeader;
+	memcpy(&indexHeader, base + header.indexOffset, sizeof(indexHeader));
+
+	if (indexHeader.magic != SESSION_INDEX_MAGIC || indexHeader.entrySize != sizeof(SessionIndexEntry)
+		|| header.indexOffset + sizeof(indexHeader) + (uint64_t)indexHeader.count * sizeof(SessionIndexEntry) > fileSize) return false;
+
+	const SessionIndexEntry* first = reinterpret_cast<const SessionIndexEntry*>(base + header.indexOffset + sizeof(indexHeader));
+	index.assign(first, first + indexHeader.count);
+
+	return true;
+}
+
+bool SessionReader::scanChunks()
+{
+	index.clear();
+
+	// 마지막 chunk는 쓰다 만 것일 수 있음 : payload가 파일 안에 다 있는 것만
+	for (uint64_t offset = alignUp(sizeof(SessionHeader)); offset + sizeof(SessionChunkHeader) <= fileSize;)
+	{
+		const SessionChunkHeader* chunk = reinterpret_cast<const SessionChunkHeader*>(base + offset);
+		if (chunk->magic != SESSION_CHUNK_MAGIC || offset + sizeof(SessionChunkHeader) + chunk->size > fileSize) break;
+
+		index.push_back({ chunk->time, offset, chunk->stream, 0 });
+		offset = alignUp(offset + sizeof(SessionChunkHeader) + chunk->size);
+	}
+
+	stable_sort(index.begin(), index.end(), [](const SessionIndexEntry& a, const SessionIndexEntry& b)
+	{
+		return a.time != b.time ? a.time < b.time : a.stream < b.stream;
+	});
+
+	return !index.empty();
+}
+
+void SessionReader::buildStreams()
+{
+	for (int i = 0; i < (int)index.size(); ++i)
+	{
+		const SessionIndexEntry& e = index[i];
+		if (e.stream > 0 && e.stream < SESSION_STREAM_SIZE && e.offset + sizeof(SessionChunkHeader) <= fileSize)
+		{
+			streams[e.stream].push_back(i);
+		}
+	}
+}
+
+void SessionReader::fitCalibration()
+{
+	const uint8_t* payload;
+	const SessionChunkHeader* chunk = getChunk(SESSION_STREAM_CALIB, 0, payload);
+	if (chunk == nullptr || chunk->width != 5 || chunk->size < chunk->height * 5 * sizeof(float) || chunk->height < 6) return;
+
+	const float* table = reinterpret_cast<const float*>(payload);
+	int count = (int)chunk->height;
+
+	// u (p8 X + p9 Y + p10 Z + 1) = p0 X + p1 Y + p2 Z + p3, v도 같음
+	cv::Mat A(2 * count, 11, CV_64F, cv::Scalar(0));
+	cv::Mat b(2 * count, 1, CV_64F);
+
+	for (int i = 0; i < count; ++i)
+	{
+		const float* row = table + i * 5;
+		double X = row[0], Y = row[1], Z = row[2], u = row[3], v = row[4];
+
+		double* au = A.ptr<double>(2 * i);
+		double* av = A.ptr<double>(2 * i + 1);
+
+		au[0] = X; au[1] = Y; au[2] = Z; au[3] = 1;
+		au[8] = -u * X; au[9] = -u * Y; au[10] = -u * Z;
+		av[4] = X; av[5] = Y; av[6] = Z; av[7] = 1;
+		av[8] = -v * X; av[9] = -v * Y; av[10] = -v * Z;
+
+		b.at<double>(2 * i) = u;
+		b.at<double>(2 * i + 1) = v;
+	}
+
+	cv::Mat x;
+	if (!cv::solve(A, b, x, cv::DECOMP_SVD)) return;
+
+	projection = cv::Mat(1, 12, CV_64F);
+	for (int i = 0; i < 11; ++i) projection.at<double>(i) = x.at<double>(i);
+	projection.at<double>(11) = 1;
+}
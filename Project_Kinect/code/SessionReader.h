@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Windows.h> // CreateFileMapping, MapViewOfFile
+#include <Kinect.h>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SessionFormat.h"
+#include "DepthCodec.h"
+
+// raw session(.ksr) 읽기 (SessionRecorder가 쓴 파일)
+//
+// 파일 전체를 매핑하고 index만 메모리에 둔다. chunk payload는 매핑 위에서 바로 읽음.
+// stream마다 시간순 chunk 목록이 있어서 seek(stream, time)은 이진 탐색.
+class SessionReader
+{
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* base = nullptr;
+	uint64_t fileSize = 0;
+
+	SessionHeader header;
+	vector<SessionIndexEntry> index; // 시간순
+	vector<int> streams[SESSION_STREAM_SIZE]; // stream별 index 위치 (시간순)
+
+	cv::Mat projection; // 3x4, CALIB로 맞춘 camera -> color 투영
+
+public:
+	SessionReader();
+	~SessionReader();
+
+	SessionReader(const SessionReader&) = delete;
+	SessionReader& operator=(const SessionReader&) = delete;
+
+	bool open(const string& path);
+	void close();
+	bool isOpen();
+
+	const SessionHeader& getHeader();
+
+	int getChunkSize(int stream);
+	TIMESPAN getStartTime();
+	TIMESPAN getEndTime();
+
+	// stream의 n번째 chunk 시간
+	TIMESPAN getTime(int stream, int n);
+
+	// time 이전(같은 시간 포함) 마지막 chunk 번호, 없으면 -1
+	int seek(int stream, TIMESPAN time);
+
+	// n : stream 안의 chunk 번호 (0 ~ getChunkSize(stream) - 1)
+	const SessionChunkHeader* getChunk(int stream, int n, const uint8_t*& payload);
+
+	// BGR
+	bool readColor(int n, cv::Mat& color);
+
+	// CV_16UC1 (mm)
+	bool readDepth(int n, cv::Mat& depth);
+
+	bool readBodies(int n, vector<SessionBody>& bodies);
+
+	bool readFace(int n, vector<CameraSpacePoint>& vertexes);
+
+	bool readMeta(int n, SessionMeta& meta);
+
+	// 센서 없이 CoordinateMapper::MapCameraPointToColorSpace 대신 (CALIB 없으면 false)
+	bool mapCameraToColor(const CameraSpacePoint& point, ColorSpacePoint& color);
+
+private:
+	bool readIndex();
+
+	// 비정상 종료로 index가 없는 파일 : chunk header를 따라가며 다시 만듦
+	bool scanChunks();
+
+	void buildStreams();
+
+	// CALIB 대응표로 DLT (11 unknown, 최소제곱)
+	void fitCalibration();
+};
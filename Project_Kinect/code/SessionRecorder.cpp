@@ -0,0 +1,411 @@
+#include "SessionRecorder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <direct.h> // _mkdir
+
+namespace
+{
+	void copyString(char* dst, size_t size, const string& src)
+	{
+		size_t length = min(src.size(), size - 1);
+		memcpy(dst, src.data(), length);
+		dst[length] = '\0';
+	}
+
+	uint64_t alignUp(uint64_t value)
+	{
+		return (value + SESSION_ALIGN - 1) / SESSION_ALIGN * SESSION_ALIGN;
+	}
+
+	// calibration 격자 (camera space, m) : 서 있는 사람이 들어오는 범위
+	const float CALIB_X[2] = { -1.5f, 1.5f };
+	const float CALIB_Y[2] = { -1.2f, 1.2f };
+	const float CALIB_Z[2] = { 0.6f, 4.2f };
+	const int CALIB_STEPS = 7;
+}
+
+SessionRecorder::SessionRecorder(int workerCount, int capacity)
+{
+	this->workerCount = workerCount;
+	this->capacity = capacity;
+	written = 0;
+	dropped = 0;
+}
+
+SessionRecorder::~SessionRecorder()
+{
+	close();
+}
+
+bool SessionRecorder::open(const string& dirpath, int colorWidth, int colorHeight, int depthWidth, int depthHeight)
+{
+	close();
+
+	_mkdir(dirpath.substr(0, dirpath.size() - 1).c_str()); // '/'로 끝남, 이미 있으면 실패 (무시)
+
+	string dateTime = currentDateTime();
+	path = dirpath + dateTime + SESSION_FILE_EXT;
+
+	out.open(path.data(), ios::out | ios::binary | ios::trunc);
+	if (!out.is_open())
+	{
+		cout << "SessionRecorder::open fail " << path << endl;
+		return false;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic = SESSION_MAGIC;
+	header.version = SESSION_VERSION;
+	header.headerSize = sizeof(SessionHeader);
+	copyString(header.dateTime, sizeof(header.dateTime), dateTime);
+	header.colorWidth = colorWidth;
+	header.colorHeight = colorHeight;
+	header.depthWidth = depthWidth;
+	header.depthHeight = depthHeight;
+
+	vector<char> padding((size_t)alignUp(sizeof(header)), 0);
+	memcpy(padding.data(), &header, sizeof(header));
+	out.write(padding.data(), padding.size());
+
+	offset = padding.size();
+	index.clear();
+	written = 0;
+	dropped = 0;
+
+	running = true;
+	for (int i = 0; i < workerCount; ++i)
+	{
+		workers.push_back(thread(&SessionRecorder::run, this));
+	}
+
+	cout << "Session recording ... " << path << endl;
+
+#ifdef BENCHMARK_DEPTH_CODEC
+	depthStats = DepthCodec::Stats();
+	cout << "DepthCodec synthetic : " << DepthCodec::toString(DepthCodec::benchmarkSynthetic(depthWidth, depthHeight, 30)) << endl;
+#endif
+
+	return out.good();
+}
+
+bool SessionRecorder::close()
+{
+	if (!isOpen()) return true;
+
+	{
+		unique_lock<mutex> guard(lock);
+		idle.wait(guard, [&] { return jobs.empty() && busy == 0; });
+		running = false;
+	}
+	wake.notify_all();
+
+	for (thread& worker : workers)
+	{
+		if (worker.joinable()) worker.join();
+	}
+	workers.clear();
+
+	// index (시간순, 같은 시간은 stream 순)
+	sort(index.begin(), index.end(), [](const SessionIndexEntry& a, const SessionIndexEntry& b)
+	{
+		return a.time != b.time ? a.time < b.time : a.stream < b.stream;
+	});
+
+	SessionIndexHeader indexHeader = { SESSION_INDEX_MAGIC, SESSION_VERSION, sizeof(SessionIndexEntry), (uint32_t)index.size() };
+	out.clear();
+	out.seekp((streamoff)offset); // 마지막 성공한 chunk 바로 뒤
+	out.write(reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader));
+	out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(SessionIndexEntry));
+
+	// index를 다 쓴 뒤에 header에 위치 기록
+	out.seekp(0);
+	header.indexOffset = offset;
+	header.indexCount = (uint32_t)index.size();
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.flush();
+	bool ok = out.good();
+	out.close();
+
+	if (!ok)
+	{
+		cout << "SessionRecorder::close fail to write index " << path << " (chunk " << written << ", dropped " << dropped << ")" << endl;
+		return false;
+	}
+
+	cout << "Session recording ... done " << path << " (chunk " << written << ", dropped " << dropped << ")" << endl;
+
+#if defined(VERIFY_DEPTH_CODEC) || defined(BENCHMARK_DEPTH_CODEC)
+	cout << "DepthCodec recorded : " << DepthCodec::toString(depthStats) << endl;
+#endif
+
+	return true;
+}
+
+bool SessionRecorder::isOpen()
+{
+	return out.is_open();
+}
+
+void SessionRecorder::pushColor(const BYTE* bgra, int width, int height, TIMESPAN time)
+{
+	push(SESSION_STREAM_COLOR, SESSION_CODEC_NONE, time, width, height, bgra, (size_t)width * height * 4);
+}
+
+void SessionRecorder::pushDepth(const uint16_t* depth, int width, int height, TIMESPAN time)
+{
+	push(SESSION_STREAM_DEPTH, SESSION_CODEC_NONE, time, width, height, depth, (size_t)width * height * sizeof(uint16_t));
+}
+
+void SessionRecorder::pushBodies(const vector<SessionBody>& bodies, TIMESPAN time)
+{
+	vector<uint8_t> data(sizeof(SessionBodyHeader) + bodies.size() * sizeof(SessionBody));
+	SessionBodyHeader bodyHeader = { (uint32_t)bodies.size(), 0 };
+
+	memcpy(data.data(), &bodyHeader, sizeof(bodyHeader));
+	if (!bodies.empty()) memcpy(data.data() + sizeof(bodyHeader), bodies.data(), bodies.size() * sizeof(SessionBody));
+
+	push(SESSION_STREAM_BODY, SESSION_CODEC_NONE, time, (uint32_t)bodies.size(), 1, data.data(), data.size());
+}
+
+void SessionRecorder::pushFace(const vector<CameraSpacePoint>& vertexes, TIMESPAN time)
+{
+	static_assert(sizeof(CameraSpacePoint) == sizeof(float) * 3, "CameraSpacePoint layout");
+
+	push(SESSION_STREAM_FACE, SESSION_CODEC_NONE, time, (uint32_t)vertexes.size(), 3, vertexes.data(), vertexes.size() * sizeof(CameraSpacePoint));
+}
+
+void SessionRecorder::pushMeta(int label, int mode, const string& workerName, TIMESPAN time)
+{
+	SessionMeta meta;
+	memset(&meta, 0, sizeof(meta));
+	meta.label = label;
+	meta.mode = mode;
+	copyString(meta.workerName, sizeof(meta.workerName), workerName);
+
+	push(SESSION_STREAM_META, SESSION_CODEC_NONE, time, 1, 1, &meta, sizeof(meta));
+}
+
+void SessionRecorder::pushCalibration(ICoordinateMapper* mapper)
+{
+	vector<float> table;
+
+	for (int i = 0; i < CALIB_STEPS; ++i)
+	{
+		for (int j = 0; j < CALIB_STEPS; ++j)
+		{
+			for (int k = 0; k < CALIB_STEPS; ++k)
+			{
+				CameraSpacePoint p;
+				p.X = CALIB_X[0] + (CALIB_X[1] - CALIB_X[0]) * i / (CALIB_STEPS - 1);
+				p.Y = CALIB_Y[0] + (CALIB_Y[1] - CALIB_Y[0]) * j / (CALIB_STEPS - 1);
+				p.Z = CALIB_Z[0] + (CALIB_Z[1] - CALIB_Z[0]) * k / (CALIB_STEPS - 1);
+
+				ColorSpacePoint c;
+				if (FAILED(mapper->MapCameraPointToColorSpace(p, &c)) || !isfinite(c.X) || !isfinite(c.Y)) continue;
+
+				table.insert(table.end(), { p.X, p.Y, p.Z, c.X, c.Y });
+			}
+		}
+	}
+
+	push(SESSION_STREAM_CALIB, SESSION_CODEC_NONE, 0, 5, (uint32_t)(table.size() / 5), table.data(), table.size() * sizeof(float));
+}
+
+int SessionRecorder::getDepth()
+{
+	lock_guard<mutex> guard(lock);
+	return (int)jobs.size() + busy;
+}
+
+int SessionRecorder::getWritten()
+{
+	return written;
+}
+
+int SessionRecorder::getDropped()
+{
+	return dropped;
+}
+
+string SessionRecorder::getPath()
+{
+	return path;
+}
+
+bool SessionRecorder::captureBody(IBody* body, ICoordinateMapper* mapper, SessionBody& out)
+{
+	BOOLEAN tracked = false;
+	if (body == nullptr || FAILED(body->get_IsTracked(&tracked)) || !tracked) return false;
+
+	array<Joint, JointType::JointType_Count> joints;
+	array<JointOrientation, JointType::JointType_Count> orientations;
+	if (FAILED(body->GetJoints((UINT)joints.size(), &joints[0]))) return false;
+	if (FAILED(body->GetJointOrientations((UINT)orientations.size(), &orientations[0]))) return false;
+
+	memset(&out, 0, sizeof(out));
+	body->get_TrackingId(&out.trackingId);
+
+	HandState handState;
+	TrackingConfidence confidence;
+	if (SUCCEEDED(body->get_HandLeftState(&handState))) out.handLeftState = handState;
+	if (SUCCEEDED(body->get_HandRightState(&handState))) out.handRightState = handState;
+	if (SUCCEEDED(body->get_HandLeftConfidence(&confidence))) out.handLeftConfidence = confidence;
+	if (SUCCEEDED(body->get_HandRightConfidence(&confidence))) out.handRightConfidence = confidence;
+
+	for (int i = 0; i < SESSION_JOINT_COUNT; ++i)
+	{
+		SessionJoint& j = out.joints[i];
+		j.x = joints[i].Position.X;
+		j.y = joints[i].Position.Y;
+		j.z = joints[i].Position.Z;
+		j.trackingState = joints[i].TrackingState;
+
+		ColorSpacePoint c = { 0, 0 };
+		mapper->MapCameraPointToColorSpace(joints[i].Position, &c);
+		j.colorX = c.X;
+		j.colorY = c.Y;
+
+		j.orientation[0] = orientations[i].Orientation.x;
+		j.orientation[1] = orientations[i].Orientation.y;
+		j.orientation[2] = orientations[i].Orientation.z;
+		j.orientation[3] = orientations[i].Orientation.w;
+	}
+
+	return true;
+}
+
+void SessionRecorder::push(uint16_t stream, uint16_t codec, TIMESPAN time, uint32_t width, uint32_t height, const void* data, size_t size)
+{
+	if (!isOpen()) return;
+
+	Job job;
+	job.header = { SESSION_CHUNK_MAGIC, stream, codec, time, width, height, size };
+
+	{
+		lock_guard<mutex> guard(lock);
+
+		// CALIB, META는 한 번뿐이라 버리지 않음
+		if ((int)jobs.size() >= capacity && stream != SESSION_STREAM_CALIB && stream != SESSION_STREAM_META)
+		{
+			++dropped;
+			return;
+		}
+	}
+
+	// 복사는 lock 밖에서 (color 1장 8MB)
+	job.data.assign(reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + size);
+
+	{
+		lock_guard<mutex> guard(lock);
+		jobs.push_back(move(job));
+	}
+	wake.notify_one();
+}
+
+void SessionRecorder::run()
+{
+	while (true)
+	{
+		Job job;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !jobs.empty() || !running; });
+			if (jobs.empty()) return; // !running
+
+			job = move(jobs.front());
+			jobs.pop_front();
+			++busy;
+		}
+
+		if (encode(job) && append(job)) ++written;
+		else ++dropped;
+
+		{
+			lock_guard<mutex> guard(lock);
+			--busy;
+		}
+		idle.notify_all();
+	}
+}
+
+bool SessionRecorder::encode(Job& job)
+{
+	if (job.header.stream == SESSION_STREAM_DEPTH) return encodeDepth(job);
+	if (job.header.stream != SESSION_STREAM_COLOR) return true;
+
+	cv::Mat bgra((int)job.header.height, (int)job.header.width, CV_8UC4, job.data.data());
+	cv::Mat bgr;
+	cv::cvtColor(bgra, bgr, cv::COLOR_BGRA2BGR);
+
+	vector<uint8_t> jpeg;
+	if (!cv::imencode(".jpg", bgr, jpeg, { cv::IMWRITE_JPEG_QUALITY, SESSION_COLOR_JPEG_QUALITY })) return false;
+
+	job.data.swap(jpeg);
+	job.header.codec = SESSION_CODEC_JPEG;
+	job.header.size = job.data.size();
+
+	return true;
+}
+
+bool SessionRecorder::encodeDepth(Job& job)
+{
+#ifdef SESSION_DEPTH_COMPRESS
+	const uint16_t* depth = reinterpret_cast<const uint16_t*>(job.data.data());
+	int width = (int)job.header.width;
+	int height = (int)job.header.height;
+	vector<uint8_t> coded;
+
+#if defined(VERIFY_DEPTH_CODEC) || defined(BENCHMARK_DEPTH_CODEC)
+	DepthCodec::Stats stats;
+	if (!DepthCodec::roundTrip(depth, width, height, coded, stats))
+	{
+		cout << "SessionRecorder::encodeDepth round trip mismatch (time " << job.header.time << ")" << endl;
+	}
+
+	{
+		lock_guard<mutex> guard(statsLock);
+		depthStats += stats;
+#ifdef BENCHMARK_DEPTH_CODEC
+		if (depthStats.frames % SESSION_DEPTH_BENCHMARK_FRAMES == 0) cout << "DepthCodec recorded : " << DepthCodec::toString(depthStats) << endl;
+#endif
+	}
+
+	if (stats.mismatches > 0) return true; // 원본 그대로 (SESSION_CODEC_NONE)
+#else
+	if (!DepthCodec::encode(depth, width, height, coded)) return false;
+#endif
+
+	job.data.swap(coded);
+	job.header.codec = SESSION_CODEC_DEPTH_RVL;
+	job.header.size = job.data.size();
+#endif
+
+	return true;
+}
+
+bool SessionRecorder::append(Job& job)
+{
+	static const char zeros[SESSION_ALIGN] = { 0 };
+
+	lock_guard<mutex> guard(fileLock);
+
+	uint64_t end = alignUp(offset + sizeof(SessionChunkHeader) + job.data.size());
+
+	out.write(reinterpret_cast<const char*>(&job.header), sizeof(job.header));
+	out.write(reinterpret_cast<const char*>(job.data.data()), job.data.size());
+	out.write(zeros, (streamsize)(end - offset - sizeof(SessionChunkHeader) - job.data.size()));
+	out.flush(); // buffer에 남은 실패를 여기서 알아야 chunk를 되돌릴 수 있음
+	if (!out.good())
+	{
+		// 반쯤 쓴 chunk는 다음 chunk (또는 index)가 덮어씀, 호출한 쪽이 dropped로 셈
+		out.clear();
+		out.seekp((streamoff)offset);
+		return false;
+	}
+
+	index.push_back({ job.header.time, offset, job.header.stream, 0 });
+	offset = end;
+
+	return true;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <Kinect.h>
+#include <opencv2/opencv.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SessionFormat.h"
+#include "DepthCodec.h"
+
+// raw sensor session 기록 (SESSION_RECORD)
+//
+// Kinect::save()는 표준화된 특징만 남기므로 LERP_PERCENT, SPoint, ROI 크기를 바꾸면 재녹화가 필요했다.
+// 센서 원본을 그대로 남겨두고 SessionReader로 읽어 다시 뽑는다.
+//
+// push*()는 버퍼를 복사해서 큐에 넣고 바로 돌아간다 (capture thread는 압축, disk를 기다리지 않음).
+// worker thread들이 color를 JPEG로 압축한 뒤 fileLock 아래에서 파일 끝에 붙인다.
+// 큐가 가득 차면 chunk를 버리고 dropped를 센다 (SampleSaver와 같음).
+class SessionRecorder
+{
+private:
+	struct Job
+	{
+		SessionChunkHeader header;
+		vector<uint8_t> data;
+	};
+
+	vector<thread> workers;
+	mutex lock;
+	condition_variable wake;
+	condition_variable idle;
+	deque<Job> jobs;
+	int workerCount;
+	int capacity;
+	int busy = 0;
+	bool running = false;
+
+	mutex fileLock;
+	ofstream out;
+	string path;
+	SessionHeader header;
+	uint64_t offset = 0;
+	vector<SessionIndexEntry> index;
+
+	atomic<int> written;
+	atomic<int> dropped;
+
+#if defined(VERIFY_DEPTH_CODEC) || defined(BENCHMARK_DEPTH_CODEC)
+	mutex statsLock;
+	DepthCodec::Stats depthStats;
+#endif
+
+public:
+	SessionRecorder(int workerCount = SESSION_WORKER_COUNT, int capacity = SESSION_QUEUE_CAPACITY);
+
+	// close()
+	~SessionRecorder();
+
+	SessionRecorder(const SessionRecorder&) = delete;
+	SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+	// dirpath/<datetime>.ksr 생성, worker 시작
+	bool open(const string& dirpath, int colorWidth, int colorHeight, int depthWidth, int depthHeight);
+
+	// 남은 chunk를 모두 쓰고 index 기록, index / header를 못 쓰면 false (chunk는 남아 있지만 SessionReader로는 못 읽음)
+	bool close();
+
+	bool isOpen();
+
+	// BGRA
+	void pushColor(const BYTE* bgra, int width, int height, TIMESPAN time);
+
+	void pushDepth(const uint16_t* depth, int width, int height, TIMESPAN time);
+
+	void pushBodies(const vector<SessionBody>& bodies, TIMESPAN time);
+
+	void pushFace(const vector<CameraSpacePoint>& vertexes, TIMESPAN time);
+
+	void pushMeta(int label, int mode, const string& workerName, TIMESPAN time);
+
+	// camera -> color 대응표 (SessionReader::mapCameraToColor), open 직후 1번
+	void pushCalibration(ICoordinateMapper* mapper);
+
+	int getDepth();
+	int getWritten();
+	int getDropped();
+	string getPath();
+
+	// IBody -> SessionBody (joint, orientation, hand state, color 좌표)
+	static bool captureBody(IBody* body, ICoordinateMapper* mapper, SessionBody& out);
+
+private:
+	void push(uint16_t stream, uint16_t codec, TIMESPAN time, uint32_t width, uint32_t height, const void* data, size_t size);
+
+	void run();
+
+	// color : BGRA -> JPEG, depth : RVL (SESSION_DEPTH_COMPRESS)
+	bool encode(Job& job);
+
+	bool encodeDepth(Job& job);
+
+	bool append(Job& job);
+};
@@ -0,0 +1,232 @@
+#include "ShardFile.h"
+
+#include <Windows.h> // CreateFileMapping, MapViewOfFile
+
+namespace
+{
+	string indexPathOf(const string& dataPath)
+	{
+		return dataPath.substr(0, dataPath.size() - string(SHARD_DATA_EXT).size()) + SHARD_INDEX_EXT;
+	}
+}
+
+//----------------------------------------------------------------------------------
+/// ShardWriter
+//----------------------------------------------------------------------------------
+
+ShardWriter::ShardWriter(const string& dirpath)
+{
+	this->dirpath = dirpath;
+	this->name = currentDateTime();
+}
+
+ShardWriter::~ShardWriter()
+{
+	close();
+}
+
+bool ShardWriter::append(const vector<uint8_t>& sample)
+{
+	if (sample.size() < sizeof(SampleHeader)) return false;
+
+	if (!data.is_open() || dataSize + sample.size() > (uint64_t)SHARD_MAX_BYTES)
+	{
+		if (!openNext()) return false;
+	}
+
+	// 샘플 시작을 SAMPLE_ALIGN에 맞춰야 section 포인터 캐스팅이 가능
+	const char zeros[SAMPLE_ALIGN] = { 0 };
+	uint64_t offset = (dataSize + SAMPLE_ALIGN - 1) / SAMPLE_ALIGN * SAMPLE_ALIGN;
+
+	data.write(zeros, (streamsize)(offset - dataSize));
+	data.write(reinterpret_cast<const char*>(sample.data()), (streamsize)sample.size());
+	data.flush();
+	if (!data.good()) return fail();
+
+	dataSize = offset + sample.size();
+
+	const SampleHeader* header = reinterpret_cast<const SampleHeader*>(sample.data());
+
+	ShardIndexEntry entry;
+	memset(&entry, 0, sizeof(entry));
+	entry.offset = offset;
+	entry.size = sample.size();
+	entry.label = header->label;
+	entry.recordStartTime = header->recordStartTime;
+	memcpy(entry.dateTime, header->dateTime, sizeof(entry.dateTime));
+	memcpy(entry.workerName, header->workerName, sizeof(entry.workerName));
+
+	// data flush 후에 index 기록 : index에 있는 샘플은 항상 완성된 샘플
+	index.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	index.flush();
+	if (!index.good()) return fail();
+
+	return true;
+}
+
+bool ShardWriter::fail()
+{
+	// 실패한 stream은 쓰다 만 샘플 / entry 뒤에 멈춰 있어서 이어 쓰면 이후 샘플이 index에서 어긋남
+	// -> 지금 shard는 여기까지 (reader는 index에 있는 완성된 샘플만 읽음), 다음 append가 새 shard를 연다
+	cout << "ShardWriter::append fail " << getDataPath() << endl;
+	close();
+
+	return false;
+}
+
+bool ShardWriter::openNext()
+{
+	close();
+
+	_mkdir(dirpath.c_str());
+
+	++shardNumber;
+	string dataPath = getDataPath();
+
+	data.open(dataPath.c_str(), ios::out | ios::binary | ios::trunc);
+	index.open(indexPathOf(dataPath).c_str(), ios::out | ios::binary | ios::trunc);
+	if (!data.is_open() || !index.is_open())
+	{
+		cout << "ShardWriter::openNext fail " << dataPath << endl;
+		close();
+		return false;
+	}
+
+	ShardIndexHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SHARD_INDEX_MAGIC;
+	header.version = SHARD_VERSION;
+	header.entrySize = sizeof(ShardIndexEntry);
+
+	index.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	index.flush();
+	if (!index.good())
+	{
+		cout << "ShardWriter::openNext fail " << indexPathOf(dataPath) << endl;
+		close();
+		return false;
+	}
+
+	dataSize = 0;
+
+	return true;
+}
+
+void ShardWriter::close()
+{
+	if (data.is_open()) data.close();
+	if (index.is_open()) index.close();
+}
+
+string ShardWriter::getDataPath()
+{
+	return dirpath + name + "_" + to_string(shardNumber) + SHARD_DATA_EXT;
+}
+
+//----------------------------------------------------------------------------------
+/// ShardReader
+//----------------------------------------------------------------------------------
+
+ShardReader::ShardReader()
+{
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+}
+
+ShardReader::~ShardReader()
+{
+	close();
+}
+
+bool ShardReader::open(const string& dataPath)
+{
+	close();
+
+	if (!readIndex(indexPathOf(dataPath), entries)) return false;
+
+	file = CreateFileA(dataPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		close();
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+	fileSize = (uint64_t)size.QuadPart;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping != NULL) base = reinterpret_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (base == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	// 기록 중인 shard는 index가 data보다 먼저 끝날 수 있음 : 매핑 범위 밖 entry 제외
+	while (!entries.empty() && entries.back().offset + entries.back().size > fileSize)
+	{
+		entries.pop_back();
+	}
+
+	return true;
+}
+
+void ShardReader::close()
+{
+	if (base != nullptr) UnmapViewOfFile(base);
+	if (mapping != NULL) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+	base = nullptr;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+	fileSize = 0;
+	entries.clear();
+}
+
+int ShardReader::getSampleSize()
+{
+	return (int)entries.size();
+}
+
+const ShardIndexEntry& ShardReader::getEntry(int idx)
+{
+	return entries[idx];
+}
+
+bool ShardReader::getSample(int idx, SampleFile& sample)
+{
+	if (base == nullptr || idx < 0 || idx >= (int)entries.size()) return false;
+
+	return sample.attach(base + entries[idx].offset, entries[idx].size);
+}
+
+bool ShardReader::readIndex(const string& indexPath, vector<ShardIndexEntry>& entries)
+{
+	entries.clear();
+
+	ifstream in(indexPath.c_str(), ios::in | ios::binary);
+	if (!in.is_open()) return false;
+
+	ShardIndexHeader header;
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!in.good() || header.magic != SHARD_INDEX_MAGIC || header.version != SHARD_VERSION || header.entrySize != sizeof(ShardIndexEntry))
+	{
+		cout << "ShardReader::readIndex invalid index " << indexPath << endl;
+		return false;
+	}
+
+	// 마지막 entry가 쓰다 만 경우 (crash) 무시
+	ShardIndexEntry entry;
+	while (in.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+	{
+		entries.push_back(entry);
+	}
+
+	return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "SampleFormat.h"
+
+// 한 thread에서만 append (SampleSaver가 shardLock으로 직렬화)
+class ShardWriter
+{
+private:
+	string dirpath;
+	string name; // 세션 시작 시각
+	int shardNumber = -1;
+	uint64_t dataSize = 0;
+	ofstream data;
+	ofstream index;
+
+public:
+	ShardWriter(const string& dirpath = string(PATH_DATA_FOLDER) + PATH_SHARD_FOLDER);
+	~ShardWriter();
+
+	// sample : SampleFile::serialize 결과
+	bool append(const vector<uint8_t>& sample);
+
+	void close();
+
+	string getDataPath();
+
+private:
+	// 세션 첫 샘플 또는 SHARD_MAX_BYTES 초과 시 새 shard
+	bool openNext();
+
+	// 쓰기 실패 : shard를 닫아 다음 append가 새 shard에 쓰게 함
+	bool fail();
+};
+
+class ShardReader
+{
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* base = nullptr;
+	uint64_t fileSize = 0;
+	vector<ShardIndexEntry> entries;
+
+public:
+	ShardReader();
+	~ShardReader();
+
+	ShardReader(const ShardReader&) = delete;
+	ShardReader& operator=(const ShardReader&) = delete;
+
+	// dataPath : .kss, 같은 이름의 .idx를 같이 읽는다
+	bool open(const string& dataPath);
+	void close();
+
+	int getSampleSize();
+	const ShardIndexEntry& getEntry(int idx);
+
+	// 복사 없이 매핑 위의 샘플, reader가 열려있는 동안만 유효
+	bool getSample(int idx, SampleFile& sample);
+
+	// .idx만 읽기 (데이터셋 목록)
+	static bool readIndex(const string& indexPath, vector<ShardIndexEntry>& entries);
+};
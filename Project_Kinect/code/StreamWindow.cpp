@@ -0,0 +1,107 @@
+#include "StreamWindow.h"
+#include "ExtractionConfig.h"
+
+StreamWindow::StreamWindow(int windowSize, int stride)
+{
+	this->windowSize = max(windowSize, 2);
+	this->stride = max(stride, 1);
+}
+
+bool StreamWindow::push(const Frame& frame, const ImageFrame& lhand, const ImageFrame& rhand, const function<bool()>& isBusy, Sample& sample)
+{
+	entries.push_back({ frame, lhand, rhand });
+	if ((int)entries.size() > windowSize) entries.pop_front();
+	++sinceEmit;
+
+	if ((int)entries.size() < windowSize || sinceEmit < stride) return false;
+
+	if (isBusy())
+	{
+		// stride 경계마다 한 번씩 센다
+		int strides = sinceEmit / stride;
+		skipped += strides - skippedStrides;
+		skippedStrides = strides;
+		return false;
+	}
+
+	// 한가해진 첫 프레임 : 가장 최근 window (밀렸던 것은 skipped로 이미 셈, 지금 내는 것은 제외)
+	if (skippedStrides > 0) --skipped;
+	sinceEmit = 0;
+	skippedStrides = 0;
+
+	if (!isActive())
+	{
+		++idle;
+		return false;
+	}
+
+	if (!makeSample(sample)) return false;
+
+	++emitted;
+	return true;
+}
+
+void StreamWindow::clear()
+{
+	entries.clear();
+	sinceEmit = 0;
+	skippedStrides = 0;
+}
+
+int StreamWindow::getFilled()
+{
+	return (int)entries.size();
+}
+
+int StreamWindow::getWindowSize()
+{
+	return windowSize;
+}
+
+int StreamWindow::getStride()
+{
+	return stride;
+}
+
+int StreamWindow::getEmitted()
+{
+	return emitted;
+}
+
+int StreamWindow::getSkipped()
+{
+	return skipped;
+}
+
+int StreamWindow::getIdle()
+{
+	return idle;
+}
+
+bool StreamWindow::isActive()
+{
+	for (Entry& entry : entries)
+	{
+		if (entry.frame.getHAL() || entry.frame.getHAR()) return true;
+	}
+	return false;
+}
+
+// window 복사 -> 세그먼트와 같은 표준화 (ImageFrame은 cv::Mat 참조라 복사가 가볍다)
+bool StreamWindow::makeSample(Sample& sample)
+{
+	sample.frames.clear();
+	sample.lhand.clear();
+	sample.rhand.clear();
+
+	for (Entry& entry : entries)
+	{
+		sample.frames.stackFrame(entry.frame);
+		sample.lhand.stackFrame(entry.lhand);
+		sample.rhand.stackFrame(entry.rhand);
+	}
+
+	sample.recordStartTime = entries.front().frame.getTime();
+
+	return ExtractionConfig::current().standardize(sample.frames, sample.lhand, sample.rhand, sample.recordStartTime);
+}
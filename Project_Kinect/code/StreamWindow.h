@@ -0,0 +1,57 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "Frame.h"
+#include "ImageFrame.h"
+#include "SampleFile.h"
+
+// KINECT_MODE_STREAM : 손을 내릴 때까지 기다리지 않고 최근 window 프레임을 계속 predict
+//
+// 매 프레임 push, window(STREAM_WINDOW_FRAMES)가 차 있으면 stride(STREAM_STRIDE_FRAMES)마다 window 하나를 낸다.
+// scheduler : 낼 차례에 recognizer가 아직 바쁘면 (isBusy) 그 window는 건너뛰고 (skipped),
+//   한가해지는 첫 프레임에 가장 최근 window를 낸다. 밀린 window를 쌓지 않으므로 결과는 항상 최근 동작.
+// 손이 하나도 활성화되지 않은 window는 내지 않는다 (idle).
+// 표준화는 세그먼트와 같은 ExtractionConfig::standardize라 tensor 크기가 같다 (FRAME_STANDARD_SIZE, IMAEG_STANDARD_FRAME_SIZE).
+class StreamWindow
+{
+private:
+	struct Entry
+	{
+		Frame frame;
+		ImageFrame lhand;
+		ImageFrame rhand;
+	};
+
+	int windowSize;
+	int stride;
+	deque<Entry> entries;
+	int sinceEmit = 0; // 마지막으로 낸 뒤 (또는 시작 뒤) 프레임 수
+	int skippedStrides = 0; // 이번에 밀린 stride 수 (이미 센 것)
+
+	int emitted = 0;
+	int skipped = 0;
+	int idle = 0;
+
+public:
+	StreamWindow(int windowSize = STREAM_WINDOW_FRAMES, int stride = STREAM_STRIDE_FRAMES);
+
+	// 새 프레임, 낼 window가 있으면 sample을 채우고 true (표준화 실패는 false)
+	bool push(const Frame& frame, const ImageFrame& lhand, const ImageFrame& rhand, const function<bool()>& isBusy, Sample& sample);
+
+	void clear();
+
+	int getFilled();
+	int getWindowSize();
+	int getStride();
+	int getEmitted();
+	int getSkipped(); // recognizer가 바빠서 건너뛴 window
+	int getIdle(); // 손 활성화 없는 window
+
+private:
+	bool isActive();
+	bool makeSample(Sample& sample);
+};
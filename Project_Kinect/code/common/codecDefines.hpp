@@ -0,0 +1,6 @@
+#pragma once
+
+// RoiCodec 종류 (RoiCodec::create), defines.hpp의 ROI_CODEC 값
+// Kinect / Windows 의존 없음 : Project_Reader(dll)가 RoiCodec.cpp를 같이 빌드한다
+#define ROI_CODEC_RAW 0 // 압축 없음, python에서 바로 memmap
+#define ROI_CODEC_DELTA_RICE 1 // temporal delta + Rice, 무손실
@@ -24,18 +24,142 @@
 //#define Show_Status_DistanceFrame
 #define Show_Status_DistanceFrame_Size 4 // do not Change/disable this
 
+// LERP_PERCENT, FRAME_STANDARD_*, IMAEG_STANDARD_FRAME_SIZE, IMAGE_SELECT_MODE, IMAGE_WIDTH, IMAGE_SCALES는
+// ExtractionConfig 기본값 (Project_Tools extract --frame-size=... 로 세션 재추출 시 덮어씀)
 #define LERP_PERCENT 0.35
 #define HAND_RECORD_TYPE_L JointType_HandLeft
 #define HAND_RECORD_TYPE_R JointType_HandRight
 #define FRAME_STANDARD_SIZE 150
 
+// 표준화 프레임 수 결정 방식 (FrameCollection::setStandard)
+#define FRAME_STANDARD_UNIFORM 0 // 항상 FRAME_STANDARD_SIZE, 균등 시간 간격
+#define FRAME_STANDARD_ADAPTIVE 1 // SPoint 움직임 에너지에 비례한 프레임 수, 움직임 많은 구간에 조밀하게
+#define FRAME_STANDARD_MODE FRAME_STANDARD_UNIFORM
+#define FRAME_ADAPTIVE_ENERGY_PER_FRAME 0.5 // FRAME_STANDARD_SIZE 전부 쓰는 프레임당 움직임 에너지 (distance 변화량 합, m)
+#define FRAME_ADAPTIVE_MIN_RATIO 0.2 // 최소 프레임 비율 (x FRAME_STANDARD_SIZE)
+#define FRAME_ADAPTIVE_FLOOR 0.1 // 정지 구간에도 주는 에너지 (평균 대비 비율)
+
+// 샘플 저장 형식 (Kinect::save)
+#define SAVE_FORMAT_TEXT 0 // Spoints.txt, Times.txt, <n>.bmp (+ scale, flow 폴더)
+#define SAVE_FORMAT_BINARY 1 // sample.ksl 단일 파일 (SampleFile.h)
+#define SAVE_FORMAT_SHARD 2 // data/shards/*.kss 에 이어 붙이기 + .idx (ShardFile.h), predict 샘플은 BINARY
+#define SAVE_FORMAT SAVE_FORMAT_BINARY
+#define SAVE_WORKER_COUNT 2 // SampleSaver worker thread 수
+#define SAVE_QUEUE_CAPACITY 8 // 대기 세그먼트 최대 수, 넘으면 drop
+
+// predict 샘플 전달 (SampleSaver -> Project_DNN/do_Predict.py), python defines.PREDICT_HANDOFF_RING과 맞출 것
+#define PREDICT_HANDOFF_FILE 0 // data/temp/에 쓰고 "[Predict]" 출력, C#이 python stdin으로 전달
+#define PREDICT_HANDOFF_RING 1 // shared memory ring + event (SampleRing.h), 디스크 / stdout 거치지 않음
+#define PREDICT_HANDOFF PREDICT_HANDOFF_RING
+
+// predict 요청 / 결과 (PredictLink.h), python defines.PREDICT_PROTOCOL_PIPE와 맞출 것
+#define PREDICT_PROTOCOL_STDOUT 0 // "[Predict]" / "[Result]" 줄, 요청과 결과 짝 없음
+#define PREDICT_PROTOCOL_PIPE 1 // \\.\pipe\KSL_Predict framed message (PredictProtocol.h), request id + 시각
+#define PREDICT_PROTOCOL PREDICT_PROTOCOL_PIPE
+#define PREDICT_PIPE_REMOTE 0 // 1 : 다른 PC의 predictor (Project_Tools predict-host)가 \\<pc>\pipe\KSL_Predict로 연결, 샘플은 inline (ring은 같은 PC만)
+
+// 세그먼트 -> predict 요청 큐 (PredictQueue.h), predictor보다 빨리 수어가 들어올 때
+#define PREDICT_QUEUE_DROP_OLDEST 0 // 가득 차면 가장 오래 기다린 요청을 버림
+#define PREDICT_QUEUE_COALESCE_LATEST 1 // 대기 요청은 최신 하나만 (새 요청이 기다리던 것을 대체)
+#define PREDICT_QUEUE_BLOCK 2 // 자리가 날 때까지 capture thread가 기다림, PREDICT_QUEUE_BLOCK_TIMEOUT_MS 넘으면 버림
+#define PREDICT_QUEUE_POLICY PREDICT_QUEUE_DROP_OLDEST
+#define PREDICT_QUEUE_CAPACITY 4 // 대기 요청 최대 수 (COALESCE_LATEST는 1)
+#define PREDICT_QUEUE_BLOCK_TIMEOUT_MS 2000
+#define PREDICT_MAX_IN_FLIGHT 2 // 결과 대기 요청 최대 수, SAMPLE_RING_SLOT_COUNT 이하 (predictor가 읽기 전에 slot이 덮이지 않게)
+
+// predict 실행 위치 (PredictQueue)
+#define PREDICT_BACKEND_PYTHON 0 // PredictLink -> do_Predict.py (ring / pipe)
+#define PREDICT_BACKEND_NATIVE 1 // 같은 process에서 C++ 추론 (Recognizer.h, data/models/M1.kslm), 모델이 없으면 PYTHON
+#define PREDICT_BACKEND_DTW 2 // SPoint distance 템플릿 DTW kNN (DtwMatcher.h, data/models/templates.ksdt), 템플릿이 없으면 PYTHON
+#define PREDICT_BACKEND_BATCH 3 // NATIVE와 같은 모델, process 안 여러 PredictQueue 요청을 batch로 (BatchPredictServer.h), Project_Kinect는 queue가 하나라 NATIVE와 같음 (station 여러 대는 PYTHON + PREDICT_PIPE_REMOTE, predictor PC에서 Project_Tools predict-host)
+#define PREDICT_BACKEND_EMBEDDING 4 // NATIVE 모델의 임베딩을 등록된 임베딩 (data/models/embeddings.ksan)과 kNN, 등록이 없으면 PYTHON
+#define PREDICT_BACKEND_LEARNED 5 // NATIVE 모델 + KINECT_MODE_LEARNING으로 배운 label 평균 (NcmHead.h, data/models/learned.ksnc), 배운 것이 없으면 NATIVE와 같음
+#define PREDICT_BACKEND PREDICT_BACKEND_LEARNED
+#define PREDICT_BATCH_MAX 8 // batch 최대 요청 수
+#define PREDICT_BATCH_WAIT_MS 5 // 첫 요청이 batch를 기다리는 최대 시간, 다른 producer가 입력을 준비 중일 때만 기다림
+#define INFERENCE_AVX2 // AVX2 + FMA kernel (실행 시 CPU 확인, 미지원이면 scalar), 주석 처리하면 scalar만
+#define INFERENCE_INT8 // 모델 옆 M1.kslq (Project_Tools quant-eval)에 적힌 image branch conv를 int8로, 파일이 없으면 float
+//#define INFERENCE_VNNI // int8 dot product를 AVX512-VNNI로 (VS2019 이상, INFERENCE_AVX2 필요, 실행 시 CPU 확인)
+
+// cascade : skeleton만 보는 빠른 recognizer가 먼저 답하고, 애매할 때만 PREDICT_BACKEND (ROI 이미지 경로)로 (PredictQueue)
+#define PREDICT_GATE_NONE -1
+#define PREDICT_GATE PREDICT_BACKEND_DTW // PREDICT_GATE_NONE이면 모든 요청이 PREDICT_BACKEND로, 템플릿이 없어도 마찬가지
+#define PREDICT_GATE_MARGIN 0.5 // gate의 top-1 - top-2 score가 이 이상이면 바로 결과
+#define PREDICT_GATE_MAX_DISTANCE 2.0 // 단, gate의 가장 가까운 이웃이 이보다 멀면 (DTW 프레임당 거리, 등록 안 된 동작) 뒤 단계로, 0이면 검사 안함 (dtw-enroll이 분포 출력)
+
+// KINECT_MODE_STREAM : 손을 내리지 않아도 최근 window를 계속 predict (StreamWindow.h)
+#define STREAM_WINDOW_FRAMES 90 // window 길이 (30fps 기준 3초), 표준화 후에는 FRAME_STANDARD_SIZE
+#define STREAM_STRIDE_FRAMES 10 // 이 프레임마다 window 하나, recognizer가 바쁘면 건너뜀
+
+// KINECT_MODE_PREDICT : 세그먼트 진행 중 prefix를 predict해서 먼저 결과 (EarlyExit.h), recognizer(PREDICT_BACKEND_NATIVE / DTW)일 때만
+#define EARLY_EXIT // 주석 처리하면 손을 내린 뒤에만 predict
+#define EARLY_EXIT_CHECKPOINTS { 0.4f, 0.6f, 0.8f } // prefix를 보낼 진행률 (label 평균 프레임 수 기준)
+#define EARLY_EXIT_THRESHOLD 0.9 // label별 commit confidence 기본값, data/models/earlyexit.txt에서 label마다 고칠 수 있음
+#define EARLY_EXIT_DEFAULT_FRAMES 60 // 평균 길이를 모르는 label (30fps 2초)
+#define EARLY_EXIT_FILE_NAME "earlyexit.txt" // PATH_MODEL_FOLDER
+
+// KINECT_MODE_STREAM window 결과 -> 문장 (SentenceDecoder.h, CTC prefix beam search)
+#define SENTENCE_BEAM_WIDTH 8
+#define SENTENCE_TOP_LABELS 5 // step마다 확장할 label 수 (blank 제외)
+#define SENTENCE_MAX_PENDING 12 // 확정 안 된 label 최대 수 (step당 시간 / 메모리 상한)
+#define SENTENCE_LM_WEIGHT 0.5 // bigram prior 가중치, data/models/bigram.txt가 없으면 prior 없음
+#define SENTENCE_INSERTION_BONUS 0.0 // label 하나당 log 점수 (prior가 짧은 문장을 선호하는 것 보정)
+#define SENTENCE_END_WINDOWS 6 // 손 없는 window가 이만큼 이어지면 문장 끝
+#define SENTENCE_LM_FILE_NAME "bigram.txt" // PATH_MODEL_FOLDER
+
+// DTW 템플릿 매칭 (PREDICT_BACKEND_DTW, Project_Tools dtw-enroll로 등록)
+#define DTW_SERIES_LENGTH 64 // 템플릿 / 질의를 이 길이로 resample (FRAME_STANDARD_ADAPTIVE 길이 차이도 흡수)
+#define DTW_BAND_RATIO 0.1 // Sakoe-Chiba band 폭 (x DTW_SERIES_LENGTH)
+#define DTW_K 3 // kNN 이웃 수
+
+// 임베딩 (모델 분류 layer 직전 출력) kNN (PREDICT_BACKEND_EMBEDDING, HnswIndex.h, Project_Tools ann-enroll로 등록)
+#define ANN_M 16 // 노드당 이웃 수 (level 0은 2배), 클수록 recall과 메모리 증가
+#define ANN_EF_CONSTRUCTION 100 // add 때 level마다 보는 후보 수
+#define ANN_EF_SEARCH 64 // search 때 후보 수 (recall / 지연, Project_Tools bench-ann)
+#define ANN_K 5 // kNN 이웃 수
+
+// KINECT_MODE_LEARNING : 세그먼트마다 임베딩 label 평균을 갱신 (PREDICT_BACKEND_LEARNED, NcmHead.h, Project_Tools learn-eval)
+#define NCM_TEMPERATURE 16 // cos 유사도 x 이 값으로 softmax
+#define NCM_WEIGHT 0.7 // 배운 label 사이 순위에서 평균 쪽 비중 (나머지는 모델 score)
+
 #define PATH_DATA_FOLDER "../../data/"
+#define PATH_SHARD_FOLDER "shards/" // PATH_DATA_FOLDER 기준
+#define PATH_MODEL_FOLDER "models/" // PATH_DATA_FOLDER 기준, Project_DNN/do_Export.py 출력 (M1.kslm)
+#define SHARD_MAX_BYTES (1LL << 30) // 넘으면 다음 shard 파일
 #define FILE_LABEL "LABEL.txt"
 
 // ROI defines
 #define IMAEG_STANDARD_FRAME_SIZE 35 // 왼/오 각 채널당 프레임 개수 (총 *2)
 #define IMAGE_WIDTH 80
 #define IMAGE_HEIGHT 80
+#define IMAGE_SCALES { 140, 80, 64 } // ROI pyramid 출력 해상도(정사각, 내림차순), IMAGE_WIDTH 포함 필수
+#define IMAGE_SCALE_SIZE 3
+
+// ROI optical flow (flow/ 폴더에 저장, 8bit = 128 + flow * ROI_FLOW_SCALE)
+//#define ROI_OPTICAL_FLOW
+#define ROI_FLOW_SCALE 8
+
+// ROI 프레임 선택 방식 (ImageFrameCollection::setStandard)
+#define IMAGE_SELECT_UNIFORM 0 // 균등 시간 간격
+#define IMAGE_SELECT_SHARPEST 1 // 구간 내 가장 선명한 프레임 (Laplacian variance)
+#define IMAGE_SELECT_MOTION 2 // 구간 내 직전 프레임 대비 변화가 가장 큰 프레임
+#define IMAGE_SELECT_MODE IMAGE_SELECT_UNIFORM
+
+// ROI 시퀀스 압축 (RoiCodec.h), sample.ksl의 IMAGE section을 IMAGE_CODED로 저장
+#include "codecDefines.hpp" // ROI_CODEC_RAW, ROI_CODEC_DELTA_RICE
+#define ROI_CODEC ROI_CODEC_RAW
+//#define BENCHMARK_ROI_CODEC // 저장할 때 bmp / png / ROI_CODEC 크기, 시간 출력
+
+// raw session 기록 (SessionRecorder.h), OUTPUT 모드 동안 color / depth / body / HDFace 전부 저장
+//#define SESSION_RECORD
+#define PATH_SESSION_FOLDER "sessions/" // PATH_DATA_FOLDER 기준
+#define SESSION_WORKER_COUNT 3 // 압축 thread 수 (color jpeg 1장 ~15ms, 30fps 유지에 2개 이상)
+#define SESSION_QUEUE_CAPACITY 48 // 대기 chunk 최대 수, 넘으면 drop
+#define SESSION_COLOR_JPEG_QUALITY 90
+#define SESSION_DEPTH_COMPRESS // depth chunk를 DepthCodec(RVL)로 무손실 압축, 끄면 uint16 그대로
+//#define VERIFY_DEPTH_CODEC // 압축한 depth를 바로 decode해서 원본과 비교, 다르면 출력
+//#define BENCHMARK_DEPTH_CODEC // 세션 시작 시 합성 depth, 이후 SESSION_DEPTH_BENCHMARK_FRAMES마다 실제 depth 압축률 / 시간 출력
+#define SESSION_DEPTH_BENCHMARK_FRAMES 300
 
 // ---------------------------------------------------------------------
 //	Macro
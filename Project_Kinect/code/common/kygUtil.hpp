@@ -5,6 +5,7 @@
 #include <cstdlib> // system
 #include <chrono>
 #include <time.h> // localtime_s
+#include <fstream>
 #include <string>
 #include <Kinect.h>
 using namespace std;
@@ -113,6 +114,21 @@ using namespace std;
 		return buf;
 	}
 
+	// temp Ͽ   rename : д (python) ϼ ϸ  ȴ
+	inline bool write_file_atomic(const string& path, const char* data, size_t size)
+	{
+		string temp = path + ".tmp";
+		{
+			ofstream out(temp.c_str(), ios::out | ios::binary | ios::trunc);
+			if (!out.is_open()) return false;
+
+			out.write(data, size);
+			if (!out.good()) return false;
+		}
+
+		return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+	}
+
 	/*
 	static vector<vector<vector<double>>> dataRoot;
 	static void test()
@@ -48,16 +48,24 @@ void Kinect::run_one_cycle()
 void Kinect::setLabel(int l)
 {
 	label = l;
+	updateSession();
 }
 
 void Kinect::setMode(KINECT_MODE m)
 {
 	mode = m;
+	streamWindow.clear();
+	lastStreamTop = -1;
+	sentenceDecoder.reset();
+	sentence.clear();
+	idleWindows = 0;
+	updateSession();
 }
 
 void Kinect::setWorkerName(string name)
 {
 	workerName = name;
+	updateSession();
 }
 
 //----------------------------------------------------------------------------------
@@ -85,6 +93,8 @@ void Kinect::initialize()
 
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+
+	updateSession();
 }
 
 void Kinect::initializeComponents()
@@ -98,6 +108,14 @@ void Kinect::initializeComponents()
 
 	lHandPos = CameraSpacePoint();
 	rHandPos = CameraSpacePoint();
+
+	// 문장 prior는 선택 (없으면 window 결과만으로 decode)
+	string priorPath = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + SENTENCE_LM_FILE_NAME;
+	if (sentencePrior.load(priorPath))
+	{
+		sentenceDecoder.setPrior(&sentencePrior);
+		cout << "Loading " << priorPath << " ... OK" << endl;
+	}
 }
 
 // Initialize Sensor
@@ -199,6 +217,10 @@ void Kinect::finalize()
 {
     cv::destroyAllWindows();
 
+#ifdef SESSION_RECORD
+	recorder.close();
+#endif
+
 
 	// Release Body Buffer
 	Concurrency::parallel_for_each(bodies.begin(), bodies.end(), [](IBody*& body) {
@@ -237,6 +259,8 @@ void Kinect::update()
 	// send/save data if need
 	updateFrame();
 
+	updatePredict();
+
 	updateStatus();
 }
 
@@ -255,6 +279,10 @@ inline void Kinect::updateColor()
 
     // Convert Format ( YUY2 -> BGRA )
     ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+
+#ifdef SESSION_RECORD
+	recorder.pushColor(&colorBuffer[0], colorWidth, colorHeight, lastFrameRelativeTime);
+#endif
 }
 
 // call extract hand
@@ -280,11 +308,6 @@ void Kinect::extractHand()
 	//float spinePx = spinePxDepthSpaceVersion;
 	//DepthSpacePoint handPos;
 
-	float width = spinePx * 1.15f;
-	float height = spinePx * 1.15f;
-	float hWidth = width / 2;
-	float hHeight = height / 2;
-
 	for (int i = 0; i < 2; ++i)
 	{
 		CameraSpacePoint camHandPos = (i == 0 ? lHandPos : rHandPos);
@@ -293,18 +316,12 @@ void Kinect::extractHand()
 
 		coordinateMapper->MapCameraPointToColorSpace(camHandPos, &handPos);
 		//coordinateMapper->MapCameraPointToDepthSpace(camHandPos, &handPos);
-		
-		// 관심영역 설정
-		Rect roi(handPos.X - hWidth, handPos.Y - hHeight, width, height);
 
-		if (0 <= roi.x && 0 <= roi.width && roi.x + roi.width <= srcMat.cols && 0 <= roi.y && 0 <= roi.height && roi.y + roi.height <= srcMat.rows)
+		// IMAGE_SCALES 전부 한 번에 생성, IMAGE_WIDTH level은 화면 표시용
+		vector<cv::Mat>& pyramid = (i == 0 ? lHandPyramid : rHandPyramid);
+		if (ImageFrame::cropHand(srcMat, handPos.X, handPos.Y, spinePx, pyramid))
 		{
-			cv::Mat extractedMat = srcMat(roi);
-			cv::Mat resizedMat;
-
-			cv::resize(extractedMat, resizedMat, cv::Size(IMAGE_WIDTH, IMAGE_HEIGHT));
-
-			(i == 0 ? lHandImage : rHandImage) = resizedMat;
+			(i == 0 ? lHandImage : rHandImage) = pyramid[ImageFrame::baseScaleIndex()];
 		}
 	}
 }
@@ -323,6 +340,13 @@ inline void Kinect::updateDepth()
 	unsigned short* buf;
 	depthFrame->AccessUnderlyingBuffer(&sz, &buf);
 
+#ifdef SESSION_RECORD
+	// 16bit 원본 (아래 depthBuffer는 표시용 8bit)
+	TIMESPAN depthTime;
+	depthFrame->get_RelativeTime(&depthTime);
+	recorder.pushDepth(buf, depthWidth, depthHeight, depthTime);
+#endif
+
 	const unsigned short* curr = (const unsigned short*)buf;
 	const unsigned short* dataEnd = curr + (depthWidth * depthHeight);
 	BYTE* dest = depthBuffer;
@@ -365,22 +389,30 @@ inline void Kinect::updateBody()
 	// Find Closest Body
 	findClosestBody(bodies);
 
-	findLRHandPos();
-
-	// 손 활성화 확인
+#ifdef SESSION_RECORD
+	if (recorder.isOpen())
 	{
-		if (sPoints[SPOINT_BODY_WRIST_LEFT].getPoint().Y > sPoints[SPOINT_BODY_SPINE_BASE].getPoint().Y + spinePx / 2)
-		{
-			leftHandActivated = true;
-		}
-		else leftHandActivated = false;
+		TIMESPAN bodyTime;
+		bodyFrame->get_RelativeTime(&bodyTime);
 
-		if (sPoints[SPOINT_BODY_WRIST_RIGHT].getPoint().Y > sPoints[SPOINT_BODY_SPINE_BASE].getPoint().Y + spinePx / 2)
+		vector<SessionBody> snapshot;
+		for (int count = 0; count < BODY_COUNT; ++count)
 		{
-			rightHandActivated = true;
+			SessionBody b;
+			if (!SessionRecorder::captureBody(bodies[count], coordinateMapper.Get(), b)) continue;
+
+			b.closest = (atLeastOneTracked && count == trackingCount) ? 1 : 0;
+			snapshot.push_back(b);
 		}
-		else rightHandActivated = false;
+		recorder.pushBodies(snapshot, bodyTime);
 	}
+#endif
+
+	findLRHandPos();
+
+	// 손 활성화 확인
+	leftHandActivated = SPoint::isHandActivated(sPoints, SPOINT_BODY_WRIST_LEFT, spinePx);
+	rightHandActivated = SPoint::isHandActivated(sPoints, SPOINT_BODY_WRIST_RIGHT, spinePx);
 }
 
 // Update HDFace
@@ -424,85 +456,7 @@ void Kinect::updateSPoint()
 	coordinateMapper->MapCameraPointToDepthSpace(jointB.Position, &yd);
 	spinePxDepthSpaceVersion = (float)distance2d(xd, yd);
 
-	sPoints[SPOINT_HEAD_HAIR].setPoint(vertexes[28]);
-	sPoints[SPOINT_HEAD_FACE_EYE_LEFT].setPoint(vertexes[333]);
-	sPoints[SPOINT_HEAD_FACE_EYE_RIGHT].setPoint(vertexes[732]);
-	sPoints[SPOINT_HEAD_FACE_NOSE].setPoint(vertexes[23]);
-	sPoints[SPOINT_HEAD_FACE_LIP].setPoint(vertexes[8]);
-	sPoints[SPOINT_HEAD_FACE_CHEEK_LEFT].setPoint(vertexes[52]);
-	sPoints[SPOINT_HEAD_FACE_CHEEK_RIGHT].setPoint(vertexes[581]);
-	sPoints[SPOINT_HEAD_FACE_JAW].setPoint(vertexes[0]);
-
-	sPoints[SPOINT_BODY_NECK].setPoint(joints[JointType::JointType_Neck].Position);
-	sPoints[SPOINT_BODY_SPINE_MID].setPoint(joints[JointType::JointType_SpineMid].Position);
-	sPoints[SPOINT_BODY_SPINE_BASE].setPoint(joints[JointType::JointType_SpineBase].Position);
-	sPoints[SPOINT_BODY_SPINE_SHOULDER].setPoint(joints[JointType::JointType_SpineShoulder].Position);
-	sPoints[SPOINT_BODY_SHOULDER_LEFT].setPoint(joints[JointType::JointType_ShoulderLeft].Position);
-	sPoints[SPOINT_BODY_SHOULDER_RIGHT].setPoint(joints[JointType::JointType_ShoulderRight].Position);
-	sPoints[SPOINT_BODY_ELBOW_LEFT].setPoint(joints[JointType::JointType_ElbowLeft].Position);
-	sPoints[SPOINT_BODY_ELBOW_RIGHT].setPoint(joints[JointType::JointType_ElbowRight].Position);
-	sPoints[SPOINT_BODY_WRIST_LEFT].setPoint(joints[JointType::JointType_WristLeft].Position);
-	sPoints[SPOINT_BODY_WRIST_RIGHT].setPoint(joints[JointType::JointType_WristRight].Position);
-	sPoints[SPOINT_BODY_HAND_TIP_LEFT].setPoint(joints[JointType::JointType_HandTipLeft].Position);
-	sPoints[SPOINT_BODY_HAND_TIP_RIGHT].setPoint(joints[JointType::JointType_HandTipRight].Position);
-
-	// additional points
-	addtionalPoints[0].X = sPoints[SPOINT_HEAD_HAIR].getPoint().X;
-	addtionalPoints[0].Y = sPoints[SPOINT_HEAD_HAIR].getPoint().Y + spinePx;
-	addtionalPoints[0].Z = sPoints[SPOINT_HEAD_HAIR].getPoint().Z;
-	addtionalPoints[1].X = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().X - spinePx;
-	addtionalPoints[1].Y = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Y;
-	addtionalPoints[1].Z = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Z;
-	addtionalPoints[2].X = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().X + spinePx;
-	addtionalPoints[2].Y = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Y;
-	addtionalPoints[2].Z = sPoints[SPOINT_HEAD_FACE_NOSE].getPoint().Z;
-
-	sPoints[SPOINT_HEAD_TOP].setPoint(addtionalPoints[0]);
-	sPoints[SPOINT_HEAD_SIDE_LEFT].setPoint(addtionalPoints[1]);
-	sPoints[SPOINT_HEAD_SIDE_RIGHT].setPoint(addtionalPoints[2]);
-
-	// version2 points
-	sPoints[SPOINT_BODY_HIP_LEFT].setPoint(joints[JointType::JointType_HipLeft].Position);
-	sPoints[SPOINT_BODY_HIP_RIGHT].setPoint(joints[JointType::JointType_HipRight].Position);
-	sPoints[SPOINT_BODY_KNEE_LEFT].setPoint(joints[JointType::JointType_KneeLeft].Position);
-	sPoints[SPOINT_BODY_KNEE_RIGHT].setPoint(joints[JointType::JointType_KneeRight].Position);
-	sPoints[SPOINT_BODY_ANKLE_LEFT].setPoint(joints[JointType::JointType_AnkleLeft].Position);
-	sPoints[SPOINT_BODY_ANKLE_RIGHT].setPoint(joints[JointType::JointType_AnkleRight].Position);
-
-	// version2 addtional points
-	addtionalPoints[3].X = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().X - spinePx;
-	addtionalPoints[3].Y = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().Y;
-	addtionalPoints[3].Z = sPoints[SPOINT_BODY_HIP_LEFT].getPoint().Z;
-	addtionalPoints[4].X = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().X + spinePx;
-	addtionalPoints[4].Y = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().Y;
-	addtionalPoints[4].Z = sPoints[SPOINT_BODY_HIP_RIGHT].getPoint().Z;
-	addtionalPoints[5].X = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().X - spinePx;
-	addtionalPoints[5].Y = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().Y;
-	addtionalPoints[5].Z = sPoints[SPOINT_BODY_SHOULDER_LEFT].getPoint().Z;
-	addtionalPoints[6].X = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().X + spinePx;
-	addtionalPoints[6].Y = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().Y;
-	addtionalPoints[6].Z = sPoints[SPOINT_BODY_SHOULDER_RIGHT].getPoint().Z;
-	addtionalPoints[7].X = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().X - spinePx;
-	addtionalPoints[7].Y = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().Y;
-	addtionalPoints[7].Z = sPoints[SPOINT_BODY_KNEE_LEFT].getPoint().Z;
-	addtionalPoints[8].X = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().X + spinePx;
-	addtionalPoints[8].Y = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().Y;
-	addtionalPoints[8].Z = sPoints[SPOINT_BODY_KNEE_RIGHT].getPoint().Z;
-	addtionalPoints[9].X = sPoints[SPOINT_BODY_SPINE_MID].getPoint().X - spinePx;
-	addtionalPoints[9].Y = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Y;
-	addtionalPoints[9].Z = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Z;
-	addtionalPoints[10].X = sPoints[SPOINT_BODY_SPINE_MID].getPoint().X + spinePx;
-	addtionalPoints[10].Y = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Y;
-	addtionalPoints[10].Z = sPoints[SPOINT_BODY_SPINE_MID].getPoint().Z;
-
-	sPoints[SPOINT_BODY_HIP_SIDE_LEFT].setPoint(addtionalPoints[3]);
-	sPoints[SPOINT_BODY_HIP_SIDE_RIGHT].setPoint(addtionalPoints[4]);
-	sPoints[SPOINT_BODY_SHOULDER_SIDE_LEFT].setPoint(addtionalPoints[5]);
-	sPoints[SPOINT_BODY_SHOULDER_SIDE_RIGHT].setPoint(addtionalPoints[6]);
-	sPoints[SPOINT_BODY_KNEE_SIDE_LEFT].setPoint(addtionalPoints[7]);
-	sPoints[SPOINT_BODY_KNEE_SIDE_RIGHT].setPoint(addtionalPoints[8]);
-	sPoints[SPOINT_BODY_SPINE_MID_SIDE_LEFT].setPoint(addtionalPoints[9]);
-	sPoints[SPOINT_BODY_SPINE_MID_SIDE_RIGHT].setPoint(addtionalPoints[10]);
+	SPoint::fill(sPoints, &joints[0], vertexes, spinePx);
 }
 
 void Kinect::updateStatus()
@@ -522,6 +476,12 @@ void Kinect::updateFrame()
 {
 	if (mode == KINECT_MODE_IDLE) return;
 
+	if (mode == KINECT_MODE_STREAM)
+	{
+		updateStream();
+		return;
+	}
+
 	if (!frameStacking)
 	{
 		// 기록 시작
@@ -529,6 +489,9 @@ void Kinect::updateFrame()
 		{
 			recordStartTime = lastFrameRelativeTime;
 			frameStacking = true;
+#ifdef EARLY_EXIT
+			if (mode == KINECT_MODE_PREDICT) segment = earlyExit.begin();
+#endif
 		}
 	}
 	else
@@ -536,7 +499,14 @@ void Kinect::updateFrame()
 		// 기록 끝
 		if (frameStacking && (!leftHandActivated && !rightHandActivated))
 		{
-			int needStackedCnt = (mode == KINECT_MODE_PREDICT ? 18 : 35);
+			int needStackedCnt = (mode == KINECT_MODE_PREDICT || mode == KINECT_MODE_LEARNING ? 18 : ExtractionConfig::current().minStackedFrames);
+
+#ifdef ROI_OPTICAL_FLOW
+			// setStandard 전에 raw 프레임에 flow 연결
+			flowStage.finish(lhandCollection, rhandCollection);
+#endif
+
+			bool sent = false;
 
 			// 일정 frame 이상 쌓여야 함, 아니면 송신/저장 안함
 			if (frameCollection.getCollectionSize() > needStackedCnt)
@@ -545,18 +515,14 @@ void Kinect::updateFrame()
 				{
 				case KINECT_MODE_PREDICT:
 
-					frameCollection.setStandard(recordStartTime);
-					rhandCollection.setStandard(recordStartTime);
-					lhandCollection.setStandard(recordStartTime);
-					
-					if (frameCollection.getCollectionSize() == FRAME_STANDARD_SIZE &&
-						rhandCollection.getCollectionSize() == IMAEG_STANDARD_FRAME_SIZE &&
-						rhandCollection.getCollectionSize() == IMAEG_STANDARD_FRAME_SIZE)
+#ifdef EARLY_EXIT
+					earlyExit.end(segment, frameCollection.getCollectionSize());
+#endif
+					if (standardize())
 					{
-						save(true);
+						save(true); // "[Predict]"는 쓰기 완료 후 SampleSaver가 출력
 						++recorded;
-
-						cout << "[Predict]" << endl;
+						sent = true;
 					}
 					else
 					{
@@ -566,16 +532,25 @@ void Kinect::updateFrame()
 
 					break;
 
+				case KINECT_MODE_LEARNING:
+
+					// predict와 같은 세그먼트를 지금 label로 배움 (PredictQueue -> Recognizer::learn), 결과는 updatePredict
+					if (standardize())
+					{
+						frameCollection.setLabel(LABEL(label));
+						if (predictQueue.push(makeSample(), -1, label)) ++recorded;
+					}
+					else
+					{
+						cout << LABEL(label) << " Learn ... fail (standardize bug)" << endl;
+					}
+
+					break;
+
 				case KINECT_MODE_OUTPUT:
 
 					// record
-					frameCollection.setStandard(recordStartTime);
-					rhandCollection.setStandard(recordStartTime);
-					lhandCollection.setStandard(recordStartTime);
-
-					if (frameCollection.getCollectionSize() == FRAME_STANDARD_SIZE &&
-						rhandCollection.getCollectionSize() == IMAEG_STANDARD_FRAME_SIZE &&
-						rhandCollection.getCollectionSize() == IMAEG_STANDARD_FRAME_SIZE)
+					if (standardize())
 					{
 						save(false);
 						++recorded;
@@ -590,10 +565,18 @@ void Kinect::updateFrame()
 				}
 			}
 
+#ifdef EARLY_EXIT
+			// 보내지 않은 세그먼트 (프레임 부족, 표준화 실패), 보낸 것은 final 결과에서 정리
+			if (mode == KINECT_MODE_PREDICT && !sent) earlyExit.cancel(segment);
+#endif
 			frameStacking = false;
+			segment = -1;
 			frameCollection.clear();
 			rhandCollection.clear();
 			lhandCollection.clear();
+#ifdef ROI_OPTICAL_FLOW
+			flowStage.clear();
+#endif
 		}
 	}
 
@@ -603,77 +586,222 @@ void Kinect::updateFrame()
 		Frame f;
 
 		f.memorize(lHandPos, rHandPos, sPoints, leftHandActivated, rightHandActivated, lastFrameRelativeTime);
-		l.memorize(lHandImage, lastFrameRelativeTime);
-		r.memorize(rHandImage, lastFrameRelativeTime);
+		l.memorize(lHandPyramid, lastFrameRelativeTime);
+		r.memorize(rHandPyramid, lastFrameRelativeTime);
+
+#ifdef ROI_OPTICAL_FLOW
+		flowStage.push(0, lhandCollection.getCollectionSize(), lHandImage);
+		flowStage.push(1, rhandCollection.getCollectionSize(), rHandImage);
+#endif
 
 		frameCollection.stackFrame(f);
 		lhandCollection.stackFrame(l);
 		rhandCollection.stackFrame(r);
+
+#ifdef EARLY_EXIT
+		if (mode == KINECT_MODE_PREDICT) updateEarlyExit();
+#endif
 	}
 }
 
-void Kinect::isFolderNotExistCreate(string path)
+void Kinect::updateEarlyExit()
 {
-	DWORD attribs = ::GetFileAttributesA(path.c_str());
-	if (attribs == INVALID_FILE_ATTRIBUTES)
-	{
-		// wrong
+#ifdef EARLY_EXIT
+	if (!predictQueue.isNative()) return; // python 경로는 prefix를 보내지 않음
 
-		_mkdir(path.c_str());
-	}
-	else if (attribs & FILE_ATTRIBUTE_DIRECTORY)
+	int checkpoint = earlyExit.check(segment, frameCollection.getCollectionSize());
+	if (checkpoint < 0) return;
+
+	// 세그먼트는 계속 쌓으므로 복사 (ImageFrame은 cv::Mat 참조라 가볍다), 표준화는 세그먼트와 같게
+	Sample sample;
+	sample.label = label;
+	sample.labelName = LABEL(label);
+	sample.recordStartTime = recordStartTime;
+	sample.segmentTime = PredictChannel::now();
+	sample.frames = frameCollection;
+	sample.lhand = lhandCollection;
+	sample.rhand = rhandCollection;
+
+	if (!ExtractionConfig::current().standardize(sample.frames, sample.lhand, sample.rhand, sample.recordStartTime)) return;
+
+	predictQueue.pushPartial(move(sample), segment, checkpoint);
+#endif
+}
+
+// KINECT_MODE_STREAM : 손 활성화와 상관없이 매 프레임 window에 넣고, stride마다 predict (PredictQueue가 바쁘면 건너뜀)
+void Kinect::updateStream()
+{
+	ImageFrame l, r;
+	Frame f;
+
+	f.memorize(lHandPos, rHandPos, sPoints, leftHandActivated, rightHandActivated, lastFrameRelativeTime);
+	l.memorize(lHandPyramid, lastFrameRelativeTime);
+	r.memorize(rHandPyramid, lastFrameRelativeTime);
+
+	Sample sample;
+	int idle = streamWindow.getIdle();
+	if (!streamWindow.push(f, l, r, [&] { return predictQueue.isBusy(); }, sample))
 	{
-		// directory exist
+		// 손 없는 window는 blank, 앞 window 결과를 먼저 넣는다
+		if (streamWindow.getIdle() > idle && sentenceLabels > 0)
+		{
+			updatePredict();
+			updateSentence(vector<float>(sentenceLabels, 0), 1);
+		}
+		return;
 	}
-	else
+
+	sample.label = label;
+	sample.labelName = LABEL(label);
+	sample.workerName = workerName;
+	sample.dateTime = currentDateTime();
+	sample.segmentTime = PredictChannel::now();
+
+	predictQueue.push(move(sample));
+	++recorded;
+}
+
+bool Kinect::isPredictMode()
+{
+	return mode == KINECT_MODE_PREDICT || mode == KINECT_MODE_STREAM;
+}
+
+// 표준화 후 프레임 수 확인
+bool Kinect::standardize()
+{
+	return ExtractionConfig::current().standardize(frameCollection, lhandCollection, rhandCollection, recordStartTime);
+}
+
+void Kinect::updateSession()
+{
+#ifdef SESSION_RECORD
+	if (mode != KINECT_MODE_OUTPUT || coordinateMapper == nullptr) return; // initialize 전
+
+	if (!recorder.isOpen())
 	{
-		// not directory
+		if (!recorder.open(string(PATH_DATA_FOLDER) + PATH_SESSION_FOLDER, colorWidth, colorHeight, depthWidth, depthHeight)) return;
+
+		recorder.pushCalibration(coordinateMapper.Get());
 	}
+
+	recorder.pushMeta(label, mode, workerName, lastFrameRelativeTime);
+#endif
 }
 
 void Kinect::save(bool isSending)
 {
-	string path;
-
 	frameCollection.setLabel(LABEL(label));
-	static int i = 0;
 
-	if (!isSending)
+	if (isSending)
 	{
-		// folder :: data/0_안녕하세요/20180519_kyg/
-		path = string(PATH_DATA_FOLDER);
-		path += "/" + to_string(label) + "_" + LABEL(label);
-		isFolderNotExistCreate(path);
-		path += "/" + currentDateTime() + "_" + to_string(label) + "_" + workerName;
-		isFolderNotExistCreate(path);
-		path += "/";
+		// predict : 요청 큐 (PredictQueue), 보낼 곳이 없으면 data/temp/ + "[Predict]"
+		predictQueue.push(makeSample(), segment);
+		return;
 	}
-	else
-	{ 
-		// folder :: data/temp/
-		path = string(PATH_DATA_FOLDER);
-		path += "temp";
-		isFolderNotExistCreate(path);
-		path += "/";
+
+	// folder :: data/0_안녕하세요/20180519_kyg/
+	string path = string(PATH_DATA_FOLDER);
+	path += "/" + to_string(label) + "_" + LABEL(label);
+	path += "/" + currentDateTime() + "_" + to_string(label) + "_" + workerName;
+	path += "/";
+
+	// 폴더 생성, 쓰기는 saver worker에서 (SampleSaver)
+	saver.push(makeSample(), path, false);
+}
+
+// 결과는 PredictLink worker가 받아 두고, LABEL 변환과 출력은 main thread에서
+void Kinect::updatePredict()
+{
+	PredictLink::Completed result;
+
+	while (predictQueue.poll(result))
+	{
+		string labelName = result.top >= 0 ? LABEL(result.top) : "None";
+
+		// 배우기 전에 무엇으로 봤는지와 함께
+		if (result.learn >= 0)
+		{
+			if (result.learned) ++learned;
+			cout << "Learn #" << result.requestId << " " << LABEL(result.learn) << " : " << (result.learned ? "learned" : "fail") << " (was " << labelName
+				<< " " << (int)(result.confidence * 100) << "%, infer " << result.inferMs << "ms, update " << result.learnMs << "ms)" << endl;
+			if (result.learned) cout << "[Learn]" << LABEL(result.learn) << " " << (result.top == result.learn ? "ok" : "fixed") << endl;
+			continue;
+		}
+
+#ifdef EARLY_EXIT
+		// 진행 중 prefix : threshold를 넘었을 때만 먼저 출력
+		if (result.checkpoint >= 0)
+		{
+			if (!earlyExit.accept(result.segment, result.checkpoint, result.top, result.confidence)) continue;
+
+			cout << "Predict #" << result.requestId << " " << labelName << " (early, checkpoint " << result.checkpoint << ") : " << result.inferMs << "ms infer" << endl;
+			cout << "[Result]" << labelName << " " << (int)(result.confidence * 100) << "%" << endl;
+			continue;
+		}
+#endif
+
+		cout << "Predict #" << result.requestId << " " << labelName << (result.early ? " (gate)" : "") << " : " << result.totalMs << "ms"
+			<< " (queue " << result.queueMs << ", send " << result.sendMs << ", transfer " << result.transferMs << ", infer " << result.inferMs << ")" << endl;
+
+#ifdef EARLY_EXIT
+		// 이미 같은 결과를 냈으면 다시 출력하지 않음, 다르면 final로 고침
+		int committed = earlyExit.finish(result.segment, result.top);
+		if (committed >= 0)
+		{
+			if (committed == result.top) continue;
+			cout << "Predict #" << result.requestId << " early " << LABEL(committed) << " -> " << labelName << endl;
+		}
+#endif
+
+		if (mode == KINECT_MODE_STREAM) updateSentence(result.scores, 1 - result.confidence);
+
+		// stream은 window가 겹치므로 같은 수어가 연달아 나오면 한 번만
+		if (mode == KINECT_MODE_STREAM && result.top == lastStreamTop) continue;
+		lastStreamTop = result.top;
+
+		// 메인창 표시 (Logic.outputDataReceived)
+		cout << "[Result]" << labelName << " " << (int)(result.confidence * 100) << "%" << endl;
 	}
+}
 
-	// Spoints.txt
-	string fileName = "Spoints.txt";
-	stringstream sstream;
-	sstream << frameCollection.toString() << endl;
+void Kinect::updateSentence(const vector<float>& scores, float blank)
+{
+	if (scores.empty()) return;
 
-	ofstream writeFile((path + fileName).data(), std::ios::out|ios::trunc);
-	if (writeFile.is_open()) {
-		writeFile << sstream.str();
-		writeFile.close();
+	// 확신이 낮은 window는 수어 사이로 본다
+	vector<float> posteriors;
+	SentenceDecoder::addBlank(scores, blank, posteriors);
+	sentenceDecoder.push(posteriors, sentence);
+	sentenceLabels = (int)scores.size();
 
-		cout << LABEL(label) << " Record saving ... done " << ++i << path << endl;
+	idleWindows = blank >= 1 ? idleWindows + 1 : 0;
+	if (idleWindows != SENTENCE_END_WINDOWS) return;
+
+	sentenceDecoder.flush(sentence);
+	if (!sentence.empty())
+	{
+		cout << "[Sentence]";
+		for (int label : sentence) cout << " " << LABEL(label);
+		cout << endl;
 	}
-	else cout << LABEL(label) << " Record saving ... fail " << ++i << path << endl;
+	sentence.clear();
+}
 
-	// ROI Images
-	lhandCollection.save(path, 0);
-	rhandCollection.save(path, IMAEG_STANDARD_FRAME_SIZE);
+Sample Kinect::makeSample()
+{
+	Sample sample;
+
+	sample.label = label;
+	sample.labelName = LABEL(label);
+	sample.workerName = workerName;
+	sample.dateTime = currentDateTime();
+	sample.recordStartTime = recordStartTime;
+	sample.segmentTime = PredictChannel::now();
+	sample.frames = move(frameCollection);
+	sample.lhand = move(lhandCollection);
+	sample.rhand = move(rhandCollection);
+
+	return sample;
 }
 
 //----------------------------------------------------------------------------------
@@ -746,6 +874,11 @@ inline void Kinect::drawHDFace()
 
 	// Retrieve Vertexes
 	ERROR_CHECK(faceModel->CalculateVerticesForAlignment(faceAlignment.Get(), vertexCount, &vertexes[0]));
+
+#ifdef SESSION_RECORD
+	// vertex는 이 cycle의 color 시각으로 기록 (updateSPoint와 같은 값)
+	recorder.pushFace(vertexes, lastFrameRelativeTime);
+#endif
 	//drawVertexes(colorMat, vertexes, 1, colors[trackingCount]);
 }
 
@@ -934,13 +1067,108 @@ void Kinect::drawStatusText()
 		statusStream.str("");
 	}
 
-	if (mode == KINECT_MODE_PREDICT)
+	if (isPredictMode())
 	{
 		cv::putText(srcMat, "Sending Cnt : " + std::to_string(recorded), point, fontFace, fontScale, statusFontColor, fontThickness);
 		point.y += yd;
 		statusStream.str("");
 	}
 
+	if (mode == KINECT_MODE_LEARNING)
+	{
+		statusStream << "Learning : label " << label << ", sent " << recorded << ", learned " << learned << " (" << predictQueue.getBackendName() << ")";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+	if (mode == KINECT_MODE_OUTPUT || isPredictMode())
+	{
+		statusStream << "Save Queue : " << saver.getDepth() << " (saved " << saver.getSaved() << ", dropped " << saver.getDropped() << ", fail " << saver.getFailed() << ")";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+	if (mode == KINECT_MODE_STREAM)
+	{
+		statusStream << "Stream Window : " << streamWindow.getFilled() << " / " << streamWindow.getWindowSize() << " stride " << streamWindow.getStride()
+			<< " (sent " << streamWindow.getEmitted() << ", skipped " << streamWindow.getSkipped() << " busy, " << streamWindow.getIdle() << " idle)";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+
+		// 확정 | 아직 확정 안 된 best (label id, putText는 한글을 못 그림)
+		statusStream << "Sentence :";
+		for (int label : sentence) statusStream << " " << label;
+		statusStream << " |";
+		for (int label : sentenceDecoder.getPending()) statusStream << " " << label;
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+	if (isPredictMode())
+	{
+		statusStream << "Predict Queue : " << predictQueue.getDepth() << " " << PredictQueue::getPolicyName(PREDICT_QUEUE_POLICY)
+			<< " (dropped " << predictQueue.getDropped() << ", coalesced " << predictQueue.getCoalesced()
+			<< ", wait " << (int)predictQueue.getLastWait() << "ms, max " << (int)predictQueue.getMaxWait() << "ms)";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+	if (isPredictMode() && predictQueue.isNative())
+	{
+		statusStream << "Predictor : " << predictQueue.getBackendName() << " (last " << (int)predictQueue.getLastLatency() << "ms)";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+	else if (isPredictMode() && PREDICT_PROTOCOL == PREDICT_PROTOCOL_PIPE)
+	{
+		PredictLink& link = predictQueue.getPredictLink();
+		statusStream << "Predictor : " << (link.isConnected() ? "connected" : "waiting") << " (sent " << link.getSent() << ", result " << link.getReceived()
+			<< ", pending " << link.getOutstanding() << ", fail " << link.getFailed() << ", last " << (int)link.getLastLatency() << "ms)";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+	if (isPredictMode() && !predictQueue.getGateName().empty())
+	{
+		int answered = predictQueue.getAnswered();
+		int early = predictQueue.getEarly();
+		statusStream << "Cascade : " << predictQueue.getGateName() << " early " << early << " / " << answered
+			<< " (" << (answered > 0 ? 100 * early / answered : 0) << "%), mean " << (int)predictQueue.getMeanLatency() << "ms"
+			<< " (early " << (int)predictQueue.getMeanEarlyLatency() << ", late " << (int)predictQueue.getMeanLateLatency() << ")";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+
+#ifdef EARLY_EXIT
+	if (mode == KINECT_MODE_PREDICT && predictQueue.isNative())
+	{
+		int commits = earlyExit.getCommits();
+		statusStream << "Early Exit : " << commits << " / " << earlyExit.getFinals() << " commit"
+			<< ", agree " << (commits > 0 ? 100 * earlyExit.getAgreed() / commits : 0) << "% (" << predictQueue.getPartials() << " prefix)";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+#endif
+
+#ifdef SESSION_RECORD
+	if (recorder.isOpen())
+	{
+		statusStream << "Session : " << recorder.getDepth() << " (chunk " << recorder.getWritten() << ", dropped " << recorder.getDropped() << ")";
+		cv::putText(srcMat, statusStream.str(), point, fontFace, fontScale, statusFontColor, fontThickness);
+		point.y += yd;
+		statusStream.str("");
+	}
+#endif
+
 #endif
 
 	// SPoint
@@ -1229,9 +1457,11 @@ CameraSpacePoint Kinect::lerp(CameraSpacePoint src, CameraSpacePoint dst)
 {
 	CameraSpacePoint result;
 
-	result.X = Lerp((float)LERP_PERCENT, src.X, dst.X);
-	result.Y = Lerp((float)LERP_PERCENT, src.Y, dst.Y);
-	result.Z = Lerp((float)LERP_PERCENT, src.Z, dst.Z);
+	float percent = ExtractionConfig::current().lerpPercent;
+
+	result.X = Lerp(percent, src.X, dst.X);
+	result.Y = Lerp(percent, src.Y, dst.Y);
+	result.Z = Lerp(percent, src.Z, dst.Z);
 
 	return result;
 }
\ No newline at end of file
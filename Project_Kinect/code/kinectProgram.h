@@ -21,6 +21,14 @@ using namespace cv;
 #include "SPoint.h"
 #include "FrameCollection.h"
 #include "ImageFrameCollection.h"
+#include "OpticalFlowStage.h"
+#include "SampleSaver.h"
+#include "PredictQueue.h"
+#include "StreamWindow.h"
+#include "EarlyExit.h"
+#include "SentenceDecoder.h"
+#include "SessionRecorder.h"
+#include "ExtractionConfig.h"
 
 enum KINECT_MODE
 {
@@ -28,6 +36,7 @@ enum KINECT_MODE
 	KINECT_MODE_OUTPUT,
 	KINECT_MODE_PREDICT,
 	KINECT_MODE_LEARNING,
+	KINECT_MODE_STREAM, // 손을 내리지 않아도 sliding window로 predict
 
 	KINECT_MODE_SIZE,
 };
@@ -44,6 +53,8 @@ static string to_string(KINECT_MODE mode)
 		return "KINECT_MODE_PREDICT";
 	case		KINECT_MODE_IDLE:
 		return "KINECT_MODE_IDLE";
+	case		KINECT_MODE_STREAM:
+		return "KINECT_MODE_STREAM";
 	default:
 		return "ERR_NOT_MODE_NUMBER";
 
@@ -53,7 +64,7 @@ static string to_string(KINECT_MODE mode)
 class Kinect
 {
 private:
-	KINECT_MODE mode;
+	KINECT_MODE mode = KINECT_MODE_IDLE;
 
 	// Sensor
 	ComPtr<IKinectSensor> kinect;
@@ -98,12 +109,11 @@ private:
 	float spinePxColorSpaceVersion;
 	float spinePxDepthSpaceVersion;
 	std::array<SPoint, SPOINT_SIZE> sPoints;
-	CameraSpacePoint addtionalPoints[11];
 	bool atLeastOneTracked;
 
 	// Status Text
 	double fps = 0;
-	TIMESPAN lastFrameRelativeTime;
+	TIMESPAN lastFrameRelativeTime = 0;
 	TIMESPAN pastFrameRelativeTime;
 	std::stringstream statusStream;
 	cv::Scalar statusFontColor;
@@ -116,19 +126,41 @@ private:
 	bool rightHandActivated = false;
 	bool frameStacking = false;
 	int recorded = 0;
+	int learned = 0; // KINECT_MODE_LEARNING : 반영된 세그먼트
 	FrameCollection frameCollection;
 	ImageFrameCollection lhandCollection;
 	ImageFrameCollection rhandCollection;
+#ifdef ROI_OPTICAL_FLOW
+	OpticalFlowStage flowStage;
+#endif
+	SampleSaver saver;
+	PredictQueue predictQueue{ saver }; // saver보다 먼저 소멸 (data/temp fallback)
+	StreamWindow streamWindow; // KINECT_MODE_STREAM
+	int lastStreamTop = -1;
+	SentenceDecoder sentenceDecoder; // KINECT_MODE_STREAM window 결과 -> 문장
+	BigramPrior sentencePrior; // data/models/bigram.txt
+	vector<int> sentence; // 확정된 label
+	int sentenceLabels = 0; // recognizer score 수 (손 없는 window를 blank로)
+	int idleWindows = 0;
+#ifdef EARLY_EXIT
+	EarlyExit earlyExit;
+#endif
+	int segment = -1; // 진행 중 세그먼트 (EarlyExit::begin)
+#ifdef SESSION_RECORD
+	SessionRecorder recorder;
+#endif
 
 	CameraSpacePoint lHandPos;
 	CameraSpacePoint rHandPos;
 	TIMESPAN recordStartTime;
-	int label;
+	int label = -1;
 	string workerName = "None";
 
 	// Hand ROI
 	cv::Mat lHandImage;
 	cv::Mat rHandImage;
+	vector<cv::Mat> lHandPyramid; // IMAGE_SCALES
+	vector<cv::Mat> rHandPyramid;
 
 public:
 	// Constructor
@@ -177,12 +209,25 @@ private:
 
 	void updateFrame();
 
+	void updateStream();
+
+	// KINECT_MODE_STREAM window 결과 하나 -> SentenceDecoder, 손 없는 window가 SENTENCE_END_WINDOWS 이어지면 "[Sentence]"
+	void updateSentence(const vector<float>& scores, float blank);
+
+	// 진행 중 세그먼트 checkpoint마다 prefix predict (EarlyExit)
+	void updateEarlyExit();
+
+	bool isPredictMode(); // PREDICT, STREAM
+
 	void updateHDFace();
 
 	void updateDepth();
 
 	void updateROI();
 
+	// predict 결과 수신 (PredictQueue -> PredictLink), "[Result]" 출력, KINECT_MODE_LEARNING은 "[Learn]"
+	void updatePredict();
+
 	// Draw Data
 	void draw();
 
@@ -216,9 +261,15 @@ private:
 
 	string status2string(const FaceModelBuilderCollectionStatus collection);
 
+	bool standardize();
+
 	void save(bool);
 
-	void isFolderNotExistCreate(string path);
+	// 표준화된 collection들을 move (이후 clear해서 재사용)
+	Sample makeSample();
+
+	// SESSION_RECORD : OUTPUT 모드면 session 시작, label / 작업자 변경 기록
+	void updateSession();
 
 	// for extract hand
 	void extractHand();
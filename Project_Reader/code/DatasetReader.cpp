@@ -0,0 +1,487 @@
+#include "DatasetReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <ppl.h> // parallel_for
+
+#include "RoiCodec.h"
+
+namespace
+{
+	const char* TEMP_FOLDER = "temp"; // predict 샘플 (data/temp), 학습 데이터 아님
+
+	bool endsWith(const string& text, const string& suffix)
+	{
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	// 균등 시점 size개 -> 가장 가까운 프레임 (dataFormater._expandToStandard, 같은 거리면 앞 프레임)
+	// times가 없거나 길이가 다르면 비율로 대응
+	void standardIndex(const int64_t* times, int count, int size, vector<int>& index)
+	{
+		index.resize(size);
+
+		if (count == size || times == nullptr || count <= 0)
+		{
+			for (int j = 0; j < size; ++j) index[j] = count <= 0 ? 0 : (int)((int64_t)j * count / size);
+			return;
+		}
+
+		for (int j = 0; j < size; ++j)
+		{
+			double grid = (double)times[count - 1] * (j + 1) / size;
+			int i = (int)(lower_bound(times, times + count, (int64_t)ceil(grid)) - times);
+
+			if (i >= count) i = count - 1;
+			if (i > 0 && grid - times[i - 1] <= times[i] - grid) --i;
+
+			index[j] = i;
+		}
+	}
+
+	// IMAGE : 매핑 위의 view, IMAGE_CODED : decode
+	bool getHandFrames(const uint8_t* base, const SampleSection& s, int hand, vector<cv::Mat>& frames)
+	{
+		frames.clear();
+		const uint8_t* ptr = base + s.offset;
+
+		if (s.type == SAMPLE_SECTION_IMAGE)
+		{
+			if (s.dtype != SAMPLE_DTYPE_UINT8 || s.rank != 4 || s.shape[0] != 2) return false;
+
+			int count = (int)s.shape[1];
+			int h = (int)s.shape[2];
+			int w = (int)s.shape[3];
+			if ((uint64_t)2 * count * h * w > s.size) return false;
+
+			for (int i = 0; i < count; ++i)
+			{
+				const uint8_t* frame = ptr + ((size_t)hand * count + i) * h * w;
+				frames.push_back(cv::Mat(h, w, CV_8UC1, const_cast<uint8_t*>(frame)));
+			}
+
+			return true;
+		}
+
+		if (s.size < sizeof(uint32_t)) return false;
+
+		uint32_t leftSize;
+		memcpy(&leftSize, ptr, sizeof(leftSize));
+		if (sizeof(uint32_t) + (uint64_t)leftSize > s.size) return false;
+
+		const uint8_t* stream = ptr + sizeof(uint32_t) + (hand == 0 ? 0 : leftSize);
+		size_t size = hand == 0 ? leftSize : (size_t)(s.size - sizeof(uint32_t) - leftSize);
+
+		return DeltaRiceRoiCodec().decode(stream, size, frames);
+	}
+}
+
+//----------------------------------------------------------------------------------
+/// MappedFile
+//----------------------------------------------------------------------------------
+
+MappedFile::MappedFile()
+{
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const string& path)
+{
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+	size = (uint64_t)fileSize.QuadPart;
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		close();
+		return false;
+	}
+
+	base = reinterpret_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (base == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (base != nullptr) UnmapViewOfFile(base);
+	if (mapping != NULL) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+	base = nullptr;
+	mapping = NULL;
+	file = INVALID_HANDLE_VALUE;
+	size = 0;
+}
+
+const uint8_t* MappedFile::getData()
+{
+	return base;
+}
+
+uint64_t MappedFile::getSize()
+{
+	return size;
+}
+
+//----------------------------------------------------------------------------------
+/// DatasetReader
+//----------------------------------------------------------------------------------
+
+DatasetReader::DatasetReader()
+{
+	config = { 0, 0, 0, false };
+}
+
+bool DatasetReader::open(const string& root, const ReaderConfig& config)
+{
+	close();
+
+	if (config.frameSize <= 0 || config.imageFrameSize <= 0 || config.imageScale <= 0)
+	{
+		setError("DatasetReader::open invalid config");
+		return false;
+	}
+	this->config = config;
+
+	string dirpath = root;
+	if (!dirpath.empty() && dirpath.back() != '/' && dirpath.back() != '\\') dirpath += '/';
+
+	scan(dirpath);
+	maps.resize(files.size());
+
+	if (items.empty())
+	{
+		setError("DatasetReader::open no sample in " + root);
+		return false;
+	}
+
+	return true;
+}
+
+void DatasetReader::close()
+{
+	lock_guard<mutex> guard(mapLock);
+
+	maps.clear();
+	files.clear();
+	items.clear();
+}
+
+int64_t DatasetReader::getSize()
+{
+	return (int64_t)items.size();
+}
+
+const DatasetItem& DatasetReader::getItem(int64_t idx)
+{
+	return items[(size_t)idx];
+}
+
+const ReaderConfig& DatasetReader::getConfig()
+{
+	return config;
+}
+
+size_t DatasetReader::getSPointCount()
+{
+	return (size_t)config.frameSize * SAMPLE_SPOINT_WIDTH;
+}
+
+size_t DatasetReader::getImageCount()
+{
+	return (size_t)config.imageFrameSize * config.imageScale * config.imageScale * 2;
+}
+
+size_t DatasetReader::getImageBytes()
+{
+	return getImageCount() * (config.imageFloat ? sizeof(float) : sizeof(uint8_t));
+}
+
+int DatasetReader::readBatch(const int64_t* indices, int count, float* spoints, void* images, int32_t* labels)
+{
+	size_t spointCount = getSPointCount();
+	size_t imageCount = getImageCount();
+	atomic<int> success(0);
+
+	Concurrency::parallel_for(0, count, [&](int n)
+	{
+		float* spointOut = spoints + n * spointCount;
+		uint8_t* image8 = config.imageFloat ? nullptr : reinterpret_cast<uint8_t*>(images) + n * imageCount;
+		float* image32 = config.imageFloat ? reinterpret_cast<float*>(images) + n * imageCount : nullptr;
+
+		int64_t idx = indices[n];
+		bool result = false;
+
+		if (idx < 0 || idx >= getSize()) setError("DatasetReader index out of range " + to_string(idx));
+		else result = readSample(items[(size_t)idx], spointOut, image8, image32);
+
+		if (result)
+		{
+			labels[n] = items[(size_t)idx].label;
+			++success;
+		}
+		else
+		{
+			labels[n] = -1;
+			memset(spointOut, 0, spointCount * sizeof(float));
+			if (image8 != nullptr) memset(image8, 0, imageCount);
+			else memset(image32, 0, imageCount * sizeof(float));
+		}
+	});
+
+	return success;
+}
+
+string DatasetReader::getError()
+{
+	lock_guard<mutex> guard(errorLock);
+	return error;
+}
+
+void DatasetReader::setError(const string& message)
+{
+	lock_guard<mutex> guard(errorLock);
+	error = message;
+}
+
+// 폴더 재귀 순회, 이름 순 (실행마다 같은 index)
+void DatasetReader::scan(const string& dirpath)
+{
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((dirpath + "*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) return;
+
+	vector<string> dirs, names;
+	do
+	{
+		string name = data.cFileName;
+		if (name == "." || name == "..") continue;
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (name != TEMP_FOLDER) dirs.push_back(name);
+		}
+		else names.push_back(name);
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+
+	sort(dirs.begin(), dirs.end());
+	sort(names.begin(), names.end());
+
+	for (const string& name : names)
+	{
+		if (name == SAMPLE_FILE_NAME) addSampleFile(dirpath + name);
+		else if (endsWith(name, SHARD_INDEX_EXT)) addShardIndex(dirpath + name);
+	}
+
+	for (const string& name : dirs) scan(dirpath + name + "/");
+}
+
+void DatasetReader::addSampleFile(const string& path)
+{
+	ifstream in(path.data(), ios::in | ios::binary | ios::ate);
+	if (!in.is_open()) return;
+
+	uint64_t size = (uint64_t)in.tellg();
+	SampleHeader header;
+
+	in.seekg(0);
+	if (size < sizeof(header) || !in.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != SAMPLE_MAGIC || header.version < SAMPLE_MIN_VERSION || header.version > SAMPLE_VERSION)
+	{
+		cout << "DatasetReader skip invalid sample " << path << endl;
+		return;
+	}
+
+	files.push_back(path);
+	items.push_back({ (int)files.size() - 1, 0, size, header.label });
+}
+
+// ShardReader::readIndex와 같은 규칙 : 쓰다 만 entry, data보다 앞선 entry는 버림
+void DatasetReader::addShardIndex(const string& indexPath)
+{
+	string dataPath = indexPath.substr(0, indexPath.size() - strlen(SHARD_INDEX_EXT)) + SHARD_DATA_EXT;
+
+	ifstream index(indexPath.data(), ios::in | ios::binary);
+	ifstream data(dataPath.data(), ios::in | ios::binary | ios::ate);
+	if (!index.is_open() || !data.is_open()) return;
+
+	uint64_t dataSize = (uint64_t)data.tellg();
+
+	ShardIndexHeader header;
+	if (!index.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| header.magic != SHARD_INDEX_MAGIC || header.version != SHARD_VERSION || header.entrySize != sizeof(ShardIndexEntry))
+	{
+		cout << "DatasetReader skip invalid shard index " << indexPath << endl;
+		return;
+	}
+
+	files.push_back(dataPath);
+	int file = (int)files.size() - 1;
+
+	ShardIndexEntry entry;
+	while (index.read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+	{
+		if (entry.offset + entry.size > dataSize) break;
+
+		items.push_back({ file, entry.offset, entry.size, entry.label });
+	}
+}
+
+MappedFile* DatasetReader::map(int file)
+{
+	lock_guard<mutex> guard(mapLock);
+
+	if (maps[file] == nullptr)
+	{
+		unique_ptr<MappedFile> mapped(new MappedFile());
+		if (!mapped->open(files[file])) return nullptr;
+
+		maps[file] = move(mapped);
+	}
+
+	return maps[file].get();
+}
+
+bool DatasetReader::readSample(const DatasetItem& item, float* spoints, uint8_t* images8, float* images32)
+{
+	const string& path = files[item.file];
+
+	MappedFile* mapped = map(item.file);
+	if (mapped == nullptr || item.offset + item.size > mapped->getSize())
+	{
+		setError("DatasetReader cannot map " + path);
+		return false;
+	}
+
+	// header, section 검사 (SampleFile::validate와 같음)
+	const uint8_t* base = mapped->getData() + item.offset;
+	const SampleHeader* header = reinterpret_cast<const SampleHeader*>(base);
+	const SampleSection* sections = reinterpret_cast<const SampleSection*>(base + sizeof(SampleHeader));
+
+	if (item.size < sizeof(SampleHeader) || header->magic != SAMPLE_MAGIC || header->version < SAMPLE_MIN_VERSION || header->version > SAMPLE_VERSION
+		|| header->headerSize != sizeof(SampleHeader)
+		|| sizeof(SampleHeader) + (uint64_t)header->sectionCount * sizeof(SampleSection) > item.size)
+	{
+		setError("DatasetReader invalid sample " + path);
+		return false;
+	}
+
+	const SampleSection* spoint = nullptr;
+	const SampleSection* spointTime = nullptr;
+	const SampleSection* imageTime = nullptr;
+	const SampleSection* image = nullptr;
+
+	for (uint32_t i = 0; i < header->sectionCount; ++i)
+	{
+		const SampleSection& s = sections[i];
+		if (s.rank > SAMPLE_MAX_RANK || s.offset % SAMPLE_ALIGN != 0 || s.size > item.size || s.offset > item.size - s.size)
+		{
+			setError("DatasetReader invalid section " + path);
+			return false;
+		}
+
+		if (s.type == SAMPLE_SECTION_SPOINT) spoint = &s;
+		else if (s.type == SAMPLE_SECTION_SPOINT_TIME) spointTime = &s;
+		else if (s.type == SAMPLE_SECTION_IMAGE_TIME) imageTime = &s;
+		else if (s.type == SAMPLE_SECTION_IMAGE || s.type == SAMPLE_SECTION_IMAGE_CODED)
+		{
+			// 출력 크기와 같은 scale 우선, 없으면 가장 큰 scale
+			if (image == nullptr || (image->param != (uint32_t)config.imageScale
+				&& (s.param == (uint32_t)config.imageScale || s.param > image->param))) image = &s;
+		}
+	}
+
+	// SPOINT
+	if (spoint == nullptr || spoint->dtype != SAMPLE_DTYPE_FLOAT32 || spoint->rank != 3
+		|| spoint->shape[1] * spoint->shape[2] != SAMPLE_SPOINT_WIDTH
+		|| (uint64_t)spoint->shape[0] * SAMPLE_SPOINT_WIDTH * sizeof(float) > spoint->size)
+	{
+		setError("DatasetReader no spoint " + path);
+		return false;
+	}
+
+	int frameCount = (int)spoint->shape[0];
+	const float* spointData = reinterpret_cast<const float*>(base + spoint->offset);
+	const int64_t* times = spointTime != nullptr && (int)spointTime->shape[0] == frameCount
+		? reinterpret_cast<const int64_t*>(base + spointTime->offset) : nullptr;
+
+	vector<int> index;
+	standardIndex(times, frameCount, config.frameSize, index);
+
+	for (int j = 0; j < config.frameSize; ++j)
+	{
+		memcpy(spoints + (size_t)j * SAMPLE_SPOINT_WIDTH, spointData + (size_t)index[j] * SAMPLE_SPOINT_WIDTH, SAMPLE_SPOINT_WIDTH * sizeof(float));
+	}
+
+	// IMAGE
+	vector<cv::Mat> hands[2];
+	if (image == nullptr || !getHandFrames(base, *image, 0, hands[0]) || !getHandFrames(base, *image, 1, hands[1])
+		|| hands[0].empty() || hands[0].size() != hands[1].size())
+	{
+		setError("DatasetReader no image " + path);
+		return false;
+	}
+
+	int imageCount = (int)hands[0].size();
+	times = imageTime != nullptr && (int)imageTime->shape[0] == imageCount
+		? reinterpret_cast<const int64_t*>(base + imageTime->offset) : nullptr;
+	standardIndex(times, imageCount, config.imageFrameSize, index);
+
+	int scale = config.imageScale;
+	size_t row = (size_t)scale * 2;
+	cv::Mat resized;
+
+	for (int j = 0; j < config.imageFrameSize; ++j)
+	{
+		for (int h = 0; h < 2; ++h)
+		{
+			const cv::Mat* src = &hands[h][index[j]];
+			if (src->cols != scale || src->rows != scale)
+			{
+				cv::resize(*src, resized, cv::Size(scale, scale), 0, 0, cv::INTER_AREA);
+				src = &resized;
+			}
+
+			size_t frameOffset = (size_t)j * scale * row + (size_t)h * scale;
+			for (int y = 0; y < scale; ++y)
+			{
+				const uint8_t* in = src->ptr<uint8_t>(y);
+				size_t offset = frameOffset + y * row;
+
+				if (images8 != nullptr) memcpy(images8 + offset, in, scale);
+				else
+				{
+					for (int x = 0; x < scale; ++x) images32[offset + x] = (float)in[x];
+				}
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Windows.h> // CreateFileMapping, MapViewOfFile, FindFirstFile
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+using namespace std;
+
+#include "SampleFormat.h"
+
+// 읽기 전용 파일 매핑
+class MappedFile
+{
+private:
+	HANDLE file;
+	HANDLE mapping;
+	const uint8_t* base = nullptr;
+	uint64_t size = 0;
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const string& path);
+	void close();
+
+	const uint8_t* getData();
+	uint64_t getSize();
+};
+
+// 출력 tensor 모양 (Python defines.py 값과 같게)
+struct ReaderConfig
+{
+	int frameSize; // FRAME_STANDARD_SIZE
+	int imageFrameSize; // IMAGE_STANDARD_FRAME_SIZE
+	int imageScale; // 출력 ROI 크기, 저장된 scale이 아니면 가장 큰 scale에서 resize
+	bool imageFloat; // true : float32 (0 ~ 255), false : uint8
+};
+
+// 샘플 하나 = sample.ksl 파일 전체 또는 shard(.kss) 안의 [offset, offset + size)
+struct DatasetItem
+{
+	int file;
+	uint64_t offset;
+	uint64_t size;
+	int label;
+};
+
+// 저장된 샘플(sample.ksl, shard) 목록 + batch 조립
+//
+// open()은 폴더를 돌며 목록만 만든다 (shard는 .idx, sample.ksl은 header 160 byte만 읽음).
+// 파일은 처음 읽을 때 매핑하고 dataset이 닫힐 때까지 유지한다.
+// readBatch()는 매핑 위의 section을 호출자 buffer로 한 번 복사한다 (중간 buffer, bmp decode 없음).
+//
+// 출력 (sample 순서대로 연속)
+//   spoints : float32 [n][frameSize][SAMPLE_SPOINT_WIDTH]
+//   images  : uint8 / float32 [n][imageFrameSize][imageScale][2 * imageScale]  왼손 | 오른손
+//   labels  : int32 [n], 읽기 실패한 샘플은 -1 (spoints, images는 0)
+// FRAME_STANDARD_ADAPTIVE로 줄어든 샘플은 dataFormater._expandToStandard와 같은 방식으로 펼친다
+class DatasetReader
+{
+private:
+	ReaderConfig config;
+	vector<string> files;
+	vector<DatasetItem> items;
+
+	mutex mapLock;
+	vector<unique_ptr<MappedFile>> maps; // files와 같은 순서, 처음 읽을 때 생성
+
+	mutex errorLock;
+	string error;
+
+public:
+	DatasetReader();
+
+	DatasetReader(const DatasetReader&) = delete;
+	DatasetReader& operator=(const DatasetReader&) = delete;
+
+	// root 아래 모든 sample.ksl, *.idx (temp 폴더 제외)
+	bool open(const string& root, const ReaderConfig& config);
+	void close();
+
+	int64_t getSize();
+	const DatasetItem& getItem(int64_t idx);
+	const ReaderConfig& getConfig();
+
+	size_t getSPointCount(); // 샘플 하나의 float 개수
+	size_t getImageCount(); // 샘플 하나의 pixel 개수
+	size_t getImageBytes();
+
+	// indices 순서대로 batch 조립 (샘플 단위 parallel_for)
+	// return : 성공한 샘플 수
+	int readBatch(const int64_t* indices, int count, float* spoints, void* images, int32_t* labels);
+
+	string getError();
+
+private:
+	void scan(const string& dirpath);
+	void addSampleFile(const string& path);
+	void addShardIndex(const string& indexPath);
+
+	MappedFile* map(int file);
+
+	bool readSample(const DatasetItem& item, float* spoints, uint8_t* images8, float* images32);
+
+	void setError(const string& message);
+};
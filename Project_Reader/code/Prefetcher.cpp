@@ -0,0 +1,107 @@
+#include "Prefetcher.h"
+
+#include <algorithm>
+
+Prefetcher::Prefetcher(DatasetReader& reader, int batchSize, int depth, bool shuffle, uint32_t seed)
+	: reader(reader), random(seed)
+{
+	this->batchSize = batchSize;
+	this->shuffle = shuffle;
+
+	order.resize((size_t)reader.getSize());
+	for (size_t i = 0; i < order.size(); ++i) order[i] = (int64_t)i;
+	if (shuffle) std::shuffle(order.begin(), order.end(), random);
+
+	slots.resize(depth);
+	for (int i = 0; i < depth; ++i)
+	{
+		slots[i].spoints.resize(batchSize * reader.getSPointCount());
+		slots[i].images.resize(batchSize * reader.getImageBytes());
+		slots[i].labels.resize(batchSize);
+		slots[i].indices.resize(batchSize);
+		slots[i].epoch = 0;
+		emptySlots.push_back(i);
+	}
+
+	worker = thread(&Prefetcher::run, this);
+}
+
+Prefetcher::~Prefetcher()
+{
+	{
+		lock_guard<mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_all();
+
+	if (worker.joinable()) worker.join();
+}
+
+const Prefetcher::Slot& Prefetcher::next()
+{
+	unique_lock<mutex> guard(lock);
+
+	if (current >= 0)
+	{
+		emptySlots.push_back(current);
+		wake.notify_one();
+	}
+
+	filled.wait(guard, [&] { return !readySlots.empty(); });
+
+	current = readySlots.front();
+	readySlots.pop_front();
+
+	return slots[current];
+}
+
+int Prefetcher::getBatchSize()
+{
+	return batchSize;
+}
+
+void Prefetcher::run()
+{
+	while (true)
+	{
+		int idx;
+		{
+			unique_lock<mutex> guard(lock);
+			wake.wait(guard, [&] { return !emptySlots.empty() || !running; });
+			if (!running) return;
+
+			idx = emptySlots.front();
+			emptySlots.pop_front();
+		}
+
+		Slot& slot = slots[idx];
+		nextIndices(slot.indices, slot.epoch);
+
+		// batch 안은 parallel_for (DatasetReader::readBatch)
+		reader.readBatch(slot.indices.data(), batchSize, slot.spoints.data(), slot.images.data(), slot.labels.data());
+
+		{
+			lock_guard<mutex> guard(lock);
+			readySlots.push_back(idx);
+		}
+		filled.notify_one();
+	}
+}
+
+// worker thread에서만 호출
+void Prefetcher::nextIndices(vector<int64_t>& indices, int& slotEpoch)
+{
+	slotEpoch = epoch;
+
+	for (int i = 0; i < batchSize; ++i)
+	{
+		if (cursor >= order.size())
+		{
+			cursor = 0;
+			++epoch;
+			if (shuffle) std::shuffle(order.begin(), order.end(), random);
+		}
+
+		indices[i] = order[cursor++];
+	}
+}
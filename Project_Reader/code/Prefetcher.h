@@ -0,0 +1,73 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <random>
+#include <cstdint>
+using namespace std;
+
+#include "DatasetReader.h"
+
+// batch 미리 읽기 (학습 loop가 GPU를 쓰는 동안 다음 batch 조립)
+//
+// slot depth개를 미리 할당해두고 worker thread가 빈 slot을 순서대로 채운다.
+// 순서 : epoch마다 전체 index를 shuffle(seed 고정, mt19937)해서 batchSize씩 자름.
+//        epoch 끝에서 모자라면 다음 epoch 순서로 이어서 채움 (batch는 항상 batchSize개).
+// next()가 돌려준 slot은 다음 next() 호출 때 반납된다 (그 전까지 buffer 유효).
+// batch 복사 : 매핑 -> slot (readBatch), slot -> 호출자 (보관하려면) 두 번.
+class Prefetcher
+{
+public:
+	struct Slot
+	{
+		vector<float> spoints;
+		vector<uint8_t> images; // ReaderConfig.imageFloat면 float로 사용
+		vector<int32_t> labels;
+		vector<int64_t> indices;
+		int epoch;
+	};
+
+private:
+	DatasetReader& reader;
+	int batchSize;
+	bool shuffle;
+	mt19937 random;
+
+	vector<int64_t> order;
+	size_t cursor = 0;
+	int epoch = 0;
+
+	vector<Slot> slots;
+	deque<int> readySlots;
+	deque<int> emptySlots;
+	int current = -1; // 사용자에게 넘긴 slot
+
+	thread worker;
+	mutex lock;
+	condition_variable wake;
+	condition_variable filled;
+	bool running = true;
+
+public:
+	Prefetcher(DatasetReader& reader, int batchSize, int depth, bool shuffle, uint32_t seed);
+
+	// worker 종료 대기 (채우던 batch는 끝까지 읽음)
+	~Prefetcher();
+
+	Prefetcher(const Prefetcher&) = delete;
+	Prefetcher& operator=(const Prefetcher&) = delete;
+
+	// 다음 batch, 준비될 때까지 대기
+	const Slot& next();
+
+	int getBatchSize();
+
+private:
+	void run();
+
+	// 다음 batch의 index, epoch 경계에서 reshuffle
+	void nextIndices(vector<int64_t>& indices, int& slotEpoch);
+};
@@ -0,0 +1,125 @@
+#include "kslReader.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+using namespace std;
+
+#include "DatasetReader.h"
+#include "Prefetcher.h"
+
+struct ksl_dataset
+{
+	DatasetReader reader;
+	unique_ptr<Prefetcher> prefetcher;
+};
+
+namespace
+{
+	thread_local string lastError;
+
+	void setLastError(const string& message)
+	{
+		lastError = message;
+	}
+}
+
+KSL_API int ksl_version()
+{
+	return KSL_READER_VERSION;
+}
+
+KSL_API ksl_dataset* ksl_open(const char* root, int frameSize, int imageFrameSize, int imageScale, int imageFloat)
+{
+	if (root == nullptr)
+	{
+		setLastError("ksl_open root is null");
+		return nullptr;
+	}
+
+	unique_ptr<ksl_dataset> dataset(new ksl_dataset());
+	ReaderConfig config = { frameSize, imageFrameSize, imageScale, imageFloat != 0 };
+
+	if (!dataset->reader.open(root, config))
+	{
+		setLastError(dataset->reader.getError());
+		return nullptr;
+	}
+
+	return dataset.release();
+}
+
+KSL_API void ksl_close(ksl_dataset* dataset)
+{
+	if (dataset == nullptr) return;
+
+	// prefetcher가 reader를 쓰므로 먼저 정리
+	dataset->prefetcher.reset();
+	delete dataset;
+}
+
+KSL_API int64_t ksl_size(ksl_dataset* dataset)
+{
+	return dataset == nullptr ? 0 : dataset->reader.getSize();
+}
+
+KSL_API int64_t ksl_labels(ksl_dataset* dataset, int32_t* labels, int64_t count)
+{
+	if (dataset == nullptr || labels == nullptr) return 0;
+
+	int64_t size = min(count, dataset->reader.getSize());
+	for (int64_t i = 0; i < size; ++i) labels[i] = dataset->reader.getItem(i).label;
+
+	return size;
+}
+
+KSL_API int ksl_read_batch(ksl_dataset* dataset, const int64_t* indices, int count, float* spoints, void* images, int32_t* labels)
+{
+	if (dataset == nullptr || indices == nullptr || spoints == nullptr || images == nullptr || labels == nullptr || count <= 0)
+	{
+		setLastError("ksl_read_batch invalid argument");
+		return 0;
+	}
+
+	int result = dataset->reader.readBatch(indices, count, spoints, images, labels);
+	if (result < count) setLastError(dataset->reader.getError());
+
+	return result;
+}
+
+KSL_API int ksl_prefetch_start(ksl_dataset* dataset, int batchSize, int depth, int shuffle, uint32_t seed)
+{
+	if (dataset == nullptr || batchSize <= 0 || depth <= 0)
+	{
+		setLastError("ksl_prefetch_start invalid argument");
+		return 0;
+	}
+
+	dataset->prefetcher.reset();
+	dataset->prefetcher.reset(new Prefetcher(dataset->reader, batchSize, depth, shuffle != 0, seed));
+
+	return 1;
+}
+
+KSL_API int ksl_prefetch_next(ksl_dataset* dataset, const float** spoints, const void** images, const int32_t** labels, int* epoch)
+{
+	if (dataset == nullptr || dataset->prefetcher == nullptr)
+	{
+		setLastError("ksl_prefetch_next prefetch not started");
+		return 0;
+	}
+
+	const Prefetcher::Slot& slot = dataset->prefetcher->next();
+
+	if (spoints != nullptr) *spoints = slot.spoints.data();
+	if (images != nullptr) *images = slot.images.data();
+	if (labels != nullptr) *labels = slot.labels.data();
+	if (epoch != nullptr) *epoch = slot.epoch;
+
+	return dataset->prefetcher->getBatchSize();
+}
+
+KSL_API const char* ksl_last_error()
+{
+	return lastError.c_str();
+}
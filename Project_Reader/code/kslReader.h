@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+// Project_Reader C ABI (Project_DNN/scripts/sampleReader.py에서 ctypes로 사용)
+//
+// 함수 이름, 인자는 바꾸지 않는다. 바꿔야 하면 새 함수를 추가하고 KSL_READER_VERSION을 올림.
+// 배열은 모두 호출자가 할당한 연속 buffer (numpy C order), 모양은 DatasetReader.h 참고
+//   spoints : float32 [n][frameSize][74]
+//   images  : uint8 / float32 [n][imageFrameSize][imageScale][2 * imageScale]
+//   labels  : int32 [n]
+// 실패하면 0 이하 또는 NULL, 이유는 ksl_last_error()
+
+#ifdef KSL_READER_EXPORTS
+#define KSL_API __declspec(dllexport)
+#else
+#define KSL_API __declspec(dllimport)
+#endif
+
+#define KSL_READER_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ksl_dataset ksl_dataset;
+
+KSL_API int ksl_version();
+
+// root 아래 sample.ksl, shard(.idx)를 모두 찾아 목록 생성 (샘플 데이터는 읽지 않음)
+// imageFloat : 0 = uint8 images, 1 = float32 images
+KSL_API ksl_dataset* ksl_open(const char* root, int frameSize, int imageFrameSize, int imageScale, int imageFloat);
+
+KSL_API void ksl_close(ksl_dataset* dataset);
+
+KSL_API int64_t ksl_size(ksl_dataset* dataset);
+
+// 전체 label (count = ksl_size), return : 복사한 개수
+KSL_API int64_t ksl_labels(ksl_dataset* dataset, int32_t* labels, int64_t count);
+
+// indices의 샘플을 buffer에 채움, return : 읽은 샘플 수 (실패한 샘플은 label -1)
+KSL_API int ksl_read_batch(ksl_dataset* dataset, const int64_t* indices, int count, float* spoints, void* images, int32_t* labels);
+
+// 백그라운드 prefetch 시작 (이미 있으면 교체), shuffle은 epoch마다 seed로 재현 가능
+KSL_API int ksl_prefetch_start(ksl_dataset* dataset, int batchSize, int depth, int shuffle, uint32_t seed);
+
+// 다음 batch의 내부 slot buffer 포인터 (다음 ksl_prefetch_next / ksl_close 전까지 유효)
+// slot은 매핑에서 한 번 복사해 채운 것, 더 오래 쓰려면 호출자가 다시 복사 (sampleReader.py generator)
+// return : batch 크기, prefetch가 없으면 0
+KSL_API int ksl_prefetch_next(ksl_dataset* dataset, const float** spoints, const void** images, const int32_t** labels, int* epoch);
+
+// 마지막 실패 이유 (호출한 thread 기준)
+KSL_API const char* ksl_last_error();
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,190 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "HnswIndex.h"
+
+namespace
+{
+	double percentile(vector<double>& values, double p)
+	{
+		if (values.empty()) return 0;
+		size_t k = min(values.size() - 1, (size_t)(p * values.size()));
+		nth_element(values.begin(), values.begin() + k, values.end());
+		return values[k];
+	}
+
+	double elapsedUs(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+	}
+
+	// label마다 중심 하나, 임베딩 = 중심 + spread 잡음 후 L2 정규화 (InferenceModel::embed와 같은 크기)
+	class SyntheticEmbeddings
+	{
+	private:
+		int dim;
+		float spread;
+		vector<vector<float>> centers;
+		mt19937 random;
+
+	public:
+		SyntheticEmbeddings(int dim, int labelCount, float spread, unsigned seed)
+			: dim(dim), spread(spread), random(seed)
+		{
+			normal_distribution<float> n(0, 1);
+			centers.resize(labelCount);
+			for (auto& center : centers)
+			{
+				center.resize(dim);
+				for (float& v : center) v = n(random);
+				normalize(center);
+			}
+		}
+
+		int make(vector<float>& out)
+		{
+			uniform_int_distribution<int> pick(0, (int)centers.size() - 1);
+			normal_distribution<float> n(0, spread / sqrt((float)dim));
+
+			int label = pick(random);
+			out = centers[label];
+			for (float& v : out) v += n(random);
+			normalize(out);
+			return label;
+		}
+
+	private:
+		static void normalize(vector<float>& v)
+		{
+			float norm = 0;
+			for (float x : v) norm += x * x;
+			norm = sqrt(norm);
+			for (float& x : v) x /= norm;
+		}
+	};
+
+	// 정답 k개 중 찾은 비율
+	double recall(const vector<HnswIndex::Match>& found, const vector<HnswIndex::Match>& exact)
+	{
+		int hit = 0;
+		for (const auto& e : exact)
+		{
+			for (const auto& f : found) hit += f.index == e.index;
+		}
+		return exact.empty() ? 1 : (double)hit / exact.size();
+	}
+}
+
+// bench-ann [--sizes=1000,10000,100000] [--dim=64] [--labels=0] [--spread=1.0] [--queries=200] [--k=10] [--ef=16,32,64,128,256] [--m=16] [--ef-construction=100]
+//
+// 합성 임베딩 (label 중심 + 잡음, --labels 0이면 크기 / 20)을 HnswIndex에 하나씩 add (incremental), 크기마다
+//   add 시간, ef마다 recall@k (brute force 대비), 질의 지연 평균 / p95, 거리 계산 수, top-1 label이 brute force와 같은 비율
+//   save -> load 후 같은 결과인지, load한 index에 이어서 add 가능한지
+int annBenchCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	vector<int> sizes = args.getInts("sizes", "1000,10000,100000", 1);
+	int dim = max(args.getInt("dim", 64), 1);
+	int labelOption = max(args.getInt("labels", 0), 0);
+	float spread = (float)args.getDouble("spread", 1.0);
+	int queryCount = max(args.getInt("queries", 200), 1);
+	int k = max(args.getInt("k", 10), 1);
+	vector<int> efs = args.getInts("ef", "16,32,64,128,256", 1);
+	int m = max(args.getInt("m", ANN_M), 2);
+	int efConstruction = max(args.getInt("ef-construction", ANN_EF_CONSTRUCTION), 1);
+	string temp = args.get("file", "bench-ann.ksan");
+
+	cout << "bench-ann ... dim " << dim << ", m " << m << ", ef construction " << efConstruction << ", k " << k << ", " << queryCount << " query" << endl;
+
+	bool persisted = true;
+
+	for (int size : sizes)
+	{
+		int labelCount = labelOption > 0 ? labelOption : max(size / 20, 2);
+		SyntheticEmbeddings source(dim, labelCount, spread, 3);
+
+		HnswIndex index(m, efConstruction);
+		vector<float> v;
+
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < size; ++i)
+		{
+			int label = source.make(v);
+			index.add(label, v.data(), dim);
+		}
+		double addUs = elapsedUs(start) / size;
+
+		// 질의 (index에 없는 같은 분포), 정답은 brute force
+		vector<vector<float>> queries(queryCount);
+		vector<vector<HnswIndex::Match>> exact(queryCount);
+		vector<double> exactUs;
+		for (int q = 0; q < queryCount; ++q)
+		{
+			source.make(queries[q]);
+			start = chrono::steady_clock::now();
+			exact[q] = index.searchExact(queries[q].data(), k);
+			exactUs.push_back(elapsedUs(start));
+		}
+
+		cout << "  " << size << " embedding, " << labelCount << " label : add " << addUs << "us, level " << index.getTopLevel()
+			<< ", brute force " << percentile(exactUs, 0.5) << "us" << endl;
+
+		for (int ef : efs)
+		{
+			index.setEfSearch(ef);
+
+			double recallSum = 0, distances = 0;
+			int sameTop = 0;
+			vector<double> latencies;
+			for (int q = 0; q < queryCount; ++q)
+			{
+				start = chrono::steady_clock::now();
+				vector<HnswIndex::Match> found = index.search(queries[q].data(), k);
+				latencies.push_back(elapsedUs(start));
+
+				recallSum += recall(found, exact[q]);
+				distances += index.getLastDistances();
+				sameTop += !found.empty() && found[0].label == exact[q][0].label;
+			}
+
+			double mean = 0;
+			for (double us : latencies) mean += us;
+			mean /= latencies.size();
+
+			cout << "    ef " << ef << " : recall@" << k << " " << recallSum / queryCount << ", " << mean << "us (p95 " << percentile(latencies, 0.95) << "us)"
+				<< ", " << distances / queryCount << " distance, top-1 label " << sameTop << " / " << queryCount << endl;
+		}
+
+		// 저장 -> load -> 같은 결과, 이어서 add
+		index.setEfSearch(ANN_EF_SEARCH);
+		HnswIndex loaded(m, efConstruction, ANN_EF_SEARCH);
+		bool same = index.save(temp) && loaded.load(temp) && loaded.getCount() == index.getCount();
+		for (int q = 0; q < queryCount && same; ++q)
+		{
+			vector<HnswIndex::Match> a = index.search(queries[q].data(), k);
+			vector<HnswIndex::Match> b = loaded.search(queries[q].data(), k);
+			same = a.size() == b.size();
+			for (size_t i = 0; i < a.size() && same; ++i) same = a[i].index == b[i].index;
+		}
+
+		int label = source.make(v);
+		same = same && loaded.add(label, v.data(), dim) && loaded.search(v.data(), 1)[0].index == loaded.getCount() - 1;
+		remove(temp.c_str());
+
+		cout << "    save / load / add : " << (same ? "same" : "DIFFERENT") << endl;
+		persisted = persisted && same;
+	}
+
+	return persisted ? 0 : 2;
+}
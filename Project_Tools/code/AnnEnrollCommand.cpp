@@ -0,0 +1,96 @@
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SampleFinder.h"
+#include "Recognizer.h"
+
+namespace
+{
+	struct Enroller
+	{
+		InferenceModel& model;
+		HnswIndex& index;
+		map<int, int>& counts;
+		int perLabel;
+		vector<float> spoint, images, embedding;
+
+		// label별 perLabel개까지 (0 : 전부)
+		bool enroll(SampleFile& sample)
+		{
+			int label = sample.getHeader().label;
+			if (label < 0 || (perLabel > 0 && counts[label] >= perLabel)) return false;
+
+			if (!ModelRecognizer::prepare(model, sample, spoint, images) || !model.embed({ spoint.data(), images.data() }, embedding)) return false;
+			if (!index.add(label, embedding.data(), (int)embedding.size())) return false;
+
+			++counts[label];
+			return true;
+		}
+	};
+}
+
+// ann-enroll [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--out=data/models/embeddings.ksan] [--append] [--per-label=0]
+//
+// 저장된 샘플의 모델 임베딩을 PREDICT_BACKEND_EMBEDDING index에 등록 (기본 : data/ 전체)
+// --append면 기존 index에 이어서 (graph는 그대로 두고 끼워 넣음), --per-label은 label당 최대 개수
+int annEnrollCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string modelPath = args.get("model", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+	string out = args.get("out", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + ANN_INDEX_FILE_NAME);
+	int perLabel = max(args.getInt("per-label", 0), 0);
+	vector<string> paths = args.positional;
+	if (paths.empty()) paths.push_back(PATH_DATA_FOLDER);
+
+	InferenceModel model;
+	if (!model.load(modelPath) || model.getBranchCount() != 2)
+	{
+		cout << "ann-enroll : cannot load " << modelPath << endl;
+		return 1;
+	}
+
+	HnswIndex index;
+	map<int, int> counts;
+
+	if (args.has("append") && index.load(out))
+	{
+		if ((size_t)index.getDim() != model.getEmbeddingSize())
+		{
+			cout << "ann-enroll : " << out << " dim " << index.getDim() << " != model embedding " << model.getEmbeddingSize() << endl;
+			return 1;
+		}
+		for (int i = 0; i < index.getCount(); ++i) ++counts[index.getLabel(i)];
+	}
+
+	vector<string> samples;
+	for (const string& path : paths) findSamples(path, samples);
+
+	Enroller enroller = { model, index, counts, perLabel };
+	int before = index.getCount();
+	int skipped = forEachSample(samples, [&](SampleFile& sample) { return enroller.enroll(sample); });
+
+	if (index.getCount() == 0)
+	{
+		cout << "ann-enroll : no embedding (" << samples.size() << " file, " << skipped << " skipped)" << endl;
+		return 1;
+	}
+
+	if (!index.save(out))
+	{
+		cout << "ann-enroll : cannot write " << out << endl;
+		return 1;
+	}
+
+	cout << "ann-enroll ... " << index.getCount() - before << " added, " << index.getCount() << " embedding (dim " << index.getDim() << "), "
+		<< counts.size() << " label, " << skipped << " skipped -> " << out << endl;
+	for (const auto& count : counts) cout << "  " << count.first << " : " << count.second << endl;
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "BatchPredictServer.h"
+
+namespace
+{
+	double percentile(vector<double>& values, double p)
+	{
+		if (values.empty()) return 0;
+		size_t k = min(values.size() - 1, (size_t)(p * values.size()));
+		nth_element(values.begin(), values.begin() + k, values.end());
+		return values[k];
+	}
+
+	// batch forward == 하나씩 forward
+	float verifyBatch(InferenceModel& model, const vector<vector<vector<float>>>& cases)
+	{
+		int size = (int)cases.size();
+		vector<vector<float>> packed(model.getBranchCount());
+		vector<const float*> inputs;
+		for (int b = 0; b < model.getBranchCount(); ++b)
+		{
+			for (const auto& one : cases) packed[b].insert(packed[b].end(), one[b].begin(), one[b].end());
+			inputs.push_back(packed[b].data());
+		}
+
+		vector<float> batched, single;
+		model.forward(inputs, size, batched);
+
+		float diff = 0;
+		for (int i = 0; i < size; ++i)
+		{
+			model.forward({ cases[i][0].data(), cases[i][1].data() }, single);
+			for (size_t l = 0; l < single.size(); ++l) diff = max(diff, fabs(single[l] - batched[i * single.size() + l]));
+		}
+		return diff;
+	}
+}
+
+// bench-batch [--model=data/models/M1.kslm] [--producers=1,2,4,8] [--batch=1,4,8] [--wait=5] [--requests=32] [--think=0] [--prepare=0]
+//
+// BatchPredictServer에 producer thread 여러 개가 요청 (무작위 입력, 결과를 받으면 --think ms 쉬고 다음)
+//   --prepare : 입력 준비 시간 (ModelRecognizer::prepare 대신 sleep), 준비 중인 producer가 있어야 server가 batch를 기다린다
+//   batch 1 / producer 1도 같은 --wait : 혼자면 server가 기다리지 않으므로 지연이 늘지 않아야 함
+// batch 최대 크기 x producer 수마다 처리량 (request/s), 지연 p50 / p95 (submit ~ 결과), 평균 batch 크기
+// 시작 전에 batch forward와 하나씩 forward 결과가 같은지 확인
+int batchBenchCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string path = args.get("model", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+	vector<int> producerCounts = args.getInts("producers", "1,2,4,8", 1);
+	vector<int> batchSizes = args.getInts("batch", "1,4,8", 1);
+	double waitMs = args.getDouble("wait", PREDICT_BATCH_WAIT_MS);
+	int requestCount = max(args.getInt("requests", 32), 1);
+	double thinkMs = args.getDouble("think", 0);
+	double prepareMs = args.getDouble("prepare", 0);
+
+	InferenceModel model;
+	if (!model.load(path) || model.getBranchCount() != 2)
+	{
+		cout << "bench-batch : cannot load " << path << endl;
+		return 1;
+	}
+
+	// 입력 몇 벌 (ROI 0 ~ 255, spoint 0 ~ 1)
+	mt19937 random(5);
+	uniform_real_distribution<float> u(0, 1);
+	vector<vector<vector<float>>> cases(8);
+	for (auto& one : cases)
+	{
+		one.resize(2);
+		for (int b = 0; b < 2; ++b)
+		{
+			one[b].resize(model.getInputSize(b));
+			for (float& v : one[b]) v = b == 0 ? u(random) : 255 * u(random);
+		}
+	}
+
+	float diff = verifyBatch(model, cases);
+	bool exact = diff < 1e-4f;
+	cout << "bench-batch ... " << model.getName() << ", wait " << waitMs << "ms, " << requestCount << " request / producer, think " << thinkMs << "ms, prepare " << prepareMs << "ms"
+		<< ", batch vs single max diff " << diff << (exact ? "" : " FAIL") << endl;
+
+	for (int maxBatch : batchSizes)
+	{
+		for (int producers : producerCounts)
+		{
+			BatchPredictServer server(path, maxBatch, waitMs);
+			vector<vector<double>> latencies(producers);
+			vector<thread> threads;
+
+			auto start = chrono::steady_clock::now();
+			for (int p = 0; p < producers; ++p)
+			{
+				threads.emplace_back([&, p]
+				{
+					for (int r = 0; r < requestCount; ++r)
+					{
+						auto submitted = chrono::steady_clock::now();
+						Recognition result = server.submitWith([&](vector<vector<float>>& inputs)
+						{
+							if (prepareMs > 0) this_thread::sleep_for(chrono::microseconds((long long)(prepareMs * 1000)));
+							inputs = cases[(p + r) % cases.size()];
+							return true;
+						}).get();
+						latencies[p].push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - submitted).count());
+
+						if (result.top < 0) cout << "  producer " << p << " request " << r << " fail" << endl;
+						if (thinkMs > 0) this_thread::sleep_for(chrono::microseconds((long long)(thinkMs * 1000)));
+					}
+				});
+			}
+			for (thread& t : threads) t.join();
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+			vector<double> all;
+			for (auto& one : latencies) all.insert(all.end(), one.begin(), one.end());
+
+			cout << "  batch " << maxBatch << ", " << producers << " producer : " << all.size() / seconds << " request/s"
+				<< ", latency p50 " << percentile(all, 0.5) << "ms p95 " << percentile(all, 0.95) << "ms"
+				<< ", mean batch " << server.getMeanBatch() << " (infer " << server.getMeanInfer() << "ms/batch)" << endl;
+		}
+	}
+
+	return exact ? 0 : 2;
+}
@@ -0,0 +1,263 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SentenceDecoder.h"
+
+namespace
+{
+	// label마다 자주 오는 다음 label 몇 개 (합 0.8), 나머지는 균등
+	class SyntheticGrammar
+	{
+	private:
+		int labelCount;
+		vector<vector<int>> follows; // prev + 1 (0 : 문장 시작)
+		mt19937 random;
+
+	public:
+		SyntheticGrammar(int labelCount, unsigned seed)
+			: labelCount(labelCount), random(seed)
+		{
+			uniform_int_distribution<int> pick(0, labelCount - 1);
+			follows.resize(labelCount + 1);
+			for (auto& next : follows)
+			{
+				for (int i = 0; i < 3; ++i) next.push_back(pick(random));
+			}
+		}
+
+		vector<int> make(int minLength, int maxLength)
+		{
+			uniform_int_distribution<int> length(minLength, maxLength);
+			uniform_int_distribution<int> pick(0, labelCount - 1);
+			uniform_int_distribution<int> often(0, 2);
+			uniform_real_distribution<float> u(0, 1);
+
+			vector<int> labels(length(random));
+			int prev = -1;
+			for (int& label : labels)
+			{
+				label = u(random) < 0.8f ? follows[prev + 1][often(random)] : pick(random);
+				prev = label;
+			}
+			return labels;
+		}
+	};
+
+	// 문장 -> window 확률 열 [label..., blank], window 수는 label마다 2 ~ 6, 사이 blank 0 ~ 2 (같은 label 사이는 1 이상)
+	// noise 확률로 그 window의 최대 확률이 다른 label로 (정답은 두 번째로 남음, 헷갈리는 recognizer)
+	class SyntheticStream
+	{
+	private:
+		int labelCount;
+		float noise;
+		mt19937 random;
+
+	public:
+		SyntheticStream(int labelCount, float noise, unsigned seed)
+			: labelCount(labelCount), noise(noise), random(seed)
+		{
+		}
+
+		void make(const vector<int>& labels, vector<vector<float>>& windows)
+		{
+			uniform_int_distribution<int> duration(2, 6);
+			uniform_int_distribution<int> gap(0, 2);
+			uniform_int_distribution<int> pick(0, labelCount - 1);
+
+			windows.clear();
+			for (int i = gap(random); i > 0; --i) windows.push_back(window(labelCount, -1));
+
+			for (size_t n = 0; n < labels.size(); ++n)
+			{
+				for (int i = duration(random); i > 0; --i)
+				{
+					uniform_real_distribution<float> u(0, 1);
+					windows.push_back(u(random) < noise ? window(pick(random), labels[n]) : window(labels[n], -1));
+				}
+
+				int blanks = gap(random);
+				if (n + 1 < labels.size() && labels[n + 1] == labels[n]) blanks = max(blanks, 1);
+				for (int i = blanks; i > 0; --i) windows.push_back(window(labelCount, -1));
+			}
+
+			for (int i = gap(random); i > 0; --i) windows.push_back(window(labelCount, -1));
+		}
+
+	private:
+		// peak (labelCount : blank) 0.45 ~ 0.9, second가 있으면 나머지의 절반 이상, 나머지는 무작위로 나눔
+		vector<float> window(int peak, int second)
+		{
+			uniform_real_distribution<float> u(0, 1);
+
+			vector<float> p(labelCount + 1);
+			float rest = 0;
+			for (float& v : p)
+			{
+				v = u(random) * u(random);
+				rest += v;
+			}
+
+			float high = 0.45f + 0.45f * u(random);
+			float runnerUp = second >= 0 && second != peak ? (1 - high) * (0.5f + 0.4f * u(random)) : 0;
+			for (float& v : p) v *= (1 - high - runnerUp) / rest;
+			p[peak] += high;
+			if (runnerUp > 0) p[second] += runnerUp;
+
+			return p;
+		}
+	};
+
+	// window마다 최대 확률 -> 이어지는 같은 label 합치고 blank 제거
+	vector<int> greedyDecode(const vector<vector<float>>& windows)
+	{
+		vector<int> labels;
+		int prev = -1;
+		for (const auto& p : windows)
+		{
+			int top = (int)(max_element(p.begin(), p.end()) - p.begin());
+			if (top != prev && top != (int)p.size() - 1) labels.push_back(top);
+			prev = top;
+		}
+		return labels;
+	}
+
+	int editDistance(const vector<int>& a, const vector<int>& b)
+	{
+		vector<int> row(b.size() + 1);
+		for (size_t j = 0; j <= b.size(); ++j) row[j] = (int)j;
+
+		for (size_t i = 1; i <= a.size(); ++i)
+		{
+			int diagonal = row[0];
+			row[0] = (int)i;
+			for (size_t j = 1; j <= b.size(); ++j)
+			{
+				int up = row[j];
+				row[j] = min(min(row[j] + 1, row[j - 1] + 1), diagonal + (a[i - 1] != b[j - 1]));
+				diagonal = up;
+			}
+		}
+		return row[b.size()];
+	}
+
+	struct Score
+	{
+		int errors = 0;
+		int reference = 0;
+		int exact = 0;
+		double stepNs = 0;
+		double stepMaxNs = 0;
+		int steps = 0;
+		int candidates = 0;
+
+		void add(const vector<int>& truth, const vector<int>& decoded)
+		{
+			int distance = editDistance(truth, decoded);
+			errors += distance;
+			reference += (int)truth.size();
+			exact += distance == 0;
+		}
+
+		void print(const string& name, int sentences)
+		{
+			cout << "  " << name << " : label error " << 100.0 * errors / max(reference, 1) << "%, sentence " << exact << " / " << sentences;
+			if (steps > 0) cout << ", step " << stepNs / steps / 1000 << "us (max " << stepMaxNs / 1000 << "us), prefix max " << candidates;
+			cout << endl;
+		}
+	};
+
+	void decode(SentenceDecoder& decoder, const vector<vector<float>>& windows, vector<int>& labels, Score& score)
+	{
+		labels.clear();
+		for (const auto& p : windows)
+		{
+			auto start = chrono::steady_clock::now();
+			decoder.push(p, labels);
+			double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+			score.stepNs += ns;
+			score.stepMaxNs = max(score.stepMaxNs, ns);
+			++score.steps;
+		}
+		decoder.flush(labels);
+		score.candidates = max(score.candidates, decoder.getMaxCandidates());
+	}
+}
+
+// bench-decoder [--sentences=200] [--labels=20] [--noise=0.3] [--beam=8] [--top=5] [--lm-weight=0.5] [--train=2000] [--min-length=3] [--max-length=8]
+//
+// 정답을 아는 합성 window 확률 열로 SentenceDecoder 확인
+// greedy (window별 최대 확률 + 합치기), beam, beam + bigram prior (--train개 합성 문장으로 학습)의 label error rate (편집 거리)와
+// step당 시간, 한 step에서 본 prefix 최대 수 (beam x top label 이하여야 함)
+int decoderBenchCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	int sentenceCount = max(args.getInt("sentences", 200), 1);
+	int labelCount = max(args.getInt("labels", 20), 2);
+	float noise = (float)args.getDouble("noise", 0.3);
+	int beamWidth = max(args.getInt("beam", SENTENCE_BEAM_WIDTH), 1);
+	int topLabels = max(args.getInt("top", SENTENCE_TOP_LABELS), 1);
+	float lmWeight = (float)args.getDouble("lm-weight", SENTENCE_LM_WEIGHT);
+	int trainCount = max(args.getInt("train", 2000), 0);
+	int minLength = max(args.getInt("min-length", 3), 1);
+	int maxLength = max(args.getInt("max-length", 8), minLength);
+
+	SyntheticGrammar grammar(labelCount, 11);
+	SyntheticStream stream(labelCount, noise, 13);
+
+	BigramPrior prior;
+	for (int i = 0; i < trainCount; ++i) prior.addSentence(grammar.make(minLength, maxLength));
+
+	SentenceDecoder plain(beamWidth, topLabels, SENTENCE_MAX_PENDING, 0);
+	SentenceDecoder withPrior(beamWidth, topLabels, SENTENCE_MAX_PENDING, lmWeight);
+	withPrior.setPrior(&prior);
+
+	Score greedy, beam, beamPrior;
+	vector<vector<float>> windows;
+	vector<int> labels;
+	int windowCount = 0;
+
+	for (int s = 0; s < sentenceCount; ++s)
+	{
+		vector<int> truth = grammar.make(minLength, maxLength);
+		stream.make(truth, windows);
+		windowCount += (int)windows.size();
+
+		greedy.add(truth, greedyDecode(windows));
+
+		decode(plain, windows, labels, beam);
+		beam.add(truth, labels);
+
+		decode(withPrior, windows, labels, beamPrior);
+		beamPrior.add(truth, labels);
+	}
+
+	cout << "bench-decoder ... " << sentenceCount << " sentence, " << windowCount << " window, " << labelCount << " label, noise " << noise
+		<< ", beam " << beamWidth << " x top " << topLabels << endl;
+	greedy.print("greedy    ", sentenceCount);
+	beam.print("beam      ", sentenceCount);
+	beamPrior.print("beam+prior", sentenceCount);
+
+	// 합치기가 맞으면 잡음 없는 열은 정확히 복원
+	SyntheticStream clean(labelCount, 0, 17);
+	SentenceDecoder check(beamWidth, topLabels);
+	Score exact;
+	for (int s = 0; s < 20; ++s)
+	{
+		vector<int> truth = grammar.make(minLength, maxLength);
+		clean.make(truth, windows);
+		decode(check, windows, labels, exact);
+		exact.add(truth, labels);
+	}
+	cout << "  noise 0 : " << exact.exact << " / 20 exact" << endl;
+
+	return exact.exact == 20 ? 0 : 2;
+}
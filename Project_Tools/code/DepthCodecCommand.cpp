@@ -0,0 +1,115 @@
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SessionExtractor.h" // findSessions
+#include "SessionReader.h"
+#include "DepthCodec.h"
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool ok, const string& what)
+	{
+		cout << "  " << (ok ? "ok   " : "FAIL ") << what << endl;
+		failures += ok ? 0 : 1;
+	}
+
+	// 한 장 roundTrip, 압축 크기가 최악 (pixel당 4 byte) 안인지도
+	void checkFrame(const string& name, const vector<uint16_t>& depth, int width, int height)
+	{
+		vector<uint8_t> coded;
+		DepthCodec::Stats stats;
+		bool same = DepthCodec::roundTrip(depth.data(), width, height, coded, stats);
+
+		check(same && coded.size() <= (size_t)width * height * 4 + 32,
+			name + " (" + to_string(coded.size()) + " byte, raw " + to_string(depth.size() * sizeof(uint16_t)) + ")");
+	}
+}
+
+// depth-codec [session.ksr | folder]... [--frames=30] [--width=512] [--height=424]
+//
+// DepthCodec (RVL) encode -> decode가 원래 depth와 같은지
+//   합성 depth (벽 + 사람 + 구멍 + 잡음) --frames장, 압축률 / 시간
+//   경계 값 : 전부 0, 전부 65535, 1 / 65535 번갈아 (차이 최대), 임의 uint16
+//   잘린 stream, 크기가 다른 header는 decode가 false
+//   session을 주면 DEPTH chunk를 모두 풀어서 다시 roundTrip
+int depthCodecCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	int frames = max(args.getInt("frames", 30), 1);
+	int width = max(args.getInt("width", 512), 1);
+	int height = max(args.getInt("height", 424), 1);
+	size_t count = (size_t)width * height;
+
+	cout << "depth-codec ... " << width << "x" << height << endl;
+
+	DepthCodec::Stats synthetic = DepthCodec::benchmarkSynthetic(width, height, frames);
+	check(synthetic.mismatches == 0, "synthetic " + DepthCodec::toString(synthetic));
+
+	vector<uint16_t> depth(count, 0);
+	checkFrame("all 0", depth, width, height);
+
+	fill(depth.begin(), depth.end(), (uint16_t)0xFFFF);
+	checkFrame("all 65535", depth, width, height);
+
+	for (size_t i = 0; i < count; ++i) depth[i] = i % 2 ? 0xFFFF : 1;
+	checkFrame("1 / 65535 alternating", depth, width, height);
+
+	for (size_t i = 0; i < count; ++i) depth[i] = i % 3 ? (uint16_t)(i * 7919) : 0;
+	checkFrame("0 / large alternating", depth, width, height);
+
+	mt19937 random(5);
+	uniform_int_distribution<int> u(0, 0xFFFF);
+	for (uint16_t& d : depth) d = (uint16_t)u(random);
+	checkFrame("random uint16", depth, width, height);
+
+	// 손상된 입력
+	vector<uint8_t> coded;
+	vector<uint16_t> decoded(count);
+	DepthCodec::encode(depth.data(), width, height, coded);
+	check(!DepthCodec::decode(coded.data(), coded.size() - 4, decoded.data(), width, height), "truncated stream rejected");
+	check(!DepthCodec::decode(coded.data(), coded.size() / 2, decoded.data(), width, height), "half stream rejected");
+	check(!DepthCodec::decode(coded.data(), coded.size(), decoded.data(), width + 1, height), "size mismatch rejected");
+
+	// 기록된 session
+	vector<string> sessions;
+	for (const string& p : args.positional) SessionExtractor::findSessions(p, sessions);
+
+	for (const string& path : sessions)
+	{
+		SessionReader reader;
+		if (!reader.open(path))
+		{
+			check(false, "open " + path);
+			continue;
+		}
+
+		DepthCodec::Stats stats;
+		int unreadable = 0;
+		for (int n = 0; n < reader.getChunkSize(SESSION_STREAM_DEPTH); ++n)
+		{
+			cv::Mat frame;
+			if (!reader.readDepth(n, frame) || !frame.isContinuous())
+			{
+				++unreadable;
+				continue;
+			}
+
+			DepthCodec::roundTrip(frame.ptr<uint16_t>(0), frame.cols, frame.rows, coded, stats);
+		}
+
+		check(stats.mismatches == 0 && unreadable == 0, path + " " + DepthCodec::toString(stats) + ", unreadable " + to_string(unreadable));
+	}
+
+	cout << (failures == 0 ? "depth-codec : ok" : "depth-codec : " + to_string(failures) + " failed") << endl;
+
+	return failures == 0 ? 0 : 2;
+}
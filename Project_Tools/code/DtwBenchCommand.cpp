@@ -0,0 +1,193 @@
+#include <ppl.h> // parallel_for
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "DtwMatcher.h"
+#include "InferenceKernels.h"
+#include "SampleFormat.h" // SAMPLE_SPOINT_WIDTH
+
+namespace
+{
+	const double PI = 3.14159265358979;
+
+	// label마다 부드러운 궤적 (차원마다 sin 두 개), 샘플은 시간 왜곡 + 진폭 / 잡음
+	class SyntheticSigns
+	{
+	private:
+		struct Wave
+		{
+			float base, a1, f1, p1, a2, f2, p2;
+		};
+
+		int frameSize;
+		int featureSize;
+		vector<vector<Wave>> labels;
+		mt19937 random;
+
+	public:
+		SyntheticSigns(int labelCount, int frameSize, int featureSize, unsigned seed)
+			: frameSize(frameSize), featureSize(featureSize), random(seed)
+		{
+			uniform_real_distribution<float> u(0, 1);
+			labels.resize(labelCount);
+			for (auto& waves : labels)
+			{
+				for (int d = 0; d < featureSize; ++d)
+				{
+					waves.push_back({ 0.2f + 0.4f * u(random), 0.15f * u(random), 0.5f + 2.0f * u(random), (float)(2 * PI * u(random)),
+						0.05f * u(random), 2.0f + 3.0f * u(random), (float)(2 * PI * u(random)) });
+				}
+			}
+		}
+
+		void make(int label, vector<float>& frames)
+		{
+			uniform_real_distribution<float> u(-1, 1);
+			normal_distribution<float> noise(0, 0.01f);
+
+			float warp = 0.15f * u(random); // 빠르게 / 느리게 시작
+			float gain = 1.0f + 0.1f * u(random);
+			frames.resize((size_t)frameSize * featureSize);
+
+			for (int f = 0; f < frameSize; ++f)
+			{
+				double t = (double)f / (frameSize - 1);
+				t = t + warp * sin(PI * t) / PI;
+
+				for (int d = 0; d < featureSize; ++d)
+				{
+					const Wave& w = labels[label][d];
+					frames[(size_t)f * featureSize + d] = w.base
+						+ gain * (w.a1 * (float)sin(2 * PI * w.f1 * t + w.p1) + w.a2 * (float)sin(2 * PI * w.f2 * t + w.p2)) + noise(random);
+				}
+			}
+		}
+	};
+
+	double elapsedMs(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+// bench-dtw [--templates=100,300,1000,3000] [--queries=20] [--labels=20] [--frames=150] [--k=3] [--verify=3]
+//
+// 합성 SPoint 시퀀스로 DtwMatcher search 처리량 (템플릿 수별, avx2 / scalar)
+// LB_Keogh로 건너뛴 비율, DTW 중단 비율, kNN top-1 정확도와
+// --verify개 질의는 모든 템플릿 DTW(brute force)의 가까운 k개와 같은지 확인 (템플릿 수마다 따로)
+int dtwBenchCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	vector<int> templateCounts = args.getInts("templates", "100,300,1000,3000", 1);
+	int queryCount = max(args.getInt("queries", 20), 1);
+	int labelCount = max(args.getInt("labels", 20), 1);
+	int frameSize = max(args.getInt("frames", FRAME_STANDARD_SIZE), 2);
+	int k = max(args.getInt("k", DTW_K), 1);
+	int verify = max(args.getInt("verify", 3), 0);
+	int featureSize = SAMPLE_SPOINT_WIDTH;
+
+	SyntheticSigns signs(labelCount, frameSize, featureSize, 7);
+	vector<float> frames;
+
+	vector<vector<float>> queries(queryCount);
+	vector<int> queryLabels(queryCount);
+	for (int q = 0; q < queryCount; ++q)
+	{
+		queryLabels[q] = q % labelCount;
+		signs.make(queryLabels[q], queries[q]);
+	}
+
+	bool ok = true;
+	cout << "bench-dtw ... frame " << frameSize << " -> " << DTW_SERIES_LENGTH << ", feature " << featureSize << ", band " << DTW_BAND_RATIO
+		<< ", k " << k << ", " << queryCount << " query" << (InferenceKernels::hasAvx2() ? "" : " (no avx2)") << endl;
+
+	DtwMatcher matcher;
+	for (int count : templateCounts)
+	{
+		auto start = chrono::steady_clock::now();
+		while (matcher.getTemplateCount() < count)
+		{
+			int label = matcher.getTemplateCount() % labelCount;
+			signs.make(label, frames);
+			matcher.add(label, frames.data(), frameSize, featureSize);
+		}
+		double enrollMs = elapsedMs(start);
+
+		for (int simd = InferenceKernels::hasAvx2() ? 1 : 0; simd >= 0; --simd)
+		{
+			InferenceKernels::setSimd(simd != 0);
+
+			DtwMatcher::Stats total;
+			int correct = 0;
+			start = chrono::steady_clock::now();
+
+			for (int q = 0; q < queryCount; ++q)
+			{
+				DtwMatcher::Stats stats;
+				vector<DtwMatcher::Match> matches = matcher.search(queries[q].data(), frameSize, k, &stats);
+
+				correct += !matches.empty() && matches[0].label == queryLabels[q];
+				total.pruned += stats.pruned;
+				total.abandoned += stats.abandoned;
+				total.computed += stats.computed;
+			}
+
+			double ms = elapsedMs(start) / queryCount;
+			double all = (double)count * queryCount;
+
+			cout << "  " << count << " template " << (simd ? "avx2  " : "scalar") << " : " << ms << "ms/query (" << count / ms * 1000 << " template/s)"
+				<< ", pruned " << 100 * total.pruned / all << "%, abandoned " << 100 * total.abandoned / all << "%, full " << 100 * total.computed / all << "%"
+				<< ", top-1 " << correct << " / " << queryCount << endl;
+		}
+		InferenceKernels::setSimd(true);
+
+		// brute force와 top-k 전체 비교 : 거리 순서가 같고, 각 index의 거리가 그 템플릿의 DTW와 같은지 (같은 거리는 index가 바뀔 수 있음)
+		bool exact = true;
+		for (int q = 0; q < min(verify, queryCount); ++q)
+		{
+			vector<float> query;
+			matcher.prepare(queries[q].data(), frameSize, query);
+
+			vector<float> distances(count);
+			Concurrency::parallel_for(0, count, [&](int t)
+			{
+				distances[t] = matcher.distance(query, t);
+			});
+
+			vector<float> sorted = distances;
+			int topK = min(k, count);
+			partial_sort(sorted.begin(), sorted.begin() + topK, sorted.end());
+			vector<DtwMatcher::Match> matches = matcher.search(queries[q].data(), frameSize, k);
+
+			auto near = [](float a, float b) { return fabs(a - b) <= 1e-4f * max(b, 1.0f); };
+			bool same = (int)matches.size() == topK;
+			for (int i = 0; i < topK && same; ++i)
+			{
+				same = near(matches[i].distance, sorted[i]) && near(matches[i].distance, distances[matches[i].index]);
+				if (!same)
+				{
+					cout << "  verify query " << q << " : search #" << i << " " << matches[i].distance << " (template " << matches[i].index
+						<< ") != brute force " << sorted[i] << endl;
+				}
+			}
+			if ((int)matches.size() != topK) cout << "  verify query " << q << " : search " << matches.size() << " match, expected " << topK << endl;
+
+			exact = exact && same;
+		}
+		ok = ok && exact;
+
+		cout << "  " << count << " template enroll " << enrollMs << "ms" << (verify > 0 ? (exact ? ", verify ok" : ", verify FAIL") : "") << endl;
+	}
+
+	return ok ? 0 : 2;
+}
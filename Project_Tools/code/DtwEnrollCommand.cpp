@@ -0,0 +1,128 @@
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SampleFinder.h"
+#include "DtwMatcher.h"
+
+namespace
+{
+	// 등록한 템플릿 중 임의 size개 (reservoir), leave-one-out 거리 분포용
+	struct Held
+	{
+		int index;
+		int frameSize;
+		vector<float> spoints;
+	};
+
+	struct Reservoir
+	{
+		int size = 0;
+		int seen = 0;
+		vector<Held> items;
+		mt19937 random{ 11 };
+
+		void offer(int index, const float* spoints, int frameSize)
+		{
+			int slot = seen < size ? seen : uniform_int_distribution<int>(0, seen)(random);
+			++seen;
+			if (slot >= size) return;
+
+			Held held = { index, frameSize, vector<float>(spoints, spoints + (size_t)frameSize * SAMPLE_SPOINT_WIDTH) };
+			if (slot < (int)items.size()) items[slot] = move(held);
+			else items.push_back(move(held));
+		}
+	};
+
+	// label별 perLabel개까지 (0 : 전부)
+	bool enroll(DtwMatcher& matcher, SampleFile& sample, map<int, int>& counts, int perLabel, Reservoir& reservoir)
+	{
+		int label = sample.getHeader().label;
+		const float* spoints = sample.getSPoints();
+
+		if (label < 0 || spoints == nullptr || sample.getFrameSize() == 0) return false;
+		if (perLabel > 0 && counts[label] >= perLabel) return false;
+
+		if (!matcher.add(label, spoints, sample.getFrameSize(), SAMPLE_SPOINT_WIDTH)) return false;
+		++counts[label];
+		reservoir.offer(matcher.getTemplateCount() - 1, spoints, sample.getFrameSize());
+
+		return true;
+	}
+
+	// 자기 자신을 뺀 가장 가까운 템플릿 거리 / DTW_SERIES_LENGTH (DtwRecognizer가 gate에 주는 값과 같은 단위)
+	void printDistances(DtwMatcher& matcher, Reservoir& reservoir)
+	{
+		vector<float> distances;
+		for (const Held& held : reservoir.items)
+		{
+			for (const DtwMatcher::Match& match : matcher.search(held.spoints.data(), held.frameSize, 2))
+			{
+				if (match.index == held.index) continue;
+				distances.push_back(match.distance / DTW_SERIES_LENGTH);
+				break;
+			}
+		}
+		if (distances.empty()) return;
+
+		sort(distances.begin(), distances.end());
+		auto at = [&](double p) { return distances[min((size_t)(p * distances.size()), distances.size() - 1)]; };
+
+		cout << "  nearest template distance (" << distances.size() << " held out) : p50 " << at(0.5) << ", p95 " << at(0.95)
+			<< ", max " << distances.back() << " (PREDICT_GATE_MAX_DISTANCE " << PREDICT_GATE_MAX_DISTANCE << ")" << endl;
+	}
+}
+
+// dtw-enroll [folder | sample.ksl | .kss]... [--out=data/models/templates.ksdt] [--append] [--per-label=0] [--calibrate=200]
+//
+// 저장된 샘플의 SPoint distance를 PREDICT_BACKEND_DTW 템플릿으로 등록 (기본 : data/ 전체)
+// --append면 기존 템플릿 파일에 이어서, --per-label은 label당 최대 개수
+// --calibrate개 (임의) 템플릿은 자기를 뺀 가장 가까운 템플릿 거리 분포를 출력 : PREDICT_GATE_MAX_DISTANCE를 정하는 기준, 0이면 안함
+int dtwEnrollCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string out = args.get("out", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + DTW_TEMPLATE_FILE_NAME);
+	int perLabel = max(args.getInt("per-label", 0), 0);
+	Reservoir reservoir;
+	reservoir.size = max(args.getInt("calibrate", 200), 0);
+	vector<string> paths = args.positional;
+	if (paths.empty()) paths.push_back(PATH_DATA_FOLDER);
+
+	DtwMatcher matcher;
+	map<int, int> counts;
+
+	if (args.has("append") && matcher.load(out))
+	{
+		for (int t = 0; t < matcher.getTemplateCount(); ++t) ++counts[matcher.getLabel(t)];
+	}
+
+	vector<string> samples;
+	for (const string& path : paths) findSamples(path, samples);
+
+	int skipped = forEachSample(samples, [&](SampleFile& sample) { return enroll(matcher, sample, counts, perLabel, reservoir); });
+
+	if (matcher.getTemplateCount() == 0)
+	{
+		cout << "dtw-enroll : no template (" << samples.size() << " file, " << skipped << " skipped)" << endl;
+		return 1;
+	}
+
+	if (!matcher.save(out))
+	{
+		cout << "dtw-enroll : cannot write " << out << endl;
+		return 1;
+	}
+
+	cout << "dtw-enroll ... " << matcher.getTemplateCount() << " template, " << counts.size() << " label, " << skipped << " skipped -> " << out << endl;
+	for (const auto& count : counts) cout << "  " << count.first << " : " << count.second << endl;
+	printDistances(matcher, reservoir);
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include <ppl.h> // parallel_for_each, combinable
+#include <concrt.h> // SchedulerPolicy
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SessionExtractor.h"
+
+// extract <session.ksr | folder>... [--out=dir] [--threads=n] [--frame-size=150] ...
+//
+// 세션 하나가 한 task, PPL scheduler가 core마다 task를 나누고 먼저 끝난 core가 남의 것을 훔쳐 간다.
+// 세션 안의 JPEG decode / crop도 parallel_for라 마지막 긴 세션 하나만 남아도 core가 놀지 않음.
+int extractCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+	ExtractionConfig& config = ExtractionConfig::current();
+
+	if (args.positional.empty())
+	{
+		cout << "extract : no session (.ksr file or folder)" << endl;
+		return 1;
+	}
+
+	for (const auto& option : args.options)
+	{
+		if (option.first == "out" || option.first == "threads") continue;
+
+		if (!config.set(option.first, option.second))
+		{
+			cout << "extract : bad option --" << option.first << "=" << option.second << endl;
+			return 1;
+		}
+	}
+
+	string error;
+	if (!config.validate(error))
+	{
+		cout << "extract : " << error << endl;
+		return 1;
+	}
+
+	string out = args.get("out", string(PATH_DATA_FOLDER) + "extracted/");
+	if (out.back() != '/' && out.back() != '\\') out += "/";
+
+	vector<string> sessions;
+	for (const string& path : args.positional) SessionExtractor::findSessions(path, sessions);
+
+	if (sessions.empty())
+	{
+		cout << "extract : no " << SESSION_FILE_EXT << " found" << endl;
+		return 1;
+	}
+
+	LabelMapper::getInstance()->initialize();
+
+	// --threads : 다른 작업과 같이 돌릴 때 core 수 제한
+	int threads = args.getInt("threads", 0);
+	if (threads > 0)
+	{
+		Concurrency::CurrentScheduler::Create(Concurrency::SchedulerPolicy(2,
+			Concurrency::MinConcurrency, 1,
+			Concurrency::MaxConcurrency, threads));
+	}
+
+	cout << "Extract " << sessions.size() << " session -> " << out << endl;
+	cout << "  " << config.toString() << endl;
+
+	auto start = chrono::steady_clock::now();
+
+	SessionExtractor extractor(out);
+	Concurrency::combinable<SessionExtractor::Result> results;
+
+	Concurrency::parallel_for_each(sessions.begin(), sessions.end(), [&](const string& path)
+	{
+		results.local() += extractor.extract(path);
+	});
+
+	SessionExtractor::Result total;
+	results.combine_each([&](const SessionExtractor::Result& r) { total += r; });
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "Extract ... done " << total.sessions << "/" << sessions.size() << " session, "
+		<< total.colorFrames << " frame, "
+		<< total.segments << " segment, saved " << total.saved
+		<< ", skipped " << total.skipped << ", failed " << total.failed
+		<< " (" << seconds << "s, " << (seconds > 0 ? total.colorFrames / seconds : 0) << " frame/s)" << endl;
+
+	if (threads > 0) Concurrency::CurrentScheduler::Detach();
+
+	return total.failed > 0 ? 2 : 0;
+}
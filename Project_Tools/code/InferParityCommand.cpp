@@ -0,0 +1,155 @@
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "InferenceModel.h"
+
+namespace
+{
+	struct Case
+	{
+		vector<float> spoint;
+		vector<float> image;
+		vector<float> output; // keras
+	};
+
+	bool loadReference(const string& path, vector<Case>& cases, ModelReferenceHeader& header)
+	{
+		ifstream file(path.c_str(), ios::in | ios::binary);
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+			|| header.magic != MODEL_REFERENCE_MAGIC || header.version != MODEL_VERSION) return false;
+
+		cases.resize(header.caseCount);
+		for (Case& c : cases)
+		{
+			c.spoint.resize(header.spointSize);
+			c.image.resize(header.imageSize);
+			c.output.resize(header.labelCount);
+
+			if (!file.read(reinterpret_cast<char*>(c.spoint.data()), sizeof(float) * c.spoint.size())
+				|| !file.read(reinterpret_cast<char*>(c.image.data()), sizeof(float) * c.image.size())
+				|| !file.read(reinterpret_cast<char*>(c.output.data()), sizeof(float) * c.output.size())) return false;
+		}
+
+		return true;
+	}
+
+	int argmax(const vector<float>& scores)
+	{
+		return (int)(max_element(scores.begin(), scores.end()) - scores.begin());
+	}
+
+	double maxDiff(const vector<float>& a, const vector<float>& b)
+	{
+		double diff = 0;
+		for (size_t i = 0; i < min(a.size(), b.size()); ++i) diff = max(diff, (double)fabs(a[i] - b[i]));
+		return diff;
+	}
+
+	// 모든 case를 repeat번, return case당 평균 ms
+	double runAll(InferenceModel& model, vector<Case>& cases, int repeat, vector<vector<float>>& outputs)
+	{
+		outputs.assign(cases.size(), vector<float>());
+		auto start = chrono::steady_clock::now();
+
+		for (int r = 0; r < repeat; ++r)
+		{
+			for (size_t i = 0; i < cases.size(); ++i)
+			{
+				model.forward({ cases[i].spoint.data(), cases[i].image.data() }, outputs[i]);
+			}
+		}
+
+		return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / (repeat * cases.size());
+	}
+}
+
+// infer-parity [--model=data/models/M1.kslm] [--reference=data/models/M1.kslr] [--repeat=3] [--tolerance=0.0001]
+//
+// Project_DNN/do_Export.py가 저장한 무작위 입력 / keras 출력과 InferenceModel(avx2, scalar) 결과 비교
+// 출력 최대 차이가 tolerance 이하이고 argmax가 모두 같아야 통과, case당 추론 시간도 출력
+int inferParityCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string folder = string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER;
+	string modelPath = args.get("model", folder + MODEL_FILE_NAME);
+	string referencePath = args.get("reference", folder + MODEL_REFERENCE_FILE_NAME);
+	int repeat = max(args.getInt("repeat", 3), 1);
+	double tolerance = args.getDouble("tolerance", 0.0001);
+
+	InferenceModel model;
+	if (!model.load(modelPath) || model.getBranchCount() != 2) return 1;
+
+	// keras와는 float로 비교 (int8은 quant-eval)
+	model.setInt8(false);
+
+	vector<Case> cases;
+	ModelReferenceHeader header;
+	if (!loadReference(referencePath, cases, header) || cases.empty())
+	{
+		cout << "infer-parity : invalid reference " << referencePath << endl;
+		return 1;
+	}
+
+	if (header.spointSize != model.getInputSize(0) || header.imageSize != model.getInputSize(1) || (int)header.labelCount != model.getLabelCount())
+	{
+		cout << "infer-parity : reference shape != model (export again)" << endl;
+		return 1;
+	}
+
+	bool passed = true;
+	vector<vector<float>> simd, scalar;
+
+	if (InferenceKernels::hasAvx2())
+	{
+		InferenceKernels::setSimd(true);
+		double ms = runAll(model, cases, repeat, simd);
+
+		double diff = 0;
+		int agree = 0;
+		for (size_t i = 0; i < cases.size(); ++i)
+		{
+			diff = max(diff, maxDiff(simd[i], cases[i].output));
+			agree += argmax(simd[i]) == argmax(cases[i].output);
+		}
+
+		cout << "infer-parity ... avx2   " << ms << "ms/case, max diff " << diff << ", argmax " << agree << " / " << cases.size() << endl;
+		passed = passed && diff <= tolerance && agree == (int)cases.size();
+	}
+	else cout << "infer-parity ... avx2 not available (INFERENCE_AVX2 off or cpu)" << endl;
+
+	InferenceKernels::setSimd(false);
+	double ms = runAll(model, cases, repeat, scalar);
+
+	double diff = 0;
+	int agree = 0;
+	for (size_t i = 0; i < cases.size(); ++i)
+	{
+		diff = max(diff, maxDiff(scalar[i], cases[i].output));
+		agree += argmax(scalar[i]) == argmax(cases[i].output);
+	}
+
+	cout << "infer-parity ... scalar " << ms << "ms/case, max diff " << diff << ", argmax " << agree << " / " << cases.size() << endl;
+	passed = passed && diff <= tolerance && agree == (int)cases.size();
+
+	if (!simd.empty())
+	{
+		double between = 0;
+		for (size_t i = 0; i < cases.size(); ++i) between = max(between, maxDiff(simd[i], scalar[i]));
+		cout << "  avx2 vs scalar max diff " << between << endl;
+	}
+
+	InferenceKernels::setSimd(true);
+
+	cout << "infer-parity : " << (passed ? "pass" : "FAIL") << " (tolerance " << tolerance << ", " << cases.size() << " case)" << endl;
+
+	return passed ? 0 : 2;
+}
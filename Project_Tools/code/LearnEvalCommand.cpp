@@ -0,0 +1,150 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "ModelCases.h"
+
+namespace
+{
+	// top-1 정확도 (%), scores는 save / load 비교용
+	double evaluate(LearnedRecognizer& recognizer, vector<ModelCase*>& cases, vector<vector<float>>* scores = nullptr)
+	{
+		int correct = 0;
+		if (scores) scores->resize(cases.size());
+
+		for (size_t i = 0; i < cases.size(); ++i)
+		{
+			Recognition result;
+			if (!recognizer.recognize(cases[i]->spoint.data(), cases[i]->image.data(), result)) continue;
+
+			correct += result.top == cases[i]->label;
+			if (scores) (*scores)[i] = result.scores;
+		}
+		return cases.empty() ? 0 : 100.0 * correct / cases.size();
+	}
+}
+
+// learn-eval [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--worker=] [--shots=5] [--weight=0.7] [--synthetic=0] [--labels=10] [--noise=0.3]
+//
+// KINECT_MODE_LEARNING을 저장된 샘플로 흉내 : label마다 앞 --shots개를 하나씩 LearnedRecognizer::learn (--worker면 그 사람 샘플만, 새 signer)
+//   나머지 샘플로 모델만 vs shot 수마다 정확도, learn 한 번 시간 (임베딩 / 평균 갱신 + 저장), 저장 -> load 후 같은 score
+// 샘플이 없으면 --synthetic개 합성 입력 (--labels개 label 패턴 + --noise 잡음)
+int learnEvalCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string modelPath = args.get("model", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+	string worker = args.get("worker", "");
+	int shots = max(args.getInt("shots", 5), 1);
+	float weight = (float)args.getDouble("weight", NCM_WEIGHT);
+	int synthetic = max(args.getInt("synthetic", 0), 0);
+	float noise = (float)args.getDouble("noise", 0.3);
+	string temp = args.get("file", "learn-eval.ksnc");
+	vector<string> paths = args.positional;
+	if (paths.empty()) paths.push_back(PATH_DATA_FOLDER);
+
+	// 배운 것 없이 시작, 저장은 temp로
+	remove(temp.c_str());
+	LearnedRecognizer recognizer(modelPath, temp, weight);
+	InferenceModel& model = recognizer.getModel();
+	if (!recognizer.isReady())
+	{
+		cout << "learn-eval : cannot load " << modelPath << endl;
+		return 1;
+	}
+
+	vector<string> samples;
+	for (const string& p : paths) findSamples(p, samples);
+
+	vector<ModelCase> cases;
+	int skipped = loadModelCases(model, samples, worker, true, cases);
+	bool labeled = !cases.empty();
+	int labelCount = min(max(args.getInt("labels", 10), 2), model.getLabelCount());
+	if (cases.empty() && synthetic > 0) makeSyntheticCases(model, synthetic, labelCount, noise, 11, cases);
+
+	if (cases.empty())
+	{
+		cout << "learn-eval : no sample (" << samples.size() << " file, " << skipped << " skipped), --synthetic=N for generated input" << endl;
+		return 1;
+	}
+
+	// label마다 앞 shots개 배움, 나머지 평가
+	map<int, vector<ModelCase*>> learnSets;
+	vector<ModelCase*> evaluation;
+	for (ModelCase& c : cases)
+	{
+		vector<ModelCase*>& set = learnSets[c.label];
+		if ((int)set.size() < shots) set.push_back(&c);
+		else evaluation.push_back(&c);
+	}
+
+	if (evaluation.empty())
+	{
+		cout << "learn-eval : no sample left to evaluate (" << cases.size() << " sample, --shots=" << shots << ")" << endl;
+		return 1;
+	}
+
+	cout << "learn-eval ... " << model.getName() << ", " << (labeled ? "sample " : "synthetic ") << cases.size() << (worker.empty() ? "" : " of " + worker)
+		<< ", " << learnSets.size() << " label, evaluate " << evaluation.size() << ", weight " << weight << endl;
+	cout << "  model only : " << evaluate(recognizer, evaluation) << "%" << endl;
+
+	vector<double> inferMs, learnMs;
+	for (int shot = 0; shot < shots; ++shot)
+	{
+		int learned = 0;
+		for (auto& set : learnSets)
+		{
+			if (shot >= (int)set.second.size()) continue;
+
+			ModelCase* c = set.second[shot];
+			Recognition result;
+			if (!recognizer.learn(c->spoint.data(), c->image.data(), c->label, result)) continue;
+
+			inferMs.push_back(result.inferMs);
+			learnMs.push_back(result.learnMs);
+			++learned;
+		}
+		if (learned == 0) break;
+
+		cout << "  " << shot + 1 << " shot : " << evaluate(recognizer, evaluation) << "% (" << recognizer.getHead().getTotal() << " learned)" << endl;
+	}
+
+	double inferMean = 0, learnMean = 0, learnMax = 0;
+	for (double ms : inferMs) inferMean += ms;
+	for (double ms : learnMs)
+	{
+		learnMean += ms;
+		learnMax = max(learnMax, ms);
+	}
+	inferMean /= max(inferMs.size(), (size_t)1);
+	learnMean /= max(learnMs.size(), (size_t)1);
+
+	cout << "  learn : embed + score " << inferMean << "ms, update + save " << learnMean << "ms (max " << learnMax << "ms), "
+		<< recognizer.getHead().getLearnedCount() << " label x dim " << recognizer.getHead().getDim() << endl;
+
+	// 다음 실행 (predict mode)이 같은 결과를 내는지
+	vector<vector<float>> before, after;
+	evaluate(recognizer, evaluation, &before);
+	LearnedRecognizer loaded(modelPath, temp, weight);
+	evaluate(loaded, evaluation, &after);
+	remove(temp.c_str());
+
+	float diff = 0;
+	for (size_t i = 0; i < before.size(); ++i)
+	{
+		if (before[i].size() != after[i].size()) diff = 1;
+		for (size_t l = 0; l < before[i].size() && l < after[i].size(); ++l) diff = max(diff, fabs(before[i][l] - after[i][l]));
+	}
+	bool same = diff < 1e-5f;
+
+	cout << "  save / load : " << (same ? "same" : "DIFFERENT") << " (max diff " << diff << ")" << endl;
+
+	return same ? 0 : 2;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "SampleFinder.h"
+#include "Recognizer.h"
+
+// 모델 입력으로 준비된 샘플 하나 (ModelRecognizer::prepare), quant-eval / learn-eval
+struct ModelCase
+{
+	int label = -1;
+	string worker;
+	vector<float> spoint;
+	vector<float> image;
+};
+
+// labeledOnly : 모델 label 범위 밖 샘플은 건너뜀, worker가 있으면 그 사람 샘플만 (다른 사람은 건너뜀으로 세지 않음)
+inline int loadModelCases(InferenceModel& model, const vector<string>& samples, const string& worker, bool labeledOnly, vector<ModelCase>& cases)
+{
+	return forEachSample(samples, [&](SampleFile& sample)
+	{
+		const SampleHeader& header = sample.getHeader();
+
+		ModelCase c;
+		c.label = header.label;
+		c.worker = string(header.workerName, strnlen(header.workerName, sizeof(header.workerName)));
+		if (!worker.empty() && c.worker != worker) return true;
+		if (labeledOnly && (c.label < 0 || c.label >= model.getLabelCount())) return false;
+
+		if (!ModelRecognizer::prepare(model, sample, c.spoint, c.image)) return false;
+		cases.push_back(move(c));
+		return true;
+	});
+}
+
+// label마다 고정 입력 + noise 잡음 (ROI 0 ~ 255, spoint 0 ~ 1), 모델이 모르는 사람의 수어처럼 label 순서는 모델과 무관
+// labelCount가 0이면 case마다 다른 무작위 입력, label -1 (정확도 없이 비교만)
+inline void makeSyntheticCases(InferenceModel& model, int size, int labelCount, float noise, unsigned seed, vector<ModelCase>& cases)
+{
+	mt19937 random(seed);
+	uniform_real_distribution<float> u(0, 1);
+
+	auto randomize = [&](ModelCase& c)
+	{
+		c.spoint.resize(model.getInputSize(0));
+		c.image.resize(model.getInputSize(1));
+		for (float& v : c.spoint) v = u(random);
+		for (float& v : c.image) v = 255 * u(random);
+	};
+
+	cases.resize(size);
+	if (labelCount <= 0)
+	{
+		for (ModelCase& c : cases) randomize(c);
+		return;
+	}
+
+	vector<ModelCase> patterns(labelCount);
+	for (ModelCase& p : patterns) randomize(p);
+
+	normal_distribution<float> n(0, max(noise, 1e-6f));
+	for (int i = 0; i < size; ++i)
+	{
+		ModelCase& c = cases[i];
+		c.label = i % labelCount;
+		c.spoint = patterns[c.label].spoint;
+		c.image = patterns[c.label].image;
+		for (float& v : c.spoint) v = min(max(v + n(random), 0.0f), 1.0f);
+		for (float& v : c.image) v = min(max(v + 255 * n(random), 0.0f), 255.0f);
+	}
+}
@@ -0,0 +1,169 @@
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstring>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "PredictQueue.h"
+
+namespace
+{
+	// 느린 predictor 흉내 : REQUEST마다 inferMs 뒤에 RESULT
+	void runPredictor(int inferMs)
+	{
+		PredictChannel channel;
+		if (!channel.connect(5000))
+		{
+			cout << "predict-burst : predictor connect fail" << endl;
+			return;
+		}
+
+		PredictHello hello;
+		memset(&hello, 0, sizeof(hello));
+		hello.role = 1;
+		hello.labelCount = 2;
+		hello.timerFrequency = PredictChannel::frequency();
+		memcpy(hello.name, "predict-burst", sizeof("predict-burst"));
+		channel.send(PREDICT_MESSAGE_HELLO, &hello, sizeof(hello));
+
+		PredictChannel::Message message;
+		float scores[2] = { 0.9f, 0.1f };
+
+		while (channel.receive(message))
+		{
+			if (message.header.type == PREDICT_MESSAGE_BYE) break;
+
+			const PredictRequest* request = message.as<PredictRequest>();
+			if (message.header.type != PREDICT_MESSAGE_REQUEST || request == nullptr) continue;
+
+			PredictResult result;
+			memset(&result, 0, sizeof(result));
+			result.requestId = request->requestId;
+			result.sendTime = request->sendTime;
+			result.receiveTime = PredictChannel::now();
+
+			this_thread::sleep_for(chrono::milliseconds(inferMs));
+
+			result.top = 0;
+			result.confidence = scores[0];
+			result.labelCount = 2;
+			result.doneTime = PredictChannel::now();
+			channel.send(PREDICT_MESSAGE_RESULT, &result, sizeof(result), scores, sizeof(scores));
+		}
+
+		channel.close();
+	}
+
+	int parsePolicy(const string& name)
+	{
+		if (name == "coalesce-latest") return PREDICT_QUEUE_COALESCE_LATEST;
+		if (name == "block") return PREDICT_QUEUE_BLOCK;
+		if (name == "drop-oldest") return PREDICT_QUEUE_DROP_OLDEST;
+		return -1;
+	}
+}
+
+// predict-burst [--policy=drop-oldest|coalesce-latest|block] [--count=50] [--interval=20] [--infer=100]
+//               [--capacity=4] [--in-flight=2]
+//
+// PredictQueue 부하 확인 : 세그먼트를 --interval마다 push, 가짜 predictor는 요청마다 --infer ms
+// predictor보다 빨리 들어오면 policy대로 버리거나 합치거나 기다린다.
+// push = 결과 + dropped + coalesced 이어야 하고 (빠지는 요청 없음), 대기 / 전체 지연 분포를 출력한다.
+// Project_Kinect가 떠 있으면 pipe 이름이 겹쳐 실패한다.
+int predictBurstCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string policyName = args.get("policy", PredictQueue::getPolicyName(PREDICT_QUEUE_POLICY));
+	int policy = parsePolicy(policyName);
+	int count = max(args.getInt("count", 50), 1);
+	int interval = max(args.getInt("interval", 20), 0);
+	int inferMs = max(args.getInt("infer", 100), 0);
+	int capacity = args.getInt("capacity", PREDICT_QUEUE_CAPACITY);
+	int inFlight = args.getInt("in-flight", PREDICT_MAX_IN_FLIGHT);
+
+	if (policy < 0)
+	{
+		cout << "predict-burst : unknown policy " << policyName << endl;
+		return 1;
+	}
+
+	// queue(PredictLink)가 먼저 소멸해야 BYE를 받고 predictor가 끝난다
+	thread predictor;
+	bool accounted = [&]
+	{
+		SampleSaver saver;
+		PredictQueue queue(saver, policy, capacity, inFlight, PREDICT_BACKEND_PYTHON, PREDICT_GATE_NONE);
+		PredictLink& link = queue.getPredictLink();
+
+		predictor = thread(runPredictor, inferMs);
+
+		for (int i = 0; i < 50 && !link.isConnected(); ++i) this_thread::sleep_for(chrono::milliseconds(100));
+		if (!link.isConnected())
+		{
+			cout << "predict-burst : predictor not connected (Project_Kinect running?)" << endl;
+			return false;
+		}
+
+		vector<double> totals;
+		PredictLink::Completed result;
+		auto drain = [&]
+		{
+			while (link.poll(result)) totals.push_back(result.totalMs);
+		};
+
+		auto start = chrono::steady_clock::now();
+
+		for (int i = 0; i < count; ++i)
+		{
+			Sample sample;
+			sample.label = i;
+			sample.labelName = "burst " + to_string(i);
+			sample.segmentTime = PredictChannel::now();
+
+			queue.push(move(sample));
+			drain();
+
+			this_thread::sleep_for(chrono::milliseconds(interval));
+		}
+
+		// 남은 요청 결과까지
+		int expected = 0;
+		for (int wait = 0; wait < 100; ++wait)
+		{
+			drain();
+			expected = queue.getPushed() - queue.getDropped() - queue.getCoalesced();
+			if ((int)totals.size() + link.getFailed() >= expected && queue.getDepth() == 0) break;
+
+			this_thread::sleep_for(chrono::milliseconds(max(inferMs, 10)));
+		}
+
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		sort(totals.begin(), totals.end());
+		auto percentile = [&](double p) { return totals.empty() ? 0 : totals[min((size_t)(p * totals.size()), totals.size() - 1)]; };
+
+		cout << "predict-burst ... " << PredictQueue::getPolicyName(policy) << ", push " << queue.getPushed() << " every " << interval << "ms, infer " << inferMs << "ms"
+			<< ", capacity " << capacity << ", in-flight " << inFlight << endl;
+		cout << "  result " << totals.size() << ", dropped " << queue.getDropped() << ", coalesced " << queue.getCoalesced() << ", fail " << link.getFailed()
+			<< " (" << totals.size() / seconds << " result/s)" << endl;
+		cout << "  queue wait mean " << queue.getMeanWait() << "ms, max " << queue.getMaxWait() << "ms" << endl;
+		cout << "  total p50 " << percentile(0.5) << "ms, p99 " << percentile(0.99) << "ms, max " << percentile(1.0) << "ms" << endl;
+
+		if ((int)totals.size() != expected || link.getFailed() > 0)
+		{
+			cout << "predict-burst : " << expected - (int)totals.size() << " request unaccounted" << endl;
+			return false;
+		}
+		return true;
+	}();
+
+	predictor.join();
+
+	return accounted ? 0 : 2;
+}
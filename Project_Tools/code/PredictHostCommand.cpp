@@ -0,0 +1,256 @@
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstring>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "PredictChannel.h"
+#include "SampleRing.h"
+#include "BatchPredictServer.h"
+
+namespace
+{
+	// station 하나 (Project_Kinect 하나의 PredictLink pipe)
+	//   receiver : connect -> HELLO -> REQUEST마다 샘플을 BatchPredictServer에 submit (입력 준비도 이 thread)
+	//   sender : 받은 순서대로 결과를 기다려 RESULT
+	// 연결이 끊기면 sender를 멈추고 다시 connect
+	class Station
+	{
+	private:
+		struct Reply
+		{
+			PredictRequest request;
+			int64_t receiveTime;
+			future<Recognition> result;
+		};
+
+		string name;
+		bool local; // \\.\pipe\... : 같은 PC, 같은 QPC
+		BatchPredictServer& server;
+		atomic<int>& answered;
+		int count;
+
+		PredictChannel channel;
+		SampleRing ring; // 같은 PC station의 ringNumber 요청
+		atomic<int64_t> stationFrequency; // station HELLO, sender가 읽음
+
+		mutex lock;
+		condition_variable wake;
+		deque<Reply> replies;
+		bool connected = false;
+
+	public:
+		Station(const string& name, BatchPredictServer& server, atomic<int>& answered, int count)
+			: name(name), server(server), answered(answered), count(count)
+		{
+			local = name.compare(0, 4, "\\\\.\\") == 0;
+			stationFrequency = 0;
+		}
+
+		void run()
+		{
+			while (count <= 0 || answered < count)
+			{
+				if (!channel.connect(1000, name)) continue;
+
+				PredictHello hello;
+				memset(&hello, 0, sizeof(hello));
+				hello.role = 1;
+				hello.labelCount = server.getModel().getLabelCount();
+				hello.timerFrequency = PredictChannel::frequency();
+				memcpy(hello.name, "predict-host", sizeof("predict-host"));
+				channel.send(PREDICT_MESSAGE_HELLO, &hello, sizeof(hello));
+
+				cout << "predict-host ... connected " << name << endl;
+
+				{
+					lock_guard<mutex> guard(lock);
+					connected = true;
+				}
+				thread sender(&Station::send, this);
+
+				receive();
+
+				{
+					lock_guard<mutex> guard(lock);
+					connected = false;
+				}
+				wake.notify_all();
+				sender.join();
+
+				channel.close();
+				cout << "predict-host ... disconnected " << name << endl;
+			}
+		}
+
+	private:
+		void receive()
+		{
+			PredictChannel::Message message;
+			vector<uint8_t> buffer;
+			SampleRingSlot info;
+			SampleFile sample;
+
+			while (count <= 0 || answered < count)
+			{
+				if (!channel.receive(message, 200))
+				{
+					if (!channel.isConnected()) return;
+					continue;
+				}
+
+				if (message.header.type == PREDICT_MESSAGE_BYE) return;
+
+				if (message.header.type == PREDICT_MESSAGE_HELLO)
+				{
+					if (const PredictHello* hello = message.as<PredictHello>()) stationFrequency = hello->timerFrequency;
+					continue;
+				}
+
+				const PredictRequest* request = message.as<PredictRequest>();
+				if (message.header.type != PREDICT_MESSAGE_REQUEST || request == nullptr) continue;
+
+				Reply reply;
+				reply.request = *request;
+				reply.receiveTime = PredictChannel::now();
+
+				// inline은 정렬된 buffer로 복사, ring 번호는 같은 PC일 때만 읽힌다
+				bool loaded = false;
+				if (request->ringNumber < 0)
+				{
+					const uint8_t* payload = message.body.data() + sizeof(PredictRequest);
+					if (message.body.size() == sizeof(PredictRequest) + request->sampleSize)
+					{
+						buffer.assign(payload, payload + request->sampleSize);
+						loaded = true;
+					}
+				}
+				else
+				{
+					loaded = (ring.isOpen() || ring.open()) && ring.read(request->ringNumber, buffer, info);
+				}
+
+				if (loaded && sample.attach(buffer.data(), buffer.size())) reply.result = server.submit(sample);
+				else
+				{
+					promise<Recognition> failed;
+					failed.set_value(Recognition());
+					reply.result = failed.get_future();
+				}
+				sample.close();
+
+				{
+					lock_guard<mutex> guard(lock);
+					replies.push_back(move(reply));
+				}
+				wake.notify_all();
+			}
+		}
+
+		void send()
+		{
+			while (true)
+			{
+				Reply reply;
+				{
+					unique_lock<mutex> guard(lock);
+					wake.wait(guard, [&] { return !replies.empty() || !connected; });
+					if (replies.empty()) return; // 끊김
+
+					reply = move(replies.front());
+					replies.pop_front();
+				}
+
+				Recognition recognition = reply.result.get();
+				int64_t doneTime = PredictChannel::now();
+
+				PredictResult result;
+				memset(&result, 0, sizeof(result));
+				result.requestId = reply.request.requestId;
+				result.sendTime = reply.request.sendTime;
+				result.top = recognition.top;
+				result.confidence = recognition.confidence;
+				result.labelCount = (uint32_t)recognition.scores.size();
+
+				// 다른 PC는 QPC가 달라서 station 시계로 옮긴다 : 받은 시각 = 보낸 시각 (transfer 0), infer만 station 주기로
+				if (local)
+				{
+					result.receiveTime = reply.receiveTime;
+					result.doneTime = doneTime;
+				}
+				else
+				{
+					double seconds = (double)(doneTime - reply.receiveTime) / PredictChannel::frequency();
+					result.receiveTime = reply.request.sendTime;
+					result.doneTime = reply.request.sendTime + (int64_t)(seconds * stationFrequency);
+				}
+
+				channel.send(PREDICT_MESSAGE_RESULT, &result, sizeof(result), recognition.scores.data(), result.labelCount * sizeof(float));
+
+				int n = ++answered;
+				cout << name << " #" << reply.request.requestId << " : " << recognition.top << " " << recognition.confidence * 100
+					<< "% (prepare " << recognition.prepareMs << "ms, batch wait + infer " << recognition.inferMs << "ms)" << endl;
+
+				if (count > 0 && n >= count)
+				{
+					channel.cancel(); // receiver를 깨움
+					return;
+				}
+			}
+		}
+	};
+}
+
+// predict-host [pipe]... [--model=data/models/M1.kslm] [--batch=8] [--wait=5] [--count=0]
+//
+// 여러 station (Project_Kinect)이 predictor PC 하나를 같이 쓴다 : do_Predict.py 대신 station마다 pipe에 붙어서
+// 모든 station의 REQUEST를 BatchPredictServer 하나로 batch 추론하고 RESULT로 답한다 (PredictProtocol.h 그대로).
+//   pipe : station PredictLink의 pipe, 다른 PC는 \\<pc>\pipe\KSL_Predict (station은 PREDICT_PIPE_REMOTE 1, 샘플 inline)
+//          없으면 같은 PC의 \\.\pipe\KSL_Predict 하나 (ring 번호 요청도 읽음)
+//   station은 PREDICT_BACKEND_PYTHON : PredictQueue / cascade gate는 station에 그대로
+//   --count : 결과 수만큼 답하고 끝, 0이면 계속 (ctrl+c)
+// 끝나면 BatchPredictServer가 요청 수, 평균 batch 크기, 대기 / 추론 시간을 출력한다.
+int predictHostCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string path = args.get("model", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+	int maxBatch = max(args.getInt("batch", PREDICT_BATCH_MAX), 1);
+	double waitMs = max(args.getDouble("wait", PREDICT_BATCH_WAIT_MS), 0.0);
+	int count = max(args.getInt("count", 0), 0);
+
+	vector<string> pipes = args.positional;
+	if (pipes.empty()) pipes.push_back(PREDICT_PIPE_NAME);
+
+	BatchPredictServer server(path, maxBatch, waitMs);
+	if (!server.isReady())
+	{
+		cout << "predict-host : cannot load " << path << endl;
+		return 1;
+	}
+
+	cout << "predict-host ... " << server.getName() << ", " << pipes.size() << " station, batch " << maxBatch << ", wait " << waitMs << "ms"
+		<< (count > 0 ? ", " + to_string(count) + " result" : string(" (ctrl+c)")) << endl;
+
+	atomic<int> answered(0);
+	vector<unique_ptr<Station>> stations;
+	vector<thread> threads;
+	for (const string& pipe : pipes)
+	{
+		stations.emplace_back(new Station(pipe, server, answered, count));
+		threads.emplace_back(&Station::run, stations.back().get());
+	}
+	for (thread& t : threads) t.join();
+
+	return 0;
+}
@@ -0,0 +1,199 @@
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <string>
+#include <cstring>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "PredictChannel.h"
+
+namespace
+{
+	// 가짜 predictor의 답 : requestId로 정해지는 label, server가 그대로 맞는지 확인
+	int expectedTop(uint64_t requestId, int labels)
+	{
+		return (int)(requestId * 7 % labels);
+	}
+
+	uint8_t payloadByte(uint64_t requestId, uint32_t i)
+	{
+		return (uint8_t)(requestId * 31 + i);
+	}
+
+	// do_Predict.py 대신 : REQUEST -> RESULT, inline 샘플이면 내용 확인
+	void runPredictor(int labels)
+	{
+		PredictChannel channel;
+		if (!channel.connect(5000))
+		{
+			cout << "proto-loopback : predictor connect fail" << endl;
+			return;
+		}
+
+		PredictHello hello;
+		memset(&hello, 0, sizeof(hello));
+		hello.role = 1;
+		hello.labelCount = labels;
+		hello.timerFrequency = PredictChannel::frequency();
+		memcpy(hello.name, "proto-loopback", sizeof("proto-loopback"));
+		channel.send(PREDICT_MESSAGE_HELLO, &hello, sizeof(hello));
+
+		PredictChannel::Message message;
+		vector<float> scores(labels);
+
+		while (channel.receive(message))
+		{
+			if (message.header.type == PREDICT_MESSAGE_BYE) break;
+			if (message.header.type != PREDICT_MESSAGE_REQUEST) continue;
+
+			const PredictRequest* request = message.as<PredictRequest>();
+			if (request == nullptr) continue;
+
+			PredictResult result;
+			memset(&result, 0, sizeof(result));
+			result.requestId = request->requestId;
+			result.sendTime = request->sendTime;
+			result.receiveTime = PredictChannel::now();
+			result.top = expectedTop(request->requestId, labels);
+			result.labelCount = labels;
+
+			// inline 샘플이 깨졌으면 실패(-1)로 답한다
+			if (request->ringNumber < 0)
+			{
+				const uint8_t* payload = message.body.data() + sizeof(PredictRequest);
+				bool valid = message.body.size() == sizeof(PredictRequest) + request->sampleSize;
+				for (uint32_t i = 0; valid && i < request->sampleSize; ++i) valid = payload[i] == payloadByte(request->requestId, i);
+
+				if (!valid) result.top = -1;
+			}
+
+			for (int i = 0; i < labels; ++i) scores[i] = (i == result.top) ? 0.9f : 0.1f / (labels - 1);
+			result.confidence = result.top >= 0 ? scores[result.top] : 0;
+			result.doneTime = PredictChannel::now();
+
+			channel.send(PREDICT_MESSAGE_RESULT, &result, sizeof(result), scores.data(), labels * sizeof(float));
+		}
+
+		channel.close();
+	}
+}
+
+// proto-loopback [--count=1000] [--window=4] [--inline=0] [--labels=10]
+//
+// PredictProtocol 확인 : 같은 process 안에서 server(Project_Kinect 역할)와 가짜 predictor가 실제 pipe로 주고받는다
+//   --window : 결과를 기다리지 않고 동시에 보내 두는 요청 수 (pipelining)
+//   --inline : 요청마다 byte 수만큼 샘플을 붙여 보냄 (0 : ring 번호만)
+// 결과마다 requestId, label, score 개수를 확인하고 round trip 시간 분포를 출력한다.
+// Project_Kinect가 떠 있으면 pipe 이름이 겹쳐 실패한다.
+int protoLoopbackCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	int count = args.getInt("count", 1000);
+	int window = max(args.getInt("window", 4), 1);
+	uint32_t inlineSize = (uint32_t)max(args.getInt("inline", 0), 0);
+	int labels = min(max(args.getInt("labels", 10), 2), PREDICT_LABEL_MAX);
+
+	PredictChannel server;
+	thread predictor;
+
+	// accept 대기 중에 predictor가 붙는다
+	predictor = thread(runPredictor, labels);
+	if (!server.accept(5000))
+	{
+		cout << "proto-loopback : accept fail (Project_Kinect running?)" << endl;
+		predictor.join();
+		return 1;
+	}
+
+	PredictHello hello;
+	memset(&hello, 0, sizeof(hello));
+	hello.timerFrequency = PredictChannel::frequency();
+	memcpy(hello.name, "proto-loopback", sizeof("proto-loopback"));
+	server.send(PREDICT_MESSAGE_HELLO, &hello, sizeof(hello));
+
+	vector<uint8_t> payload(inlineSize);
+	map<uint64_t, int64_t> pending; // requestId -> sendTime
+	vector<double> rtts;
+	int64_t frequency = PredictChannel::frequency();
+	uint64_t nextId = 1;
+	int mismatch = 0;
+	int helloCount = 0;
+
+	auto start = chrono::steady_clock::now();
+
+	while ((int)rtts.size() + mismatch < count && server.isConnected())
+	{
+		// window만큼 채워서 보냄
+		while ((int)pending.size() < window && (int)(nextId - 1) < count)
+		{
+			PredictRequest request;
+			memset(&request, 0, sizeof(request));
+			request.requestId = nextId++;
+			request.segmentTime = PredictChannel::now();
+			request.sendTime = request.segmentTime;
+			request.ringNumber = inlineSize > 0 ? -1 : (int64_t)request.requestId;
+			request.sampleSize = inlineSize;
+
+			for (uint32_t i = 0; i < inlineSize; ++i) payload[i] = payloadByte(request.requestId, i);
+
+			pending[request.requestId] = request.sendTime;
+			server.send(PREDICT_MESSAGE_REQUEST, &request, sizeof(request), payload.data(), inlineSize);
+		}
+
+		PredictChannel::Message message;
+		if (!server.receive(message, 5000))
+		{
+			cout << "proto-loopback : receive timeout / disconnected, pending " << pending.size() << endl;
+			break;
+		}
+
+		if (message.header.type == PREDICT_MESSAGE_HELLO)
+		{
+			++helloCount;
+			continue;
+		}
+
+		const PredictResult* result = message.as<PredictResult>();
+		if (message.header.type != PREDICT_MESSAGE_RESULT || result == nullptr) continue;
+
+		int64_t now = PredictChannel::now();
+		auto it = pending.find(result->requestId);
+
+		bool valid = it != pending.end()
+			&& result->sendTime == it->second
+			&& result->top == expectedTop(result->requestId, labels)
+			&& result->labelCount == (uint32_t)labels
+			&& message.body.size() == sizeof(PredictResult) + labels * sizeof(float);
+
+		if (valid) rtts.push_back((now - it->second) * 1000.0 / frequency);
+		else
+		{
+			++mismatch;
+			cout << "proto-loopback : mismatch result #" << result->requestId << " top " << result->top << endl;
+		}
+
+		if (it != pending.end()) pending.erase(it);
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	server.send(PREDICT_MESSAGE_BYE, nullptr, 0);
+	predictor.join();
+	server.close();
+
+	sort(rtts.begin(), rtts.end());
+	auto percentile = [&](double p) { return rtts.empty() ? 0 : rtts[min((size_t)(p * rtts.size()), rtts.size() - 1)]; };
+
+	cout << "proto-loopback ... " << rtts.size() << "/" << count << " result, mismatch " << mismatch
+		<< ", hello " << helloCount << ", window " << window << ", inline " << inlineSize << " byte" << endl;
+	cout << "  round trip p50 " << percentile(0.5) << "ms, p99 " << percentile(0.99) << "ms, max " << percentile(1.0)
+		<< "ms, " << (seconds > 0 ? rtts.size() / seconds : 0) << " request/s" << endl;
+
+	return ((int)rtts.size() == count && mismatch == 0 && helloCount == 1) ? 0 : 2;
+}
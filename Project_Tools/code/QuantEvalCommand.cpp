@@ -0,0 +1,228 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "ModelCases.h"
+
+namespace
+{
+	// 섞은 뒤 label마다 돌아가며 calibrate개 (샘플은 label 순서로 찾아지므로 앞에서 자르면 일부 label만 들어간다), 나머지는 평가
+	// 전부 calibration이면 평가도 같은 샘플로
+	void splitByLabel(vector<ModelCase>& cases, int calibrate, unsigned seed, vector<ModelCase>& calibration, vector<ModelCase>& evaluation)
+	{
+		mt19937 random(seed);
+		shuffle(cases.begin(), cases.end(), random);
+
+		map<int, vector<size_t>> byLabel;
+		for (size_t i = 0; i < cases.size(); ++i) byLabel[cases[i].label].push_back(i);
+
+		vector<bool> chosen(cases.size(), false);
+		int picked = 0;
+		for (size_t round = 0; picked < calibrate; ++round)
+		{
+			for (auto& label : byLabel)
+			{
+				if (round < label.second.size() && picked < calibrate)
+				{
+					chosen[label.second[round]] = true;
+					++picked;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < cases.size(); ++i) (chosen[i] ? calibration : evaluation).push_back(move(cases[i]));
+		if (evaluation.empty()) evaluation = calibration;
+	}
+
+	int argmax(const vector<float>& scores)
+	{
+		return (int)(max_element(scores.begin(), scores.end()) - scores.begin());
+	}
+
+	void forwardAll(InferenceModel& model, vector<ModelCase>& cases, vector<vector<float>>& outputs)
+	{
+		outputs.resize(cases.size());
+		for (size_t i = 0; i < cases.size(); ++i) model.forward({ cases[i].spoint.data(), cases[i].image.data() }, outputs[i]);
+	}
+
+	// case당 branch 평균 ms
+	double timeBranch(InferenceModel& model, vector<ModelCase>& cases, int branch, int repeat)
+	{
+		vector<float> scores;
+		double sum = 0;
+		for (int r = 0; r < repeat; ++r)
+		{
+			for (ModelCase& c : cases)
+			{
+				model.forward({ c.spoint.data(), c.image.data() }, scores);
+				sum += model.getBranchMs(branch);
+			}
+		}
+		return sum / max((int)cases.size() * repeat, 1);
+	}
+
+	double maxDiff(const vector<vector<float>>& a, const vector<vector<float>>& b)
+	{
+		double diff = 0;
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			for (size_t l = 0; l < a[i].size(); ++l) diff = max(diff, (double)fabs(a[i][l] - b[i][l]));
+		}
+		return diff;
+	}
+}
+
+// quant-eval [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--calibrate=32] [--seed=7] [--branch=1] [--out=모델 옆 .kslq] [--repeat=3] [--synthetic=0]
+//
+// 저장된 샘플에서 label마다 고르게 (--seed로 섞어서) --calibrate개를 float로 돌려 conv 입력 범위를 모으고 --branch (기본 1 : ROI) conv를 int8로 (InferenceModel::quantize)
+// 결과는 --out에 (INFERENCE_INT8이면 다음 load부터 사용)
+// 나머지 샘플로 float vs int8 : top-1 일치, label 정확도, score 최대 차이
+// branch 시간 (샘플당, --repeat번 평균) : float, int8 scalar / avx2 / vnni, int8 셋의 결과는 같아야 함 (int8 conv만 바꾸고 float kernel은 그대로)
+// 샘플이 없으면 --synthetic개 무작위 입력으로 (정확도 없이 일치율만)
+int quantEvalCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string path = args.get("model", string(PATH_DATA_FOLDER) + PATH_MODEL_FOLDER + MODEL_FILE_NAME);
+	string out = args.get("out", InferenceModel::getQuantizationPath(path));
+	int calibrateCount = max(args.getInt("calibrate", 32), 1);
+	unsigned seed = (unsigned)args.getInt("seed", 7);
+	int branch = args.getInt("branch", 1);
+	int repeat = max(args.getInt("repeat", 3), 1);
+	int synthetic = max(args.getInt("synthetic", 0), 0);
+	vector<string> paths = args.positional;
+	if (paths.empty()) paths.push_back(PATH_DATA_FOLDER);
+
+	InferenceModel model;
+	if (!model.load(path) || model.getBranchCount() != 2)
+	{
+		cout << "quant-eval : cannot load " << path << endl;
+		return 1;
+	}
+
+	// 이미 있던 .kslq는 무시하고 float부터
+	model.clearQuantization();
+
+	vector<string> samples;
+	for (const string& p : paths) findSamples(p, samples);
+
+	vector<ModelCase> cases;
+	int skipped = loadModelCases(model, samples, "", false, cases);
+	bool labeled = !cases.empty();
+	if (cases.empty() && synthetic > 0) makeSyntheticCases(model, synthetic, 0, 0, 7, cases);
+
+	if (cases.empty())
+	{
+		cout << "quant-eval : no sample (" << samples.size() << " file, " << skipped << " skipped), --synthetic=N for random input" << endl;
+		return 1;
+	}
+
+	int caseCount = (int)cases.size();
+	int calibrate = min(calibrateCount, caseCount);
+	vector<ModelCase> calibration, evaluation;
+	splitByLabel(cases, calibrate, seed, calibration, evaluation);
+
+	vector<vector<float>> floats, int8s;
+	model.setCalibrating(true);
+	forwardAll(model, calibration, floats);
+	model.setCalibrating(false);
+
+	int quantized = model.quantize(branch);
+	if (quantized == 0)
+	{
+		cout << "quant-eval : no conv with non-negative input in branch " << branch << endl;
+		return 1;
+	}
+
+	cout << "quant-eval ... " << model.getName() << ", " << (labeled ? "sample " : "synthetic ") << caseCount << " (calibrate " << calibrate
+		<< ", evaluate " << evaluation.size() << "), int8 conv " << quantized << endl;
+
+	model.setInt8(false);
+	forwardAll(model, evaluation, floats);
+	model.setInt8(true);
+	forwardAll(model, evaluation, int8s);
+
+	int agree = 0, floatCorrect = 0, int8Correct = 0, labels = 0;
+	double meanDiff = 0;
+	for (size_t i = 0; i < evaluation.size(); ++i)
+	{
+		int floatTop = argmax(floats[i]);
+		int int8Top = argmax(int8s[i]);
+		agree += floatTop == int8Top;
+
+		for (size_t l = 0; l < floats[i].size(); ++l) meanDiff += fabs(floats[i][l] - int8s[i][l]);
+
+		if (evaluation[i].label >= 0 && evaluation[i].label < model.getLabelCount())
+		{
+			++labels;
+			floatCorrect += floatTop == evaluation[i].label;
+			int8Correct += int8Top == evaluation[i].label;
+		}
+	}
+	meanDiff /= max(evaluation.size() * model.getLabelCount(), (size_t)1);
+
+	cout << "  top-1 agree " << agree << " / " << evaluation.size() << ", score diff max " << maxDiff(floats, int8s) << " mean " << meanDiff << endl;
+	if (labels > 0)
+	{
+		cout << "  accuracy float " << 100.0 * floatCorrect / labels << "%, int8 " << 100.0 * int8Correct / labels
+			<< "% (" << labels << " labeled, delta " << 100.0 * (int8Correct - floatCorrect) / labels << "%)" << endl;
+	}
+
+	// int8 경로 셋은 정수 합이 같다, float kernel은 그대로 두므로 출력도 bit 단위로 같아야 함
+	vector<vector<float>> check;
+	bool same = true;
+
+	InferenceKernels::setVnni(false);
+	forwardAll(model, evaluation, check);
+	same = same && maxDiff(check, int8s) == 0;
+
+	InferenceKernels::setInt8Simd(false);
+	forwardAll(model, evaluation, check);
+	same = same && maxDiff(check, int8s) == 0;
+	InferenceKernels::setInt8Simd(true);
+	InferenceKernels::setVnni(true);
+
+	// branch 시간
+	model.setInt8(false);
+	double floatMs = timeBranch(model, evaluation, branch, repeat);
+	model.setInt8(true);
+
+	cout << "  branch " << branch << " : float " << floatMs << "ms";
+
+	InferenceKernels::setInt8Simd(false);
+	double scalarMs = timeBranch(model, evaluation, branch, repeat);
+	InferenceKernels::setInt8Simd(true);
+	cout << ", int8 scalar " << scalarMs << "ms";
+
+	if (InferenceKernels::isInt8Simd())
+	{
+		InferenceKernels::setVnni(false);
+		double avx2Ms = timeBranch(model, evaluation, branch, repeat);
+		InferenceKernels::setVnni(true);
+		cout << ", avx2 " << avx2Ms << "ms (x" << floatMs / avx2Ms << ")";
+	}
+	if (InferenceKernels::isVnni())
+	{
+		double vnniMs = timeBranch(model, evaluation, branch, repeat);
+		cout << ", vnni " << vnniMs << "ms (x" << floatMs / vnniMs << ")";
+	}
+	cout << endl;
+	cout << "  int8 scalar / avx2 / vnni " << (same ? "same" : "DIFFERENT") << endl;
+
+	if (!model.saveQuantization(out))
+	{
+		cout << "quant-eval : cannot write " << out << endl;
+		return 1;
+	}
+	cout << "  -> " << out << endl;
+
+	return same ? 0 : 2;
+}
@@ -0,0 +1,213 @@
+#include <Windows.h> // LoadLibraryA, GetProcAddress
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "common/defines.hpp"
+#include "SampleFormat.h" // SAMPLE_SPOINT_WIDTH
+#include "kslReader.h" // 함수 모양만, dll은 LoadLibrary로 (sampleReader.py와 같은 경로)
+
+namespace
+{
+	template <class F>
+	bool bind(HMODULE dll, const char* name, F& f)
+	{
+		f = reinterpret_cast<F>(GetProcAddress(dll, name));
+		if (f == nullptr) cout << "reader-check : no export " << name << endl;
+
+		return f != nullptr;
+	}
+
+	struct ReaderApi
+	{
+		HMODULE dll = nullptr;
+		decltype(&ksl_version) version = nullptr;
+		decltype(&ksl_open) open = nullptr;
+		decltype(&ksl_close) close = nullptr;
+		decltype(&ksl_size) size = nullptr;
+		decltype(&ksl_labels) labels = nullptr;
+		decltype(&ksl_read_batch) readBatch = nullptr;
+		decltype(&ksl_prefetch_start) prefetchStart = nullptr;
+		decltype(&ksl_prefetch_next) prefetchNext = nullptr;
+		decltype(&ksl_last_error) lastError = nullptr;
+
+		~ReaderApi()
+		{
+			if (dll != nullptr) FreeLibrary(dll);
+		}
+
+		bool load(const string& path)
+		{
+			dll = LoadLibraryA(path.c_str());
+			if (dll == nullptr)
+			{
+				cout << "reader-check : cannot load " << path << endl;
+				return false;
+			}
+
+			return bind(dll, "ksl_version", version) && bind(dll, "ksl_open", open) && bind(dll, "ksl_close", close)
+				&& bind(dll, "ksl_size", size) && bind(dll, "ksl_labels", labels) && bind(dll, "ksl_read_batch", readBatch)
+				&& bind(dll, "ksl_prefetch_start", prefetchStart) && bind(dll, "ksl_prefetch_next", prefetchNext)
+				&& bind(dll, "ksl_last_error", lastError);
+		}
+	};
+
+	struct Batch
+	{
+		vector<float> spoints;
+		vector<uint8_t> images;
+		vector<int32_t> labels;
+
+		bool operator==(const Batch& other) const
+		{
+			return spoints == other.spoints && images == other.images && labels == other.labels;
+		}
+	};
+
+	int failures = 0;
+
+	void check(bool ok, const string& what)
+	{
+		cout << "  " << (ok ? "ok   " : "FAIL ") << what << endl;
+		failures += ok ? 0 : 1;
+	}
+}
+
+// reader-check [root] [--dll=../../Project_Reader/program/Project_Reader_x64_Release.dll] [--frame-size=150] [--image-frame-size=35] [--image-scale=80] [--float=1] [--batch=8]
+//
+// Project_Reader dll을 C ABI (kslReader.h)로 불러서 확인
+//   ksl_read_batch 두 번이 같은지, label이 ksl_labels와 같은지, 범위 밖 index / null 인자는 실패
+//   shuffle 없는 prefetch가 ksl_read_batch와 같은 batch인지
+//   shuffle prefetch 한 epoch이 모든 샘플을 한 번씩 (label 분포), 같은 seed면 같은 순서인지
+int readerCheckCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	string root = args.positional.empty() ? string(PATH_DATA_FOLDER) : args.positional[0];
+	string dllPath = args.get("dll", "../../Project_Reader/program/Project_Reader_x64_Release.dll");
+	int frameSize = args.getInt("frame-size", FRAME_STANDARD_SIZE);
+	int imageFrameSize = args.getInt("image-frame-size", IMAEG_STANDARD_FRAME_SIZE);
+	int imageScale = args.getInt("image-scale", IMAGE_WIDTH);
+	int imageFloat = args.getInt("float", 1) != 0 ? 1 : 0;
+	int batchSize = max(args.getInt("batch", 8), 1);
+
+	ReaderApi api;
+	if (!api.load(dllPath)) return 1;
+
+	if (api.version() != KSL_READER_VERSION)
+	{
+		cout << "reader-check : version " << api.version() << ", expected " << KSL_READER_VERSION << endl;
+		return 1;
+	}
+
+	ksl_dataset* dataset = api.open(root.c_str(), frameSize, imageFrameSize, imageScale, imageFloat);
+	if (dataset == nullptr)
+	{
+		cout << "reader-check : ksl_open " << root << " : " << api.lastError() << endl;
+		return 1;
+	}
+
+	int64_t size = api.size(dataset);
+	vector<int32_t> labels((size_t)size);
+	api.labels(dataset, labels.data(), size);
+
+	size_t spointCount = (size_t)frameSize * SAMPLE_SPOINT_WIDTH;
+	size_t imageBytes = (size_t)imageFrameSize * imageScale * imageScale * 2 * (imageFloat ? sizeof(float) : 1);
+	batchSize = (int)min<int64_t>(batchSize, size);
+
+	auto allocate = [&](Batch& batch)
+	{
+		batch.spoints.assign(spointCount * batchSize, 0.0f);
+		batch.images.assign(imageBytes * batchSize, 0);
+		batch.labels.assign(batchSize, 0);
+	};
+	auto read = [&](const vector<int64_t>& indices, Batch& batch)
+	{
+		allocate(batch);
+		return api.readBatch(dataset, indices.data(), (int)indices.size(), batch.spoints.data(), batch.images.data(), batch.labels.data());
+	};
+
+	cout << "reader-check ... " << root << ", " << size << " sample, batch " << batchSize << ", image " << imageScale
+		<< (imageFloat ? " float" : " uint8") << endl;
+
+	// read_batch
+	vector<int64_t> first(batchSize);
+	for (int i = 0; i < batchSize; ++i) first[i] = i;
+
+	Batch a, b;
+	auto start = chrono::steady_clock::now();
+	int readCount = read(first, a);
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	read(first, b);
+
+	check(readCount == batchSize, "read_batch " + to_string(readCount) + "/" + to_string(batchSize) + " sample, " + to_string(ms) + "ms");
+	check(a == b, "read_batch same result twice");
+	check(equal(a.labels.begin(), a.labels.end(), labels.begin()), "read_batch labels == ksl_labels");
+
+	vector<int64_t> invalid = { size };
+	Batch c;
+	check(read(invalid, c) == 0 && c.labels[0] == -1, "read_batch out of range index -> label -1");
+	int nullCount = api.readBatch(dataset, first.data(), batchSize, nullptr, nullptr, nullptr);
+	string error = api.lastError();
+	check(nullCount == 0 && !error.empty(), "read_batch null buffer -> 0 (" + error + ")");
+
+	// prefetch, shuffle 없음 : index 순서 그대로
+	const float* spoints;
+	const void* images;
+	const int32_t* batchLabels;
+	int epoch;
+
+	bool same = api.prefetchStart(dataset, batchSize, 3, 0, 0) != 0;
+	for (int n = 0; n < 3 && same; ++n)
+	{
+		vector<int64_t> indices(batchSize);
+		for (int i = 0; i < batchSize; ++i) indices[i] = ((int64_t)n * batchSize + i) % size;
+
+		Batch expected;
+		read(indices, expected);
+
+		same = api.prefetchNext(dataset, &spoints, &images, &batchLabels, &epoch) == batchSize
+			&& memcmp(spoints, expected.spoints.data(), expected.spoints.size() * sizeof(float)) == 0
+			&& memcmp(images, expected.images.data(), expected.images.size()) == 0
+			&& memcmp(batchLabels, expected.labels.data(), expected.labels.size() * sizeof(int32_t)) == 0;
+	}
+	check(same, "prefetch without shuffle == read_batch");
+
+	// prefetch, shuffle : 첫 epoch의 앞 size개가 전체 label 분포와 같음, 같은 seed면 같은 순서
+	auto epochLabels = [&](uint32_t seed, vector<int32_t>& order)
+	{
+		order.clear();
+		if (!api.prefetchStart(dataset, batchSize, 3, 1, seed)) return;
+
+		while ((int64_t)order.size() < size)
+		{
+			if (api.prefetchNext(dataset, nullptr, nullptr, &batchLabels, &epoch) != batchSize || epoch != 0) break;
+			order.insert(order.end(), batchLabels, batchLabels + batchSize);
+		}
+		order.resize((size_t)min<int64_t>(order.size(), size));
+	};
+
+	vector<int32_t> order1, order2;
+	epochLabels(7, order1);
+	epochLabels(7, order2);
+
+	map<int, int> expected, actual;
+	for (int32_t l : labels) ++expected[l];
+	for (int32_t l : order1) ++actual[l];
+
+	check((int64_t)order1.size() == size && expected == actual, "shuffle epoch covers every sample once (label counts)");
+	check(order1 == order2, "shuffle same seed -> same order");
+
+	api.close(dataset);
+
+	cout << (failures == 0 ? "reader-check : ok" : "reader-check : " + to_string(failures) + " failed") << endl;
+
+	return failures == 0 ? 0 : 2;
+}
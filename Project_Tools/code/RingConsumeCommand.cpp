@@ -0,0 +1,116 @@
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SampleRing.h"
+#include "SampleFile.h"
+
+// ring-consume [--count=0] [--timeout=1000] [--loopback=sample.ksl] [--interval=100]
+//
+// do_Predict.py 대신 SampleRing을 읽는 consumer (PREDICT_HANDOFF_RING 확인용)
+//   Project_Kinect predict 모드를 켜 두고 실행하면 수어 하나마다 샘플 정보와 지연 출력
+//   --loopback : Kinect 없이 같은 process의 producer thread가 sample.ksl을 --interval마다 발행
+// 지연 = producer publish ~ consumer 복사 완료, parse = SampleFile::attach + SPOINT / IMAGE 접근
+int ringConsumeCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	int count = args.getInt("count", 0); // 0 : 계속
+	int timeout = args.getInt("timeout", 1000);
+	string loopback = args.get("loopback", "");
+	int interval = args.getInt("interval", 100);
+
+	vector<uint8_t> sample;
+	if (!loopback.empty())
+	{
+		ifstream file(loopback.c_str(), ios::in | ios::binary);
+		if (!file.is_open())
+		{
+			cout << "ring-consume : cannot open " << loopback << endl;
+			return 1;
+		}
+		sample.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+		if (count <= 0) count = 100;
+	}
+
+	SampleRing ring;
+	if (!ring.open()) return 1;
+
+	// producer는 consumer를 연 다음에 (open 이전 샘플은 지난 것으로 본다)
+	atomic<bool> running(true);
+	thread producer;
+	if (!sample.empty())
+	{
+		producer = thread([&]
+		{
+			SampleRing writer;
+			if (!writer.create()) return;
+
+			int label = reinterpret_cast<const SampleHeader*>(sample.data())->label;
+			for (int i = 0; i < count && running; ++i)
+			{
+				writer.publish(sample.data(), sample.size(), label);
+				this_thread::sleep_for(chrono::milliseconds(interval));
+			}
+		});
+	}
+
+	cout << "Waiting predict sample ... " << (count > 0 ? to_string(count) : string("(ctrl+c)")) << endl;
+
+	vector<uint8_t> buffer;
+	SampleRingSlot info;
+	SampleFile file;
+	int received = 0;
+	int invalid = 0;
+	int timeouts = 0;
+	double latencySum = 0, latencyMax = 0;
+
+	while (count <= 0 || received < count)
+	{
+		if (!ring.wait(buffer, info, (DWORD)timeout))
+		{
+			// loopback producer가 끝났는데 못 받은 샘플 : 더 기다리지 않음
+			if (!sample.empty() && ++timeouts >= 3) break;
+			continue;
+		}
+
+		double latency = ring.getLatency(info);
+		auto start = chrono::steady_clock::now();
+
+		bool valid = file.attach(buffer.data(), buffer.size());
+		int frames = valid ? file.getFrameSize() : 0;
+		int images = valid ? file.getImageFrameSize() : 0;
+		valid = valid && file.getSPoints() != nullptr;
+
+		double parse = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+		file.close();
+
+		++received;
+		if (!valid) ++invalid;
+		latencySum += latency;
+		latencyMax = max(latencyMax, latency);
+
+		cout << "[" << info.number << "] label " << info.label << (valid ? "" : " invalid")
+			<< " frame " << frames << " image " << images
+			<< " " << info.size << " byte, latency " << latency << "ms, parse " << parse << "ms" << endl;
+	}
+
+	running = false;
+	if (producer.joinable()) producer.join();
+
+	cout << "ring-consume ... " << received << " sample, invalid " << invalid
+		<< ", skipped " << ring.getSkipped()
+		<< ", latency avg " << (received > 0 ? latencySum / received : 0) << "ms max " << latencyMax << "ms" << endl;
+
+	return (invalid > 0 || received == 0) ? 2 : 0;
+}
@@ -0,0 +1,177 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h"
+#include "SampleFinder.h"
+#include "RoiCodec.h"
+
+namespace
+{
+	typedef vector<cv::Mat> Sequence; // 한 손 ROI 프레임들
+
+	// 샘플마다 손 2개, 저장된 scale 하나 (IMAGE 우선, 없으면 IMAGE_CODED를 decode)
+	bool addSample(SampleFile& sample, vector<Sequence>& sequences)
+	{
+		const SampleSection* s = sample.findSection(SAMPLE_SECTION_IMAGE);
+		if (s == nullptr) s = sample.findSection(SAMPLE_SECTION_IMAGE_CODED);
+		if (s == nullptr) return false;
+
+		for (int hand = 0; hand < 2; ++hand)
+		{
+			Sequence frames;
+			if (!sample.getImages(hand, (int)s->param, frames) || frames.empty()) continue;
+
+			// mapping 위의 Mat은 close 후 무효
+			for (cv::Mat& f : frames) f = f.clone();
+			sequences.push_back(move(frames));
+		}
+		return true;
+	}
+
+	// 어두운 배경 gradient 위에서 움직이는 밝은 타원 (손) + 잡음
+	void makeSynthetic(int count, int frameSize, int size, double noise, vector<Sequence>& sequences)
+	{
+		mt19937 random(7);
+		uniform_real_distribution<double> u(0, 1);
+		normal_distribution<double> n(0, noise);
+
+		for (int i = 0; i < count; ++i)
+		{
+			double cx = size * (0.3 + 0.4 * u(random)), cy = size * (0.3 + 0.4 * u(random));
+			double vx = 0.5 * (u(random) - 0.5), vy = 0.5 * (u(random) - 0.5);
+			double rx = size * (0.15 + 0.1 * u(random)), ry = size * (0.2 + 0.1 * u(random));
+
+			Sequence frames;
+			for (int f = 0; f < frameSize; ++f)
+			{
+				cv::Mat frame(size, size, CV_8UC1);
+				double x0 = cx + vx * f, y0 = cy + vy * f;
+
+				for (int y = 0; y < size; ++y)
+				{
+					uint8_t* row = frame.ptr<uint8_t>(y);
+					for (int x = 0; x < size; ++x)
+					{
+						double dx = (x - x0) / rx, dy = (y - y0) / ry;
+						double v = dx * dx + dy * dy < 1 ? 180 + 40 * (1 - dx * dx - dy * dy) : 20 + 30.0 * y / size;
+						v += noise > 0 ? n(random) : 0;
+						row[x] = (uint8_t)min(max(v, 0.0), 255.0);
+					}
+				}
+				frames.push_back(frame);
+			}
+			sequences.push_back(move(frames));
+		}
+	}
+
+	bool isSame(const Sequence& a, const Sequence& b)
+	{
+		if (a.size() != b.size()) return false;
+
+		for (size_t i = 0; i < a.size(); ++i)
+		{
+			if (a[i].size() != b[i].size() || a[i].type() != b[i].type() || cv::norm(a[i], b[i], cv::NORM_INF) != 0) return false;
+		}
+		return true;
+	}
+}
+
+// roi-codec [folder | sample.ksl | .kss]... [--synthetic=8] [--frames=60] [--size=64] [--noise=2] [--repeat=3]
+//
+// RoiCodec (raw, delta-rice) encode -> decode가 원래 프레임과 같은지, 압축률, encode / decode MB/s
+//   저장된 샘플은 손마다 ROI 시퀀스 하나 (IMAGE_CODED 샘플은 먼저 decode)
+//   샘플이 없으면 --synthetic개 합성 시퀀스 (움직이는 타원 + --noise 잡음)
+//   잘린 stream은 decode가 false여야 함
+int roiCodecCommand(int argc, char* argv[])
+{
+	ToolOptions args(argc, argv);
+
+	int synthetic = max(args.getInt("synthetic", 8), 0);
+	int frameSize = max(args.getInt("frames", 60), 1);
+	int size = max(args.getInt("size", 64), 2);
+	double noise = max(args.getDouble("noise", 2), 0.0);
+	int repeat = max(args.getInt("repeat", 3), 1);
+
+	vector<string> samples;
+	for (const string& p : args.positional) findSamples(p, samples);
+
+	vector<Sequence> sequences;
+	int skipped = forEachSample(samples, [&](SampleFile& sample) { return addSample(sample, sequences); });
+
+	bool labeled = !sequences.empty();
+	if (sequences.empty()) makeSynthetic(synthetic, frameSize, size, noise, sequences);
+	if (sequences.empty())
+	{
+		cout << "roi-codec : no sequence (" << samples.size() << " file, " << skipped << " skipped), --synthetic=N for generated input" << endl;
+		return 1;
+	}
+
+	size_t rawBytes = 0;
+	for (const Sequence& s : sequences) rawBytes += s.size() * s[0].total();
+
+	cout << "roi-codec ... " << (labeled ? "sample " : "synthetic ") << sequences.size() << " sequence, "
+		<< rawBytes / 1024 << "KB, repeat " << repeat << endl;
+
+	bool ok = true;
+	for (int type : { ROI_CODEC_RAW, ROI_CODEC_DELTA_RICE })
+	{
+		unique_ptr<RoiCodec> codec = RoiCodec::create(type);
+
+		vector<vector<uint8_t>> streams(sequences.size());
+		vector<Sequence> decoded(sequences.size());
+		double encodeSeconds = 0, decodeSeconds = 0;
+		int mismatch = 0, failed = 0;
+
+		for (int r = 0; r < repeat; ++r)
+		{
+			auto start = chrono::steady_clock::now();
+			for (size_t i = 0; i < sequences.size(); ++i)
+			{
+				streams[i].clear();
+				if (!codec->encode(sequences[i], streams[i])) ++failed;
+			}
+			encodeSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+			start = chrono::steady_clock::now();
+			for (size_t i = 0; i < sequences.size(); ++i)
+			{
+				decoded[i].clear();
+				if (!codec->decode(streams[i].data(), streams[i].size(), decoded[i])) ++failed;
+			}
+			decodeSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		}
+
+		size_t codedBytes = 0;
+		for (size_t i = 0; i < sequences.size(); ++i)
+		{
+			codedBytes += streams[i].size();
+			if (!isSame(sequences[i], decoded[i])) ++mismatch;
+		}
+
+		// 반만 남긴 stream (저장 중 꺼진 경우)
+		int truncated = 0;
+		for (const vector<uint8_t>& stream : streams)
+		{
+			Sequence frames;
+			truncated += stream.size() > 1 && !codec->decode(stream.data(), stream.size() / 2, frames);
+		}
+
+		double mb = (double)rawBytes * repeat / (1024 * 1024);
+		bool same = mismatch == 0 && failed == 0 && truncated == (int)streams.size();
+		ok = ok && same;
+
+		cout << "  " << codec->getName() << " : " << codedBytes / 1024 << "KB (" << 100.0 * codedBytes / rawBytes << "%, "
+			<< 8.0 * codedBytes / rawBytes << " bit/pixel), encode " << mb / max(encodeSeconds, 1e-9) << "MB/s, decode "
+			<< mb / max(decodeSeconds, 1e-9) << "MB/s, round trip " << (same ? "same" : "DIFFERENT")
+			<< " (mismatch " << mismatch << ", fail " << failed << ", truncated rejected " << truncated << "/" << streams.size() << ")" << endl;
+	}
+
+	return ok ? 0 : 2;
+}
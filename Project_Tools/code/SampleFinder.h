@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Windows.h> // FindFirstFileA
+#include <algorithm>
+#include <vector>
+#include <string>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "SampleFile.h"
+#include "ShardFile.h"
+
+inline bool endsWith(const string& text, const string& suffix)
+{
+	return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// sample.ksl, .kss (재귀, 이름 순), predict 임시 / 모델 / 세션 폴더는 제외
+inline void findSamples(const string& path, vector<string>& samples)
+{
+	if (endsWith(path, SAMPLE_FILE_NAME) || endsWith(path, SHARD_DATA_EXT))
+	{
+		samples.push_back(path);
+		return;
+	}
+
+	string dirpath = (endsWith(path, "/") || endsWith(path, "\\")) ? path : path + "/";
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((dirpath + "*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) return;
+
+	vector<string> dirs, names;
+	do
+	{
+		string name = data.cFileName;
+		if (name == "." || name == ".." || name == "temp" || name + "/" == PATH_MODEL_FOLDER || name + "/" == PATH_SESSION_FOLDER) continue;
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) dirs.push_back(name);
+		else if (name == SAMPLE_FILE_NAME || endsWith(name, SHARD_DATA_EXT)) names.push_back(name);
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+
+	sort(dirs.begin(), dirs.end());
+	sort(names.begin(), names.end());
+
+	for (const string& name : names) samples.push_back(dirpath + name);
+	for (const string& name : dirs) findSamples(dirpath + name + "/", samples);
+}
+
+// samples (findSamples)의 샘플마다 f(SampleFile&), .kss는 안의 샘플 모두
+// 건너뛴 수 (열지 못한 파일 / shard, 읽지 못한 샘플, f가 false)를 돌려줌
+template <class F>
+int forEachSample(const vector<string>& samples, F f)
+{
+	int skipped = 0;
+	for (const string& path : samples)
+	{
+		if (endsWith(path, SHARD_DATA_EXT))
+		{
+			ShardReader shard;
+			if (!shard.open(path))
+			{
+				++skipped;
+				continue;
+			}
+
+			for (int i = 0; i < shard.getSampleSize(); ++i)
+			{
+				SampleFile sample;
+				if (!shard.getSample(i, sample) || !f(sample)) ++skipped;
+			}
+			continue;
+		}
+
+		SampleFile sample;
+		if (!sample.open(path) || !f(sample)) ++skipped;
+	}
+
+	return skipped;
+}
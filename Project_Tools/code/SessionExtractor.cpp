@@ -0,0 +1,367 @@
+#include "SessionExtractor.h"
+
+#include <algorithm>
+#include <ppl.h> // parallel_for
+#include <Windows.h> // FindFirstFileA, MoveFileExA
+
+#include "FrameCollection.h"
+#include "ImageFrameCollection.h"
+#include "SampleFile.h"
+#include "SampleSaver.h"
+
+namespace
+{
+	const int HDFACE_VERTEX_COUNT = 1347;
+
+	bool endsWith(const string& s, const string& suffix)
+	{
+		return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	CameraSpacePoint lerp(CameraSpacePoint src, CameraSpacePoint dst)
+	{
+		float percent = ExtractionConfig::current().lerpPercent;
+		CameraSpacePoint result;
+
+		result.X = Lerp(percent, src.X, dst.X);
+		result.Y = Lerp(percent, src.Y, dst.Y);
+		result.Z = Lerp(percent, src.Z, dst.Z);
+
+		return result;
+	}
+
+	void toJoints(const SessionBody& body, array<Joint, JointType::JointType_Count>& joints)
+	{
+		for (int i = 0; i < JointType::JointType_Count; ++i)
+		{
+			joints[i].JointType = (JointType)i;
+			joints[i].Position.X = body.joints[i].x;
+			joints[i].Position.Y = body.joints[i].y;
+			joints[i].Position.Z = body.joints[i].z;
+			joints[i].TrackingState = (TrackingState)body.joints[i].trackingState;
+		}
+	}
+}
+
+SessionExtractor::Result& SessionExtractor::Result::operator+=(const Result& other)
+{
+	sessions += other.sessions;
+	segments += other.segments;
+	saved += other.saved;
+	skipped += other.skipped;
+	failed += other.failed;
+	colorFrames += other.colorFrames;
+
+	return *this;
+}
+
+SessionExtractor::SessionExtractor(const string& outRoot)
+{
+	this->outRoot = outRoot;
+}
+
+SessionExtractor::Result SessionExtractor::extract(const string& sessionPath)
+{
+	Result result;
+	SessionReader reader;
+
+	if (!reader.open(sessionPath))
+	{
+		cout << "Extract ... fail (open) " << sessionPath << endl;
+		++result.failed;
+		return result;
+	}
+
+	// CALIB 없으면 손 위치 -> color 좌표 변환 불가
+	ColorSpacePoint probe;
+	CameraSpacePoint origin = { 0, 0, 1 };
+	if (!reader.mapCameraToColor(origin, probe))
+	{
+		cout << "Extract ... fail (no calibration) " << sessionPath << endl;
+		++result.failed;
+		return result;
+	}
+
+	vector<Segment> segments;
+	segment(reader, segments, result);
+	result.sessions = 1;
+
+	// 세그먼트는 순서대로, 안에서 프레임 병렬 (세션 간은 바깥 parallel_for_each가 나눔)
+	for (int i = 0; i < (int)segments.size(); ++i)
+	{
+		build(reader, segments[i], i, result);
+		segments[i].frames.clear();
+	}
+
+	cout << "Extract ... done " << sessionPath << " (segment " << result.segments << ", saved " << result.saved << ", skipped " << result.skipped << ")" << endl;
+
+	return result;
+}
+
+void SessionExtractor::segment(SessionReader& reader, vector<Segment>& segments, Result& result)
+{
+	const ExtractionConfig& config = ExtractionConfig::current();
+
+	array<SPoint, SPOINT_SIZE> sPoints;
+	for (int i = 0; i < SPOINT_SIZE; ++i) sPoints[i] = SPoint((SPointsType)i);
+
+	vector<CameraSpacePoint> vertexes(HDFACE_VERTEX_COUNT, CameraSpacePoint());
+	array<Joint, JointType::JointType_Count> joints;
+	CameraSpacePoint lHandPos = CameraSpacePoint();
+	CameraSpacePoint rHandPos = CameraSpacePoint();
+	float spinePx = 0;
+	float spinePxColor = 0;
+	bool hasBody = false;
+	bool tracked = false;
+	bool leftHandActivated = false;
+	bool rightHandActivated = false;
+	bool frameStacking = false;
+	int lastBody = -1;
+	int lastFace = -1;
+	int lastMeta = -1;
+	SessionMeta meta = { -1 };
+	Segment current;
+
+	int colorCount = reader.getChunkSize(SESSION_STREAM_COLOR);
+	result.colorFrames += colorCount;
+
+	for (int n = 0; n < colorCount; ++n)
+	{
+		TIMESPAN time = reader.getTime(SESSION_STREAM_COLOR, n);
+
+		int m = reader.seek(SESSION_STREAM_META, time);
+		if (m >= 0 && m != lastMeta && reader.readMeta(m, meta)) lastMeta = m;
+
+		// updateBody : 새 body 프레임일 때만
+		int b = reader.seek(SESSION_STREAM_BODY, time);
+		if (b >= 0 && b != lastBody)
+		{
+			lastBody = b;
+			tracked = false;
+
+			vector<SessionBody> bodies;
+			if (reader.readBodies(b, bodies))
+			{
+				for (const SessionBody& body : bodies)
+				{
+					if (!body.closest) continue;
+
+					toJoints(body, joints);
+					spinePxColor = (float)distance2d(
+						ColorSpacePoint{ body.joints[JointType_SpineShoulder].colorX, body.joints[JointType_SpineShoulder].colorY },
+						ColorSpacePoint{ body.joints[JointType_SpineMid].colorX, body.joints[JointType_SpineMid].colorY });
+					tracked = true;
+					hasBody = true;
+				}
+			}
+
+			// findLRHandPos : 한쪽이라도 NotTracked면 거기서 멈춤
+			if (tracked && joints[HAND_RECORD_TYPE_L].TrackingState != TrackingState_NotTracked)
+			{
+				lHandPos = lerp(lHandPos, joints[HAND_RECORD_TYPE_L].Position);
+
+				if (joints[HAND_RECORD_TYPE_R].TrackingState != TrackingState_NotTracked)
+				{
+					rHandPos = lerp(rHandPos, joints[HAND_RECORD_TYPE_R].Position);
+				}
+			}
+
+			// 직전 cycle의 SPoint 기준 (라이브와 같은 순서)
+			leftHandActivated = SPoint::isHandActivated(sPoints, SPOINT_BODY_WRIST_LEFT, spinePx);
+			rightHandActivated = SPoint::isHandActivated(sPoints, SPOINT_BODY_WRIST_RIGHT, spinePx);
+		}
+
+		if (!hasBody) continue;
+
+		// 이전 cycle 시각까지의 vertex
+		int f = reader.seek(SESSION_STREAM_FACE, time - 1);
+		if (f >= 0 && f != lastFace)
+		{
+			vector<CameraSpacePoint> face;
+			if (reader.readFace(f, face) && (int)face.size() == HDFACE_VERTEX_COUNT) vertexes.swap(face);
+			lastFace = f;
+		}
+
+		// updateSPoint
+		spinePx = (float)distance3d(joints[JointType_SpineShoulder].Position, joints[JointType_SpineMid].Position);
+		SPoint::fill(sPoints, &joints[0], vertexes, spinePx);
+
+		// updateFrame
+		if (!frameStacking)
+		{
+			if (leftHandActivated || rightHandActivated)
+			{
+				frameStacking = true;
+
+				current = Segment();
+				current.label = meta.label;
+				current.labelName = makeLabelName(meta.label);
+				current.workerName = meta.workerName;
+				current.startTime = time;
+			}
+		}
+		else if (!leftHandActivated && !rightHandActivated)
+		{
+			if ((int)current.frames.size() > config.minStackedFrames)
+			{
+				++result.segments;
+				segments.push_back(move(current));
+			}
+
+			frameStacking = false;
+			current = Segment();
+		}
+
+		if (frameStacking)
+		{
+			PendingFrame p;
+			p.colorIndex = n;
+			p.frame.memorize(lHandPos, rHandPos, sPoints, leftHandActivated, rightHandActivated, time);
+			p.spinePx = spinePxColor;
+			// mapping에 실패한 손만 직전 ROI 유지
+			p.tracked[0] = tracked && reader.mapCameraToColor(lHandPos, p.hands[0]);
+			p.tracked[1] = tracked && reader.mapCameraToColor(rHandPos, p.hands[1]);
+
+			current.frames.push_back(move(p));
+		}
+	}
+}
+
+bool SessionExtractor::build(SessionReader& reader, Segment& seg, int segIndex, Result& result)
+{
+	if (seg.label < 0)
+	{
+		++result.skipped;
+		return false;
+	}
+
+	int size = (int)seg.frames.size();
+	vector<vector<cv::Mat>> pyramids[2] = { vector<vector<cv::Mat>>(size), vector<vector<cv::Mat>>(size) };
+
+	// JPEG decode + crop, 프레임마다 독립
+	Concurrency::parallel_for(0, size, [&](int i)
+	{
+		PendingFrame& p = seg.frames[i];
+		if (!p.tracked[0] && !p.tracked[1]) return;
+
+		cv::Mat color;
+		if (!reader.readColor(p.colorIndex, color)) return;
+
+		for (int h = 0; h < 2; ++h)
+		{
+			if (p.tracked[h]) ImageFrame::cropHand(color, p.hands[h].X, p.hands[h].Y, p.spinePx, pyramids[h][i]);
+		}
+	});
+
+	FrameCollection frames;
+	ImageFrameCollection hands[2];
+
+	for (int h = 0; h < 2; ++h)
+	{
+		// 라이브는 crop 실패 시 직전 ROI를 유지 : 앞으로 채우고, 맨 앞 빈 구간은 첫 ROI로
+		int first = -1;
+		for (int i = 0; i < size && first < 0; ++i)
+		{
+			if (!pyramids[h][i].empty()) first = i;
+		}
+
+		if (first < 0)
+		{
+			cout << seg.labelName << " Extract segment " << segIndex << " ... skip (no hand ROI)" << endl;
+			++result.skipped;
+			return false;
+		}
+
+		const vector<cv::Mat>* last = &pyramids[h][first];
+		for (int i = 0; i < size; ++i)
+		{
+			if (!pyramids[h][i].empty()) last = &pyramids[h][i];
+
+			ImageFrame image;
+			image.memorize(*last, seg.frames[i].frame.getTime());
+			hands[h].stackFrame(image);
+		}
+	}
+
+	for (PendingFrame& p : seg.frames) frames.stackFrame(p.frame);
+
+	if (!ExtractionConfig::current().standardize(frames, hands[0], hands[1], seg.startTime))
+	{
+		cout << seg.labelName << " Extract segment " << segIndex << " ... skip (standardize)" << endl;
+		++result.skipped;
+		return false;
+	}
+
+	Sample sample;
+	sample.label = seg.label;
+	sample.labelName = seg.labelName;
+	sample.workerName = seg.workerName;
+	sample.dateTime = reader.getHeader().dateTime;
+	sample.recordStartTime = seg.startTime;
+	sample.frames = move(frames);
+	sample.lhand = move(hands[0]);
+	sample.rhand = move(hands[1]);
+	sample.frames.setLabel(seg.labelName);
+
+	// data/extracted/0_안녕하세요/<session 시각>_<세그먼트>_0_kyg/sample.ksl (다시 돌리면 덮어씀)
+	char number[8];
+	snprintf(number, sizeof(number), "%03d", segIndex);
+
+	string dirpath = outRoot + to_string(seg.label) + "_" + seg.labelName + "/"
+		+ sample.dateTime + "_" + number + "_" + to_string(seg.label) + "_" + seg.workerName + "/";
+	SampleSaver::makeDirectories(dirpath);
+
+	string path = dirpath + SAMPLE_FILE_NAME;
+	string temp = path + ".tmp";
+
+	bool written = SampleFile::write(temp, sample) && MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+
+	if (written) ++result.saved;
+	else
+	{
+		cout << seg.labelName << " Extract saving ... fail " << dirpath << endl;
+		++result.failed;
+	}
+
+	return written;
+}
+
+string SessionExtractor::makeLabelName(int label)
+{
+	if (label < 0) return "none";
+
+	lock_guard<mutex> guard(labelLock);
+	return LABEL(label);
+}
+
+void SessionExtractor::findSessions(const string& path, vector<string>& sessions)
+{
+	if (endsWith(path, SESSION_FILE_EXT))
+	{
+		sessions.push_back(path);
+		return;
+	}
+
+	string dirpath = (endsWith(path, "/") || endsWith(path, "\\")) ? path : path + "/";
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((dirpath + "*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) return;
+
+	vector<string> dirs, names;
+	do
+	{
+		string name = data.cFileName;
+		if (name == "." || name == "..") continue;
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) dirs.push_back(name);
+		else if (endsWith(name, SESSION_FILE_EXT)) names.push_back(name);
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+
+	sort(dirs.begin(), dirs.end());
+	sort(names.begin(), names.end());
+
+	for (const string& name : names) sessions.push_back(dirpath + name);
+	for (const string& name : dirs) findSessions(dirpath + name + "/", sessions);
+}
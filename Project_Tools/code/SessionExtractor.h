@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Kinect.h>
+#include <array>
+#include <vector>
+#include <string>
+#include <mutex>
+using namespace std;
+
+#include "common/defines.hpp"
+#include "common/LabelMapper.h"
+#include "SPoint.h"
+#include "Frame.h"
+#include "ImageFrame.h"
+#include "SessionReader.h"
+#include "ExtractionConfig.h"
+
+// 기록된 session(.ksr) -> 샘플 (sample.ksl) 재추출
+//
+// Kinect::update()의 body -> SPoint -> ROI -> updateFrame 순서를 color 프레임 시각마다 그대로 재현한다.
+//   body : color 시각 이전 마지막 BODY chunk (새 chunk일 때만 손 위치 lerp, 활성화 판단)
+//   face : 이전 cycle에 계산된 vertex (라이브에서 updateSPoint가 drawHDFace보다 먼저 돌기 때문)
+//   ROI  : 손 위치를 CALIB로 맞춘 투영으로 color 좌표 변환 후 ImageFrame::cropHand
+// 파라미터는 ExtractionConfig::current() (defines.hpp 기본, Project_Tools extract에서 덮어씀)
+//
+// 시간순 상태(lerp, 세그먼트 판단)는 순차로 한 번 훑고,
+// color JPEG decode와 crop은 세그먼트의 프레임 단위로 parallel_for (PPL work stealing).
+class SessionExtractor
+{
+public:
+	struct Result
+	{
+		int sessions = 0;
+		int segments = 0; // minStackedFrames 넘은 세그먼트
+		int saved = 0;
+		int skipped = 0; // label 없음, ROI 없음, 표준화 실패
+		int failed = 0; // 파일 열기 / 쓰기 실패
+		int colorFrames = 0;
+
+		Result& operator+=(const Result& other);
+	};
+
+private:
+	// 세그먼트의 프레임 하나 (ROI crop은 나중에 병렬)
+	struct PendingFrame
+	{
+		int colorIndex;
+		Frame frame;
+		bool tracked[2]; // 손마다, false면 라이브처럼 직전 ROI 유지
+		ColorSpacePoint hands[2];
+		float spinePx; // color space
+	};
+
+	struct Segment
+	{
+		int label;
+		string labelName;
+		string workerName;
+		TIMESPAN startTime;
+		vector<PendingFrame> frames;
+	};
+
+	string outRoot; // '/'로 끝남
+	mutex labelLock; // LabelMapper는 thread safe 아님
+
+public:
+	SessionExtractor(const string& outRoot);
+
+	// session 하나, 세션 간 병렬은 호출측 (parallel_for_each)
+	Result extract(const string& sessionPath);
+
+	// .ksr 파일 또는 폴더 (재귀, 이름 순)
+	static void findSessions(const string& path, vector<string>& sessions);
+
+private:
+	// 시간순 재현 -> 세그먼트 목록
+	void segment(SessionReader& reader, vector<Segment>& segments, Result& result);
+
+	// ROI crop, 표준화, 저장
+	bool build(SessionReader& reader, Segment& seg, int segIndex, Result& result);
+
+	string makeLabelName(int label);
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+// 숫자 option 값이 잘못됨 (--count=abc), main이 받아서 해당 command usage 출력
+struct ToolOptionError : runtime_error
+{
+	ToolOptionError(const string& message) : runtime_error(message) {}
+};
+
+// subcommand 인자 : --key=value (또는 --flag), 나머지는 순서대로 positional
+struct ToolOptions
+{
+	vector<string> positional;
+	map<string, string> options;
+
+	ToolOptions(int argc, char* argv[])
+	{
+		for (int i = 0; i < argc; ++i)
+		{
+			string arg = argv[i];
+
+			if (arg.compare(0, 2, "--") == 0)
+			{
+				size_t eq = arg.find('=');
+				if (eq == string::npos) options[arg.substr(2)] = "1";
+				else options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+			}
+			else positional.push_back(arg);
+		}
+	}
+
+	bool has(const string& key) const
+	{
+		return options.count(key) > 0;
+	}
+
+	string get(const string& key, const string& value) const
+	{
+		auto it = options.find(key);
+		return it == options.end() ? value : it->second;
+	}
+
+	// 값 전체가 숫자여야 함 (stoi("12abc") = 12를 받지 않음), 아니면 ToolOptionError
+	int getInt(const string& key, int value) const
+	{
+		if (!has(key)) return value;
+
+		string text = get(key, "");
+		try
+		{
+			size_t end = 0;
+			int result = stoi(text, &end);
+			if (end == text.size()) return result;
+		}
+		catch (const invalid_argument&) {}
+		catch (const out_of_range&) {}
+
+		throw ToolOptionError("invalid --" + key + "=" + text);
+	}
+
+	double getDouble(const string& key, double value) const
+	{
+		if (!has(key)) return value;
+
+		string text = get(key, "");
+		try
+		{
+			size_t end = 0;
+			double result = stod(text, &end);
+			if (end == text.size()) return result;
+		}
+		catch (const invalid_argument&) {}
+		catch (const out_of_range&) {}
+
+		throw ToolOptionError("invalid --" + key + "=" + text);
+	}
+
+	// 쉼표 목록 (--templates=100,300,1000), 각 값은 minimum 이상으로
+	vector<int> getInts(const string& key, const string& value, int minimum) const
+	{
+		vector<int> result;
+		stringstream stream(get(key, value));
+		string item;
+
+		while (getline(stream, item, ','))
+		{
+			try
+			{
+				size_t end = 0;
+				int n = stoi(item, &end);
+				if (end == item.size())
+				{
+					result.push_back(max(n, minimum));
+					continue;
+				}
+			}
+			catch (const invalid_argument&) {}
+			catch (const out_of_range&) {}
+
+			throw ToolOptionError("invalid --" + key + "=" + get(key, value));
+		}
+
+		if (result.empty()) throw ToolOptionError("empty --" + key);
+		return result;
+	}
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// Project_Tools subcommand, argv는 subcommand 이름 다음부터
+// 반환값은 process exit code
+
+// 기록된 session -> 샘플 재추출 (ExtractCommand.cpp)
+int extractCommand(int argc, char* argv[]);
+
+// predict 샘플 ring consumer, --loopback이면 producer도 (RingConsumeCommand.cpp)
+int ringConsumeCommand(int argc, char* argv[]);
+
+// PredictProtocol server / client loopback (ProtoLoopbackCommand.cpp)
+int protoLoopbackCommand(int argc, char* argv[]);
+
+// PredictQueue policy 부하 확인, 가짜 predictor (PredictBurstCommand.cpp)
+int predictBurstCommand(int argc, char* argv[]);
+
+// InferenceModel과 keras export 결과 비교, avx2 / scalar (InferParityCommand.cpp)
+int inferParityCommand(int argc, char* argv[]);
+
+// 저장된 샘플 -> DTW 템플릿 파일 (DtwEnrollCommand.cpp)
+int dtwEnrollCommand(int argc, char* argv[]);
+
+// DtwMatcher 처리량, 템플릿 수별 (DtwBenchCommand.cpp)
+int dtwBenchCommand(int argc, char* argv[]);
+
+// SentenceDecoder 정확도 / step 시간, 합성 window 확률 열 (DecoderBenchCommand.cpp)
+int decoderBenchCommand(int argc, char* argv[]);
+
+// BatchPredictServer 처리량 / 지연, producer 수 x batch 크기 (BatchBenchCommand.cpp)
+int batchBenchCommand(int argc, char* argv[]);
+
+// InferenceModel image branch int8 quantization, float 대비 정확도 / 시간 (QuantEvalCommand.cpp)
+int quantEvalCommand(int argc, char* argv[]);
+
+// HnswIndex recall / 질의 지연, 임베딩 수별 (AnnBenchCommand.cpp)
+int annBenchCommand(int argc, char* argv[]);
+
+// 저장된 샘플 -> 모델 임베딩 index (AnnEnrollCommand.cpp)
+int annEnrollCommand(int argc, char* argv[]);
+
+// KINECT_MODE_LEARNING 정확도 / learn 시간, 저장된 샘플 shot 수별 (LearnEvalCommand.cpp)
+int learnEvalCommand(int argc, char* argv[]);
+
+// RoiCodec encode / decode 왕복, 압축률 / 속도 (RoiCodecCommand.cpp)
+int roiCodecCommand(int argc, char* argv[]);
+
+// Project_Reader dll C ABI 확인, read_batch / prefetch (ReaderCheckCommand.cpp)
+int readerCheckCommand(int argc, char* argv[]);
+
+// DepthCodec (RVL) encode / decode 왕복, 합성 / 경계 값 / 기록된 session (DepthCodecCommand.cpp)
+int depthCodecCommand(int argc, char* argv[]);
+
+// 여러 station의 predict 요청을 pipe로 받아 BatchPredictServer 하나로 (PredictHostCommand.cpp)
+int predictHostCommand(int argc, char* argv[]);
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+using namespace std;
+
+#include "commands.h"
+#include "ToolOptions.h" // ToolOptionError
+
+namespace
+{
+	struct Command
+	{
+		const char* name;
+		int(*run)(int argc, char* argv[]);
+		const char* usage;
+	};
+
+	const Command COMMANDS[] =
+	{
+		{ "extract", extractCommand, "extract <session.ksr | folder>... [--out=dir] [--frame-size=150] [--image-size=35] [--image-width=80] [--image-scales=140,80,64] [--lerp=0.35] ..." },
+		{ "ring-consume", ringConsumeCommand, "ring-consume [--count=0] [--timeout=1000] [--loopback=sample.ksl] [--interval=100]" },
+		{ "proto-loopback", protoLoopbackCommand, "proto-loopback [--count=1000] [--window=4] [--inline=0] [--labels=10]" },
+		{ "predict-burst", predictBurstCommand, "predict-burst [--policy=drop-oldest|coalesce-latest|block] [--count=50] [--interval=20] [--infer=100] [--capacity=4] [--in-flight=2]" },
+		{ "infer-parity", inferParityCommand, "infer-parity [--model=data/models/M1.kslm] [--reference=data/models/M1.kslr] [--repeat=3] [--tolerance=0.0001]" },
+		{ "dtw-enroll", dtwEnrollCommand, "dtw-enroll [folder | sample.ksl | .kss]... [--out=data/models/templates.ksdt] [--append] [--per-label=0] [--calibrate=200]" },
+		{ "bench-dtw", dtwBenchCommand, "bench-dtw [--templates=100,300,1000,3000] [--queries=20] [--labels=20] [--frames=150] [--k=3] [--verify=3]" },
+		{ "bench-decoder", decoderBenchCommand, "bench-decoder [--sentences=200] [--labels=20] [--noise=0.3] [--beam=8] [--top=5] [--lm-weight=0.5] [--train=2000]" },
+		{ "bench-batch", batchBenchCommand, "bench-batch [--model=data/models/M1.kslm] [--producers=1,2,4,8] [--batch=1,4,8] [--wait=5] [--requests=32] [--think=0] [--prepare=0]" },
+		{ "quant-eval", quantEvalCommand, "quant-eval [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--calibrate=32] [--seed=7] [--branch=1] [--out=data/models/M1.kslq] [--repeat=3] [--synthetic=0]" },
+		{ "ann-enroll", annEnrollCommand, "ann-enroll [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--out=data/models/embeddings.ksan] [--append] [--per-label=0]" },
+		{ "bench-ann", annBenchCommand, "bench-ann [--sizes=1000,10000,100000] [--dim=64] [--labels=0] [--spread=1.0] [--queries=200] [--k=10] [--ef=16,32,64,128,256] [--m=16]" },
+		{ "learn-eval", learnEvalCommand, "learn-eval [folder | sample.ksl | .kss]... [--model=data/models/M1.kslm] [--worker=] [--shots=5] [--weight=0.7] [--synthetic=0] [--labels=10] [--noise=0.3]" },
+		{ "roi-codec", roiCodecCommand, "roi-codec [folder | sample.ksl | .kss]... [--synthetic=8] [--frames=60] [--size=64] [--noise=2] [--repeat=3]" },
+		{ "reader-check", readerCheckCommand, "reader-check [root] [--dll=../../Project_Reader/program/Project_Reader_x64_Release.dll] [--frame-size=150] [--image-frame-size=35] [--image-scale=80] [--float=1] [--batch=8]" },
+		{ "depth-codec", depthCodecCommand, "depth-codec [session.ksr | folder]... [--frames=30] [--width=512] [--height=424]" },
+		{ "predict-host", predictHostCommand, "predict-host [pipe]... [--model=data/models/M1.kslm] [--batch=8] [--wait=5] [--count=0]" },
+	};
+
+	void printUsage()
+	{
+		cout << "usage : Project_Tools <command> [args]" << endl;
+		for (const Command& c : COMMANDS) cout << "  " << c.usage << endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	string name = argv[1];
+	for (const Command& c : COMMANDS)
+	{
+		if (name != c.name) continue;
+
+		try
+		{
+			return c.run(argc - 2, argv + 2);
+		}
+		catch (const ToolOptionError& e)
+		{
+			cout << name << " : " << e.what() << endl;
+			cout << "usage : " << c.usage << endl;
+			return 1;
+		}
+	}
+
+	cout << "unknown command " << name << endl;
+	printUsage();
+
+	return 1;
+}